@@ -3,6 +3,7 @@ TEMPLATE = subdirs
 SUBDIRS += \
     interfaces/can/src/ifc_can.pro \
     interfaces/rs/src/ifc_rs.pro \
+    interfaces/rs_hub/src/rs_hub.pro \
     interfaces/tcp_client_multi/src/tcp_client_multi.pro \
     interfaces/tcp_server/src/tcp_server.pro \
     interfaces/udp/src/ifc_udp.pro
@@ -0,0 +1,157 @@
+#include "sv_latency.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace {
+
+  struct StageInfo {
+    const char* metric;
+    const char* name;
+  };
+
+  const StageInfo Stages[] = {
+    {L_PARSE,   "parse"},
+    {L_SIGNAL,  "signal"},
+    {L_PUBLISH, "publish"},
+    {L_ISE,     "ise"},
+    {L_STORAGE, "storage"}
+  };
+
+}
+
+const char* latency::stageMetric(Stage stage)
+{
+  return Stages[stage].metric;
+}
+
+const char* latency::stageName(Stage stage)
+{
+  return Stages[stage].name;
+}
+
+void latency::Receiver::attach(const QString& device)
+{
+  metrics::SvMetrics* m = metrics::SvMetrics::instance();
+
+  m_received = m->received(m->device(device));
+
+}
+
+void latency::Tracer::attach(const QString& device)
+{
+  m_metrics   = metrics::SvMetrics::instance();
+  m_device    = m_metrics->device(device);
+  m_received  = m_metrics->received(m_device);
+  m_stamp     = 0;
+
+  m_parse     = m_metrics->histogram(L_PARSE,  device);
+  m_signal    = m_metrics->histogram(L_SIGNAL, device);
+
+}
+
+void latency::Tracer::parsed()
+{
+  // интерфейс не отмечает время приема - трассировки нет
+  m_stamp = m_received ? m_received->load(std::memory_order_relaxed) & L_STAMP_MASK : 0;
+
+  if(m_stamp)
+    m_parse.record(now() - m_stamp);
+
+}
+
+void latency::Tracer::updated(int signal_id)
+{
+  if(!m_stamp)
+    return;
+
+  metrics::Slot* slot = m_metrics->slot(signal_id, true);
+
+  if(!slot || m_device < 0)
+    return;
+
+  // новое значение - отметки этапов снимаются
+  slot->device.store(m_device, std::memory_order_relaxed);
+  slot->stamp.store(m_stamp, std::memory_order_release);
+
+}
+
+void latency::Tracer::committed()
+{
+  if(m_stamp)
+    m_signal.record(now() - m_stamp);
+
+  m_stamp = 0;
+
+}
+
+latency::Consumer::Consumer(Stage stage):
+  m_stage(stage),
+  m_bit(quint64(1) << (L_STAMP_BITS + int(stage)))
+{
+
+}
+
+void latency::Consumer::record(int signal_id)
+{
+  metrics::SvMetrics* m = metrics::SvMetrics::instance();
+  metrics::Slot* slot = m->slot(signal_id, false);
+
+  // значение сигнала не проходило через протокол с трассировкой
+  if(!slot)
+    return;
+
+  quint64 stamp = slot->stamp.load(std::memory_order_acquire);
+
+  if(!(stamp & L_STAMP_MASK) || (stamp & m_bit))
+    return;
+
+  // значение уже учтено этим этапом в другом потоке или сменилось
+  if(!slot->stamp.compare_exchange_strong(stamp, stamp | m_bit, std::memory_order_acq_rel))
+    return;
+
+  int device = slot->device.load(std::memory_order_relaxed);
+
+  if(!m_histograms.contains(device))
+    m_histograms.insert(device, m->histogram(stageMetric(m_stage), QString::fromUtf8(m->deviceName(device))));
+
+  m_histograms[device].record(now() - (stamp & L_STAMP_MASK));
+
+}
+
+QByteArray latency::report()
+{
+  QJsonObject devices;
+
+  for(const metrics::Quantiles& q: metrics::SvMetrics::instance()->quantiles(L_PREFIX)) {
+
+    const char* stage = nullptr;
+
+    for(const StageInfo& s: Stages)
+      if(q.name == s.metric)
+        stage = s.name;
+
+    if(!stage)
+      continue;
+
+    QJsonObject j;
+    j.insert("count", QJsonValue(double(q.count)));
+    j.insert("p50",   QJsonValue(double(q.p50)));
+    j.insert("p99",   QJsonValue(double(q.p99)));
+    j.insert("p999",  QJsonValue(double(q.p999)));
+
+    QString device = QString::fromUtf8(q.device);
+
+    QJsonObject d = devices.value(device).toObject();
+    d.insert(stage, j);
+    devices.insert(device, d);
+
+  }
+
+  QJsonObject r;
+  r.insert("unit",    QJsonValue("us"));
+  r.insert("devices", devices);
+
+  return QJsonDocument(r).toJson(QJsonDocument::Compact);
+
+}
@@ -0,0 +1,134 @@
+/**********************************************************************
+ *  трассировка задержек от приема данных интерфейсом до потребителей
+ *  значений сигналов: web клиентов, межсерверного обмена и хранилищ.
+ *
+ *  интерфейс при чтении данных отмечает время приема для устройства
+ *  (Receiver). протокол после разбора пакета берет это время, и при
+ *  назначении значений сигналам оно сохраняется как метка времени
+ *  каждого сигнала (Tracer). потребитель при отправке значения
+ *  сигнала записывает задержку от приема (Consumer).
+ *
+ *  все задержки отсчитываются от приема данных, а не от предыдущего
+ *  этапа: так для каждого этапа видна полная задержка, например, от
+ *  приема сигнала тревоги до его отображения.
+ *
+ *  время - CLOCK_MONOTONIC, мкс. часы общие для всех процессов, поэтому
+ *  метки сравнимы между библиотеками и процессами.
+ *
+ *  метки хранятся в таблице трассировки общего сегмента метрик
+ *  (sv_metrics.h). каждое значение учитывается этапом один раз: при
+ *  учете этап отмечается в метке, новое значение сигнала отметки
+ *  снимает. для сигнала, значение которого не менялось, задержка не
+ *  записывается.
+ *
+ *  гистограммы этапов - ряды реестра метрик с меткой устройства, они
+ *  выводятся в /metrics, квантили - в /latency (report).
+ * *********************************************************************/
+
+#ifndef SV_LATENCY_H
+#define SV_LATENCY_H
+
+#include <QHash>
+#include <QString>
+#include <QByteArray>
+
+#include <time.h>
+
+#include "sv_metrics.h"
+
+// метка сигнала: младшие биты - время, старшие - отметки этапов
+#define L_STAMP_BITS          56
+#define L_STAMP_MASK          ((quint64(1) << L_STAMP_BITS) - 1)
+
+namespace latency {
+
+  enum Stage {
+    lsParse,
+    lsSignal,
+    lsPublish,
+    lsIse,
+    lsStorage
+  };
+
+  // имя гистограммы и краткое имя этапа для /latency
+  const char* stageMetric(Stage stage);
+  const char* stageName(Stage stage);
+
+  // монотонное время, мкс
+  inline quint64 now()
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return quint64(ts.tv_sec) * 1000000 + quint64(ts.tv_nsec) / 1000;
+  }
+
+  /** интерфейс: время приема данных устройства **/
+  class Receiver
+  {
+  public:
+    void attach(const QString& device);
+
+    inline void stamp() { if(m_received) m_received->store(now(), std::memory_order_relaxed); }
+
+  private:
+    std::atomic<quint64>* m_received = nullptr;
+
+  };
+
+  /** протокол: задержка разбора и назначения значений, метки сигналов **/
+  class Tracer
+  {
+  public:
+    void attach(const QString& device);
+
+    // пакет разобран. время приема берется у интерфейса
+    void parsed();
+
+    // значение сигнала назначено. метка - время приема пакета
+    void updated(int signal_id);
+
+    // все значения пакета назначены
+    void committed();
+
+    // время приема разбираемого пакета, мкс. 0 - интерфейс не отмечает время приема
+    quint64 stamp() const { return m_stamp; }
+
+  private:
+    metrics::SvMetrics*   m_metrics  = nullptr;
+    int                   m_device   = -1;
+    std::atomic<quint64>* m_received = nullptr;
+
+    quint64               m_stamp    = 0;     // время приема разбираемого пакета
+
+    metrics::Histogram    m_parse;
+    metrics::Histogram    m_signal;
+
+  };
+
+  /** потребитель значений сигналов: задержка этапа stage.
+   *  гистограммы устройств регистрируются при первом значении устройства.
+   *  один объект используется одновременно только в одном потоке **/
+  class Consumer
+  {
+  public:
+    explicit Consumer(Stage stage);
+
+    // значение сигнала отправлено или записано
+    void record(int signal_id);
+
+  private:
+    Stage                 m_stage;
+    quint64               m_bit;
+
+    QHash<int, metrics::Histogram> m_histograms;
+
+  };
+
+  // квантили этапов по устройствам, json:
+  // {"unit":"us","devices":{"<устройство>":{"<этап>":{"count":..,"p50":..,"p99":..,"p999":..}}}}
+  QByteArray report();
+
+}
+
+#endif // SV_LATENCY_H
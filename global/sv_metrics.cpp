@@ -0,0 +1,657 @@
+#include "sv_metrics.h"
+
+#include <QMap>
+#include <QMutexLocker>
+#include <QDir>
+#include <QFile>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+  struct Family {
+    const char* name;
+    const char* help;
+  };
+
+  const Family Families[] = {
+    {M_IFC_BYTES_IN,      "Байт получено интерфейсом"},
+    {M_IFC_BYTES_OUT,     "Байт отправлено интерфейсом"},
+    {M_IFC_DROPS,         "Сбросы входного буфера интерфейса из-за переполнения"},
+    {M_PRT_FRAMES,        "Разобрано пакетов"},
+    {M_PRT_CRC_ERRORS,    "Пакетов с ошибкой crc"},
+    {M_PRT_RESETS,        "Сбросы входного буфера протоколом: чужие и ошибочные пакеты"},
+    {M_PRT_PARSE_TIME,    "Время разбора пакета, с"},
+    {M_STG_QUEUE_DEPTH,   "Кол-во сигналов, ожидающих записи в хранилище"},
+    {M_STG_WRITE_TIME,    "Время записи в хранилище, с"},
+    {M_STG_WRITE_ERRORS,  "Ошибки записи в хранилище"},
+    {L_PARSE,             "Задержка от приема данных до разбора пакета, с"},
+    {L_SIGNAL,            "Задержка от приема данных до назначения значений сигналам, с"},
+    {L_PUBLISH,           "Задержка от приема данных до отправки значения web клиенту, с"},
+    {L_ISE,               "Задержка от приема данных до отправки межсерверного обмена, с"},
+    {L_STORAGE,           "Задержка от приема данных до записи в хранилище, с"}
+  };
+
+  const char* TypeNames[] = {"counter", "gauge", "histogram"};
+
+  // границы интервалов гистограммы в выводе - степени двойки от 1 мкс до 2^24 мкс (~16.8 с)
+  const int EXPOSITION_BOUNDS = 25;
+
+  bool alive(qint32 pid)
+  {
+    return pid > 0 && (kill(pid, 0) == 0 || errno != ESRCH);
+  }
+
+  QByteArray escape(const char* value)
+  {
+    QByteArray r;
+
+    for(const char* c = value; *c; ++c) {
+
+      switch (*c) {
+        case '\\': r.append("\\\\"); break;
+        case '"':  r.append("\\\""); break;
+        case '\n': r.append("\\n");  break;
+        default:   r.append(*c);
+      }
+    }
+
+    return r;
+
+  }
+
+  QByteArray seconds(quint64 us)
+  {
+    return QByteArray::number(double(us) / 1000000.0, 'g', 10);
+  }
+
+  // UTF-8 не длиннее size байт. обрезка только по границе символа:
+  // байты продолжения (10xxxxxx) отбрасываются вместе с начальным байтом
+  QByteArray utf8(const QString& text, int size)
+  {
+    QByteArray r = text.toUtf8();
+
+    if(r.size() <= size)
+      return r;
+
+    while(size > 0 && (quint8(r.at(size)) & 0xC0) == 0x80)
+      --size;
+
+    return r.left(size);
+
+  }
+
+  // время старта процесса в тиках от загрузки системы, поле 22 /proc/<pid>/stat
+  QByteArray started(qint32 pid)
+  {
+    QFile f(QString("/proc/%1/stat").arg(pid));
+
+    if(!f.open(QIODevice::ReadOnly))
+      return QByteArray();
+
+    QByteArray stat = f.readAll();
+
+    // имя программы в скобках может содержать пробелы, поля отсчитываются после него
+    QList<QByteArray> fields = stat.mid(stat.lastIndexOf(')') + 2).split(' ');
+
+    return fields.count() > 19 ? fields.at(19) : QByteArray();
+
+  }
+
+  // имя сегмента процесса
+  QString segmentName(qint32 pid, const QByteArray& start)
+  {
+    return QString("%1_%2_%3").arg(DEFAULT_METRICS_SHM_NAME).arg(pid).arg(QString(start));
+  }
+
+  // удаление сегментов процессов, которые уже завершились или были перезапущены с тем же pid
+  void removeStale()
+  {
+    QString prefix = QString(DEFAULT_METRICS_SHM_NAME).mid(1) + '_';
+
+    for(const QString& file: QDir("/dev/shm").entryList(QStringList() << prefix + '*', QDir::Files)) {
+
+      QStringList parts = file.mid(prefix.length()).split('_');
+
+      if(parts.count() != 2)
+        continue;
+
+      qint32 pid = parts.at(0).toInt();
+
+      if(pid > 0 && started(pid) == parts.at(1).toLatin1())
+        continue;
+
+      shm_unlink(QString('/' + file).toLocal8Bit().constData());
+
+    }
+  }
+
+}
+
+metrics::SvMetrics::SvMetrics()
+{
+
+}
+
+metrics::SvMetrics* metrics::SvMetrics::instance()
+{
+  static QMutex     mutex;
+  static SvMetrics* metrics = nullptr;
+
+  QMutexLocker locker(&mutex);
+
+  if(!metrics) {
+
+    metrics = new SvMetrics();
+    metrics->open(segmentName(getpid(), started(getpid())));
+
+  }
+
+  return metrics;
+
+}
+
+QString metrics::SvMetrics::lastError() const
+{
+  QMutexLocker locker(&m_error_mutex);
+  return m_last_error;
+}
+
+void metrics::SvMetrics::setError(const QString& error)
+{
+  QMutexLocker locker(&m_error_mutex);
+  m_last_error = error;
+}
+
+bool metrics::SvMetrics::open(const QString& name)
+{
+  QByteArray n = name.toLocal8Bit();
+
+  size_t size = sizeof(Header)
+              + size_t(METRICS_ENTRIES) * sizeof(Entry)
+              + size_t(METRICS_HISTOGRAMS) * HIST_BUCKETS * sizeof(std::atomic<quint64>)
+              + size_t(METRICS_DEVICES) * sizeof(Device)
+              + size_t(METRICS_SLOTS) * sizeof(Slot);
+
+  bool created = true;
+  int fd = shm_open(n.constData(), O_RDWR | O_CREAT | O_EXCL, METRICS_SHM_MODE);
+
+  if(fd < 0 && errno == EEXIST) {
+
+    created = false;
+    fd = shm_open(n.constData(), O_RDWR, METRICS_SHM_MODE);
+
+  }
+  else if(fd >= 0)
+    removeStale();
+
+  if(fd < 0) {
+
+    setError(QString("Ошибка открытия разделяемой памяти %1: %2").arg(name).arg(strerror(errno)));
+    return false;
+
+  }
+
+  if(created && ftruncate(fd, off_t(size)) < 0) {
+
+    setError(QString("Ошибка выделения разделяемой памяти %1: %2").arg(name).arg(strerror(errno)));
+
+    ::close(fd);
+    shm_unlink(n.constData());
+
+    return false;
+
+  }
+
+  // сегмент создан другим процессом - ожидание, пока он задаст размер
+  if(!created) {
+
+    struct stat st;
+
+    for(int i = 0; i < 100; ++i) {
+
+      if(fstat(fd, &st) == 0 && size_t(st.st_size) >= size)
+        break;
+
+      usleep(1000);
+
+    }
+
+    if(size_t(st.st_size) < size) {
+
+      setError(QString("Сегмент разделяемой памяти %1 не инициализирован или другой версии").arg(name));
+
+      ::close(fd);
+      return false;
+
+    }
+  }
+
+  void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+  // отображение остается действительным после закрытия дескриптора
+  ::close(fd);
+
+  if(memory == MAP_FAILED) {
+
+    setError(QString("Ошибка отображения разделяемой памяти %1: %2").arg(name).arg(strerror(errno)));
+    return false;
+
+  }
+
+  Header* header = reinterpret_cast<Header*>(memory);
+
+  if(created) {
+
+    header->version     = METRICS_VERSION;
+    header->entries     = METRICS_ENTRIES;
+    header->histograms  = METRICS_HISTOGRAMS;
+    header->pid.store(getpid());
+    header->lock.store(0);
+    header->count.store(0);
+    header->hcount.store(0);
+    header->dcount.store(0);
+
+    // magic записывается последним, после этого сегмент считается готовым
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = METRICS_MAGIC;
+
+  }
+  else {
+
+    for(int i = 0; i < 100 && header->magic != METRICS_MAGIC; ++i)
+      usleep(1000);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if(header->magic != METRICS_MAGIC || header->version != METRICS_VERSION ||
+       header->entries != METRICS_ENTRIES || header->histograms != METRICS_HISTOGRAMS) {
+
+      setError(QString("Неверный формат сегмента разделяемой памяти %1").arg(name));
+
+      munmap(memory, size);
+      return false;
+
+    }
+  }
+
+  m_header  = header;
+  m_entries = reinterpret_cast<Entry*>(reinterpret_cast<char*>(memory) + sizeof(Header));
+  m_buckets = reinterpret_cast<std::atomic<quint64>*>(reinterpret_cast<char*>(m_entries) + size_t(METRICS_ENTRIES) * sizeof(Entry));
+  m_devices = reinterpret_cast<Device*>(m_buckets + size_t(METRICS_HISTOGRAMS) * HIST_BUCKETS);
+  m_slots   = reinterpret_cast<Slot*>(m_devices + METRICS_DEVICES);
+
+  return true;
+
+}
+
+void metrics::SvMetrics::lock()
+{
+  qint32 self = getpid();
+  qint32 owner = 0;
+
+  while(!m_header->lock.compare_exchange_weak(owner, self, std::memory_order_acquire)) {
+
+    // процесс завершился, не освободив блокировку
+    if(owner && owner != self && !alive(owner) &&
+       m_header->lock.compare_exchange_strong(owner, self, std::memory_order_acquire))
+      return;
+
+    owner = 0;
+    sched_yield();
+
+  }
+}
+
+void metrics::SvMetrics::unlock()
+{
+  m_header->lock.store(0, std::memory_order_release);
+}
+
+metrics::Entry* metrics::SvMetrics::entry(Type type, const char* name, const QString& device)
+{
+  if(!m_header)
+    return nullptr;
+
+  QByteArray d = utf8(device, METRICS_DEVICE_SIZE - 1);
+
+  lock();
+
+  quint32 count = m_header->count.load(std::memory_order_acquire);
+
+  // повторная регистрация - существующий ряд
+  for(quint32 i = 0; i < count; ++i) {
+
+    Entry* e = &m_entries[i];
+
+    if(e->type == quint32(type) && strncmp(e->name, name, METRICS_NAME_SIZE) == 0 && d == e->device) {
+
+      unlock();
+      return e;
+
+    }
+  }
+
+  if(count >= m_header->entries || (type == mtHistogram && m_header->hcount.load() >= m_header->histograms)) {
+
+    unlock();
+
+    setError(QString("Нет места для метрики %1 устройства %2").arg(name).arg(device));
+    return nullptr;
+
+  }
+
+  Entry* e = &m_entries[count];
+
+  e->type = quint32(type);
+  e->histogram = type == mtHistogram ? m_header->hcount.fetch_add(1) : 0;
+
+  strncpy(e->name, name, METRICS_NAME_SIZE - 1);
+  e->name[METRICS_NAME_SIZE - 1] = '\0';
+
+  memcpy(e->device, d.constData(), size_t(d.size()));
+  e->device[d.size()] = '\0';
+
+  e->value.store(0);
+  e->sum.store(0);
+
+  e->state.store(1, std::memory_order_release);
+  m_header->count.store(count + 1, std::memory_order_release);
+
+  unlock();
+
+  return e;
+
+}
+
+metrics::Counter metrics::SvMetrics::counter(const char* name, const QString& device)
+{
+  return Counter(entry(mtCounter, name, device));
+}
+
+metrics::Gauge metrics::SvMetrics::gauge(const char* name, const QString& device)
+{
+  return Gauge(entry(mtGauge, name, device));
+}
+
+metrics::Histogram metrics::SvMetrics::histogram(const char* name, const QString& device)
+{
+  Entry* e = entry(mtHistogram, name, device);
+
+  return e ? Histogram(e, &m_buckets[size_t(e->histogram) * HIST_BUCKETS]) : Histogram();
+}
+
+QByteArray metrics::SvMetrics::exposition() const
+{
+  if(!m_header)
+    return QByteArray();
+
+  // ряды группируются по имени метрики
+  QMap<QByteArray, QList<const Entry*>> families;
+
+  quint32 count = m_header->count.load(std::memory_order_acquire);
+
+  for(quint32 i = 0; i < count; ++i) {
+
+    const Entry* e = &m_entries[i];
+
+    if(e->state.load(std::memory_order_acquire) == 1)
+      families[QByteArray(e->name)].append(e);
+
+  }
+
+  QByteArray r;
+  r.reserve(int(count) * 128);
+
+  for(auto it = families.constBegin(); it != families.constEnd(); ++it) {
+
+    const QByteArray& name = it.key();
+    quint32 type = it.value().first()->type;
+
+    for(const Family& f: Families)
+      if(name == f.name)
+        r.append("# HELP ").append(name).append(' ').append(f.help).append('\n');
+
+    r.append("# TYPE ").append(name).append(' ').append(TypeNames[type < 3 ? type : 0]).append('\n');
+
+    for(const Entry* e: it.value()) {
+
+      QByteArray label = QByteArray("device=\"").append(escape(e->device)).append('"');
+
+      if(type != mtHistogram) {
+
+        r.append(name).append('{').append(label).append("} ")
+         .append(QByteArray::number(e->value.load(std::memory_order_relaxed))).append('\n');
+
+        continue;
+
+      }
+
+      // накопленные значения по границам 2^k мкс. степени двойки - границы интервалов
+      const std::atomic<quint64>* buckets = &m_buckets[size_t(e->histogram) * HIST_BUCKETS];
+
+      quint64 total = 0;
+      int b = 0;
+
+      for(int k = 0; k < EXPOSITION_BOUNDS; ++k) {
+
+        quint64 le = quint64(1) << k;
+
+        for(; b < HIST_BUCKETS && bound(b) <= le; ++b)
+          total += buckets[b].load(std::memory_order_relaxed);
+
+        r.append(name).append("_bucket{").append(label).append(",le=\"").append(seconds(le)).append("\"} ")
+         .append(QByteArray::number(total)).append('\n');
+
+      }
+
+      for(; b < HIST_BUCKETS; ++b)
+        total += buckets[b].load(std::memory_order_relaxed);
+
+      r.append(name).append("_bucket{").append(label).append(",le=\"+Inf\"} ").append(QByteArray::number(total)).append('\n');
+      r.append(name).append("_sum{").append(label).append("} ").append(seconds(e->sum.load(std::memory_order_relaxed))).append('\n');
+      r.append(name).append("_count{").append(label).append("} ").append(QByteArray::number(total)).append('\n');
+
+    }
+  }
+
+  return r;
+
+}
+
+QList<metrics::Quantiles> metrics::SvMetrics::quantiles(const char* prefix) const
+{
+  QList<Quantiles> result;
+
+  if(!m_header)
+    return result;
+
+  size_t len = strlen(prefix);
+  quint32 count = m_header->count.load(std::memory_order_acquire);
+
+  for(quint32 i = 0; i < count; ++i) {
+
+    const Entry* e = &m_entries[i];
+
+    if(e->state.load(std::memory_order_acquire) != 1 || e->type != mtHistogram || strncmp(e->name, prefix, len) != 0)
+      continue;
+
+    // копия счетчиков, чтобы ранги считались по одному состоянию
+    const std::atomic<quint64>* buckets = &m_buckets[size_t(e->histogram) * HIST_BUCKETS];
+    quint64 values[HIST_BUCKETS];
+
+    Quantiles q;
+    q.name   = QByteArray(e->name);
+    q.device = QByteArray(e->device);
+
+    for(int b = 0; b < HIST_BUCKETS; ++b) {
+
+      values[b] = buckets[b].load(std::memory_order_relaxed);
+      q.count += values[b];
+
+    }
+
+    if(q.count) {
+
+      // ранг квантиля - номер значения в отсортированном ряду, от 1
+      quint64 r50  = (q.count * 500  + 999)  / 1000;
+      quint64 r99  = (q.count * 990  + 999)  / 1000;
+      quint64 r999 = (q.count * 999  + 999)  / 1000;
+
+      quint64 total = 0;
+
+      for(int b = 0; b < HIST_BUCKETS; ++b) {
+
+        if(!values[b])
+          continue;
+
+        total += values[b];
+
+        if(!q.p50  && total >= r50)  q.p50  = bound(b);
+        if(!q.p99  && total >= r99)  q.p99  = bound(b);
+        if(!q.p999 && total >= r999) { q.p999 = bound(b); break; }
+
+      }
+    }
+
+    result.append(q);
+
+  }
+
+  return result;
+
+}
+
+int metrics::SvMetrics::device(const QString& name)
+{
+  if(!m_header)
+    return -1;
+
+  QByteArray n = utf8(name, METRICS_DEVICE_SIZE - 1);
+
+  lock();
+
+  quint32 count = m_header->dcount.load(std::memory_order_acquire);
+
+  for(quint32 i = 0; i < count; ++i) {
+
+    if(n == m_devices[i].name) {
+
+      unlock();
+      return int(i);
+
+    }
+  }
+
+  if(count >= METRICS_DEVICES) {
+
+    unlock();
+
+    setError(QString("Нет места для устройства %1 в таблице трассировки").arg(name));
+    return -1;
+
+  }
+
+  Device* d = &m_devices[count];
+
+  memcpy(d->name, n.constData(), size_t(n.size()));
+  d->name[n.size()] = '\0';
+  d->received.store(0);
+
+  m_header->dcount.store(count + 1, std::memory_order_release);
+
+  unlock();
+
+  return int(count);
+
+}
+
+QByteArray metrics::SvMetrics::deviceName(int device) const
+{
+  if(!m_header || device < 0 || quint32(device) >= m_header->dcount.load(std::memory_order_acquire))
+    return QByteArray();
+
+  return QByteArray(m_devices[device].name);
+
+}
+
+std::atomic<quint64>* metrics::SvMetrics::received(int device)
+{
+  if(!m_header || device < 0 || device >= METRICS_DEVICES)
+    return nullptr;
+
+  return &m_devices[device].received;
+
+}
+
+metrics::Slot* metrics::SvMetrics::slot(int signal_id, bool create)
+{
+  if(!m_header)
+    return nullptr;
+
+  // открытая адресация, линейный поиск. сигналы из таблицы не удаляются
+  qint32  key  = signal_id + 1;
+  quint32 mask = METRICS_SLOTS - 1;
+  quint32 i    = (quint32(signal_id) * 2654435761u) & mask;
+
+  for(quint32 n = 0; n < METRICS_SLOTS; ++n, i = (i + 1) & mask) {
+
+    Slot* s = &m_slots[i];
+    qint32 k = s->key.load(std::memory_order_acquire);
+
+    if(k == key)
+      return s;
+
+    if(k != 0)
+      continue;
+
+    if(!create)
+      return nullptr;
+
+    // свободная ячейка. ее может одновременно занять другой поток
+    if(s->key.compare_exchange_strong(k, key, std::memory_order_acq_rel) || k == key)
+      return s;
+
+  }
+
+  return nullptr;
+
+}
+
+void metrics::InterfaceMetrics::attach(const QString& device)
+{
+  SvMetrics* m = SvMetrics::instance();
+
+  bytes_in    = m->counter(M_IFC_BYTES_IN,  device);
+  bytes_out   = m->counter(M_IFC_BYTES_OUT, device);
+  drops       = m->counter(M_IFC_DROPS,     device);
+
+}
+
+void metrics::ProtocolMetrics::attach(const QString& device)
+{
+  SvMetrics* m = SvMetrics::instance();
+
+  frames      = m->counter(M_PRT_FRAMES,       device);
+  crc_errors  = m->counter(M_PRT_CRC_ERRORS,   device);
+  resets      = m->counter(M_PRT_RESETS,       device);
+  parse_time  = m->histogram(M_PRT_PARSE_TIME, device);
+
+}
+
+void metrics::StorageMetrics::attach(const QString& device)
+{
+  SvMetrics* m = SvMetrics::instance();
+
+  queue_depth   = m->gauge(M_STG_QUEUE_DEPTH,     device);
+  write_time    = m->histogram(M_STG_WRITE_TIME,  device);
+  write_errors  = m->counter(M_STG_WRITE_ERRORS,  device);
+
+}
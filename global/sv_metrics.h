@@ -0,0 +1,331 @@
+/**********************************************************************
+ *  реестр метрик устройств, интерфейсов и хранилищ.
+ *
+ *  метрики хранятся в сегменте POSIX shm, как журнал sv_shm_log:
+ *  библиотеки интерфейсов, протоколов, хранилищ и провайдеров
+ *  загружаются отдельно, и у каждой свои статические объекты. общий
+ *  сегмент дает всем библиотекам процесса один реестр.
+ *
+ *  сегмент свой у каждого процесса: /modus_metrics_<pid>_<запуск>, где
+ *  <запуск> - время старта процесса (поле starttime /proc/self/stat),
+ *  чтобы процесс с повторно выданным pid не получил чужой сегмент.
+ *  доступ - только пользователю процесса (0600). сегменты завершившихся
+ *  процессов удаляются при создании нового.
+ *
+ *  ряд метрики - имя и метка device. регистрация ряда (при
+ *  конфигурировании) выполняется под блокировкой сегмента, повторная
+ *  регистрация возвращает существующий ряд. обновление на рабочем пути
+ *  - одна атомарная операция без блокировок и без системных вызовов.
+ *  текст для /metrics формируется только при запросе.
+ *
+ *  виды метрик:
+ *    Counter   - монотонный счетчик;
+ *    Gauge     - текущее значение;
+ *    Histogram - распределение времени, мкс. логарифмически-линейные
+ *                интервалы (HDR): 16 интервалов на каждую степень двойки,
+ *                погрешность не более 6.25%, диапазон до 2^32 мкс.
+ *
+ *  в том же сегменте - таблица трассировки задержек (см. sv_latency.h):
+ *  устройства со временем последнего приема и метки времени значений
+ *  сигналов. метки передаются от протокола к потребителям сигналов,
+ *  которые загружены другими библиотеками.
+ *
+ *  если сегмент открыть не удалось, регистрация возвращает пустые
+ *  метрики, обновление которых ничего не делает.
+ *
+ *  сегмент переживает процесс (аварийное завершение), до запуска
+ *  следующего.
+ * *********************************************************************/
+
+#ifndef SV_METRICS_H
+#define SV_METRICS_H
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+
+#include <atomic>
+
+#define DEFAULT_METRICS_SHM_NAME  "/modus_metrics"    // префикс, см. выше
+#define METRICS_SHM_MODE          0600
+
+#define METRICS_MAGIC             0x4D455452  // METR
+#define METRICS_VERSION           2
+
+#define METRICS_ENTRIES           4096        // рядов в сегменте
+#define METRICS_HISTOGRAMS        1024        // гистограмм в сегменте
+#define METRICS_DEVICES           512         // устройств в таблице трассировки
+#define METRICS_SLOTS             65536       // сигналов в таблице трассировки, степень двойки
+
+#define METRICS_NAME_SIZE         64
+#define METRICS_DEVICE_SIZE       128
+
+#define HIST_SUB_BITS             4
+#define HIST_SUB                  (1 << HIST_SUB_BITS)
+#define HIST_MAX_BITS             32
+#define HIST_BUCKETS              (HIST_SUB + (HIST_MAX_BITS - HIST_SUB_BITS) * HIST_SUB)
+
+/** имена метрик **/
+// интерфейсы
+#define M_IFC_BYTES_IN            "modus_interface_bytes_in_total"
+#define M_IFC_BYTES_OUT           "modus_interface_bytes_out_total"
+#define M_IFC_DROPS               "modus_interface_drops_total"
+// протоколы
+#define M_PRT_FRAMES              "modus_protocol_frames_total"
+#define M_PRT_CRC_ERRORS          "modus_protocol_crc_errors_total"
+#define M_PRT_RESETS              "modus_protocol_resets_total"
+#define M_PRT_PARSE_TIME          "modus_protocol_parse_seconds"
+// хранилища
+#define M_STG_QUEUE_DEPTH         "modus_storage_queue_depth"
+#define M_STG_WRITE_TIME          "modus_storage_write_seconds"
+#define M_STG_WRITE_ERRORS        "modus_storage_write_errors_total"
+// задержки от приема данных по этапам (sv_latency.h)
+#define L_PREFIX                  "modus_latency_"
+#define L_PARSE                   "modus_latency_parse_seconds"     // разбор пакета
+#define L_SIGNAL                  "modus_latency_signal_seconds"    // назначение значений сигналам
+#define L_PUBLISH                 "modus_latency_publish_seconds"   // отправка web клиентам
+#define L_ISE                     "modus_latency_ise_seconds"       // отправка межсерверного обмена
+#define L_STORAGE                 "modus_latency_storage_seconds"   // запись в хранилище
+
+namespace metrics {
+
+  enum Type {
+    mtCounter,
+    mtGauge,
+    mtHistogram
+  };
+
+  /** ряд метрики в разделяемой памяти **/
+  struct Entry {
+
+    std::atomic<quint32>  state;      // 0 - не заполнен, 1 - готов
+    quint32               type;
+    quint32               histogram;  // номер гистограммы
+    quint32               reserved;
+
+    char                  name[METRICS_NAME_SIZE];
+    char                  device[METRICS_DEVICE_SIZE];
+
+    std::atomic<qint64>   value;      // Counter, Gauge
+    std::atomic<quint64>  sum;        // Histogram, сумма значений, мкс
+
+  };
+
+  /** устройство в таблице трассировки задержек (sv_latency) **/
+  struct Device {
+
+    char                  name[METRICS_DEVICE_SIZE];
+    std::atomic<quint64>  received;   // время последнего приема данных интерфейсом, мкс
+
+  };
+
+  /** метка времени сигнала в таблице трассировки задержек **/
+  struct Slot {
+
+    std::atomic<qint32>   key;        // id сигнала + 1, 0 - свободно
+    std::atomic<qint32>   device;     // номер устройства, получившего значение
+    std::atomic<quint64>  stamp;      // время приема значения и отметки этапов, см. sv_latency.h
+
+  };
+
+  /** квантили гистограммы, мкс. верхние границы интервалов - оценка сверху **/
+  struct Quantiles {
+
+    QByteArray  name;
+    QByteArray  device;
+    quint64     count = 0;
+    quint64     p50   = 0;
+    quint64     p99   = 0;
+    quint64     p999  = 0;
+
+  };
+
+  // номер интервала гистограммы для значения. интервал i содержит значения
+  // (bound(i - 1), bound(i)], поэтому степени двойки - точные границы интервалов
+  inline int bucket(quint64 value)
+  {
+    quint64 v = value ? value - 1 : 0;
+
+    if(v < HIST_SUB)
+      return int(v);
+
+    if(v >= (quint64(1) << HIST_MAX_BITS))
+      return HIST_BUCKETS - 1;
+
+    int msb = 63 - __builtin_clzll(v);
+
+    return HIST_SUB + (msb - HIST_SUB_BITS) * HIST_SUB + int((v >> (msb - HIST_SUB_BITS)) - HIST_SUB);
+  }
+
+  // верхняя (включительно) граница интервала, мкс
+  inline quint64 bound(int bucket)
+  {
+    int i = bucket + 1;
+
+    if(i < HIST_SUB)
+      return quint64(i);
+
+    int msb  = HIST_SUB_BITS + (i - HIST_SUB) / HIST_SUB;
+    int mant = HIST_SUB + (i - HIST_SUB) % HIST_SUB;
+
+    return quint64(mant) << (msb - HIST_SUB_BITS);
+  }
+
+  class Counter
+  {
+  public:
+    Counter(Entry* entry = nullptr): m_entry(entry) { }
+
+    inline void inc(quint64 n = 1) { if(m_entry) m_entry->value.fetch_add(qint64(n), std::memory_order_relaxed); }
+
+    quint64 value() const { return m_entry ? quint64(m_entry->value.load(std::memory_order_relaxed)) : 0; }
+
+  private:
+    Entry* m_entry;
+
+  };
+
+  class Gauge
+  {
+  public:
+    Gauge(Entry* entry = nullptr): m_entry(entry) { }
+
+    inline void set(qint64 value) { if(m_entry) m_entry->value.store(value, std::memory_order_relaxed); }
+    inline void add(qint64 delta) { if(m_entry) m_entry->value.fetch_add(delta, std::memory_order_relaxed); }
+
+    qint64 value() const { return m_entry ? m_entry->value.load(std::memory_order_relaxed) : 0; }
+
+  private:
+    Entry* m_entry;
+
+  };
+
+  class Histogram
+  {
+  public:
+    Histogram(Entry* entry = nullptr, std::atomic<quint64>* buckets = nullptr):
+      m_entry(entry), m_buckets(buckets)
+    { }
+
+    // значение, мкс
+    inline void record(quint64 value)
+    {
+      if(!m_entry)
+        return;
+
+      m_buckets[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+      m_entry->sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+  private:
+    Entry*                m_entry;
+    std::atomic<quint64>* m_buckets;
+
+  };
+
+  /** метрики интерфейса **/
+  struct InterfaceMetrics {
+
+    Counter   bytes_in;
+    Counter   bytes_out;
+    Counter   drops;
+
+    void attach(const QString& device);
+
+  };
+
+  /** метрики протокола **/
+  struct ProtocolMetrics {
+
+    Counter   frames;
+    Counter   crc_errors;
+    Counter   resets;
+    Histogram parse_time;
+
+    void attach(const QString& device);
+
+  };
+
+  /** метрики хранилища **/
+  struct StorageMetrics {
+
+    Gauge     queue_depth;
+    Histogram write_time;
+    Counter   write_errors;
+
+    void attach(const QString& device);
+
+  };
+
+  class SvMetrics;
+
+}
+
+class metrics::SvMetrics
+{
+public:
+  // реестр процесса. сегмент открывается при первом обращении
+  static SvMetrics* instance();
+
+  bool isValid() const { return m_header != nullptr; }
+  QString lastError() const;
+
+  Counter   counter(const char* name, const QString& device);
+  Gauge     gauge(const char* name, const QString& device);
+  Histogram histogram(const char* name, const QString& device);
+
+  // все ряды в текстовом формате Prometheus (text/plain; version=0.0.4)
+  QByteArray exposition() const;
+
+  // квантили гистограмм, имя которых начинается с prefix
+  QList<Quantiles> quantiles(const char* prefix) const;
+
+  // таблица трассировки задержек. номер устройства (-1 - нет места) и его имя
+  int device(const QString& name);
+  QByteArray deviceName(int device) const;
+  std::atomic<quint64>* received(int device);
+
+  // метка времени сигнала. если create = false и сигнала нет в таблице - nullptr
+  Slot* slot(int signal_id, bool create);
+
+private:
+  SvMetrics();
+
+  struct Header {
+
+    quint32               magic;
+    quint32               version;
+    quint32               entries;
+    quint32               histograms;
+
+    std::atomic<qint32>   pid;        // процесс, создавший ряды
+    std::atomic<qint32>   lock;       // pid процесса, выполняющего регистрацию, 0 - свободно
+    std::atomic<quint32>  count;      // занято рядов
+    std::atomic<quint32>  hcount;     // занято гистограмм
+    std::atomic<quint32>  dcount;     // занято устройств
+    quint32               reserved;   // выравнивание следующих областей на 8 байт
+
+  };
+
+  Header*               m_header  = nullptr;
+  Entry*                m_entries = nullptr;
+  std::atomic<quint64>* m_buckets = nullptr;
+  Device*               m_devices = nullptr;
+  Slot*                 m_slots   = nullptr;
+
+  // ряды регистрируются из потоков разных модулей
+  mutable QMutex        m_error_mutex;
+  QString               m_last_error = "";
+
+  bool open(const QString& name);
+  void setError(const QString& error);
+
+  void lock();
+  void unlock();
+
+  Entry* entry(Type type, const char* name, const QString& device);
+
+};
+
+#endif // SV_METRICS_H
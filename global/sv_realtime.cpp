@@ -0,0 +1,286 @@
+#include "sv_realtime.h"
+
+#include <QFile>
+#include <QMutex>
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#define CAP_IPC_LOCK_BIT  14
+#define CAP_SYS_NICE_BIT  23
+
+namespace {
+
+  // действующие права процесса (CapEff из /proc/self/status)
+  bool hasCapability(int bit)
+  {
+    QFile f("/proc/self/status");
+
+    if(!f.open(QIODevice::ReadOnly))
+      return geteuid() == 0;
+
+    for(QByteArray line: f.readAll().split('\n')) {
+
+      if(!line.startsWith("CapEff:"))
+        continue;
+
+      bool ok;
+      quint64 caps = line.mid(7).trimmed().toULongLong(&ok, 16);
+
+      return ok && (caps & (quint64(1) << bit));
+
+    }
+
+    return geteuid() == 0;
+
+  }
+
+  int schedPolicy(rt::Policy policy)
+  {
+    switch (policy) {
+      case rt::rpFifo: return SCHED_FIFO;
+      case rt::rpRr:   return SCHED_RR;
+      default:         return SCHED_OTHER;
+    }
+  }
+
+  QMutex  mlock_mutex;
+  bool    mlock_done = false;
+
+}
+
+rt::Params rt::Params::fromJsonString(const QString& json_string)
+{
+  // параметры компонента не заданы - потоки не настраиваются
+  if(json_string.trimmed().isEmpty())
+    return Params();
+
+  QJsonParseError err;
+  QJsonDocument jd = QJsonDocument::fromJson(json_string.toUtf8(), &err);
+
+  if(err.error != QJsonParseError::NoError)
+    throw SvException(err.errorString());
+
+  try {
+
+    if(!jd.object().contains(P_REALTIME))
+      return Params();
+
+    if(!jd.object().value(P_REALTIME).isObject())
+      throw SvException(QString(IMPERMISSIBLE_VALUE)
+                        .arg(P_REALTIME)
+                        .arg(jd.object().value(P_REALTIME).toVariant().toString())
+                        .arg("Параметры реального времени должны быть заданы объектом"));
+
+    return fromJsonObject(jd.object().value(P_REALTIME).toObject());
+
+  }
+  catch(SvException& e) {
+    throw e;
+  }
+}
+
+rt::Params rt::Params::fromJsonObject(const QJsonObject &object)
+{
+  Params p;
+  QString P;
+
+  P = P_REALTIME_CPUS;
+  if(object.contains(P)) {
+
+    int configured = int(sysconf(_SC_NPROCESSORS_CONF));
+
+    QStringList items;
+
+    if(object.value(P).isArray()) {
+
+      for(QJsonValue v: object.value(P).toArray())
+        items << QString::number(v.toInt(-1));
+
+    }
+    else
+      items = object.value(P).toString().split(',', QString::SkipEmptyParts);
+
+    for(QString item: items) {
+
+      QStringList range = item.trimmed().split('-');
+
+      bool ok1 = false, ok2 = false;
+      int first = range.first().toInt(&ok1);
+      int last  = range.count() == 2 ? range.last().toInt(&ok2) : (ok2 = true, first);
+
+      if(!ok1 || !ok2 || range.count() > 2 || first < 0 || last < first || last >= configured || last >= CPU_SETSIZE)
+        throw SvException(QString(IMPERMISSIBLE_VALUE)
+                          .arg(P)
+                          .arg(object.value(P).toVariant().toString())
+                          .arg(QString("Номера ядер задаются списком или диапазоном от 0 до %1: \"2,3\", \"2-3\", [2, 3]").arg(configured - 1)));
+
+      for(int cpu = first; cpu <= last; cpu++)
+        if(!p.cpus.contains(cpu))
+          p.cpus.append(cpu);
+
+    }
+  }
+
+  P = P_REALTIME_POLICY;
+  if(object.contains(P)) {
+
+    QString policy = object.value(P).toString().toLower();
+
+    if(!Policies.contains(policy))
+      throw SvException(QString(IMPERMISSIBLE_VALUE)
+                        .arg(P)
+                        .arg(object.value(P).toVariant().toString())
+                        .arg("Допустимые значения: other, fifo, rr"));
+
+    p.policy = Policies.value(policy);
+
+  }
+
+  P = P_REALTIME_PRIORITY;
+  if(object.contains(P)) {
+
+    int min = sched_get_priority_min(schedPolicy(p.policy));
+    int max = sched_get_priority_max(schedPolicy(p.policy));
+
+    p.priority = object.value(P).toInt(-1);
+
+    if(p.priority < min || p.priority > max)
+      throw SvException(QString(IMPERMISSIBLE_VALUE)
+                        .arg(P)
+                        .arg(object.value(P).toVariant().toString())
+                        .arg(QString("Для политики %1 приоритет задается от %2 до %3")
+                             .arg(Policies.key(p.policy)).arg(min).arg(max)));
+
+  }
+  else if(p.policy != rpOther)
+    p.priority = sched_get_priority_min(schedPolicy(p.policy));
+
+  // права процесса проверяются сразу, а не при запуске потока
+  if(p.policy != rpOther && !hasCapability(CAP_SYS_NICE_BIT)) {
+
+    struct rlimit rl;
+    getrlimit(RLIMIT_RTPRIO, &rl);
+
+    if(rl.rlim_cur != RLIM_INFINITY && rlim_t(p.priority) > rl.rlim_cur)
+      throw SvException(QString(IMPERMISSIBLE_VALUE)
+                        .arg(P_REALTIME_POLICY)
+                        .arg(Policies.key(p.policy))
+                        .arg(QString("Нет прав на политику реального времени: требуется CAP_SYS_NICE или RLIMIT_RTPRIO >= %1 (сейчас %2)")
+                             .arg(p.priority).arg(rl.rlim_cur)));
+
+  }
+
+  P = P_REALTIME_MLOCKALL;
+  if(object.contains(P)) {
+
+    p.mlockall = object.value(P).toBool(false);
+
+    struct rlimit rl;
+    getrlimit(RLIMIT_MEMLOCK, &rl);
+
+    if(p.mlockall && !hasCapability(CAP_IPC_LOCK_BIT) && rl.rlim_cur != RLIM_INFINITY)
+      throw SvException(QString(IMPERMISSIBLE_VALUE)
+                        .arg(P)
+                        .arg("true")
+                        .arg("Нет прав на блокировку памяти: требуется CAP_IPC_LOCK или неограниченный RLIMIT_MEMLOCK"));
+
+  }
+
+  return p;
+
+}
+
+QJsonObject rt::Params::toJsonObject() const
+{
+  QJsonObject j;
+  QJsonArray  c;
+
+  for(int cpu: cpus)
+    c.append(cpu);
+
+  j.insert(P_REALTIME_CPUS,     c);
+  j.insert(P_REALTIME_POLICY,   QJsonValue(Policies.key(policy)));
+  j.insert(P_REALTIME_PRIORITY, QJsonValue(priority));
+  j.insert(P_REALTIME_MLOCKALL, QJsonValue(mlockall));
+
+  return j;
+
+}
+
+QString rt::Params::toString() const
+{
+  QStringList c;
+
+  for(int cpu: cpus)
+    c << QString::number(cpu);
+
+  return QString("ядра: %1, политика: %2, приоритет: %3%4")
+            .arg(cpus.isEmpty() ? QString("все") : c.join(','))
+            .arg(Policies.key(policy))
+            .arg(priority)
+            .arg(mlockall ? ", mlockall" : "");
+}
+
+bool rt::apply(const Params& params, QString* error)
+{
+  if(!params.cpus.isEmpty()) {
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    for(int cpu: params.cpus)
+      CPU_SET(cpu, &set);
+
+    int r = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+
+    if(r != 0) {
+
+      if(error) *error = QString("Ошибка привязки потока к ядрам: %1").arg(strerror(r));
+      return false;
+
+    }
+  }
+
+  if(params.policy != rpOther) {
+
+    sched_param sp;
+    memset(&sp, 0, sizeof(sp));
+    sp.sched_priority = params.priority;
+
+    int r = pthread_setschedparam(pthread_self(), schedPolicy(params.policy), &sp);
+
+    if(r != 0) {
+
+      if(error) *error = QString("Ошибка установки политики %1, приоритет %2: %3")
+                            .arg(Policies.key(params.policy)).arg(params.priority).arg(strerror(r));
+      return false;
+
+    }
+  }
+
+  if(params.mlockall) {
+
+    QMutexLocker locker(&mlock_mutex);
+
+    if(!mlock_done) {
+
+      if(::mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+
+        if(error) *error = QString("Ошибка блокировки памяти процесса: %1").arg(strerror(errno));
+        return false;
+
+      }
+
+      mlock_done = true;
+
+    }
+  }
+
+  return true;
+
+}
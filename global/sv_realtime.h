@@ -0,0 +1,76 @@
+/**********************************************************************
+ *  параметры реального времени для потоков устройств, интерфейсов,
+ *  хранилищ и провайдеров.
+ *
+ *  задаются в параметрах компонента, в объекте "realtime":
+ *    "realtime": { "cpus": "2,3" | "2-3" | [2, 3],
+ *                  "policy": "other" | "fifo" | "rr",
+ *                  "priority": 1..99,
+ *                  "mlockall": true }
+ *
+ *  параметры проверяются при конфигурировании (номера ядер, диапазон
+ *  приоритета, права процесса на SCHED_FIFO/SCHED_RR и mlockall).
+ *  применяются к вызывающему потоку функцией apply в начале работы
+ *  компонента, в его собственном потоке. ошибка применения выводится
+ *  в лог, компонент продолжает работу без этих параметров. mlockall
+ *  действует на весь процесс и выполняется один раз.
+ * *********************************************************************/
+
+#ifndef SV_REALTIME_H
+#define SV_REALTIME_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "../../Modus/global/global_defs.h"
+
+#define P_REALTIME            "realtime"
+#define P_REALTIME_CPUS       "cpus"
+#define P_REALTIME_POLICY     "policy"
+#define P_REALTIME_PRIORITY   "priority"
+#define P_REALTIME_MLOCKALL   "mlockall"
+
+namespace rt {
+
+  enum Policy {
+    rpOther,    // SCHED_OTHER, обычное разделение времени
+    rpFifo,     // SCHED_FIFO
+    rpRr        // SCHED_RR
+  };
+
+  const QMap<QString, Policy> Policies = {{"other", rpOther},
+                                          {"fifo",  rpFifo},
+                                          {"rr",    rpRr}};
+
+  struct Params {
+
+    QList<int>  cpus;               // пустой список - привязка к ядрам не меняется
+    Policy      policy   = rpOther;
+    int         priority = 0;
+    bool        mlockall = false;
+
+    bool isEmpty() const { return cpus.isEmpty() && policy == rpOther && !mlockall; }
+
+    // параметры компонента целиком. используется только объект "realtime"
+    static Params fromJsonString(const QString& json_string); //throw (SvException)
+
+    static Params fromJsonObject(const QJsonObject &object); //throw (SvException)
+
+    QJsonObject toJsonObject() const;
+
+    QString toString() const;
+
+  };
+
+  // применение параметров к вызывающему потоку. при ошибке false и текст в error
+  bool apply(const Params& params, QString* error = nullptr);
+
+}
+
+#endif // SV_REALTIME_H
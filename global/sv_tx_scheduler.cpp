@@ -0,0 +1,62 @@
+#include "sv_tx_scheduler.h"
+
+#include <time.h>
+
+namespace {
+
+  // монотонное время, мкс
+  qint64 now()
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return qint64(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+  }
+}
+
+tx::SvTxScheduler::SvTxScheduler(int gap, int limit):
+  m_gap(qint64(gap) * 1000),
+  m_limit(limit)
+{
+
+}
+
+bool tx::SvTxScheduler::enqueue(const QByteArray& data)
+{
+  if(m_queue.count() >= m_limit) {
+
+    m_dropped++;
+    return false;
+
+  }
+
+  m_last_due = qMax(now(), m_last_due) + m_gap;
+
+  m_queue.enqueue(Item{m_last_due, data});
+
+  return true;
+
+}
+
+bool tx::SvTxScheduler::next(QByteArray& data)
+{
+  if(m_queue.isEmpty() || m_queue.head().due > now())
+    return false;
+
+  data = m_queue.dequeue().data;
+
+  return true;
+
+}
+
+int tx::SvTxScheduler::wait(int limit) const
+{
+  if(m_queue.isEmpty())
+    return limit;
+
+  // округление вверх: проснуться раньше момента отправки бесполезно
+  qint64 us = m_queue.head().due - now();
+
+  return us <= 0 ? 0 : int(qMin(qint64(limit), (us + 999) / 1000));
+
+}
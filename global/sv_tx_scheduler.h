@@ -0,0 +1,71 @@
+/**********************************************************************
+ *  очередь отправки устройства с минимальным интервалом между пакетами.
+ *
+ *  некоторые устройства (шкафы) не успевают обработать ответ, пришедший
+ *  сразу после их посылки. раньше поток приема засыпал перед каждой
+ *  отправкой подтверждения, и на это время прием останавливался.
+ *
+ *  теперь пакет ставится в очередь с моментом отправки не раньше, чем
+ *  через gap мс после постановки и через gap мс после предыдущего
+ *  пакета. поток приема ждет данные не дольше, чем до ближайшего
+ *  момента отправки (wait), и отправляет пакеты, время которых
+ *  наступило (next). прием между отправками не прерывается.
+ *
+ *  задается в параметрах устройства: "tx_gap": мс, 0 - без задержки.
+ *  очередь используется в одном потоке - потоке устройства.
+ * *********************************************************************/
+
+#ifndef SV_TX_SCHEDULER_H
+#define SV_TX_SCHEDULER_H
+
+#include <QByteArray>
+#include <QQueue>
+
+#define P_TX_GAP          "tx_gap"
+
+#define DEFAULT_TX_GAP    10    // мс
+#define DEFAULT_TX_QUEUE  64    // пакетов. при переполнении новые пакеты отбрасываются
+
+namespace tx {
+
+  class SvTxScheduler
+  {
+  public:
+    explicit SvTxScheduler(int gap = DEFAULT_TX_GAP, int limit = DEFAULT_TX_QUEUE);
+
+    void setGap(int gap) { m_gap = qint64(gap) * 1000; }
+
+    // false - очередь переполнена, пакет отброшен
+    bool enqueue(const QByteArray& data);
+
+    // следующий пакет, время отправки которого наступило
+    bool next(QByteArray& data);
+
+    // время ожидания данных, мс: до ближайшего момента отправки, но не больше limit
+    int wait(int limit) const;
+
+    bool isEmpty() const { return m_queue.isEmpty(); }
+
+    quint64 dropped() const { return m_dropped; }
+
+    void clear() { m_queue.clear(); }
+
+  private:
+    struct Item {
+
+      qint64      due;    // момент отправки, мкс
+      QByteArray  data;
+
+    };
+
+    QQueue<Item>  m_queue;
+
+    qint64        m_gap;
+    int           m_limit;
+    qint64        m_last_due = 0;
+    quint64       m_dropped  = 0;
+
+  };
+}
+
+#endif // SV_TX_SCHEDULER_H
@@ -0,0 +1,127 @@
+#include "sv_http_worker_pool.h"
+
+#include <unistd.h>
+
+/** ********** SvConnectionHandler ************ **/
+
+httpsrv::SvConnectionHandler::SvConnectionHandler():
+  QObject()
+{
+
+}
+
+void httpsrv::SvConnectionHandler::addConnection(qintptr descriptor)
+{
+  QTcpSocket* socket = new QTcpSocket(this);
+
+  if(!socket->setSocketDescriptor(descriptor)) {
+
+    emit message(QString("Ошибка при подключении клиента: %1").arg(socket->errorString()), sv::log::llError, sv::log::mtError);
+
+    delete socket;
+    ::close(int(descriptor));
+
+    return;
+
+  }
+
+  p_connections.insert(socket);
+
+  connect(socket, &QTcpSocket::disconnected, this, &httpsrv::SvConnectionHandler::socketDisconnected);
+
+  newConnection(socket);
+
+}
+
+void httpsrv::SvConnectionHandler::socketDisconnected()
+{
+  QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+
+  if(!socket || !p_connections.remove(socket))
+    return;
+
+  connectionClosed(socket);
+
+  socket->deleteLater();
+
+}
+
+void httpsrv::SvConnectionHandler::shutdown()
+{
+  foreach (QTcpSocket* socket, p_connections) {
+
+    disconnect(socket, &QTcpSocket::disconnected, this, &httpsrv::SvConnectionHandler::socketDisconnected);
+
+    connectionClosed(socket);
+
+    socket->close();
+    delete socket;
+
+  }
+
+  p_connections.clear();
+
+}
+
+/** ********** SvWorkerPool ************ **/
+
+httpsrv::SvWorkerPool::SvWorkerPool(QObject* parent):
+  QTcpServer(parent)
+{
+  qRegisterMetaType<qintptr>("qintptr");
+}
+
+httpsrv::SvWorkerPool::~SvWorkerPool()
+{
+  stopHandlers();
+}
+
+void httpsrv::SvWorkerPool::addHandler(SvConnectionHandler* handler)
+{
+  QThread* thread = new QThread();
+  thread->setObjectName(QString("http worker %1").arg(m_threads.count()));
+
+  handler->moveToThread(thread);
+  thread->start();
+
+  m_handlers.append(handler);
+  m_threads.append(thread);
+
+}
+
+void httpsrv::SvWorkerPool::stopHandlers()
+{
+  close();
+
+  for(int i = 0; i < m_handlers.count(); ++i) {
+
+    QMetaObject::invokeMethod(m_handlers.at(i), "shutdown", Qt::BlockingQueuedConnection);
+
+    m_threads.at(i)->quit();
+    m_threads.at(i)->wait();
+
+    delete m_handlers.at(i);
+    delete m_threads.at(i);
+
+  }
+
+  m_handlers.clear();
+  m_threads.clear();
+
+}
+
+void httpsrv::SvWorkerPool::incomingConnection(qintptr descriptor)
+{
+  if(m_handlers.isEmpty()) {
+
+    ::close(int(descriptor));
+    return;
+
+  }
+
+  SvConnectionHandler* handler = m_handlers.at(m_next);
+  m_next = (m_next + 1) % m_handlers.count();
+
+  QMetaObject::invokeMethod(handler, "addConnection", Qt::QueuedConnection, Q_ARG(qintptr, descriptor));
+
+}
@@ -0,0 +1,99 @@
+/**********************************************************************
+ *  пул рабочих потоков для http серверов (restapi, web_server, log_server)
+ *
+ *  прием соединений выполняется в потоке сервера (SvWorkerPool),
+ *  принятый дескриптор передается одному из обработчиков по очереди.
+ *  каждый обработчик живет в собственном потоке со своим циклом событий,
+ *  поэтому медленный клиент или большой файл не блокируют других клиентов
+ *  и поток провайдера.
+ * *********************************************************************/
+
+#ifndef SV_HTTP_WORKER_POOL_H
+#define SV_HTTP_WORKER_POOL_H
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QSet>
+#include <QList>
+
+#include "../../../Modus/global/global_defs.h"
+
+#define P_WORKERS "workers"
+
+namespace httpsrv {
+
+  class SvConnectionHandler;
+  class SvWorkerPool;
+
+  /** кол-во рабочих потоков по умолчанию - по числу ядер **/
+  inline int defaultWorkersCount()
+  {
+    return qMax(1, QThread::idealThreadCount());
+  }
+
+}
+
+/** обработчик соединений. один экземпляр на каждый рабочий поток **/
+class httpsrv::SvConnectionHandler: public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit SvConnectionHandler();
+  virtual ~SvConnectionHandler() { }
+
+public slots:
+  // принимает соединение, переданное пулом. выполняется в потоке обработчика
+  void addConnection(qintptr descriptor);
+
+  // закрытие всех соединений перед остановкой потока
+  virtual void shutdown();
+
+protected:
+  QSet<QTcpSocket*> p_connections;
+
+  // новое соединение. наследник подключает свои обработчики readyRead
+  virtual void newConnection(QTcpSocket* socket) = 0;
+
+  // соединение закрыто, сокет будет удален после выхода из функции
+  virtual void connectionClosed(QTcpSocket* socket) { Q_UNUSED(socket); }
+
+signals:
+  // сообщения для журнала передаются в поток сервера. уровень и тип - sv::log::Level и sv::log::MessageTypes
+  void message(const QString& text, int level, int type);
+
+private slots:
+  void socketDisconnected();
+
+};
+
+/** прием соединений и распределение их по рабочим потокам **/
+class httpsrv::SvWorkerPool: public QTcpServer
+{
+  Q_OBJECT
+
+public:
+  explicit SvWorkerPool(QObject* parent = nullptr);
+  ~SvWorkerPool() override;
+
+  // обработчик переносится в собственный поток, владение переходит к пулу
+  void addHandler(SvConnectionHandler* handler);
+
+  // закрывает соединения, останавливает потоки и удаляет обработчики
+  void stopHandlers();
+
+  const QList<SvConnectionHandler*>& handlers() const { return m_handlers; }
+
+protected:
+  void incomingConnection(qintptr descriptor) override;
+
+private:
+  QList<SvConnectionHandler*> m_handlers;
+  QList<QThread*>             m_threads;
+
+  int m_next = 0;
+
+};
+
+#endif // SV_HTTP_WORKER_POOL_H
@@ -0,0 +1,311 @@
+#include "sv_shm_log.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// после стольких попыток незаполненный слот пропускается (писатель завершился аварийно)
+#define SHM_MAX_STALLS  100
+
+namespace {
+
+  // первые size байт строки UTF-8 без разрыва многобайтового символа
+  QByteArray utf8Left(const QByteArray& text, int size)
+  {
+    if(text.size() <= size)
+      return text;
+
+    while(size > 0 && (quint8(text.at(size)) & 0xC0) == 0x80)
+      --size;
+
+    return text.left(size);
+
+  }
+}
+
+shmlog::SvShmLog::SvShmLog(int fd, void* memory, size_t size):
+  m_fd(fd),
+  m_memory(memory),
+  m_size(size),
+  m_header(reinterpret_cast<Header*>(memory)),
+  m_slots(reinterpret_cast<char*>(memory) + sizeof(Header))
+{
+
+}
+
+shmlog::SvShmLog::~SvShmLog()
+{
+  munmap(m_memory, m_size);
+  ::close(m_fd);
+}
+
+shmlog::SvShmLog* shmlog::SvShmLog::open(const QString& name, quint32 slots, QString* error)
+{
+  QByteArray n = name.toLocal8Bit();
+
+  bool created = true;
+  // журнал доступен процессам того же пользователя и группы
+  int fd = shm_open(n.constData(), O_RDWR | O_CREAT | O_EXCL, SHM_LOG_MODE);
+
+  if(fd < 0 && errno == EEXIST) {
+
+    created = false;
+    fd = shm_open(n.constData(), O_RDWR, SHM_LOG_MODE);
+
+  }
+
+  if(fd < 0) {
+
+    if(error) *error = QString("Ошибка открытия разделяемой памяти %1: %2").arg(name).arg(strerror(errno));
+    return nullptr;
+
+  }
+
+  size_t size;
+
+  if(created) {
+
+    size = sizeof(Header) + size_t(slots) * SHM_SLOT_SIZE;
+
+    if(ftruncate(fd, off_t(size)) < 0) {
+
+      if(error) *error = QString("Ошибка выделения разделяемой памяти %1: %2").arg(name).arg(strerror(errno));
+
+      ::close(fd);
+      shm_unlink(n.constData());
+
+      return nullptr;
+
+    }
+  }
+  else {
+
+    // сегмент создан другим процессом. размер определяется по нему
+    struct stat st;
+
+    for(int i = 0; i < 100; ++i) {
+
+      if(fstat(fd, &st) == 0 && size_t(st.st_size) > sizeof(Header))
+        break;
+
+      usleep(1000);
+
+    }
+
+    size = size_t(st.st_size);
+
+    if(size <= sizeof(Header)) {
+
+      if(error) *error = QString("Сегмент разделяемой памяти %1 не инициализирован").arg(name);
+
+      ::close(fd);
+      return nullptr;
+
+    }
+  }
+
+  void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+  if(memory == MAP_FAILED) {
+
+    if(error) *error = QString("Ошибка отображения разделяемой памяти %1: %2").arg(name).arg(strerror(errno));
+
+    ::close(fd);
+    return nullptr;
+
+  }
+
+  Header* header = reinterpret_cast<Header*>(memory);
+
+  if(created) {
+
+    header->version   = SHM_LOG_VERSION;
+    header->slots     = slots;
+    header->slot_size = SHM_SLOT_SIZE;
+    header->head.store(0);
+
+    // magic записывается последним, после этого сегмент считается готовым
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = SHM_LOG_MAGIC;
+
+  }
+  else {
+
+    for(int i = 0; i < 100 && header->magic != SHM_LOG_MAGIC; ++i)
+      usleep(1000);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if(header->magic != SHM_LOG_MAGIC || header->version != SHM_LOG_VERSION ||
+       sizeof(Header) + size_t(header->slots) * header->slot_size > size) {
+
+      if(error) *error = QString("Неверный формат сегмента разделяемой памяти %1").arg(name);
+
+      munmap(memory, size);
+      ::close(fd);
+
+      return nullptr;
+
+    }
+  }
+
+  return new SvShmLog(fd, memory, size);
+
+}
+
+void shmlog::SvShmLog::write(const QString& entity, int id, int level, const QString& type, const QString& message,
+                             qint64 time, const QString& time_text)
+{
+  size_t free = m_header->slot_size - sizeof(SlotHeader);
+
+  QByteArray e  = utf8Left(entity.toUtf8(), 64);
+  QByteArray t  = utf8Left(type.toUtf8(), 64);
+  QByteArray tt = utf8Left(time_text.toUtf8(), 64);
+
+  // запись не должна занимать больше четверти буфера, иначе перезапишет себя же у медленного читателя
+  size_t max_parts = qBound(size_t(1), size_t(m_header->slots) / 4, size_t(SHM_MAX_PARTS));
+  size_t fixed     = size_t(e.size() + t.size() + tt.size());
+
+  QByteArray m = utf8Left(message.toUtf8(), int(qMin(size_t(SHM_MAX_MESSAGE), max_parts * free - fixed)));
+
+  QByteArray data = e + t + tt + m;
+  size_t     parts = qMax(size_t(1), (size_t(data.size()) + free - 1) / free);
+
+  quint64 seq = m_header->head.fetch_add(parts, std::memory_order_acq_rel);
+
+  // слоты заняты записью, читатели их пропускают
+  for(size_t i = 0; i < parts; ++i)
+    slot(seq + i)->seq.store(0, std::memory_order_relaxed);
+
+  std::atomic_thread_fence(std::memory_order_release);
+
+  for(size_t i = 0; i < parts; ++i) {
+
+    slot(seq + i)->parts = 0;
+
+    size_t offset = i * free;
+    memcpy(payload(seq + i), data.constData() + offset, qMin(free, size_t(data.size()) - offset));
+
+  }
+
+  SlotHeader* s = slot(seq);
+
+  s->time         = time;
+  s->id           = id;
+  s->level        = quint8(level);
+  s->entity_size  = quint8(e.size());
+  s->type_size    = quint8(t.size());
+  s->time_size    = quint8(tt.size());
+  s->parts        = quint8(parts);
+  s->message_size = quint16(m.size());
+
+  // продолжения публикуются раньше первого слота: читатель берет запись по первому
+  for(size_t i = parts - 1; i > 0; --i)
+    slot(seq + i)->seq.store(seq + i + 1, std::memory_order_release);
+
+  s->seq.store(seq + 1, std::memory_order_release);
+
+}
+
+quint64 shmlog::SvShmLog::head() const
+{
+  return m_header->head.load(std::memory_order_acquire);
+}
+
+bool shmlog::SvShmLog::read(quint64& cursor, Record& record, quint64& dropped)
+{
+  dropped = 0;
+
+  quint64 head  = m_header->head.load(std::memory_order_acquire);
+  quint64 slots = m_header->slots;
+
+  // читатель отстал больше, чем на размер буфера
+  if(head > slots && cursor < head - slots) {
+
+    dropped = head - slots - cursor;
+    cursor  = head - slots;
+
+  }
+
+  while(cursor < head) {
+
+    SlotHeader* s = slot(cursor);
+
+    if(s->seq.load(std::memory_order_acquire) != cursor + 1) {
+
+      // запись еще не завершена
+      if(++m_stalls < SHM_MAX_STALLS)
+        return false;
+
+      m_stalls = 0;
+      ++cursor;
+      ++dropped;
+
+      continue;
+
+    }
+
+    m_stalls = 0;
+
+    size_t parts = s->parts;
+
+    // продолжение записи, начало которой уже перезаписано
+    if(parts == 0) {
+
+      ++cursor;
+      continue;
+
+    }
+
+    // продолжения опубликованы раньше первого слота, поэтому уже заполнены
+    size_t     free = m_header->slot_size - sizeof(SlotHeader);
+    QByteArray data;
+    data.reserve(int(parts * free));
+
+    for(size_t i = 0; i < parts; ++i)
+      data.append(payload(cursor + i), int(free));
+
+    qint64 time = s->time;
+    int    id   = s->id;
+    int    lvl  = s->level;
+    int    es   = s->entity_size;
+    int    ts   = s->type_size;
+    int    tts  = s->time_size;
+    int    ms   = s->message_size;
+
+    // слоты могли быть перезаписаны во время чтения
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    bool intact = true;
+
+    for(size_t i = 0; i < parts && intact; ++i)
+      intact = slot(cursor + i)->seq.load(std::memory_order_relaxed) == cursor + i + 1;
+
+    record.seq = cursor;
+    cursor += parts;
+
+    if(!intact || es + ts + tts + ms > data.size()) {
+
+      ++dropped;
+      continue;
+
+    }
+
+    record.time      = time;
+    record.id        = id;
+    record.level     = lvl;
+    record.entity    = QString::fromUtf8(data.constData(), es);
+    record.type      = QString::fromUtf8(data.constData() + es, ts);
+    record.time_text = QString::fromUtf8(data.constData() + es + ts, tts);
+    record.message   = QString::fromUtf8(data.constData() + es + ts + tts, ms);
+
+    return true;
+
+  }
+
+  return false;
+
+}
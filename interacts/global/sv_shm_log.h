@@ -0,0 +1,128 @@
+/**********************************************************************
+ *  журнал в разделяемой памяти.
+ *
+ *  кольцевой буфер записей фиксированного размера в сегменте POSIX shm.
+ *  писать могут несколько процессов и потоков одновременно: позиция
+ *  резервируется атомарным увеличением head, после заполнения слота
+ *  в нем публикуется номер записи. читатели (сервер журнала, logview)
+ *  не блокируют писателей, каждый хранит свой курсор. запись хранится
+ *  в двоичном виде, текст формируется только у читателя.
+ *
+ *  формат записи: SlotHeader, затем entity, type, время отправителя
+ *  (строкой, если задано) и message в UTF-8. длинная запись занимает
+ *  несколько соседних слотов (не больше SHM_MAX_PARTS): данные
+ *  продолжаются после SlotHeader следующих слотов, в их заголовке
+ *  parts = 0. обрезаются только сообщения длиннее SHM_MAX_MESSAGE
+ *  байт или не помещающиеся в четверть буфера.
+ * *********************************************************************/
+
+#ifndef SV_SHM_LOG_H
+#define SV_SHM_LOG_H
+
+#include <QString>
+#include <QByteArray>
+#include <QDateTime>
+
+#include <atomic>
+
+#define P_SHM_NAME        "shm_name"
+#define P_SHM_SLOTS       "shm_slots"
+
+#define DEFAULT_SHM_NAME  "/modus_log"
+#define DEFAULT_SHM_SLOTS 65536
+#define SHM_SLOT_SIZE     512
+#define SHM_LOG_MODE      0660
+
+#define SHM_LOG_MAGIC     0x4D4C4F47  // MLOG
+#define SHM_LOG_VERSION   2
+
+#define SHM_MAX_PARTS     255         // слотов в одной записи
+#define SHM_MAX_MESSAGE   65535       // байт сообщения
+
+namespace shmlog {
+
+  /** запись, прочитанная из буфера **/
+  struct Record {
+
+    quint64   seq = 0;
+    qint64    time = 0;   // мс от начала эпохи
+    int       id = 0;
+    int       level = 0;
+    QString   entity;
+    QString   type;
+    QString   time_text;  // время отправителя строкой (мост D-Bus). пустое - время задано time
+    QString   message;
+
+  };
+
+  class SvShmLog;
+
+}
+
+class shmlog::SvShmLog
+{
+public:
+  // подключение к сегменту. если сегмент не существует, он создается с заданным кол-вом слотов
+  static SvShmLog* open(const QString& name = DEFAULT_SHM_NAME, quint32 slots = DEFAULT_SHM_SLOTS, QString* error = nullptr);
+
+  ~SvShmLog();
+
+  // добавление записи. может вызываться из любого потока и процесса
+  void write(const QString& entity, int id, int level, const QString& type, const QString& message,
+             qint64 time = QDateTime::currentMSecsSinceEpoch(), const QString& time_text = QString());
+
+  // позиция, с которой читатель будет получать только новые записи
+  quint64 head() const;
+
+  // чтение очередной записи. возвращает false, если новых записей нет.
+  // dropped - кол-во записей, перезаписанных до того, как читатель успел их прочитать
+  bool read(quint64& cursor, Record& record, quint64& dropped);
+
+private:
+  struct Header {
+
+    quint32               magic;
+    quint32               version;
+    quint32               slots;
+    quint32               slot_size;
+    std::atomic<quint64>  head;       // номер следующей резервируемой записи
+
+  };
+
+  struct SlotHeader {
+
+    std::atomic<quint64>  seq;        // номер записи + 1, после того как слот заполнен
+    qint64                time;
+    qint32                id;
+    quint8                level;
+    quint8                entity_size;
+    quint8                type_size;
+    quint8                time_size;
+    quint8                parts;      // кол-во слотов записи. 0 - продолжение предыдущего слота
+    quint8                reserved;
+    quint16               message_size;
+
+  };
+
+  SvShmLog(int fd, void* memory, size_t size);
+
+  int       m_fd;
+  void*     m_memory;
+  size_t    m_size;
+
+  Header*   m_header;
+  char*     m_slots;
+
+  // кол-во неудачных попыток чтения незаполненного слота
+  int       m_stalls = 0;
+
+  SlotHeader* slot(quint64 seq) const
+  {
+    return reinterpret_cast<SlotHeader*>(m_slots + (seq % m_header->slots) * m_header->slot_size);
+  }
+
+  char* payload(quint64 seq) const { return reinterpret_cast<char*>(slot(seq)) + sizeof(SlotHeader); }
+
+};
+
+#endif // SV_SHM_LOG_H
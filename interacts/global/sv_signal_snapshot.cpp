@@ -0,0 +1,59 @@
+#include "sv_signal_snapshot.h"
+
+#include <QDateTime>
+
+httpsrv::SvSignalSnapshot::SvSignalSnapshot(FragmentSerializer serializer):
+  m_serializer(serializer)
+{
+  qRegisterMetaType<httpsrv::SignalSnapshot>("httpsrv::SignalSnapshot");
+}
+
+httpsrv::SignalSnapshot httpsrv::SvSignalSnapshot::current() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_current;
+}
+
+httpsrv::SignalSnapshot httpsrv::SvSignalSnapshot::update(const QMap<int, modus::SvSignal*>& signal_map)
+{
+  SignalSnapshot previous = current();
+
+  SignalSnapshotData* data = new SignalSnapshotData;
+  data->time = QDateTime::currentMSecsSinceEpoch();
+  data->values.reserve(signal_map.count());
+
+  // сериализованные значения неизменившихся сигналов переходят из предыдущего снимка
+  if(previous)
+    data->fragments = previous->fragments;
+
+  for(QMap<int, modus::SvSignal*>::const_iterator it = signal_map.constBegin(); it != signal_map.constEnd(); ++it) {
+
+    QVariant value = it.value()->value();
+
+    data->values.insert(it.key(), value);
+
+    if(!previous || !previous->values.contains(it.key()) || previous->values.value(it.key()) != value) {
+
+      data->changed.append(it.key());
+
+      if(m_serializer)
+        data->fragments.insert(it.key(), m_serializer(it.key(), value));
+
+    }
+  }
+
+  if(previous && data->changed.isEmpty()) {
+
+    delete data;
+    return SignalSnapshot();
+
+  }
+
+  SignalSnapshot snapshot(data);
+
+  QMutexLocker locker(&m_mutex);
+  m_current = snapshot;
+
+  return snapshot;
+
+}
@@ -0,0 +1,67 @@
+/**********************************************************************
+ *  снимок значений сигналов для рабочих потоков http серверов.
+ *
+ *  снимок формируется в потоке сервера и публикуется целиком,
+ *  рабочие потоки читают неизменяемую копию без обращения к сигналам.
+ *  для изменившихся сигналов однократно формируется json представление,
+ *  которое затем используется всеми клиентами.
+ * *********************************************************************/
+
+#ifndef SV_SIGNAL_SNAPSHOT_H
+#define SV_SIGNAL_SNAPSHOT_H
+
+#include <QHash>
+#include <QMap>
+#include <QList>
+#include <QVariant>
+#include <QByteArray>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QMetaType>
+
+#include "../../../Modus/global/signal/sv_signal.h"
+
+namespace httpsrv {
+
+  struct SignalSnapshotData {
+
+    qint64                  time = 0;   // время формирования снимка, мс
+
+    QHash<int, QVariant>    values;     // id -> значение
+    QHash<int, QByteArray>  fragments;  // id -> json представление значения
+    QList<int>              changed;    // сигналы, изменившиеся с предыдущего снимка
+
+  };
+
+  typedef QSharedPointer<const SignalSnapshotData> SignalSnapshot;
+
+  // формирование json представления значения сигнала
+  typedef QByteArray (*FragmentSerializer)(int id, const QVariant& value);
+
+  class SvSignalSnapshot;
+
+}
+
+Q_DECLARE_METATYPE(httpsrv::SignalSnapshot)
+
+class httpsrv::SvSignalSnapshot
+{
+public:
+  explicit SvSignalSnapshot(FragmentSerializer serializer = nullptr);
+
+  // последний опубликованный снимок. может вызываться из любого потока
+  SignalSnapshot current() const;
+
+  // формирование и публикация нового снимка. вызывается в потоке сервера.
+  // если ни один сигнал не изменился, то возвращается пустой указатель
+  SignalSnapshot update(const QMap<int, modus::SvSignal*>& signal_map);
+
+private:
+  mutable QMutex      m_mutex;
+  SignalSnapshot      m_current;
+
+  FragmentSerializer  m_serializer;
+
+};
+
+#endif // SV_SIGNAL_SNAPSHOT_H
@@ -0,0 +1,562 @@
+#include "sv_static_cache.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/sendfile.h>
+
+#include <string.h>
+#include <zlib.h>
+
+httpsrv::SvStaticCache::SvStaticCache(const QString& root, const QString& index_file, qint64 cache_size, qint64 file_limit):
+  QObject(),
+  m_root(QDir(root).absolutePath()),
+  m_index_file(index_file),
+  m_cache_size(cache_size),
+  m_file_limit(file_limit),
+  m_watcher(new QFileSystemWatcher(this))
+{
+  connect(m_watcher, &QFileSystemWatcher::fileChanged,      this, &httpsrv::SvStaticCache::fileChanged);
+  connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &httpsrv::SvStaticCache::directoryChanged);
+}
+
+namespace {
+
+  // ETag по размеру и времени изменения файла, с суффиксом кодирования
+  QByteArray etag(const QFileInfo& fi, const QByteArray& encoding = QByteArray())
+  {
+    QByteArray tag = QString("%1-%2").arg(fi.size(), 0, 16).arg(fi.lastModified().toMSecsSinceEpoch(), 0, 16).toLatin1();
+
+    if(!encoding.isEmpty())
+      tag.append('-').append(encoding);
+
+    return QByteArray("\"").append(tag).append('"');
+
+  }
+
+  // время изменения файла, мс. -1 - файла нет
+  qint64 stamp(const QString& path)
+  {
+    QFileInfo fi(path);
+    return fi.exists() ? fi.lastModified().toMSecsSinceEpoch() : -1;
+  }
+}
+
+QString httpsrv::SvStaticCache::resolve(const QString& resource) const
+{
+  QString file = resource;
+
+  if(file.startsWith('/'))
+    file.remove(0, 1);
+
+  QString path = QDir::cleanPath(m_root + '/' + file);
+
+  // запросы за пределы каталога html не обслуживаются
+  if(path != m_root && !path.startsWith(m_root + '/'))
+    return QString();
+
+  if(QFileInfo(path).isDir())
+    path = QDir::cleanPath(path + '/' + m_index_file);
+
+  return path;
+
+}
+
+httpsrv::StaticReply httpsrv::SvStaticCache::get(const QString& resource, const QString& if_none_match, const QString& accept_encoding)
+{
+  StaticReply reply;
+
+  QString path = resolve(resource);
+
+  if(path.isEmpty()) {
+
+    reply.status = 404;
+    reply.error  = QString("Файл отсутствует: %1").arg(resource);
+
+    return reply;
+
+  }
+
+  StaticFilePtr file;
+  {
+    QReadLocker locker(&m_lock);
+    file = m_files.value(path);
+  }
+
+  if(!file) {
+
+    file = load(path, reply);
+
+    if(!file)
+      return reply;
+
+  }
+
+  const QByteArray* content  = &file->data;
+  QByteArray        encoding = QByteArray();
+  QByteArray        tag      = file->etag;
+
+  if(!file->brotli.isEmpty() && accept_encoding.contains("br")) {
+
+    content  = &file->brotli;
+    encoding = "br";
+    tag      = file->brotli_etag;
+
+  }
+  else if(!file->gzip.isEmpty() && accept_encoding.contains("gzip")) {
+
+    content  = &file->gzip;
+    encoding = "gzip";
+    tag      = file->gzip_etag;
+
+  }
+
+  // клиент уже имеет актуальную версию файла в том же кодировании
+  if(!if_none_match.isEmpty()) {
+
+    for(QString match: if_none_match.split(',', QString::SkipEmptyParts)) {
+
+      match = match.trimmed();
+      if(match.startsWith("W/"))
+        match.remove(0, 2);
+
+      if(match == "*" || match.toLatin1() == tag) {
+
+        reply.status = 304;
+        reply.head.append("HTTP/1.1 304 Not Modified\r\n")
+                  .append("ETag: ").append(tag).append("\r\n")
+                  .append("Cache-Control: no-cache\r\n")
+                  .append("Vary: Accept-Encoding\r\n")
+                  .append("Content-Length: 0\r\n\r\n");
+
+        return reply;
+
+      }
+    }
+  }
+
+  qint64 length = file->cached ? content->size() : file->size;
+
+  reply.status = 200;
+  reply.head.append("HTTP/1.1 200 Ok\r\n")
+            .append("Content-Type: ").append(file->content_type).append("\r\n")
+            .append("Content-Length: ").append(QByteArray::number(length)).append("\r\n")
+            .append("ETag: ").append(tag).append("\r\n")
+            .append("Cache-Control: no-cache\r\n")
+            .append("Vary: Accept-Encoding\r\n");
+
+  if(!encoding.isEmpty())
+    reply.head.append("Content-Encoding: ").append(encoding).append("\r\n");
+
+  reply.head.append("\r\n");
+
+  if(file->cached)
+    reply.body = *content;  // без копирования, QByteArray разделяет данные
+
+  else {
+
+    reply.sendfile_path = file->path;
+    reply.sendfile_size = file->size;
+
+  }
+
+  return reply;
+
+}
+
+httpsrv::StaticFilePtr httpsrv::SvStaticCache::load(const QString& path, StaticReply& reply)
+{
+  QFileInfo fi(path);
+
+  if(!fi.exists() || !fi.isFile()) {
+
+    reply.status = 404;
+    reply.error  = QString("Файл отсутствует: %1").arg(fi.fileName());
+
+    return StaticFilePtr();
+
+  }
+
+  QSharedPointer<StaticFile> file(new StaticFile);
+
+  file->path  = path;
+  file->size  = fi.size();
+  file->etag  = etag(fi);
+
+  QString suffix = fi.suffix().toLower();
+  file->content_type = ContentTypeBySuffix.value(suffix, "application/octet-stream").toLatin1(); //двоичный файл без указания формата (RFC 2046)
+
+  if(file->content_type.startsWith("text/"))
+    file->content_type.append("; charset=\"utf-8\"");
+
+  // большие файлы не кэшируются, передаются через sendfile
+  if(file->size > m_file_limit)
+    return file;
+
+  QFile f(path);
+
+  if(!f.open(QIODevice::ReadOnly)) {
+
+    reply.status = 500;
+    reply.error  = f.errorString();
+
+    return StaticFilePtr();
+
+  }
+
+  file->data   = f.readAll();
+  file->cached = true;
+  f.close();
+
+  // предварительно сжатые варианты используются, только если они не старше файла.
+  // на контроль ставятся все существующие варианты, в том числе устаревшие
+  QStringList variants;
+
+  file->gzip_stamp   = stamp(path + ".gz");
+  file->brotli_stamp = stamp(path + ".br");
+
+  for(QString ext: QStringList() << ".gz" << ".br") {
+
+    QFileInfo vi(path + ext);
+
+    if(!vi.exists())
+      continue;
+
+    variants << vi.absoluteFilePath();
+
+    if(vi.lastModified() < fi.lastModified())
+      continue;
+
+    QFile v(vi.absoluteFilePath());
+    if(!v.open(QIODevice::ReadOnly))
+      continue;
+
+    if(ext == ".gz") {
+
+      file->gzip      = v.readAll();
+      file->gzip_etag = etag(vi, "gz");
+
+    }
+    else {
+
+      file->brotli      = v.readAll();
+      file->brotli_etag = etag(vi, "br");
+
+    }
+  }
+
+  if(file->gzip.isEmpty() && file->data.size() >= 1024 && isCompressible(file->content_type)) {
+
+    file->gzip      = gzipCompress(file->data);
+    file->gzip_etag = etag(fi, "gz");
+
+    if(file->gzip.size() >= file->data.size())
+      file->gzip.clear();
+
+  }
+
+  {
+    QWriteLocker locker(&m_lock);
+
+    StaticFilePtr previous = m_files.value(path);
+    qint64 total = m_total - (previous ? previous->footprint() : 0) + file->footprint();
+
+    // кэш заполнен. файл отдается, но не сохраняется
+    if(total > m_cache_size)
+      return file;
+
+    m_files.insert(path, file);
+    m_total = total;
+
+  }
+
+  QMetaObject::invokeMethod(this, "watch", Qt::QueuedConnection, Q_ARG(QString, path));
+
+  // каталог - для вариантов, которых при загрузке не было
+  QMetaObject::invokeMethod(this, "watch", Qt::QueuedConnection, Q_ARG(QString, fi.absolutePath()));
+
+  for(QString variant: variants) {
+
+    QWriteLocker locker(&m_lock);
+    m_watched.insert(variant, path);
+
+    QMetaObject::invokeMethod(this, "watch", Qt::QueuedConnection, Q_ARG(QString, variant));
+
+  }
+
+  return file;
+
+}
+
+void httpsrv::SvStaticCache::watch(const QString& path)
+{
+  if(!m_watcher->files().contains(path) && !m_watcher->directories().contains(path))
+    m_watcher->addPath(path);
+
+}
+
+void httpsrv::SvStaticCache::fileChanged(const QString& path)
+{
+  QWriteLocker locker(&m_lock);
+
+  QString file = m_watched.take(path);
+  if(file.isEmpty())
+    file = path;
+
+  StaticFilePtr entry = m_files.take(file);
+
+  if(entry)
+    m_total -= entry->footprint();
+
+  // файл будет снова поставлен на контроль при следующей загрузке
+  m_watcher->removePath(path);
+
+}
+
+void httpsrv::SvStaticCache::directoryChanged(const QString& path)
+{
+  QWriteLocker locker(&m_lock);
+
+  // в каталоге появился или удален сжатый вариант кэшированного файла
+  for(auto it = m_files.begin(); it != m_files.end(); ) {
+
+    const StaticFilePtr& file = it.value();
+
+    if(QFileInfo(file->path).absolutePath() != path ||
+       (stamp(file->path + ".gz") == file->gzip_stamp && stamp(file->path + ".br") == file->brotli_stamp)) {
+
+      ++it;
+      continue;
+
+    }
+
+    m_total -= file->footprint();
+    it = m_files.erase(it);
+
+  }
+}
+
+bool httpsrv::SvStaticCache::send(QTcpSocket* socket, const StaticReply& reply)
+{
+  int fd = -1;
+
+  if(!reply.sendfile_path.isEmpty()) {
+
+    fd = ::open(reply.sendfile_path.toLocal8Bit().constData(), O_RDONLY | O_CLOEXEC);
+
+    if(fd < 0) {
+
+      socket->abort();
+      return false;
+
+    }
+  }
+
+  socket->write(reply.head);
+
+  if(!reply.body.isEmpty())
+    socket->write(reply.body);
+
+  socket->flush();
+
+  if(fd < 0) {
+
+    socket->close();
+    return true;
+
+  }
+
+  // передача продолжается в цикле событий потока, сокет закрывается по ее окончании
+  new SvFileTransfer(socket, fd, reply.sendfile_size);
+
+  return true;
+
+}
+
+/** ********** SvFileTransfer ************ **/
+
+namespace {
+
+  // sendfile в закрытый клиентом сокет вызывает SIGPIPE (в отличие от send с MSG_NOSIGNAL).
+  // сигнал блокируется в потоке на время вызова, а возникший - забирается из очереди
+  ssize_t sendNoSignal(int sock, int fd, off_t* offset, size_t count)
+  {
+    sigset_t pipe, old;
+    sigemptyset(&pipe);
+    sigaddset(&pipe, SIGPIPE);
+
+    pthread_sigmask(SIG_BLOCK, &pipe, &old);
+
+    ssize_t sent = ::sendfile(sock, fd, offset, count);
+    int     error = errno;
+
+    if(sent < 0 && error == EPIPE) {
+
+      struct timespec zero = {0, 0};
+      while(sigtimedwait(&pipe, nullptr, &zero) > 0) { }
+
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old, nullptr);
+
+    errno = error;
+    return sent;
+
+  }
+}
+
+httpsrv::SvFileTransfer::SvFileTransfer(QTcpSocket* socket, int fd, qint64 size):
+  QObject(socket),
+  m_socket(socket),
+  m_fd(fd),
+  m_size(size)
+{
+  m_timer.setSingleShot(true);
+  m_timer.setInterval(SENDFILE_TIMEOUT);
+  connect(&m_timer, &QTimer::timeout, this, &SvFileTransfer::timeout);
+
+  m_timer.start();
+
+  // заголовки должны быть отправлены раньше содержимого файла
+  if(m_socket->bytesToWrite() > 0)
+    connect(m_socket, &QTcpSocket::bytesWritten, this, &SvFileTransfer::headersWritten);
+
+  else
+    QMetaObject::invokeMethod(this, "headersWritten", Qt::QueuedConnection);
+
+}
+
+httpsrv::SvFileTransfer::~SvFileTransfer()
+{
+  if(m_fd >= 0)
+    ::close(m_fd);
+
+}
+
+void httpsrv::SvFileTransfer::headersWritten()
+{
+  if(m_notifier || m_socket->bytesToWrite() > 0)
+    return;
+
+  disconnect(m_socket, &QTcpSocket::bytesWritten, this, &SvFileTransfer::headersWritten);
+
+  m_notifier = new QSocketNotifier(m_socket->socketDescriptor(), QSocketNotifier::Write, this);
+  connect(m_notifier, &QSocketNotifier::activated, this, &SvFileTransfer::writable);
+
+}
+
+void httpsrv::SvFileTransfer::writable()
+{
+  int sock = int(m_socket->socketDescriptor());
+
+  // пишем, пока ядро принимает данные. при EAGAIN ждем следующей готовности сокета
+  while(m_offset < m_size) {
+
+    off_t   offset = off_t(m_offset);
+    ssize_t sent   = sendNoSignal(sock, m_fd, &offset, size_t(m_size - m_offset));
+
+    if(sent > 0) {
+
+      m_offset = qint64(offset);
+      m_timer.start();
+
+      continue;
+
+    }
+
+    if(sent < 0 && errno == EINTR)
+      continue;
+
+    if(sent < 0 && errno == EAGAIN)
+      return;
+
+    // ошибка сокета, либо файл стал короче
+    finish(false);
+    return;
+
+  }
+
+  finish(true);
+
+}
+
+void httpsrv::SvFileTransfer::timeout()
+{
+  finish(false);
+}
+
+void httpsrv::SvFileTransfer::finish(bool ok)
+{
+  m_timer.stop();
+
+  if(m_notifier)
+    m_notifier->setEnabled(false);
+
+  if(ok)
+    m_socket->close();
+
+  else
+    m_socket->abort();
+
+  deleteLater();
+
+}
+
+QString httpsrv::SvStaticCache::headerField(const QList<QByteArray>& lines, const QByteArray& name)
+{
+  for(const QByteArray& line: lines) {
+
+    int colon = line.indexOf(':');
+
+    if(colon > 0 && line.left(colon).trimmed().toLower() == name.toLower())
+      return QString(line.mid(colon + 1).trimmed());
+
+  }
+
+  return QString();
+
+}
+
+QByteArray httpsrv::SvStaticCache::gzipCompress(const QByteArray& data)
+{
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+
+  // 15 + 16 - формат gzip
+  if(deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK)
+    return QByteArray();
+
+  QByteArray out;
+  out.resize(int(deflateBound(&zs, uLong(data.size()))));
+
+  zs.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(data.constData()));
+  zs.avail_in  = uInt(data.size());
+  zs.next_out  = reinterpret_cast<Bytef*>(out.data());
+  zs.avail_out = uInt(out.size());
+
+  int result = deflate(&zs, Z_FINISH);
+  deflateEnd(&zs);
+
+  if(result != Z_STREAM_END)
+    return QByteArray();
+
+  out.resize(int(zs.total_out));
+
+  return out;
+
+}
+
+bool httpsrv::SvStaticCache::isCompressible(const QByteArray& content_type)
+{
+  return content_type.startsWith("text/")
+      || content_type.startsWith("application/javascript")
+      || content_type.startsWith("application/json")
+      || content_type.startsWith("application/xml")
+      || content_type.startsWith("image/svg+xml");
+}
@@ -0,0 +1,188 @@
+/**********************************************************************
+ *  кэш статических файлов для http серверов (web_server, restapi).
+ *
+ *  файлы, не превышающие заданного размера, хранятся в памяти вместе
+ *  со сжатыми вариантами (gzip формируется при загрузке, либо берется
+ *  предварительно сжатый файл.gz; brotli - только предварительно сжатый
+ *  файл.br). запись кэша удаляется при изменении файла или его сжатых
+ *  вариантов, в том числе при появлении и удалении варианта (inotify
+ *  через QFileSystemWatcher, для вариантов - и за каталогом файла).
+ *  ETag у каждого кодирования свой (суффикс -gz, -br), ответ содержит
+ *  Vary: Accept-Encoding. при совпадении If-None-Match с ETag того
+ *  кодирования, которое получит клиент, возвращается 304. большие файлы не кэшируются
+ *  и передаются через sendfile асинхронно: файл дописывается в сокет
+ *  по готовности к записи (QSocketNotifier), поток обработчика
+ *  соединений не блокируется.
+ * *********************************************************************/
+
+#ifndef SV_STATIC_CACHE_H
+#define SV_STATIC_CACHE_H
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <QFileSystemWatcher>
+#include <QReadWriteLock>
+#include <QSharedPointer>
+#include <QDateTime>
+#include <QHash>
+#include <QMap>
+
+#define P_CACHE_SIZE        "cache_size"
+#define P_CACHE_FILE_LIMIT  "cache_file_limit"
+
+#define DEFAULT_CACHE_SIZE        67108864  // 64 МБ
+#define DEFAULT_CACHE_FILE_LIMIT  8388608   // 8 МБ
+
+// время без продвижения передачи большого файла, после которого соединение разрывается, мс
+#define SENDFILE_TIMEOUT  5000
+
+namespace httpsrv {
+
+  const QMap<QString, QString> ContentTypeBySuffix = {{"html", "text/html"},
+                                                      {"htm",  "text/html"},
+                                                      {"cmd",  "text/cmd"},
+                                                      {"css",  "text/css"},
+                                                      {"csv",  "text/csv"},
+                                                      {"txt",  "text/plain"},
+                                                      {"php",  "text/php"},
+                                                      {"ico",  "image/vnd.microsoft.icon"},
+                                                      {"gif",  "image/gif"},
+                                                      {"jpeg", "image/jpeg"},
+                                                      {"jpg",  "image/jpeg"},
+                                                      {"png",  "image/png"},
+                                                      {"svg",  "image/svg+xml"},
+                                                      {"js",   "application/javascript"},
+                                                      {"map",  "application/json"},
+                                                      {"xml",  "application/xml"},
+                                                      {"zip",  "application/zip"},
+                                                      {"gzip", "application/gzip"},
+                                                      {"pdf",  "application/pdf"},
+                                                      {"json", "application/json"},
+                                                      {"woff", "font/woff"},
+                                                      {"woff2","font/woff2"}
+                                                     };
+
+  struct StaticFile {
+
+    QString     path;           // абсолютный путь к файлу
+    QByteArray  content_type;
+    QByteArray  etag;
+    qint64      size    = 0;
+    bool        cached  = false;
+
+    QByteArray  data;
+    QByteArray  gzip;
+    QByteArray  brotli;
+
+    QByteArray  gzip_etag;
+    QByteArray  brotli_etag;
+
+    // время изменения файлов.gz и .br на момент загрузки, мс. -1 - файла не было
+    qint64      gzip_stamp    = -1;
+    qint64      brotli_stamp  = -1;
+
+    qint64 footprint() const { return data.size() + gzip.size() + brotli.size(); }
+
+  };
+
+  typedef QSharedPointer<const StaticFile> StaticFilePtr;
+
+  /** ответ на запрос статического файла **/
+  struct StaticReply {
+
+    int         status  = 200;
+    QString     error;          // описание ошибки для статусов 404 и 500
+
+    QByteArray  head;           // строка статуса и заголовки
+    QByteArray  body;           // содержимое из кэша
+
+    QString     sendfile_path;  // файл, передаваемый через sendfile
+    qint64      sendfile_size = 0;
+
+  };
+
+  class SvStaticCache;
+  class SvFileTransfer;
+
+}
+
+class httpsrv::SvStaticCache: public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit SvStaticCache(const QString& root, const QString& index_file,
+                         qint64 cache_size = DEFAULT_CACHE_SIZE, qint64 file_limit = DEFAULT_CACHE_FILE_LIMIT);
+
+  // формирование ответа на GET запрос. может вызываться из любого потока
+  StaticReply get(const QString& resource, const QString& if_none_match, const QString& accept_encoding);
+
+  // отправка ответа клиенту и закрытие соединения. вызывается в потоке, которому
+  // принадлежит сокет. файл sendfile передается асинхронно, соединение закрывается
+  // по окончании передачи. false - файл не удалось открыть, соединение закрыто
+  static bool send(QTcpSocket* socket, const StaticReply& reply);
+
+  // значение поля заголовка запроса, для серверов, которые не разбирают запрос целиком
+  static QString headerField(const QList<QByteArray>& lines, const QByteArray& name);
+
+private:
+  QString m_root;
+  QString m_index_file;
+
+  qint64  m_cache_size;
+  qint64  m_file_limit;
+  qint64  m_total = 0;
+
+  QReadWriteLock                m_lock;
+  QHash<QString, StaticFilePtr> m_files;
+
+  // отслеживаемый путь -> путь файла в кэше (для сжатых вариантов)
+  QHash<QString, QString>       m_watched;
+
+  QFileSystemWatcher*           m_watcher;
+
+  QString resolve(const QString& resource) const;
+  StaticFilePtr load(const QString& path, StaticReply& reply);
+
+  static QByteArray gzipCompress(const QByteArray& data);
+  static bool isCompressible(const QByteArray& content_type);
+
+private slots:
+  void watch(const QString& path);
+  void fileChanged(const QString& path);
+  void directoryChanged(const QString& path);
+
+};
+
+/** асинхронная передача файла через sendfile. принадлежит сокету **/
+class httpsrv::SvFileTransfer: public QObject
+{
+  Q_OBJECT
+
+public:
+  SvFileTransfer(QTcpSocket* socket, int fd, qint64 size);
+  ~SvFileTransfer() override;
+
+private:
+  QTcpSocket*       m_socket;
+  int               m_fd;
+  qint64            m_size;
+  qint64            m_offset    = 0;
+
+  QSocketNotifier*  m_notifier  = nullptr;
+  QTimer            m_timer;
+
+  void finish(bool ok);
+
+private slots:
+  // заголовки, записанные через буфер сокета, отправлены - начинаем передачу файла
+  void headersWritten();
+
+  void writable();
+  void timeout();
+
+};
+
+#endif // SV_STATIC_CACHE_H
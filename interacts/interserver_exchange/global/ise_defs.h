@@ -17,6 +17,10 @@
 #define P_ISE_RESET_TIMEOUT   "reset_timeout"
 #define P_ISE_HOST            "host"
 #define P_ISE_PORT            "port"
+#define P_ISE_RECEIVERS       "receivers"       // дополнительные получатели того же пакета
+#define P_ISE_MULTICAST_TTL   "multicast_ttl"
+#define P_ISE_MULTICAST_IFC   "multicast_ifc"   // имя сетевого интерфейса для multicast
+#define P_ISE_MULTICAST_LOOP  "multicast_loop"
 
 #define ISE_DEFAULT_RESET_INTERVAL  10
 #define ISE_DEFAULT_SEND_INTERVAL   1000
@@ -24,6 +28,7 @@
 #define ISE_DEFAULT_SENDER_ISEID    0
 #define ISE_DEFAULT_RECEIVER_ISEID  0
 #define ISE_DEFAULT_PORT            25555
+#define ISE_DEFAULT_MULTICAST_TTL   1
 
 namespace ise {
 
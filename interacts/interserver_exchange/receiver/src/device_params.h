@@ -9,6 +9,7 @@
 
 #include "../../global/ise_defs.h"
 #include "../../../../svlib/sv_exception.h"
+#include "../../../../global/sv_tx_scheduler.h"
 
 
 // имена параметров устройств
@@ -31,6 +32,7 @@ namespace iser {
     quint16   iseid          = ISE_DEFAULT_ISEID;
     quint16   sender_iseid   = ISE_DEFAULT_SENDER_ISEID;
     quint16   reset_interval = ISE_DEFAULT_RESET_INTERVAL;
+    quint16   tx_gap         = DEFAULT_TX_GAP;    // пауза перед отправкой подтверждения, мс
 
     static DeviceParams fromJson(const QString& json_string) throw (SvException)
     {
@@ -110,6 +112,21 @@ namespace iser {
       else
         p.reset_interval = ISE_DEFAULT_RESET_INTERVAL;
 
+      /* tx_gap */
+      P = P_TX_GAP;
+      if(object.contains(P)) {
+
+        if(object.value(P).toInt(-1) < 0 || object.value(P).toInt(-1) > 10000)
+          throw SvException(QString(E_IMPERMISSIBLE_VALUE)
+                                 .arg(P)
+                                 .arg(object.value(P).toVariant().toString())
+                                 .arg("Пауза перед отправкой задается в мсек. от 0 до 10000"));
+
+        p.tx_gap = object.value(P).toInt(DEFAULT_TX_GAP);
+
+      }
+      else
+        p.tx_gap = DEFAULT_TX_GAP;
 
       return p;
 
@@ -137,6 +154,7 @@ namespace iser {
       j.insert(P_ISE_ISEID,         QJsonValue(iseid_r).toString("0x00"));
       j.insert(P_ISE_SENDER_ISEID,  QJsonValue(sender_iseid_r).toString("0x00"));
       j.insert(P_ISE_RESET_TIMEOUT, QJsonValue(reset_interval).toInt(ISE_DEFAULT_RESET_INTERVAL));
+      j.insert(P_TX_GAP,            QJsonValue(tx_gap).toInt(DEFAULT_TX_GAP));
 
       return j;
 
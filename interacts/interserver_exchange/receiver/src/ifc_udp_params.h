@@ -17,6 +17,7 @@
 
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QNetworkInterface>
 
 #include "../../../../svlib/sv_exception.h"
 
@@ -25,6 +26,8 @@
 #define P_UDP_HOST      "host"
 #define P_UDP_RECV_PORT "recv_port"
 #define P_UDP_SEND_PORT "send_port"
+#define P_UDP_MULTICAST_GROUP "multicast_group"   // группа multicast, к которой присоединяется получатель
+#define P_UDP_MULTICAST_IFC   "multicast_ifc"     // имя сетевого интерфейса для группы
 
 #define DEFAULT_RECV_PORT 26000
 #define DEFAULT_SEND_PORT 25000
@@ -43,6 +46,9 @@ struct UdpParams {
   quint16 recv_port = DEFAULT_RECV_PORT;
   quint16 send_port = DEFAULT_SEND_PORT;
 
+  QHostAddress multicast_group = QHostAddress();  // пусто - прием без группы
+  QString      multicast_ifc   = "";              // пусто - интерфейс выбирает система
+
   static UdpParams fromJsonString(const QString& json_string) throw (SvException)
   {
     QJsonParseError err;
@@ -117,6 +123,36 @@ struct UdpParams {
     P = P_UDP_IFC;
     p.ifc = object.contains(P) ? object.value(P).toString() : "";
 
+    /* multicast group */
+    P = P_UDP_MULTICAST_GROUP;
+    if(object.contains(P)) {
+
+      p.multicast_group = QHostAddress(object.value(P).toString(""));
+
+      if(!p.multicast_group.isMulticast() || p.multicast_group.protocol() != QAbstractSocket::IPv4Protocol)
+        throw SvException(QString(UDP_IMPERMISSIBLE_VALUE)
+                           .arg(P).arg(object.value(P).toVariant().toString())
+                           .arg("Допускаются адреса групп multicast IPv4 в диапазоне 224.0.0.0 - 239.255.255.255"));
+
+    }
+    else
+      p.multicast_group = QHostAddress();
+
+    /* multicast interface */
+    P = P_UDP_MULTICAST_IFC;
+    if(object.contains(P)) {
+
+      p.multicast_ifc = object.value(P).toString();
+
+      if(!QNetworkInterface::interfaceFromName(p.multicast_ifc).isValid())
+        throw SvException(QString(UDP_IMPERMISSIBLE_VALUE)
+                           .arg(P).arg(p.multicast_ifc)
+                           .arg("Сетевой интерфейс не найден"));
+
+    }
+    else
+      p.multicast_ifc = "";
+
 
     return p;
 
@@ -138,6 +174,13 @@ struct UdpParams {
     j.insert(P_UDP_RECV_PORT, QJsonValue(static_cast<int>(recv_port)).toInt());
     j.insert(P_UDP_SEND_PORT, QJsonValue(static_cast<int>(send_port)).toInt());
 
+    if(!multicast_group.isNull()) {
+
+      j.insert(P_UDP_MULTICAST_GROUP, QJsonValue(multicast_group.toString()));
+      j.insert(P_UDP_MULTICAST_IFC,   QJsonValue(multicast_ifc));
+
+    }
+
     return j;
 
   }
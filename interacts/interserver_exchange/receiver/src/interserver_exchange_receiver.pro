@@ -16,13 +16,19 @@ TEMPLATE = lib
 DEFINES += INTERSERVER_EXCHANGE_RECEIVER_LIBRARY
 
 SOURCES += sv_iser.cpp \
+    sv_ise_decoder.cpp \
+    ../../../../global/sv_tx_scheduler.cpp \
+    ../../../../global/sv_metrics.cpp \
     ../../../../Modus/global/sv_signal.cpp
 
 HEADERS += sv_iser.h \
+    sv_ise_decoder.h \
     interserver_exchange_receiver_global.h \
     ../../../../Modus/global/sv_abstract_device.h \
     ../../../../Modus/global/sv_signal.h \
     ../../global/ise_defs.h \
+    ../../../../global/sv_tx_scheduler.h \
+    ../../../../global/sv_metrics.h \
     device_params.h \
     ifc_udp_params.h
 
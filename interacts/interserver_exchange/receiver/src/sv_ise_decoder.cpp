@@ -0,0 +1,200 @@
+#include "sv_ise_decoder.h"
+
+#include <QDataStream>
+#include <QIODevice>
+#include <QtEndian>
+
+#include <string.h>
+
+#define NULL_STRING 0xFFFFFFFF  // QString() в QDataStream
+
+namespace {
+
+  // QMetaType
+  enum TypeId {
+    tiInvalid   = 0,
+    tiBool      = 1,
+    tiInt       = 2,
+    tiUInt      = 3,
+    tiLongLong  = 4,
+    tiULongLong = 5,
+    tiDouble    = 6,
+    tiFloat     = 38
+  };
+
+  inline quint32 u32(const char* p) { return qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(p)); }
+  inline quint64 u64(const char* p) { return qFromBigEndian<quint64>(reinterpret_cast<const uchar*>(p)); }
+
+  inline double f64(const char* p)
+  {
+    quint64 bits = u64(p);
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+
+    return d;
+  }
+}
+
+void iser::SvMapDecoder::setSignals(const QList<SvSignal*>& list)
+{
+  m_by_key.clear();
+  m_slots.clear();
+
+  for(SvSignal* signal: list) {
+
+    const QString& name = signal->config()->name;
+
+    QByteArray key(name.size() * 2, Qt::Uninitialized);
+
+    for(int i = 0; i < name.size(); i++)
+      qToBigEndian<quint16>(name.at(i).unicode(), reinterpret_cast<uchar*>(key.data() + i * 2));
+
+    m_by_key.insert(key, signal);
+
+  }
+}
+
+SvSignal* iser::SvMapDecoder::resolve(size_t index, const char* key, int length)
+{
+  if(index < m_slots.size()) {
+
+    const Slot& slot = m_slots[index];
+
+    if(slot.key.size() == length && memcmp(slot.key.constData(), key, size_t(length)) == 0)
+      return slot.signal;
+
+  }
+
+  // сигнал на этой позиции еще не встречался или состав пакета изменился
+  SvSignal* signal = m_by_key.value(QByteArray::fromRawData(key, length), nullptr);
+
+  if(index >= m_slots.size())
+    m_slots.resize(index + 1);
+
+  m_slots[index] = Slot{QByteArray(key, length), signal};
+
+  return signal;
+
+}
+
+int iser::SvMapDecoder::update(const char* data, int size)
+{
+  m_values.clear();
+
+  if(size < 4)
+    return -1;
+
+  quint32 count = u32(data);
+  int pos = 4;
+
+  for(quint32 i = 0; i < count; i++) {
+
+    /* имя */
+    if(size - pos < 4)
+      return -1;
+
+    quint32 length = u32(data + pos);
+    pos += 4;
+
+    if(length == NULL_STRING)
+      length = 0;
+
+    if((length & 1) || length > quint32(size - pos))
+      return -1;
+
+    SvSignal* signal = resolve(i, data + pos, int(length));
+    pos += int(length);
+
+    /* значение */
+    if(size - pos < 5)
+      return -1;
+
+    quint32 type    = u32(data + pos);
+    bool    is_null = data[pos + 4] != 0;
+
+    int start = pos;
+    pos += 5;
+
+    QVariant value;
+
+    switch (type) {
+
+      case tiInvalid:
+        break;
+
+      case tiBool:
+        if(size - pos < 1) return -1;
+        value = QVariant(data[pos] != 0);
+        pos += 1;
+        break;
+
+      case tiInt:
+        if(size - pos < 4) return -1;
+        value = QVariant(qint32(u32(data + pos)));
+        pos += 4;
+        break;
+
+      case tiUInt:
+        if(size - pos < 4) return -1;
+        value = QVariant(u32(data + pos));
+        pos += 4;
+        break;
+
+      case tiLongLong:
+        if(size - pos < 8) return -1;
+        value = QVariant(qint64(u64(data + pos)));
+        pos += 8;
+        break;
+
+      case tiULongLong:
+        if(size - pos < 8) return -1;
+        value = QVariant(u64(data + pos));
+        pos += 8;
+        break;
+
+      case tiDouble:
+        if(size - pos < 8) return -1;
+        value = QVariant(f64(data + pos));
+        pos += 8;
+        break;
+
+      case tiFloat:
+        // float передается как double (QDataStream::DoublePrecision)
+        if(size - pos < 8) return -1;
+        value = QVariant(float(f64(data + pos)));
+        pos += 8;
+        break;
+
+      default:
+      {
+        // прочие типы - средствами QDataStream, поверх буфера приема
+        QByteArray raw = QByteArray::fromRawData(data, size);
+        QDataStream stream(raw);
+        stream.setVersion(QDataStream::Qt_5_5);
+
+        stream.device()->seek(start);
+        stream >> value;
+
+        if(stream.status() != QDataStream::Ok)
+          return -1;
+
+        pos = int(stream.device()->pos());
+        is_null = false;
+
+      }
+    }
+
+    if(is_null && type != tiInvalid)
+      value = QVariant(QVariant::Type(type));
+
+    if(signal)
+      m_values.push_back(Value{signal, value});
+
+  }
+
+  for(const Value& v: m_values)
+    v.signal->setValue(v.value);
+
+  return int(m_values.size());
+
+}
@@ -0,0 +1,77 @@
+/**********************************************************************
+ *  разбор данных межсерверного обмена прямо из буфера приема.
+ *
+ *  отправитель (ises::SvISESThread) передает значения сигналов как
+ *  QVariantMap в формате QDataStream::Qt_5_5:
+ *    quint32 кол-во записей, далее записи:
+ *      QString  имя   - quint32 длина в байтах, символы UTF-16BE;
+ *      QVariant value - quint32 тип, qint8 признак null, значение.
+ *
+ *  раньше данные копировались в QByteArray, разбирались в QVariantMap,
+ *  копировался список ключей и значение назначалось по имени сигнала.
+ *  теперь имя сравнивается с таблицей сигналов устройства без
+ *  преобразования в QString: таблица хранит имена в том же виде
+ *  (UTF-16BE), а сигнал каждой позиции пакета запоминается - отправитель
+ *  передает одни и те же сигналы в одном порядке, и для повторного
+ *  пакета имя только сверяется с запомненным.
+ *
+ *  числовые типы и bool разбираются напрямую, прочие - через
+ *  QDataStream поверх того же буфера, без копирования. если пакет
+ *  поврежден, значения не назначаются (как при ошибке QDataStream).
+ * *********************************************************************/
+
+#ifndef SV_ISE_DECODER_H
+#define SV_ISE_DECODER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QVariant>
+
+#include <vector>
+
+#include "../../../../Modus/global/sv_signal.h"
+
+namespace iser {
+
+  class SvMapDecoder
+  {
+  public:
+    // таблица сигналов устройства по имени
+    void setSignals(const QList<SvSignal*>& list);
+
+    bool isEmpty() const { return m_by_key.isEmpty(); }
+
+    // разбор data[0..size) и назначение значений сигналам.
+    // кол-во назначенных значений, -1 - пакет поврежден
+    int update(const char* data, int size);
+
+  private:
+    struct Slot {
+
+      QByteArray  key;      // имя в UTF-16BE
+      SvSignal*   signal;   // nullptr - у устройства нет такого сигнала
+
+    };
+
+    struct Value {
+
+      SvSignal*   signal;
+      QVariant    value;
+
+    };
+
+    QHash<QByteArray, SvSignal*>  m_by_key;
+
+    // сигналы по позициям записей последнего пакета
+    std::vector<Slot>   m_slots;
+
+    // значения разбираемого пакета. память переиспользуется
+    std::vector<Value>  m_values;
+
+    SvSignal* resolve(size_t index, const char* key, int length);
+
+  };
+}
+
+#endif // SV_ISE_DECODER_H
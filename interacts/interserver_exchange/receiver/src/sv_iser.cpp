@@ -155,6 +155,8 @@ void iser::UDPThread::conform(const QString& jsonDevParams, const QString& jsonI
     dev_params = DeviceParams::fromJson(jsonDevParams);
     ifc_params = UdpParams::fromJsonString(jsonIfcParams);
 
+    m_tx.setGap(dev_params.tx_gap);
+
   }
   catch(SvException& e) {
 
@@ -164,8 +166,27 @@ void iser::UDPThread::conform(const QString& jsonDevParams, const QString& jsonI
 
 void iser::UDPThread::open() throw(SvException)
 {
-  if(!socket.bind(ifc_params.recv_port, QAbstractSocket::DontShareAddress))
-    throw SvException(socket.errorString());
+  if(ifc_params.multicast_group.isNull()) {
+
+    if(!socket.bind(ifc_params.recv_port, QAbstractSocket::DontShareAddress))
+      throw SvException(socket.errorString());
+
+  }
+  else {
+
+    // группу на одном компьютере могут слушать несколько получателей.
+    // для группы IPv4 сокет привязывается к AnyIPv4, а не к двойному стеку
+    if(!socket.bind(QHostAddress(QHostAddress::AnyIPv4), ifc_params.recv_port, QAbstractSocket::ShareAddress | QAbstractSocket::ReuseAddressHint))
+      throw SvException(socket.errorString());
+
+    bool joined = ifc_params.multicast_ifc.isEmpty()
+                ? socket.joinMulticastGroup(ifc_params.multicast_group)
+                : socket.joinMulticastGroup(ifc_params.multicast_group, QNetworkInterface::interfaceFromName(ifc_params.multicast_ifc));
+
+    if(!joined)
+      throw SvException(QString("Ошибка подключения к группе %1: %2").arg(ifc_params.multicast_group.toString()).arg(socket.errorString()));
+
+  }
 
   // с заданным интервалом сбрасываем буфер, чтобы отсекать мусор и битые пакеты
   p_reset_timer.setInterval(dev_params.reset_interval);
@@ -182,29 +203,45 @@ void iser::UDPThread::run()
 {
   p_is_active = true;
 
+  QByteArray confirm;
+
   while(p_is_active) {
 
     process_signals();
 
-    while(socket.waitForReadyRead(1000) && p_is_active) {
+    // ожидание данных прерывается к моменту отправки очередного подтверждения
+    while((socket.waitForReadyRead(m_tx.wait(1000)) || !m_tx.isEmpty()) && p_is_active) {
 
       while(socket.hasPendingDatagrams() && p_is_active)
       {
         if(socket.pendingDatagramSize() <= 0)
           continue;
 
-        if(p_buff.offset > MAX_PACKET_SIZE)
+        if(p_buff.offset > MAX_PACKET_SIZE) {
+
           reset_buffer();
+          m_ifc_metrics.drops.inc();
+
+        }
 
         if(!p_is_active)
           break;
 
         /* ... the rest of the datagram will be lost ... */
-        p_buff.offset += socket.readDatagram(&p_buff.buf[p_buff.offset], MAX_PACKET_SIZE - p_buff.offset);
+        qint64 readed = socket.readDatagram(&p_buff.buf[p_buff.offset], MAX_PACKET_SIZE - p_buff.offset);
+
+        if(readed > 0)
+          m_ifc_metrics.bytes_in.inc(quint64(readed));
+
+        p_buff.offset += readed;
 
         process_data();
 
       }
+
+      while(m_tx.next(confirm))
+        transmit(confirm);
+
     }
   }
 
@@ -218,9 +255,17 @@ quint64 iser::UDPThread::write(const QByteArray& data)
     return 0;
 
   // небольшая задержка перед отправкой подтверждения
-  // из-за того, что "шкаф не успевает обработать данные" (c) Гаврилов
-  msleep(10);
+  // из-за того, что "шкаф не успевает обработать данные" (c) Гаврилов.
+  // подтверждение отправит цикл приема, когда пауза истечет
+  if(!m_tx.enqueue(data))
+    return 0;
+
+  return data.size();
+
+}
 
+quint64 iser::UDPThread::transmit(const QByteArray& data)
+{
   if(p_logger) // && p_device->info()->debug_mode)
     *p_logger //<< static_cast<dev::SvAbstractKsutsDevice*>(p_device)->make_dbus_sender()
               << sv::log::mtDebug
@@ -231,9 +276,12 @@ quint64 iser::UDPThread::write(const QByteArray& data)
 
 //  QUdpSocket s;
 //  quint64 w = s.writeDatagram(data, QHostAddress(p_ifc_params.host), p_ifc_params.send_port);
-  quint64 w = socket.writeDatagram(data, ifc_params.host, ifc_params.send_port);
+  qint64 w = socket.writeDatagram(data, ifc_params.host, ifc_params.send_port);
   socket.flush();
 
+  if(w > 0)
+    m_ifc_metrics.bytes_out.inc(quint64(w));
+
   return w;
 }
 
@@ -260,6 +308,8 @@ void iser::GenericThread::process_data()
        ((dev_params.sender_iseid!= ISE_DEFAULT_SENDER_ISEID)  && (m_header.sender != dev_params.sender_iseid)))
     {
       reset_buffer();
+      m_metrics.resets.inc();
+
       return;
     }
 
@@ -277,9 +327,6 @@ void iser::GenericThread::process_data()
         // считаем, что линия передачи в порядке и задаем новую контрольную точку времени
         p_device->setNewLostEpoch();
 
-        // вытаскиваем данные
-        QDataStream stream(QByteArray(&p_buff.buf[m_hsz], m_header.data_length));
-
         // проверяем crc
         quint16 got_crc;
         memcpy(&got_crc, &p_buff.buf[m_hsz + m_header.data_length], 2); // crc полученная
@@ -302,11 +349,18 @@ void iser::GenericThread::process_data()
         }
         else {
 
-            QVariantMap v;
-            stream >> v;
+            // таблица сигналов строится по первому пакету: к этому времени сигналы устройства уже добавлены
+            if(m_decoder.isEmpty())
+              m_decoder.setSignals(p_device->Signals()->values());
+
+            // значения разбираются прямо из буфера приема
+            QElapsedTimer parse_timer;
+            parse_timer.start();
+
+            m_decoder.update(&p_buff.buf[m_hsz], m_header.data_length);
 
-            foreach (QString signal_name, v.keys())
-              p_device->setSignalValue(signal_name, v.value(signal_name));
+            m_metrics.parse_time.record(quint64(parse_timer.nsecsElapsed() / 1000));
+            m_metrics.frames.inc();
 
         }
 
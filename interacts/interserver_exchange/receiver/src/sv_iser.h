@@ -4,6 +4,7 @@
 #include <QRegularExpression>
 #include <QNetworkInterface>
 #include <QStringBuilder>
+#include <QElapsedTimer>
 
 #include "interserver_exchange_receiver_global.h"
 
@@ -15,9 +16,11 @@
 #include "../../../../svlib/sv_crc.h"
 
 #include "../../global/ise_defs.h"
+#include "../../../../global/sv_metrics.h"
 
 #include "device_params.h"
 #include "ifc_udp_params.h"
+#include "sv_ise_decoder.h"
 
 
 extern "C" {
@@ -83,6 +86,9 @@ public:
     ad::SvAbstractDeviceThread(device, logger)
   {
     me = sv::log::sender(device->config()->name);
+
+    m_ifc_metrics.attach(device->config()->name);
+    m_metrics.attach(device->config()->name);
   }
 
   ~GenericThread();
@@ -93,7 +99,11 @@ protected:
   ise::Header m_header;
   size_t m_hsz = sizeof(ise::Header);
 
+  iser::SvMapDecoder m_decoder;
 
+  // /metrics: прием и отправка подтверждений, разбор пакетов
+  metrics::InterfaceMetrics m_ifc_metrics;
+  metrics::ProtocolMetrics  m_metrics;
 
   sv::log::sender me;
 
@@ -128,6 +138,11 @@ private:
 
   UdpParams    ifc_params;
 
+  // подтверждения отправляются с паузой, не останавливая прием
+  tx::SvTxScheduler m_tx;
+
+  quint64 transmit(const QByteArray& data);
+
   void run() Q_DECL_OVERRIDE;
 
 public slots:
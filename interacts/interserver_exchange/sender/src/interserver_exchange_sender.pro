@@ -17,6 +17,8 @@ DEFINES += INTERSERVER_EXCHANGE_SENDER_LIBRARY
 
 SOURCES += \
     ../../../../Modus/global/sv_signal.cpp \
+    ../../../../global/sv_metrics.cpp \
+    ../../../../global/sv_latency.cpp \
     sv_ises.cpp
 
 HEADERS += \
@@ -25,6 +27,8 @@ HEADERS += \
     ../../../../svlib/sv_exception.h \
     ../../../../Modus/global/sv_signal.h \
     ../../global/ise_defs.h \
+    ../../../../global/sv_metrics.h \
+    ../../../../global/sv_latency.h \
     sv_ises.h \
     storage_params.h
 
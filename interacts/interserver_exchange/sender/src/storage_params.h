@@ -8,6 +8,8 @@
 
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QJsonArray>
+#include <QNetworkInterface>
 
 #include "../../global/ise_defs.h"
 #include "../../../../svlib/sv_exception.h"
@@ -18,6 +20,19 @@ namespace ises {
   const QMap<QString, QHostAddress::SpecialAddress> SpecialHosts = {{"localhost", QHostAddress::LocalHost},
                                                                   {"broadcast", QHostAddress::Broadcast}};
 
+  /** получатель пакетов: адрес (в т.ч. группа multicast) и порт **/
+  struct Target {
+
+    QHostAddress  host;
+    quint16       port;
+
+  };
+
+  /** один пакет за цикл отправки передается всем получателям: основному (host, port)
+   *  и дополнительным (receivers), сигналы опрашиваются и сериализуются один раз.
+   *  для нескольких пультов удобнее группа multicast: "host": "239.1.1.1".
+   *  идентификатор получателя в заголовке общий, поэтому для нескольких пультов
+   *  его обычно оставляют нулевым **/
   struct StorageParams {
 
     quint16       iseid         = ISE_DEFAULT_ISEID;
@@ -26,6 +41,45 @@ namespace ises {
     quint16       port          = ISE_DEFAULT_PORT;
     quint16       send_interval = ISE_DEFAULT_SEND_INTERVAL;
 
+    QList<Target> receivers;
+    int           multicast_ttl  = ISE_DEFAULT_MULTICAST_TTL;
+    QString       multicast_ifc  = "";                          // пусто - интерфейс выбирает система
+    bool          multicast_loop = false;                       // доставлять ли пакеты группы на этот же компьютер
+
+    // все получатели пакета: основной и дополнительные
+    QList<Target> targets() const
+    {
+      QList<Target> t;
+      t.append(Target{host, port});
+      t.append(receivers);
+
+      return t;
+    }
+
+    bool hasMulticast() const
+    {
+      for(const Target& t: targets())
+        if(t.host.isMulticast())
+          return true;
+
+      return false;
+    }
+
+    static QHostAddress hostFromString(const QString& P, const QString& value) throw (SvException)
+    {
+      QString host = value.toLower();
+
+      if(SpecialHosts.contains(host))
+        return QHostAddress(SpecialHosts.value(host));
+
+      if(QHostAddress(host).toIPv4Address() != 0)
+        return QHostAddress(host);
+
+      throw SvException(QString(E_IMPERMISSIBLE_VALUE)
+                         .arg(P).arg(value)
+                         .arg("Допускаются ip адреса в формате \"192.168.1.1\", адреса групп multicast \"239.1.1.1\", а также слова \"localhost\", \"broadcast\""));
+    }
+
     static StorageParams fromJson(const QString& json_string) throw (SvException)
     {
       QJsonParseError err;
@@ -51,21 +105,9 @@ namespace ises {
 
       /* host */
       P = P_ISE_HOST;
-      if(object.contains(P)) {
+      if(object.contains(P))
+        p.host = hostFromString(P, object.value(P).toString(""));
 
-        QString host = object.value(P).toString("").toLower();
-
-        if(SpecialHosts.contains(host)) p.host = QHostAddress(SpecialHosts.value(host));
-
-        else
-        if(QHostAddress(host).toIPv4Address() != 0)
-          p.host = QHostAddress(host);
-
-        else
-          throw SvException(QString(E_IMPERMISSIBLE_VALUE)
-                             .arg(P).arg(object.value(P).toVariant().toString())
-                             .arg("Допускаются ip адреса в формате \"192.168.1.1\", а также слова \"localhost\", \"any\", \"broadcast\""));
-      }
       else
         p.host = QHostAddress::Any;
 
@@ -140,6 +182,75 @@ namespace ises {
       else
         p.send_interval = ISE_DEFAULT_SEND_INTERVAL;
 
+      /* receivers: ["192.168.1.2:25555", {"host": "192.168.1.3", "port": 25556}] */
+      P = P_ISE_RECEIVERS;
+      if(object.contains(P)) {
+
+        for(QJsonValue v: object.value(P).toArray()) {
+
+          Target t{QHostAddress(), p.port};
+
+          if(v.isObject()) {
+
+            t.host = hostFromString(P, v.toObject().value(P_ISE_HOST).toString(""));
+            t.port = quint16(v.toObject().value(P_ISE_PORT).toInt(p.port));
+
+          }
+          else {
+
+            QStringList hp = v.toString().split(':');
+
+            t.host = hostFromString(P, hp.at(0));
+
+            if(hp.count() > 1)
+              t.port = quint16(hp.at(1).toUInt());
+
+          }
+
+          if(t.port == 0)
+            throw SvException(QString(E_IMPERMISSIBLE_VALUE)
+                               .arg(P).arg(v.toVariant().toString())
+                               .arg("Получатель задается строкой \"192.168.1.2:25555\" или объектом {\"host\": \"192.168.1.2\", \"port\": 25555}"));
+
+          p.receivers.append(t);
+
+        }
+      }
+
+      /* multicast_ttl */
+      P = P_ISE_MULTICAST_TTL;
+      if(object.contains(P)) {
+
+        p.multicast_ttl = object.value(P).toInt(-1);
+
+        if(p.multicast_ttl < 1 || p.multicast_ttl > 255)
+          throw SvException(QString(E_IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Время жизни пакета multicast задается числом в диапазоне [1..255]"));
+
+      }
+      else
+        p.multicast_ttl = ISE_DEFAULT_MULTICAST_TTL;
+
+      /* multicast_ifc */
+      P = P_ISE_MULTICAST_IFC;
+      if(object.contains(P)) {
+
+        p.multicast_ifc = object.value(P).toString();
+
+        if(!QNetworkInterface::interfaceFromName(p.multicast_ifc).isValid())
+          throw SvException(QString(E_IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(p.multicast_ifc)
+                             .arg("Сетевой интерфейс не найден"));
+
+      }
+      else
+        p.multicast_ifc = "";
+
+      /* multicast_loop */
+      P = P_ISE_MULTICAST_LOOP;
+      p.multicast_loop = object.contains(P) ? object.value(P).toBool(false) : false;
+
 
       return p;
 
@@ -170,6 +281,15 @@ namespace ises {
       j.insert(P_ISE_PORT,            QJsonValue(static_cast<int>(port)).toInt(ISE_DEFAULT_PORT));
       j.insert(P_ISE_SEND_INTERVAL,   QJsonValue(static_cast<int>(send_interval)).toInt(ISE_DEFAULT_SEND_INTERVAL));
 
+      QJsonArray a;
+      for(const Target& t: receivers)
+        a.append(QJsonValue(QString("%1:%2").arg(t.host.toString()).arg(t.port)));
+
+      j.insert(P_ISE_RECEIVERS,       a);
+      j.insert(P_ISE_MULTICAST_TTL,   QJsonValue(multicast_ttl));
+      j.insert(P_ISE_MULTICAST_IFC,   QJsonValue(multicast_ifc));
+      j.insert(P_ISE_MULTICAST_LOOP,  QJsonValue(multicast_loop));
+
       return j;
 
     }
@@ -126,6 +126,9 @@ bool ises::SvISESThread::init()
 
     m_params = ises::StorageParams::fromJson(p_storage->config()->params);
 
+    m_metrics.attach(p_storage->config()->name);
+    m_ifc_metrics.attach(p_storage->config()->name);
+
     return true;
 
   }
@@ -159,6 +162,25 @@ void ises::SvISESThread::run()
   QDataStream stream(&varmap, QIODevice::WriteOnly);
   stream.setVersion(QDataStream::Qt_5_5);
 
+  latency::Consumer trace(latency::lsIse);
+
+  // пакет формируется один раз и отправляется всем получателям
+  QList<ises::Target> targets = m_params.targets();
+
+  // для multicast сокет привязывается заранее: ttl и исходящий интерфейс задаются привязанному сокету
+  if(m_params.hasMulticast()) {
+
+    if(!socket.bind(QHostAddress(QHostAddress::AnyIPv4), 0))
+      emit error(QString("Ошибка привязки сокета multicast: %1").arg(socket.errorString()));
+
+    socket.setSocketOption(QAbstractSocket::MulticastTtlOption, m_params.multicast_ttl);
+    socket.setSocketOption(QAbstractSocket::MulticastLoopbackOption, m_params.multicast_loop ? 1 : 0);
+
+    if(!m_params.multicast_ifc.isEmpty())
+      socket.setMulticastInterface(QNetworkInterface::interfaceFromName(m_params.multicast_ifc));
+
+  }
+
   QTime elapsed_time = QTime::currentTime();
 
   elapsed_time.start();
@@ -175,6 +197,9 @@ void ises::SvISESThread::run()
 
     elapsed_time.restart();
 
+    QElapsedTimer write_timer;
+    write_timer.start();
+
     QVariantMap signals_values;
 
     for(SvSignal* signal: *p_signals) {
@@ -204,9 +229,26 @@ void ises::SvISESThread::run()
 
     datagram.append((const char*)&crc, sizeof(quint16));
 
-    socket.writeDatagram(datagram, m_params.host, m_params.port);
+    for(const ises::Target& target: targets) {
+
+      qint64 w = socket.writeDatagram(datagram, target.host, target.port);
+
+      if(w < 0)
+        m_metrics.write_errors.inc();
+
+      else
+        m_ifc_metrics.bytes_out.inc(quint64(w));
+
+    }
+
     socket.flush();
 
+    m_metrics.write_time.record(quint64(write_timer.nsecsElapsed() / 1000));
+
+    // задержка от приема данных до отправки значений в межсерверный обмен
+    for(SvSignal* signal: *p_signals)
+      trace.record(signal->config()->id);
+
   }
 
   p_finished = true;
@@ -10,6 +10,7 @@
 #include <QTimer>
 #include <QHostAddress>
 #include <QTime>
+#include <QElapsedTimer>
 
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -17,6 +18,8 @@
 #include "../../../../svlib/sv_crc.h"
 #include "../../../../Modus/global/sv_abstract_storage.h"
 #include "../../global/ise_defs.h"
+#include "../../../../global/sv_latency.h"
+#include "../../../../global/sv_metrics.h"
 
 #include "storage_params.h"
 
@@ -88,6 +91,10 @@ private:
 
   ises::StorageParams m_params;
 
+  // /metrics: формирование и отправка пакета, отправленные байты
+  metrics::StorageMetrics   m_metrics;
+  metrics::InterfaceMetrics m_ifc_metrics;
+
 signals:
   void error(QString e);
   void connected();
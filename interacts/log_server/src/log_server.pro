@@ -9,15 +9,25 @@ QT       -= gui
 
 CONFIG += c++11 plugin
 
+LIBS += -lrt
+
 TARGET = /home/user/Modus/lib/interacts/http_eventlog
 TEMPLATE = lib
 
 DEFINES += INTERACT_LOG_LIBRARY
 
 SOURCES += sv_log_server.cpp \
+    sv_log_worker.cpp \
+    sv_log_ring.cpp \
+    ../../global/sv_http_worker_pool.cpp \
+    ../../global/sv_shm_log.cpp \
     ../../../Modus/global/signal/sv_signal.cpp
 
 HEADERS += sv_log_server.h \
+        sv_log_worker.h \
+        sv_log_ring.h \
+    ../../global/sv_http_worker_pool.h \
+    ../../global/sv_shm_log.h \
         log_server_global.h \
     params.h \
     ../../../Modus/global/interact/sv_abstract_interact.h \
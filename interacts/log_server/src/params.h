@@ -20,15 +20,26 @@
 
 #include "../../../../svlib/SvException/svexception.h"
 #include "../../../../Modus/global/global_defs.h"
+#include "../../global/sv_http_worker_pool.h"
+#include "../../global/sv_shm_log.h"
 
 // имена параметров
 #define P_PORT                  "port"
 #define P_INDEX_FILE_NAME       "index_file_name"
 #define P_PATH                  "path"
+#define P_RING_SIZE             "ring_size"
+#define P_HISTORY               "history"
+#define P_MAX_BUFFER            "max_buffer"
+#define P_SHM_POLL              "shm_poll"
+#define P_DBUS_BRIDGE           "dbus_bridge"
 
 #define DEFAULT_PORT            8001
 #define DEFAULT_INDEX_FILE_NAME "index.html"
 #define DEFAULT_PATH            "html/log"
+#define DEFAULT_RING_SIZE       10000
+#define DEFAULT_HISTORY         100
+#define DEFAULT_MAX_BUFFER      1048576
+#define DEFAULT_SHM_POLL        20
 
 /** структура для хранения параметров **/
 namespace httplog {
@@ -39,6 +50,17 @@ namespace httplog {
     QString index_file = DEFAULT_INDEX_FILE_NAME;
     QString html_path  = DEFAULT_PATH;
 
+    int     workers    = httpsrv::defaultWorkersCount();
+
+    int     ring_size  = DEFAULT_RING_SIZE;   // кол-во сообщений в буфере, предельное отставание клиента
+    int     history    = DEFAULT_HISTORY;     // кол-во последних сообщений, отправляемых при подключении
+    qint64  max_buffer = DEFAULT_MAX_BUFFER;  // предельный объем неотправленных данных клиенту, байт
+
+    QString shm_name    = DEFAULT_SHM_NAME;   // сегмент разделяемой памяти журнала
+    quint32 shm_slots   = DEFAULT_SHM_SLOTS;  // кол-во записей, если сегмент создается сервером
+    quint16 shm_poll    = DEFAULT_SHM_POLL;   // период опроса сегмента, мс
+    bool    dbus_bridge = true;               // принимать сообщения D-Bus вместе с разделяемой памятью
+
     static Params fromJsonString(const QString& json) throw (SvException)
     {
       QJsonParseError err;
@@ -82,6 +104,105 @@ namespace httplog {
       P = P_PATH;
       p.html_path = object.contains(P) ? object.value(P).toString() : DEFAULT_PATH;
 
+      /* workers */
+      P = P_WORKERS;
+      if(object.contains(P)) {
+
+        p.workers = object.value(P).toInt(0);
+
+        if(p.workers < 1)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Кол-во рабочих потоков должно быть больше 0"));
+
+      }
+      else p.workers = httpsrv::defaultWorkersCount();
+
+      /* ring_size */
+      P = P_RING_SIZE;
+      if(object.contains(P)) {
+
+        p.ring_size = object.value(P).toInt(0);
+
+        if(p.ring_size < 1)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Размер буфера сообщений должен быть больше 0"));
+
+      }
+      else p.ring_size = DEFAULT_RING_SIZE;
+
+      /* history */
+      P = P_HISTORY;
+      if(object.contains(P)) {
+
+        p.history = object.value(P).toInt(-1);
+
+        if(p.history < 0)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Кол-во сообщений, отправляемых при подключении, не может быть отрицательным"));
+
+      }
+      else p.history = DEFAULT_HISTORY;
+
+      /* max_buffer */
+      P = P_MAX_BUFFER;
+      if(object.contains(P)) {
+
+        p.max_buffer = qint64(object.value(P).toDouble(0));
+
+        if(p.max_buffer <= 0)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Объем буфера клиента задается в байтах и должен быть больше 0"));
+
+      }
+      else p.max_buffer = DEFAULT_MAX_BUFFER;
+
+      /* shm_name */
+      P = P_SHM_NAME;
+      p.shm_name = object.contains(P) ? object.value(P).toString() : DEFAULT_SHM_NAME;
+
+      if(!p.shm_name.startsWith('/') || p.shm_name.count('/') > 1)
+        throw SvException(QString(IMPERMISSIBLE_VALUE)
+                           .arg(P).arg(p.shm_name)
+                           .arg("Имя сегмента должно начинаться с символа '/' и не содержать других символов '/'"));
+
+      /* shm_slots */
+      P = P_SHM_SLOTS;
+      if(object.contains(P)) {
+
+        p.shm_slots = quint32(object.value(P).toInt(0));
+
+        if(p.shm_slots == 0)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Кол-во записей в разделяемой памяти должно быть больше 0"));
+
+      }
+      else p.shm_slots = DEFAULT_SHM_SLOTS;
+
+      /* shm_poll */
+      P = P_SHM_POLL;
+      if(object.contains(P)) {
+
+        int poll = object.value(P).toInt(0);
+
+        if(poll < 1 || poll > 65535)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Период опроса задается в миллисекундах в диапазоне 1 - 65535"));
+
+        p.shm_poll = quint16(poll);
+
+      }
+      else p.shm_poll = DEFAULT_SHM_POLL;
+
+      /* dbus_bridge */
+      P = P_DBUS_BRIDGE;
+      p.dbus_bridge = object.contains(P) ? object.value(P).toBool(true) : true;
+
 
       return p;
 
@@ -102,6 +223,14 @@ namespace httplog {
       j.insert(P_PORT,            QJsonValue(static_cast<int>(port)).toInt());
       j.insert(P_INDEX_FILE_NAME, QJsonValue(index_file).toString());
       j.insert(P_PATH,            QJsonValue(html_path).toString());
+      j.insert(P_WORKERS,         QJsonValue(workers).toInt());
+      j.insert(P_RING_SIZE,       QJsonValue(ring_size).toInt());
+      j.insert(P_HISTORY,         QJsonValue(history).toInt());
+      j.insert(P_MAX_BUFFER,      QJsonValue(static_cast<double>(max_buffer)));
+      j.insert(P_SHM_NAME,        QJsonValue(shm_name).toString());
+      j.insert(P_SHM_SLOTS,       QJsonValue(static_cast<int>(shm_slots)).toInt());
+      j.insert(P_SHM_POLL,        QJsonValue(static_cast<int>(shm_poll)).toInt());
+      j.insert(P_DBUS_BRIDGE,     QJsonValue(dbus_bridge).toBool());
 
       return j;
 
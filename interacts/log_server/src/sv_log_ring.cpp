@@ -0,0 +1,128 @@
+#include "sv_log_ring.h"
+
+#include <QStringList>
+#include <QDateTime>
+
+/** ********** LogFilter ************ **/
+
+httplog::LogFilter httplog::LogFilter::fromQuery(const QUrlQuery& query)
+{
+  LogFilter filter;
+
+  for(QString entity: query.queryItemValue(P_FILTER_ENTITY).split(',', QString::SkipEmptyParts))
+    filter.entities.insert(entity.trimmed());
+
+  for(QString id: query.queryItemValue(P_FILTER_ID).split(',', QString::SkipEmptyParts)) {
+
+    bool ok;
+    int i = id.trimmed().toInt(&ok);
+
+    if(ok)
+      filter.ids.insert(i);
+
+  }
+
+  for(QString type: query.queryItemValue(P_FILTER_TYPE).split(',', QString::SkipEmptyParts))
+    filter.types.insert(type.trimmed());
+
+  return filter;
+
+}
+
+/** ********** SvLogRing ************ **/
+
+httplog::SvLogRing::SvLogRing(int capacity):
+  m_records(qMax(1, capacity))
+{
+
+}
+
+httplog::LogRecord& httplog::SvLogRing::next()
+{
+  LogRecord& record = m_records[int(m_head % quint64(m_records.size()))];
+  record.text.clear();
+
+  ++m_head;
+
+  return record;
+
+}
+
+void httplog::SvLogRing::push(const QString& entity, int id, const QString& type, const QString& time, const QString& message)
+{
+  QMutexLocker locker(&m_mutex);
+
+  LogRecord& record = next();
+
+  record.entity   = entity;
+  record.id       = id;
+  record.type     = type;
+  record.time     = time;
+  record.msecs    = 0;
+  record.message  = message;
+
+}
+
+void httplog::SvLogRing::push(const QString& entity, int id, const QString& type, qint64 msecs, const QString& message)
+{
+  QMutexLocker locker(&m_mutex);
+
+  LogRecord& record = next();
+
+  record.entity   = entity;
+  record.id       = id;
+  record.type     = type;
+  record.time.clear();
+  record.msecs    = msecs;
+  record.message  = message;
+
+}
+
+quint64 httplog::SvLogRing::cursorForLast(int count) const
+{
+  QMutexLocker locker(&m_mutex);
+
+  quint64 last = quint64(qBound(0, count, m_records.size()));
+
+  return m_head > last ? m_head - last : 0;
+
+}
+
+quint64 httplog::SvLogRing::read(quint64 cursor, const LogFilter& filter, qint64 max_bytes, QByteArray& out, quint64& dropped)
+{
+  QMutexLocker locker(&m_mutex);
+
+  quint64 capacity = quint64(m_records.size());
+  quint64 oldest   = m_head > capacity ? m_head - capacity : 0;
+
+  // клиент отстал больше, чем на размер буфера. старые сообщения потеряны
+  dropped = 0;
+  if(cursor < oldest) {
+
+    dropped = oldest - cursor;
+    cursor  = oldest;
+
+  }
+
+  while(cursor < m_head && out.size() < max_bytes) {
+
+    LogRecord& record = m_records[int(cursor % capacity)];
+    ++cursor;
+
+    if(!filter.accepts(record))
+      continue;
+
+    if(record.text.isEmpty() && record.time.isEmpty())
+      record.time = QDateTime::fromMSecsSinceEpoch(record.msecs).toString("dd.MM.yyyy hh:mm:ss.zzz");
+
+    if(record.text.isEmpty())
+      record.text = QString("%1%2:%3:%4\n%5").arg(record.entity).arg(record.id).arg(record.time)
+                                             .arg(record.type).arg(record.message).toUtf8();
+
+    out.append(record.text);
+
+  }
+
+  return cursor;
+
+}
@@ -0,0 +1,92 @@
+/**********************************************************************
+ *  общий кольцевой буфер сообщений журнала.
+ *
+ *  сообщение помещается в буфер один раз, в потоке сервера. каждый
+ *  клиент хранит собственный курсор (порядковый номер следующего
+ *  сообщения). если клиент отстал больше, чем на размер буфера,
+ *  старые сообщения для него теряются, курсор переносится на самое
+ *  старое доступное сообщение. фильтр клиента проверяется по полям
+ *  сообщения до форматирования, текст формируется один раз при первом
+ *  чтении и используется всеми клиентами.
+ * *********************************************************************/
+
+#ifndef SV_LOG_RING_H
+#define SV_LOG_RING_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QSet>
+#include <QMutex>
+#include <QUrlQuery>
+
+#define P_FILTER_ENTITY "entity"
+#define P_FILTER_ID     "id"
+#define P_FILTER_TYPE   "type"
+#define P_FILTER_LAST   "last"
+
+namespace httplog {
+
+  struct LogRecord {
+
+    QString     entity;
+    int         id = 0;
+    QString     type;
+    QString     time;
+    qint64      msecs = 0;  // время из журнала в разделяемой памяти, строка time формируется при чтении
+    QString     message;
+
+    QByteArray  text;   // форматируется при первом чтении
+
+  };
+
+  /** фильтр клиента. пустой список - без ограничений **/
+  struct LogFilter {
+
+    QSet<QString> entities;
+    QSet<int>     ids;
+    QSet<QString> types;
+
+    bool accepts(const LogRecord& record) const
+    {
+      return (entities.isEmpty() || entities.contains(record.entity))
+          && (ids.isEmpty()      || ids.contains(record.id))
+          && (types.isEmpty()    || types.contains(record.type));
+    }
+
+    // параметры запроса: ?entity=protocol,interface&id=1,2&type=error
+    static LogFilter fromQuery(const QUrlQuery& query);
+
+  };
+
+  class SvLogRing;
+
+}
+
+class httplog::SvLogRing
+{
+public:
+  explicit SvLogRing(int capacity);
+
+  // добавление сообщения. вызывается в потоке сервера
+  void push(const QString& entity, int id, const QString& type, const QString& time, const QString& message);
+  void push(const QString& entity, int id, const QString& type, qint64 msecs, const QString& message);
+
+  // курсор, с которого клиент получит последние count сообщений
+  quint64 cursorForLast(int count) const;
+
+  // чтение сообщений, начиная с cursor, пока объем не превысит max_bytes.
+  // возвращает новое значение курсора. dropped - кол-во потерянных клиентом сообщений
+  quint64 read(quint64 cursor, const LogFilter& filter, qint64 max_bytes, QByteArray& out, quint64& dropped);
+
+private:
+  QVector<LogRecord>  m_records;
+  quint64             m_head = 0;   // порядковый номер следующего сообщения
+
+  mutable QMutex      m_mutex;
+
+  LogRecord& next();
+
+};
+
+#endif // SV_LOG_RING_H
@@ -7,166 +7,163 @@
 
 httplog::SvHttpEventlog::SvHttpEventlog():
   modus::SvAbstractProvider(),
-  m_server(new QTcpServer(this)),
+  m_server(new httpsrv::SvWorkerPool(this)),
   m_is_active(false)
 {
-  QDBusConnection::sessionBus().connect(QString(), QString("/%1").arg(P_INTERFACE), DBUS_SERVER_NAME, "message", this, SLOT(messageSlot(const QString&,int,const QString&,const QString&,const QString&)));
-  QDBusConnection::sessionBus().connect(QString(), QString("/%1").arg(P_PROTOCOL),  DBUS_SERVER_NAME, "message", this, SLOT(messageSlot(const QString&,int,const QString&,const QString&,const QString&)));
-  QDBusConnection::sessionBus().connect(QString(), QString("/%1").arg(P_SIGNAL),    DBUS_SERVER_NAME, "message", this, SLOT(messageSlot(const QString&,int,const QString&,const QString&,const QString&)));
-  QDBusConnection::sessionBus().connect(QString(), QString("/%1").arg(P_STORAGE),   DBUS_SERVER_NAME, "message", this, SLOT(messageSlot(const QString&,int,const QString&,const QString&,const QString&)));
-  QDBusConnection::sessionBus().connect(QString(), QString("/%1").arg(P_PROVIDER),  DBUS_SERVER_NAME, "message", this, SLOT(messageSlot(const QString&,int,const QString&,const QString&,const QString&)));
+  m_notify_timer.setSingleShot(true);
+  m_notify_timer.setInterval(0);
+  connect(&m_notify_timer, &QTimer::timeout, this, &httplog::SvHttpEventlog::logAppended);
+
+  connect(&m_shm_timer, &QTimer::timeout, this, &httplog::SvHttpEventlog::readShm);
 }
 
 httplog::SvHttpEventlog::~SvHttpEventlog()
 {
+  m_server->stopHandlers();
+
+  if(m_ring)
+    delete m_ring;
+
+  if(m_shm)
+    delete m_shm;
 
 }
 
 void httplog::SvHttpEventlog::messageSlot(const QString& entity, int id, const QString& type, const QString& time, const QString& message)
 {
-  for(QTcpSocket* client: m_clients) {
+  if(!m_ring)
+    return;
 
-    client->write(QString("%1%2:%3:%4\n%5").arg(entity).arg(id).arg(time).arg(type).arg(message).toUtf8());
+  // мост D-Bus: сообщение переносится в разделяемую память и становится доступно
+  // всем ее читателям (logview). время отправителя сохраняется строкой, длинное
+  // сообщение занимает несколько слотов. сервер получит его при опросе сегмента
+  if(m_shm) {
+
+    m_shm->write(entity, id, 0, type, message, QDateTime::currentMSecsSinceEpoch(), time);
+    return;
 
   }
+
+  // сегмент недоступен - сообщение помещается в общий буфер один раз,
+  // клиенты читают его каждый со своей позиции
+  m_ring->push(entity, id, type, time, message);
+
+  if(!m_notify_timer.isActive())
+    m_notify_timer.start();
 }
 
-bool httplog::SvHttpEventlog::configure(modus::ProviderConfig* config)
+void httplog::SvHttpEventlog::readShm()
 {
-  p_config = config;
+  shmlog::Record record;
+  quint64 dropped;
+  quint64 lost = 0;
+  bool    appended = false;
 
-  try {
+  while(m_shm->read(m_shm_cursor, record, dropped)) {
 
-    m_params = httplog::Params::fromJsonString(p_config->params);
+    lost += dropped;
 
-    if (!m_server->listen(QHostAddress::Any, m_params.port))
-    {
-      p_last_error = QString("Ошибка запуска сервера %1: %2").arg(p_config->name).arg(m_server->errorString());
+    if(record.time_text.isEmpty())
+      m_ring->push(record.entity, record.id, record.type, record.time, record.message);
 
-      return false;
+    else
+      m_ring->push(record.entity, record.id, record.type, record.time_text, record.message);
 
-    };
+    appended = true;
 
-    connect(m_server, &QTcpServer::newConnection, this, &httplog::SvHttpEventlog::newConnection);
+  }
 
-    return true;
+  lost += dropped;
 
-  }
-  catch(SvException e)
-  {
-    p_last_error = e.error;
+  if(lost > 0)
+    emit message(QString("Сервер журнала не успевает читать разделяемую память, пропущено сообщений: %1").arg(lost),
+                 sv::log::llError, sv::log::mtError);
+
+  if(appended && !m_notify_timer.isActive())
+    m_notify_timer.start();
 
-    return false;
-  }
 }
 
-void httplog::SvHttpEventlog::stop()
+bool httplog::SvHttpEventlog::configure(modus::ProviderConfig* config)
 {
-  m_is_active = false;
-  m_server->close();
-  qDeleteAll(m_clients.begin(), m_clients.end());
+  p_config = config;
 
-}
+  try {
 
-void httplog::SvHttpEventlog::newConnection()
-{
-  QTcpSocket *client = m_server->nextPendingConnection();
+    m_params = httplog::Params::fromJsonString(p_config->params);
 
-  if(!client)
-    return;
+    if (!m_server->listen(QHostAddress::Any, m_params.port))
+    {
+      p_last_error = QString("Ошибка запуска сервера %1: %2").arg(p_config->name).arg(m_server->errorString());
 
-  connect(client, &QTcpSocket::readyRead, this, &httplog::SvHttpEventlog::processRequest);
-  connect(client, &QTcpSocket::disconnected, this, &httplog::SvHttpEventlog::socketDisconnected);
+      return false;
 
-  m_clients << client;
+    };
 
-}
+    m_ring = new httplog::SvLogRing(m_params.ring_size);
 
-void httplog::SvHttpEventlog::socketDisconnected()
-{
-    QTcpSocket *client = qobject_cast<QTcpSocket *>(sender());
+    // основной канал - журнал в разделяемой памяти. если сегмент недоступен,
+    // сообщения принимаются только через D-Bus
+    QString shm_error;
+    m_shm = shmlog::SvShmLog::open(m_params.shm_name, m_params.shm_slots, &shm_error);
+
+    if(m_shm) {
+
+      m_shm_cursor = m_shm->head();
+
+      m_shm_timer.setInterval(m_params.shm_poll);
+      m_shm_timer.start();
 
-    if (client) {
-        m_clients.removeAll(client);
-        client->deleteLater();
     }
-}
+    else
+      emit message(shm_error, sv::log::llError, sv::log::mtError);
 
-void httplog::SvHttpEventlog::processRequest()
-{
-    QTcpSocket *client = qobject_cast<QTcpSocket *>(sender());
+    if(m_params.dbus_bridge || !m_shm) {
 
-    QByteArray req = client->readAll();
+      QDBusConnection::sessionBus().connect(QString(), QString("/%1").arg(P_INTERFACE), DBUS_SERVER_NAME, "message", this, SLOT(messageSlot(const QString&,int,const QString&,const QString&,const QString&)));
+      QDBusConnection::sessionBus().connect(QString(), QString("/%1").arg(P_PROTOCOL),  DBUS_SERVER_NAME, "message", this, SLOT(messageSlot(const QString&,int,const QString&,const QString&,const QString&)));
+      QDBusConnection::sessionBus().connect(QString(), QString("/%1").arg(P_SIGNAL),    DBUS_SERVER_NAME, "message", this, SLOT(messageSlot(const QString&,int,const QString&,const QString&,const QString&)));
+      QDBusConnection::sessionBus().connect(QString(), QString("/%1").arg(P_STORAGE),   DBUS_SERVER_NAME, "message", this, SLOT(messageSlot(const QString&,int,const QString&,const QString&,const QString&)));
+      QDBusConnection::sessionBus().connect(QString(), QString("/%1").arg(P_PROVIDER),  DBUS_SERVER_NAME, "message", this, SLOT(messageSlot(const QString&,int,const QString&,const QString&,const QString&)));
 
-    restapi::HttpRequest request = restapi::HttpRequest::parse(req);
+    }
 
-    emit message(QString(req), sv::log::llDebug, sv::log::mtRequest);
+    for(int i = 0; i < m_params.workers; ++i) {
 
+      httplog::SvLogWorker* worker = new httplog::SvLogWorker(m_ring, m_params);
 
-    if((request.method == "GET"))
-      client->write(reply_get());
+      connect(worker, &httplog::SvLogWorker::message, this, &httplog::SvHttpEventlog::workerMessage);
+      connect(this, &httplog::SvHttpEventlog::logAppended, worker, &httplog::SvLogWorker::logAppended);
 
-//    else if (is_POST)
-//      client->write(reply_POST(parts));
+      m_server->addHandler(worker);
 
-    client->flush(); // waitForBytesWritten(); //
+    }
 
+    return true;
 
-  // нужно закрыть сокет
-//  client->close();
+  }
+  catch(SvException e)
+  {
+    p_last_error = e.error;
 
+    return false;
+  }
 }
 
-//void httplog::SvHttpEventlog::run()
-//{
-//  while(true)
-//  {
-//    if(m_server->waitForNewConnection(100))
-//    {
-//      QTcpSocket *client = m_server->nextPendingConnection();
+void httplog::SvHttpEventlog::stop()
+{
+  m_is_active = false;
 
-//      connect(client, &QTcpSocket::readyRead, this, &httplog::SvHttpEventlog::processRequest);
-//      connect(client, &QTcpSocket::disconnected, this, &httplog::SvHttpEventlog::socketDisconnected);
+  m_shm_timer.stop();
 
-//      m_clients << client;
+  // закрывает соединения всех клиентов и останавливает рабочие потоки
+  m_server->stopHandlers();
 
-//    }
-//  }
-//}
+}
 
-QByteArray httplog::SvHttpEventlog::reply_get()
+void httplog::SvHttpEventlog::workerMessage(const QString& text, int level, int type)
 {
-  return QByteArray()
-                      .append(QString("HTTP/1.1 200 OK\r\n\
-                              Content-Type: text/html; charset=\"utf-8\"\r\n\r\n\
-                              <html>\
-                              <head><meta charset=\"UTF-8\"><title>Журнал событий</title>\n\
-                                <script>\n\
-                                  var get_log = function() {\
-                                    const webSocket = new WebSocket('ws://' + location.origin);\n\
-                                    \
-                                    webSocket.onopen = event => {\n\
-                                      alert('onopen');\n\
-                                      webSocket.send(\"Hello Web Socket!\");\n\
-                                    };\n\n\
-                                    \
-                                    webSocket.onmessage = event => {\
-                                      alert('onmessage, ' + event.data);\
-                                    };\
-                                    \
-                                    webSocket.onclose = event => {\n\
-                                      alert('onclose');\n\
-                                    };\n\
-                                  }\
-                                </script>\n\
-                              <head>\
-                              <body>\
-                              <button id=\"bnGetLog\" onclick=\"get_log()\" >GET</button>\
-                              <p style=\"text-align:center\"><textarea cols=\"150\" name=\"text\" rows=\"50\"></p>\
-                              </body></html>\n")
-                              .toUtf8());
-//  <p><input name=\"bnGetLog\" type=\"button\" value=\"get\" /></p>
-
+  emit message(text, sv::log::Level(level), sv::log::MessageTypes(type));
 }
 
 /** ********** EXPORT ************ **/
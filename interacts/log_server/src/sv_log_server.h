@@ -16,9 +16,9 @@
 #include <QDir>
 #include <QHash>
 #include <QFileInfo>
-#include <QThreadPool>
 #include <QByteArray>
 #include <QDataStream>
+#include <QTimer>
 
 #include "log_server_global.h"
 
@@ -26,7 +26,12 @@
 #include "../../../../Modus/global/global_defs.h"
 #include "../../../../Modus/global/restapi/http_global.h"
 #include "../../../../Modus/global/dbus/sv_dbus.h"
+#include "../../global/sv_http_worker_pool.h"
+#include "../../global/sv_shm_log.h"
+
 #include "params.h"
+#include "sv_log_ring.h"
+#include "sv_log_worker.h"
 
 extern "C" {
 
@@ -56,28 +61,39 @@ namespace httplog {
   //  const QHash<QString, modus::SvSignal*>* signalsByName() const { return &m_signals_by_name; }
 
   private:
-    QTcpServer* m_server;
-    QList<QTcpSocket*> m_clients;
+    // прием соединений, клиенты обслуживаются в рабочих потоках
+    httpsrv::SvWorkerPool* m_server;
 
     httplog::Params m_params;
 
+    // общий буфер сообщений для рабочих потоков
+    httplog::SvLogRing* m_ring = nullptr;
+
+    // уведомление рабочих потоков откладывается до конца пачки сообщений
+    QTimer m_notify_timer;
+
+    // журнал в разделяемой памяти, в который пишут модули
+    shmlog::SvShmLog* m_shm = nullptr;
+    quint64           m_shm_cursor = 0;
+    QTimer            m_shm_timer;
+
   //  QMap<int, modus::SvSignal*>      m_signals_by_id;
   //  QHash<QString, modus::SvSignal*> m_signals_by_name;
 
     bool m_is_active;
 
-    QByteArray reply_get();
-//    QByteArray reply_POST(QList<QByteArray> &parts);
-
   //  void run() override;
 
   public slots:
     void stop() override;
 
+  signals:
+    void logAppended();
+
   private slots:
-    void newConnection();
-    void processRequest();
-    void socketDisconnected();
+    void workerMessage(const QString& text, int level, int type);
+
+    void readShm();
 
     void messageSlot(const QString& entity, int id, const QString& type, const QString& time, const QString& message);
 
@@ -0,0 +1,141 @@
+#include "sv_log_worker.h"
+
+/** ********** SvLogWorker ************ **/
+
+httplog::SvLogWorker::SvLogWorker(httplog::SvLogRing* ring, const httplog::Params& params):
+  httpsrv::SvConnectionHandler(),
+  m_ring(ring),
+  m_params(params)
+{
+
+}
+
+void httplog::SvLogWorker::newConnection(QTcpSocket* socket)
+{
+  connect(socket, &QTcpSocket::readyRead, this, &httplog::SvLogWorker::processRequest);
+}
+
+void httplog::SvLogWorker::connectionClosed(QTcpSocket* socket)
+{
+  m_clients.remove(socket);
+}
+
+void httplog::SvLogWorker::logAppended()
+{
+  for(QHash<QTcpSocket*, Client>::iterator it = m_clients.begin(); it != m_clients.end(); ++it)
+    flush(it.key(), it.value());
+
+}
+
+void httplog::SvLogWorker::bytesWritten()
+{
+  QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+
+  // буфер клиента освободился, можно отправлять накопившиеся сообщения
+  if(socket && m_clients.contains(socket))
+    flush(socket, m_clients[socket]);
+
+}
+
+void httplog::SvLogWorker::flush(QTcpSocket* socket, Client& client)
+{
+  qint64 free = m_params.max_buffer - socket->bytesToWrite();
+
+  if(free <= 0)
+    return;
+
+  QByteArray out;
+  quint64    dropped;
+
+  client.cursor = m_ring->read(client.cursor, client.filter, free, out, dropped);
+
+  if(dropped > 0)
+    socket->write(QString("\n... пропущено сообщений: %1\n").arg(dropped).toUtf8());
+
+  if(!out.isEmpty())
+    socket->write(out);
+
+}
+
+void httplog::SvLogWorker::processRequest()
+{
+    QTcpSocket *client = qobject_cast<QTcpSocket *>(sender());
+
+    QByteArray req = client->readAll();
+
+    restapi::HttpRequest request = restapi::HttpRequest::parse(req);
+
+    emit message(QString(req), sv::log::llDebug, sv::log::mtRequest);
+
+
+    if((request.method == "GET") && !m_clients.contains(client)) {
+
+      // GET /stream?entity=...&id=...&type=...&last=N - только сообщения журнала, без страницы
+      QList<QByteArray> line = req.left(req.indexOf('\r')).split(' ');
+      QUrl url(line.count() > 1 ? QString(line.at(1)) : QString("/"));
+      QUrlQuery query(url);
+
+      if(url.path().startsWith("/stream"))
+        client->write("HTTP/1.1 200 OK\r\nContent-Type: text/plain; charset=\"utf-8\"\r\nCache-Control: no-cache\r\n\r\n");
+
+      else
+        client->write(reply_get());
+
+      Client c;
+      c.filter = LogFilter::fromQuery(query);
+      c.cursor = m_ring->cursorForLast(query.hasQueryItem(P_FILTER_LAST) ? query.queryItemValue(P_FILTER_LAST).toInt()
+                                                                          : m_params.history);
+
+      m_clients.insert(client, c);
+      connect(client, &QTcpSocket::bytesWritten, this, &httplog::SvLogWorker::bytesWritten);
+
+      // последние сообщения журнала
+      flush(client, m_clients[client]);
+
+    }
+
+//    else if (is_POST)
+//      client->write(reply_POST(parts));
+
+    client->flush(); // waitForBytesWritten(); //
+
+
+  // нужно закрыть сокет
+//  client->close();
+
+}
+
+QByteArray httplog::SvLogWorker::reply_get()
+{
+  return QByteArray()
+                      .append(QString("HTTP/1.1 200 OK\r\n\
+                              Content-Type: text/html; charset=\"utf-8\"\r\n\r\n\
+                              <html>\
+                              <head><meta charset=\"UTF-8\"><title>Журнал событий</title>\n\
+                                <script>\n\
+                                  var get_log = function() {\
+                                    const webSocket = new WebSocket('ws://' + location.origin);\n\
+                                    \
+                                    webSocket.onopen = event => {\n\
+                                      alert('onopen');\n\
+                                      webSocket.send(\"Hello Web Socket!\");\n\
+                                    };\n\n\
+                                    \
+                                    webSocket.onmessage = event => {\
+                                      alert('onmessage, ' + event.data);\
+                                    };\
+                                    \
+                                    webSocket.onclose = event => {\n\
+                                      alert('onclose');\n\
+                                    };\n\
+                                  }\
+                                </script>\n\
+                              <head>\
+                              <body>\
+                              <button id=\"bnGetLog\" onclick=\"get_log()\" >GET</button>\
+                              <p style=\"text-align:center\"><textarea cols=\"150\" name=\"text\" rows=\"50\"></p>\
+                              </body></html>\n")
+                              .toUtf8());
+//  <p><input name=\"bnGetLog\" type=\"button\" value=\"get\" /></p>
+
+}
@@ -0,0 +1,64 @@
+#ifndef SV_LOG_WORKER_H
+#define SV_LOG_WORKER_H
+
+#include <QTcpSocket>
+#include <QByteArray>
+#include <QHash>
+#include <QUrl>
+
+#include "../../../../Modus/global/global_defs.h"
+#include "../../../../Modus/global/restapi/http_global.h"
+
+#include "../../global/sv_http_worker_pool.h"
+
+#include "params.h"
+#include "sv_log_ring.h"
+
+namespace httplog {
+
+  class SvLogWorker;
+
+}
+
+/** обслуживание клиентов журнала. работает в собственном потоке пула **/
+class httplog::SvLogWorker: public httpsrv::SvConnectionHandler
+{
+  Q_OBJECT
+
+public:
+  explicit SvLogWorker(httplog::SvLogRing* ring, const httplog::Params& params);
+
+public slots:
+  // в буфере появились новые сообщения. отправка клиентам данного потока
+  void logAppended();
+
+protected:
+  void newConnection(QTcpSocket* socket) override;
+  void connectionClosed(QTcpSocket* socket) override;
+
+private:
+  struct Client {
+
+    quint64   cursor = 0;
+    LogFilter filter;
+
+  };
+
+  httplog::SvLogRing*         m_ring;
+  httplog::Params             m_params;
+
+  // клиенты, подписанные на журнал
+  QHash<QTcpSocket*, Client>  m_clients;
+
+  QByteArray reply_get();
+
+  // отправка клиенту новых сообщений, пока объем неотправленных данных не превысит max_buffer
+  void flush(QTcpSocket* socket, Client& client);
+
+private slots:
+  void processRequest();
+  void bytesWritten();
+
+};
+
+#endif // SV_LOG_WORKER_H
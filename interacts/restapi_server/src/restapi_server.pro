@@ -9,16 +9,34 @@ QT       -= gui
 
 CONFIG += c++11 plugin
 
+LIBS += -lz
+
 TARGET = /home/user/Modus/lib/interacts/restapi_server
 TEMPLATE = lib
 
 DEFINES += INTERACT_LIBRARY
 
 SOURCES += sv_restapi_server.cpp \
+    sv_restapi_worker.cpp \
+    sv_websocket.cpp \
+    ../../global/sv_http_worker_pool.cpp \
+    ../../global/sv_signal_snapshot.cpp \
+    ../../global/sv_static_cache.cpp \
+    ../../../global/sv_realtime.cpp \
+    ../../../global/sv_metrics.cpp \
+    ../../../global/sv_latency.cpp \
     ../../../../Modus/global/signal/sv_signal.cpp \
     http_get_with_params.cpp
 
 HEADERS += sv_restapi_server.h \
+        sv_restapi_worker.h \
+        sv_websocket.h \
+    ../../global/sv_http_worker_pool.h \
+    ../../global/sv_signal_snapshot.h \
+    ../../global/sv_static_cache.h \
+    ../../../global/sv_realtime.h \
+    ../../../global/sv_metrics.h \
+    ../../../global/sv_latency.h \
         restapi_server_global.h \
     ../../../../Modus/global/interact/sv_abstract_interact.h \
     ../../../../Modus/global/signal/sv_signal.h \
@@ -17,25 +17,112 @@
 
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QJsonArray>
+#include <QMap>
+#include <QVariant>
 
 #include "../../../../svlib/SvException/svexception.h"
 #include "../../../../Modus/global/global_defs.h"
+#include "../../global/sv_http_worker_pool.h"
+#include "../../global/sv_static_cache.h"
 
 // имена параметров для UDP
 #define P_PORT        "port"
 #define P_INDEX_FILE  "index_file"
 #define P_HTML_PATH   "html_path"
 
+// параметры WebSocket
+#define P_WS_INTERVAL     "ws_interval"
+#define P_WS_MAX_BUFFER   "ws_max_buffer"
+#define P_WS_DROP_POLICY  "ws_drop_policy"
+#define P_WS_GROUPS       "ws_groups"
+
+#define WS_DROP_SKIP      "skip"
+#define WS_DROP_CLOSE     "close"
+
+// команды WebSocket клиента
+#define P_WS_SUBSCRIBE    "subscribe"
+#define P_WS_UNSUBSCRIBE  "unsubscribe"
+#define P_WS_IDS          "ids"
+#define P_WS_NAMES        "names"
+#define P_WS_GROUP_LIST   "groups"
+
+// пакетная запись значений сигналов
+#define P_ATOMIC          "atomic"
+#define P_APPLIED         "applied"
+#define P_INDEX           "index"
+
+#define CONTENT_TYPE_BINARY   "application/octet-stream"
+#define CONTENT_TYPE_METRICS  "text/plain; version=0.0.4; charset=utf-8"
+
+// метрики интерфейсов, протоколов и хранилищ в формате Prometheus
+#define METRICS_RESOURCE      "/metrics"
+
+// квантили задержек от приема данных по этапам и устройствам, json
+#define LATENCY_RESOURCE      "/latency"
+
+// предельный размер http запроса, байт
+#define HTTP_MAX_REQUEST_SIZE  16777216
+
 
 /** структура для хранения параметров **/
 namespace restapi {
 
+  // что делать, если клиент не успевает забирать данные
+  enum WsDropPolicy {
+    dpSkip,   // пропустить отправку, промежуточные значения отбрасываются, последние будут отправлены позже
+    dpClose   // закрыть соединение с медленным клиентом
+  };
+
+  /** тип значения в двоичном запросе на запись.
+   *  запись: id (uint32) + тип (uint8) + значение, little endian **/
+  enum BinaryValueType {
+    bvBool    = 0,  // 1 байт
+    bvInt32   = 1,  // 4 байта
+    bvUInt32  = 2,  // 4 байта
+    bvFloat   = 3,  // 4 байта
+    bvDouble  = 4   // 8 байт
+  };
+
+  /** элемент пакетной записи значений сигналов **/
+  struct WriteItem {
+
+    int       index = 0;    // порядковый номер в запросе, для сообщений об ошибках
+    int       id    = -1;   // сигнал задается по id, либо по имени
+    QString   name;
+    QVariant  value;
+    int       type  = -1;   // тип значения двоичной записи (BinaryValueType). -1 - значение из JSON
+
+  };
+
+  /** описание ошибки элемента пакетной записи **/
+  inline QJsonObject writeError(int index, const QString& text)
+  {
+    QJsonObject error;
+    error.insert(P_INDEX, index);
+    error.insert("value", text);
+
+    return error;
+  }
+
   struct Params {
 
     quint16 port       = 80;
     QString index_file = "index.html";
     QString html_path  = "html";
 
+    int     workers    = httpsrv::defaultWorkersCount();
+
+    qint64  cache_size        = DEFAULT_CACHE_SIZE;        // объем кэша статических файлов, байт
+    qint64  cache_file_limit  = DEFAULT_CACHE_FILE_LIMIT;  // файлы большего размера не кэшируются, байт
+
+    quint16       ws_interval     = 200;      // период отправки изменений клиентам, мс
+    qint64        ws_max_buffer   = 1048576;  // предельный объем неотправленных данных клиенту, байт
+    WsDropPolicy  ws_drop_policy  = dpSkip;
+
+    // именованные группы сигналов для подписки
+    QMap<QString, QList<int>> ws_groups;
+
     static Params fromJsonString(const QString& json) throw (SvException)
     {
       QJsonParseError err;
@@ -79,6 +166,136 @@ namespace restapi {
       P = P_HTML_PATH;
       p.html_path = object.contains(P) ? object.value(P).toString() : "html";
 
+      /* workers */
+      P = P_WORKERS;
+      if(object.contains(P)) {
+
+        p.workers = object.value(P).toInt(0);
+
+        if(p.workers < 1)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Кол-во рабочих потоков должно быть больше 0"));
+
+      }
+      else p.workers = httpsrv::defaultWorkersCount();
+
+      /* cache_size */
+      P = P_CACHE_SIZE;
+      if(object.contains(P)) {
+
+        p.cache_size = qint64(object.value(P).toDouble(-1));
+
+        if(p.cache_size < 0)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Объем кэша задается в байтах. 0 - кэширование отключено"));
+
+      }
+      else p.cache_size = DEFAULT_CACHE_SIZE;
+
+      /* cache_file_limit */
+      P = P_CACHE_FILE_LIMIT;
+      if(object.contains(P)) {
+
+        p.cache_file_limit = qint64(object.value(P).toDouble(-1));
+
+        if(p.cache_file_limit < 0)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Максимальный размер кэшируемого файла задается в байтах"));
+
+      }
+      else p.cache_file_limit = DEFAULT_CACHE_FILE_LIMIT;
+
+      /* ws_interval */
+      P = P_WS_INTERVAL;
+      if(object.contains(P)) {
+
+        // проверка до приведения к quint16, иначе значения больше 65535 переполняются
+        int interval = object.value(P).toInt(0);
+
+        if(interval < 1 || interval > 65535)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Период отправки должен быть задан в миллисекундах в диапазоне 1 - 65535"));
+
+        p.ws_interval = quint16(interval);
+
+      }
+      else p.ws_interval = 200;
+
+      /* ws_max_buffer */
+      P = P_WS_MAX_BUFFER;
+      if(object.contains(P)) {
+
+        p.ws_max_buffer = object.value(P).toVariant().toLongLong();
+
+        if(p.ws_max_buffer <= 0)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Объем буфера задается в байтах и должен быть больше 0"));
+
+      }
+      else p.ws_max_buffer = 1048576;
+
+      /* ws_drop_policy */
+      P = P_WS_DROP_POLICY;
+      if(object.contains(P)) {
+
+        QString policy = object.value(P).toString().toLower();
+
+        if(policy == WS_DROP_SKIP)
+          p.ws_drop_policy = dpSkip;
+
+        else if(policy == WS_DROP_CLOSE)
+          p.ws_drop_policy = dpClose;
+
+        else
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg(QString("Допустимые значения: \"%1\", \"%2\"").arg(WS_DROP_SKIP).arg(WS_DROP_CLOSE)));
+
+      }
+      else p.ws_drop_policy = dpSkip;
+
+      /* ws_groups */
+      P = P_WS_GROUPS;
+      if(object.contains(P)) {
+
+        if(!object.value(P).isObject())
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Группы задаются объектом вида {\"имя группы\": [id1, id2, ...]}"));
+
+        QJsonObject groups = object.value(P).toObject();
+
+        for(QString group: groups.keys()) {
+
+          if(!groups.value(group).isArray())
+            throw SvException(QString(IMPERMISSIBLE_VALUE)
+                               .arg(P).arg(group)
+                               .arg("Состав группы задается массивом идентификаторов сигналов"));
+
+          QList<int> ids;
+          for(QJsonValue v: groups.value(group).toArray()) {
+
+            int id = v.toInt(-1);
+
+            if(id < 0)
+              throw SvException(QString(IMPERMISSIBLE_VALUE)
+                                 .arg(P).arg(group)
+                                 .arg("Идентификаторы сигналов должны быть целыми неотрицательными числами"));
+
+            ids.append(id);
+
+          }
+
+          p.ws_groups.insert(group, ids);
+
+        }
+      }
+
 
       return p;
 
@@ -99,6 +316,25 @@ namespace restapi {
       j.insert(P_PORT, QJsonValue(static_cast<int>(port)).toInt());
       j.insert(P_INDEX_FILE, QJsonValue(index_file).toString());
       j.insert(P_HTML_PATH, QJsonValue(html_path).toString());
+      j.insert(P_WORKERS, QJsonValue(workers).toInt());
+      j.insert(P_CACHE_SIZE, QJsonValue(static_cast<double>(cache_size)));
+      j.insert(P_CACHE_FILE_LIMIT, QJsonValue(static_cast<double>(cache_file_limit)));
+      j.insert(P_WS_INTERVAL, QJsonValue(static_cast<int>(ws_interval)).toInt());
+      j.insert(P_WS_MAX_BUFFER, QJsonValue(static_cast<double>(ws_max_buffer)));
+      j.insert(P_WS_DROP_POLICY, QJsonValue(ws_drop_policy == dpClose ? WS_DROP_CLOSE : WS_DROP_SKIP));
+
+      QJsonObject groups;
+      for(QString group: ws_groups.keys()) {
+
+        QJsonArray ids;
+        for(int id: ws_groups.value(group))
+          ids.append(id);
+
+        groups.insert(group, ids);
+
+      }
+
+      j.insert(P_WS_GROUPS, groups);
 
       return j;
 
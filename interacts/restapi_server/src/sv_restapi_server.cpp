@@ -1,5 +1,7 @@
 ﻿#include "sv_restapi_server.h"
 
+#include <cmath>
+
 //using namespace sv::log;
 
 
@@ -7,7 +9,8 @@
 
 restapi::SvRestAPI::SvRestAPI():
   modus::SvAbstractProvider(),
-  m_server(new QTcpServer()),
+  m_server(new httpsrv::SvWorkerPool()),
+  m_snapshot(&restapi::SvRestAPI::valueFragment),
   m_is_active(false)
 {
 
@@ -27,7 +30,7 @@ bool restapi::SvRestAPI::configure(modus::ProviderConfig* config, modus::Configu
 
     m_params = restapi::Params::fromJsonString(p_config->params);
 
-//    m_web_server->moveToThread(this);
+    m_realtime = rt::Params::fromJsonString(p_config->params);
 
     if (!m_server->listen(QHostAddress::Any, m_params.port))
     {
@@ -37,6 +40,23 @@ bool restapi::SvRestAPI::configure(modus::ProviderConfig* config, modus::Configu
 
     };
 
+    // до запуска сигналы еще не привязаны, соединения принимаются только после start()
+    m_server->pauseAccepting();
+
+    m_cache = new httpsrv::SvStaticCache(m_params.html_path, m_params.index_file, m_params.cache_size, m_params.cache_file_limit);
+    m_cache->setParent(this);
+
+    for(int i = 0; i < m_params.workers; ++i) {
+
+      restapi::SvRestWorker* worker = new restapi::SvRestWorker(this, m_params, &m_snapshot, m_cache);
+
+      connect(worker, &restapi::SvRestWorker::message, this, &restapi::SvRestAPI::workerMessage);
+      connect(this, &restapi::SvRestAPI::snapshotUpdated, worker, &restapi::SvRestWorker::snapshotUpdated);
+
+      m_server->addHandler(worker);
+
+    }
+
     return true;
 
   }
@@ -62,638 +82,259 @@ bool restapi::SvRestAPI::bindSignal(modus::SvSignal* signal)
 
 void restapi::SvRestAPI::start()
 {
-  connect(m_server, &QTcpServer::newConnection, this, &restapi::SvRestAPI::newConnection);
-}
+  m_is_active = true;
 
-void restapi::SvRestAPI::stop()
-{
-  disconnect(m_server, &QTcpServer::newConnection, this, &restapi::SvRestAPI::newConnection);
-  m_is_active = false;
+  // параметры реального времени применяются в потоке провайдера
+  QString rt_error;
+  if(!rt::apply(m_realtime, &rt_error))
+    emit message(rt_error, sv::log::llError, sv::log::mtError);
 
-  foreach (QTcpSocket* client, m_websocket_clients)
-    client->close();
+  updateSnapshot();
 
-  qDeleteAll(m_websocket_clients.begin(), m_websocket_clients.end());
+  m_snapshot_timer = new QTimer();
+  m_snapshot_timer->setInterval(m_params.ws_interval);
+  connect(m_snapshot_timer, &QTimer::timeout, this, &restapi::SvRestAPI::updateSnapshot);
+  m_snapshot_timer->start();
 
-  m_server->close();
-  delete m_server;
+  m_server->resumeAccepting();
 
 }
 
-void restapi::SvRestAPI::newConnection()
-{
-  QTcpSocket *client = m_server->nextPendingConnection();
-
-  connect(client, &QTcpSocket::readyRead, this, &restapi::SvRestAPI::processHttpRequest);
-  connect(client, &QTcpSocket::disconnected, this, &restapi::SvRestAPI::socketDisconnected);
-
-}
-
-void restapi::SvRestAPI::socketDisconnected()
-{
-    QTcpSocket *client = qobject_cast<QTcpSocket *>(sender());
-
-    if (client)
-        client->deleteLater();
-
-}
-
-void restapi::SvRestAPI::processHttpRequest()
+void restapi::SvRestAPI::stop()
 {
-  QTcpSocket *client = qobject_cast<QTcpSocket *>(sender());
-
-//    QTextStream serialized(client);
-//    serialized.readAll();
-
-  QByteArray req = client->readAll();
-  emit message(QString(req), sv::log::llDebug, sv::log::mtRequest);
-
-  http::HttpRequest request = http::HttpRequest::parse(req);
-
-  // если клиент запрашивает изменение протокола на WebSocket, то отвечаем на запрос http, меняем обработчик и НЕ закрываем сокет
-  if(request.fields.contains("upgrade") && request.fields.value("upgrade") == "websocket")
-  {
-    if(request.method == "GET")
-      client->write(reply_ws_get(request));
-
-    disconnect(client, &QTcpSocket::readyRead, this, &restapi::SvRestAPI::processHttpRequest);
-    connect(client, &QTcpSocket::readyRead, this, &restapi::SvRestAPI::processWebSocketRequest);
-
-    m_websocket_clients << client;
-
-    QByteArray b;
-    b.append(char(0x81));
-    b.append(char(0x05));
-//    b.append(char(0x00));
-//    b.append(char(0x00));
-    b.append("hello");
+  m_is_active = false;
 
-    client->write(b);
+  if(m_snapshot_timer) {
 
+    m_snapshot_timer->stop();
+    delete m_snapshot_timer;
+    m_snapshot_timer = nullptr;
 
   }
-  else {
-
-    if(request.method == "GET") {
-
-      if(request.params.isEmpty())
-        client->write(reply_http_get(request));
 
-      else
-        client->write(reply_http_get_params(request));
+  // закрывает соединения всех клиентов и останавливает рабочие потоки
+  m_server->stopHandlers();
 
-    }
-
-    else if (request.method == "POST")
-      client->write(reply_http_post(request));
-
-    client->flush(); // waitForBytesWritten(); //
-
-    // нужно закрыть сокет
-    client->close();
+  delete m_server;
+  m_server = nullptr;
 
-  }
 }
 
-void restapi::SvRestAPI::processWebSocketRequest()
+void restapi::SvRestAPI::updateSnapshot()
 {
-  QTcpSocket *client = qobject_cast<QTcpSocket *>(sender());
-
-  QList<QByteArray> rawreq = client->readAll().split('\n');
-  if(!rawreq.count())
-    return;
+  httpsrv::SignalSnapshot snapshot = m_snapshot.update(m_signals_by_id);
 
-  QList<QByteArray> rawheader = rawreq.at(0).split(' ');
-  if(rawheader.count() < 3)
-    return;
+  if(snapshot)
+    emit snapshotUpdated(snapshot);
 
-  for(QByteArray line: rawreq)
-    emit message(QString(line), sv::log::llDebug2, sv::log::mtDebug);
-
-  http::HttpRequest request;
-
-  // разбираем заголовок запроса
-  request.method   = QString(rawheader.at(0).trimmed());
-  request.resourse = QString(rawheader.at(1).split('?').count() > 0 ? rawheader.at(1).split('?').at(0).trimmed() : rawheader.at(1));
-  request.params   = QString(rawheader.at(1).split('?').count() > 1 ? rawheader.at(1).split('?').at(1).trimmed() : "");
-  request.protocol = QString(rawheader.at(2).split('/').count() > 0 ? rawheader.at(2).split('/').at(0).trimmed() : rawheader.at(2));
-  request.version  = QString(rawheader.at(2).split('/').count() > 1 ? rawheader.at(2).split('/').at(1).trimmed() : "");
 }
 
-QByteArray restapi::SvRestAPI::reply_http_get(const http::HttpRequest &request)
+void restapi::SvRestAPI::workerMessage(const QString& text, int level, int type)
 {
-  return http::replyHttpGet(request, m_params.html_path, m_params.index_file);
+  emit message(text, sv::log::Level(level), sv::log::MessageTypes(type));
 }
 
-QByteArray restapi::SvRestAPI::reply_http_get_params(const http::HttpRequest &request)
+QByteArray restapi::SvRestAPI::valueFragment(int id, const QVariant& value)
 {
-  auto getErr = [=](int errorCode, QString errorString) -> QByteArray {
-
-    emit message(errorString, sv::log::llError, sv::log::mtError);
-
-//      if(m_logger)
-//        *m_logger <<llError << mtError << errorString << sv::log::endl;
-
-      return QByteArray()
-                        .append(QString("HTTP/1.1 %1 Error" \
-                                "Content-Type: text/html; charset=\"utf-8\"\r\n\r\n"
-                                "<html>"
-                                "<head><meta charset=\"UTF-8\"><title>Ошибка</title><head>"
-                                "<body>"
-                                "<p style=\"font-size: 16\">%2</p>"
-                                "<a href=\"index.html\" style=\"font-size: 14\">На главную</a>"
-                                "<p>%3</p>"
-                                "</body></html>\n")
-                                    .arg(errorCode)
-                                    .arg(errorString)
-                                    .arg(QDateTime::currentDateTime().toString())
-                                .toUtf8());
-  };
-
-  QStringList get_params = QString(request.params).split('&', QString::SplitBehavior::SkipEmptyParts);
-
-  if(get_params.count() == 0)
-    return getErr(404, QString("Неверный запрос"));
-
-  QString entity  = "";
-  QString task    = "";
-  QString option  = "";
-  QString data    = "";
-
-  for(QString param: get_params) {
-
-    if(param.indexOf('=') < 1)
-      return getErr(404, QString("Неверный запрос. Неопределенный параметр %1").arg(param));
-
-    QString field = param.left(param.indexOf('='));
-    QString tag   = param.right(param.length() - param.indexOf('=') - 1);
-
-    if(field.toLower().trimmed() == "entity")
-      entity = tag;
-
-    else if(field.toLower().trimmed() == "task")
-      task = tag;
-
-    else if(field.toLower().trimmed() == "option")
-      option = tag;
-
-    else if(field.toLower().trimmed() == "data")
-      data = tag;
-
-  }
-
-  QByteArray json = getEntityData(entity, task, option, data);
-
-/*  QString entity_param = QString(get_params.at(0));
-
-
-  if(!RestGetFieldsMap.contains(tag))
-    return getErr(404, QString("Неизвестный параметр запроса '%1'").arg(tag));
-
-  if(RestGetFieldsMap.value(tag) != RestGetFields::entity)
-    return getErr(404, QString("Неверный запрос. Ожидалось поле 'entity'. Получено '%1'").arg(tag));
-
-  if(!RestGetEntitiesMap.contains(entity))
-    return getErr(404, QString("Неверный запрос. Неизвестная сущность '%1'").arg(entity));
-
-  get_params.pop_front();
-  QString json = ""; // формируем ответ в формате JSON
-
-  switch (RestGetEntitiesMap.value(entity)) {
-
-    case RestGetEntities::signal:
-
-      json = processEntitySignal(get_params);
-
-      break;
-
-    case RestGetEntities::device:
-
-      break;
-
-    case RestGetEntities::storage:
-
-      break;
-
-    case RestGetEntities::analize:
-
-      break;
-
-    case RestGetEntities::configuration:
-
-      break;
-
-  }
-
-
-  for(QString query: get_params) {
-
-    if(query.indexOf('=') < 1)
-      continue;
-
-    QString query_field = query.left(query.indexOf('='));
-    QString query_data  = query.right(query.length() - query.indexOf('=') - 1);
-
-    if(!RestGetEntitiesMap.contains(query_field))
-      continue;
-
-    switch (RestGetEntitiesMap.value(query_field)) {
-    case RestGetEntities::signal:
-
-      json = handle_signal_request();
-
-      break;
-    default:
-      break;
-    }
-
-    if(query_field == "names")
-    {
-
-      QStringList names = query_data.split(',');
-
-      for(QString name: names)
-      {
-        if(name.trimmed().isEmpty())
-          continue;
-
-        if(signalsByName()->contains(name))
-          json.append(QString("{\"name\":\"%1\",\"value\":\"%2\"},")
-                        .arg(name).arg(Var2Str(signalsByName()->value(name)->value())));
-
-      }
-
-
-      if(!json.isEmpty()) json.chop(1);
-
-
-    }
-
-    else if(query_field == "ids")
-    {
-      QStringList ids = query_data.split(',');
-
-      for(QString curid: ids)
-      {
-        if(curid.trimmed().isEmpty())
-          continue;
-
-        bool ok;
-        int id = curid.toInt(&ok);
-
-        if(ok && signalsById()->contains(id))
-          json.append(QString("{\"id\":\"%1\",\"value\":\"%2\"},")
-                        .arg(id).arg(Var2Str(signalsById()->value(id)->value())));
-
-      }
-
-      if(!json.isEmpty()) json.chop(1);
-
-    }
-  }
-  */
-
-  QByteArray http = QByteArray()
-                    .append("HTTP/1.0 200 Ok\r\n")
-                    .append("Content-Type: text/json; charset=\"utf-8\"\r\n")
-                    .append(QString("Content-Length: %1\r\n").arg(json.length() + 2))
-                    .append("Access-Control-Allow-Origin: *\r\n")
-                    .append("Access-Control-Allow-Headers: *\r\n")
-                    .append("Origin: file://\r\n\r\n")        //! обязательно два!
-                    .append(json).append("\r\n");
-
-//  if(m_logger && m_logger->options().log_level >= sv::log::llDebug2)
-//    *m_logger << sv::log::llDebug2 << sv::log::mtDebug << QString(http) << sv::log::endl;
-
-  emit message(QString(http), sv::log::llDebug, sv::log::mtReply);
-
-  return http;
-
-}
-
-QByteArray restapi::SvRestAPI::getEntityData(const QString& entity, const QString& task, const QString& option, const QString& data, const char separator)
-{
-  QByteArray result;
-
-  switch (restapi::eto::EntitiesTable.value(entity, restapi::eto::noentity)) {
-
-    case restapi::eto::signal:
-
-      result = getSignalsData(task, option, data, separator);
-
-      break;
-
-    case restapi::eto::configuration:
-
-      result = getConfigurationData(task, option, data, separator);
-
-      break;
-
-    default:
-      result = "Не доступно в данной версии";
-      break;
-
-  }
-
-  return result;
-
+  return QString("{\"id\":%1,\"value\":%2}").arg(id).arg(var2str(value)).toUtf8();
 }
 
-QByteArray restapi::SvRestAPI::getSignalsData(const QString& task, const QString& option, const QString& data, const char separator)
+QString restapi::SvRestAPI::var2str(const QVariant& value)
 {
-  QByteArray result;
+  QString result = "\"null\"";
 
-  switch (restapi::eto::TasksTable.value(task, restapi::eto::notask)) {
+  if(value.isValid() && !value.isNull())
+  {
+    switch (value.type()) {
+/* Although this function is declared as returning QVariant::Type,
+ * the return value should be interpreted as QMetaType::Type */
+      case QMetaType::Int:
+        result = QString::number(value.toInt());
+        break;
 
-    case restapi::eto::value:
+      case QMetaType::UInt:
+        result = QString::number(value.toUInt());
+        break;
 
-      result = getSignalsValues(option, data, separator);
+      case QMetaType::LongLong:
+        result = QString::number(value.toLongLong());
+        break;
 
-      break;
+      case QMetaType::ULongLong:
+        result = QString::number(value.toULongLong());
+        break;
 
-    case restapi::eto::json:
+      case QMetaType::Float:
+        result = QString::number(value.toFloat());
+        break;
 
-      result = "Не доступно в данной версии";
-      break;
+      case QMetaType::Double:
+        result = QString::number(value.toDouble());
+        break;
 
-    default:
-      result = "Не доступно в данной версии";
-      break;
+      default:
+        result = QString("\"Неизвестный тип сигнала: %1\"").arg(value.typeName());
 
+    }
   }
 
   return result;
 
 }
 
-QByteArray restapi::SvRestAPI::getSignalsValues(const QString& option, const QString& data, const char separator)
+QByteArray restapi::SvRestAPI::setSignalValues(const QList<restapi::WriteItem>& items, bool atomic, QJsonArray errors)
 {
-  auto var2str = [](QVariant value) -> QString {
-
-    QString result = "\"null\"";
-
-    if(value.isValid() && !value.isNull())
-    {
-      switch (value.type()) {
-/* Although this function is declared as returning QVariant::Type,
- * the return value should be interpreted as QMetaType::Type */
-        case QMetaType::Int:
-          result = QString::number(value.toInt());
-          break;
+  // элементы, отброшенные при разборе запроса, уже находятся в errors
+  int total = items.count() + errors.count();
 
-        case QMetaType::UInt:
-          result = QString::number(value.toUInt());
-          break;
+  // проверка всего пакета до изменения значений
+  QVector<QPair<modus::SvSignal*, QVariant>> batch;
+  batch.reserve(items.count());
 
-        case QMetaType::LongLong:
-          result = QString::number(value.toLongLong());
-          break;
+  for(const restapi::WriteItem& item: items) {
 
-        case QMetaType::ULongLong:
-          result = QString::number(value.toULongLong());
-          break;
+    modus::SvSignal* signal = item.name.isEmpty() ? m_signals_by_id.value(item.id, nullptr)
+                                                  : m_signals_by_name.value(item.name, nullptr);
 
-        case QMetaType::Float:
-          result = QString::number(value.toFloat());
-          break;
+    if(!signal) {
 
-        case QMetaType::Double:
-          result = QString::number(value.toDouble());
-          break;
-
-        default:
-          result = QString("\"Неизвестный тип сигнала: %1\"").arg(value.typeName());
+      errors.append(writeError(item.index, item.name.isEmpty() ? QString(M_WRITE_ID_NOT_FOUND).arg(item.id)
+                                                               : QString(M_WRITE_NAME_NOT_FOUND).arg(item.name)));
+      continue;
 
-      }
     }
 
-    return result;
-
-  };
-
-  QByteArray values;
-  QByteArray errors;
-
-  values.append('{')
-        .append("\"values\":[");
-  errors.append("\"errors\":[");
-
-  switch (restapi::eto::OptionsTable.value(option, restapi::eto::nooption)) {
-
-    case restapi::eto::Options::byid:
-    {
-      QList<QString> ids = data.split(QChar(separator), QString::SkipEmptyParts);
-
-      if(ids.isEmpty())
-        errors.append("{\"value\": \"Неверный запрос значений сигналов. Список идентификаторов (data) пуст.\"},");
-
-      bool ok;
-      for(QString id: ids) {
-
-        int iid = id.toInt(&ok);
-
-        if(ok) {
+    if(signal->config()->usecase != modus::OUT &&
+       signal->config()->usecase != modus::VAR) {
 
-          modus::SvSignal* signal = m_signals_by_id.value(iid);
-
-          if(signal)
-            values.append(QString("{\"id\":%1,\"value\":%2},").arg(id).arg(var2str(signal->value())));
-
-          else
-            errors.append(QString("{\"value\":\"Сигнал с id '%1' не найден\"},").arg(id));
-
-        }
-        else
-          errors.append(QString("{\"value\":\"Неверный id сигнала: '%1'\"},").arg(id));
-
-      }
+      errors.append(writeError(item.index, QString(M_WRITE_NOT_SUITABLE_TYPE).arg(signal->id())));
+      continue;
 
-      break;
     }
 
-    case eto::Options::byname:
-    {
-
-      QList<QString> names = data.split(QChar(separator), QString::SkipEmptyParts);
+    QVariant value;
 
-      if(names.isEmpty())
-        errors.append("{\"value\": \"Неверный запрос значений сигналов. Список имен сигналов (data) пуст.\"}");
+    if(!castValue(item, signal->value(), value)) {
 
-      for(QString name: names) {
-
-        modus::SvSignal* signal = m_signals_by_name.value(name);
-
-        if(signal)
-          values.append(QString("{\"name\":%1,\"value\":%2},").arg(name).arg(var2str(signal->value())));
-
-        else
-          errors.append(QString("{\"value\":\"Сигнал с именем '%1' не найден\"},").arg(name));
-
-
-      }
-
-      break;
-    }
+      errors.append(writeError(item.index, QString(M_WRITE_TYPE_MISMATCH).arg(signal->id()).arg(signal->value().typeName())));
+      continue;
 
-    default:
-      errors.append(QString("{\"value\":\"Неверный запрос. Неизвестная опция '%1'\"},").arg(option));
-      break;
     }
 
-  if(values.endsWith(',')) values.chop(1);
-  if(errors.endsWith(',')) errors.chop(1);
-
-  errors.append(']');
-  values.append(']').append(',').append(errors).append('}');
-
-  return values;
-
-}
-
-QByteArray restapi::SvRestAPI::getConfigurationData(const QString& task, const QString& option, const QString& data, const char separator)
-{
-  return QByteArray(QString("Not avalable yet. %1 %2 %3 %4").arg(task,option,data).arg(separator).toUtf8());
-}
-
-QByteArray restapi::SvRestAPI::reply_http_post(const http::HttpRequest &request)
-{
-  QByteArray json   = QByteArray();
-
-  QJsonParseError per;
-  QJsonDocument jd = QJsonDocument::fromJson(request.data, &per); // запрос должен быть в формате JSON
+    batch.append(qMakePair(signal, value));
 
-  if(per.error != QJsonParseError::NoError) {
-
-    return getHttpError(400, QString("Некорректный запрос на обновление данных.\n%1\n%2")
-                        .arg(QString(request.data)).arg(per.errorString()));
   }
 
-  QJsonObject jo = jd.object();
-  if(!jo.contains(P_ENTITY) || !jo.value(P_ENTITY).isString() || !jo.contains(P_DATA) || !jo.value(P_DATA).isObject()) {
-
-     return getHttpError(400, QString("Некорректный запрос на обновление данных.\n%1\n%2")
-                         .arg(QString(request.data)).arg(per.errorString()));
-
-  }
+  bool rejected = atomic && !errors.isEmpty();
 
-  if((jo.value(P_ENTITY).toString() == P_SIGNAL) || (jo.value(P_ENTITY).toString() == P_SIGNALS)) {
+  if(!rejected) {
 
-    json = setSignalValues(jo.value(P_DATA).toObject());
+    // у всех значений пакета одна метка времени
+    QDateTime time = QDateTime::currentDateTime();
 
-  }
-  else if(jo.value(P_ENTITY).toString() == P_EVENTLOG) {
+    for(const QPair<modus::SvSignal*, QVariant>& write: batch)
+      write.first->setValue(write.second, time);
 
-//    json = setEventlog(jo.value(P_DATA).toObject());
+    // все значения пакета попадают в один снимок и сразу становятся видны рабочим потокам
+    updateSnapshot();
 
   }
 
+  emit message(QString("Запись значений сигналов: элементов %1, применено %2, ошибок %3")
+               .arg(total).arg(rejected ? 0 : batch.count()).arg(errors.count()),
+               sv::log::llDebug, sv::log::mtParse);
 
-  QByteArray http = QByteArray()
-                    .append("HTTP/1.0 200 Ok\r\n")
-                    .append("Content-Type: text/json; charset=\"utf-8\"\r\n")
-                    .append(QString("Content-Length: %1\r\n").arg(json.length() + 2))
-                    .append("Access-Control-Allow-Origin: *\r\n")
-                    .append("Access-Control-Allow-Headers: *\r\n")
-                    .append("Origin: file://\r\n\r\n")        //! обязательно два!
-                    .append(json).append("\r\n");
+  for(const QJsonValue& error: errors)
+    emit message(error.toObject().value(P_VALUE).toString(), sv::log::llDebug, sv::log::mtError);
 
-//  if(m_logger && m_logger->options().log_level >= sv::log::llDebug2)
-//    *m_logger << sv::log::llDebug2 << sv::log::mtDebug << QString(http) << sv::log::endl;
+  QJsonObject reply;
+  reply.insert(P_APPLIED, rejected ? 0 : batch.count());
+  reply.insert(P_ATOMIC, atomic);
 
-  emit message(QString(http), sv::log::llDebug, sv::log::mtReply);
+  if(!errors.isEmpty())
+    reply.insert("errors", errors);
 
-  return http;
+  return QJsonDocument(reply).toJson(QJsonDocument::Compact);
 
 }
 
-QByteArray restapi::SvRestAPI::setSignalValues(const QJsonObject& jo)
+bool restapi::SvRestAPI::castValue(const restapi::WriteItem& item, const QVariant& current, QVariant& value)
 {
-  QByteArray result   = QByteArray();
-  result.append('{');
-
-  QByteArray errors = QByteArray();
-
-  QJsonArray ja = jo.value(P_SIGNALS).toArray();
-
-  for(QJsonValue jv: ja) {
-
-    if(!jv.isObject())
-      continue;
-
-    QJsonObject o = jv.toObject();
-
-    if(!o.contains(P_VALUE))
-      continue;
-
-    if(o.contains(P_ID)) {
-
-      int id = o.value(P_ID).toInt(-1);
-
-      if(!m_signals_by_id.contains(id)) {
-
-        errors.append(QString(M_SIGNAL_ID_NOT_FOUND).arg(id));
+  // тип сигнала определяется по текущему значению. пока значение не задано,
+  // принимается любое число или bool
+  int target = current.isValid() && !current.isNull() ? current.userType() : int(QMetaType::UnknownType);
 
-        emit message(QString(M_SIGNAL_ID_NOT_FOUND).arg(id), sv::log::llDebug, sv::log::mtError);
+  if(item.type >= 0) {
 
-        continue;
-      }
+    // двоичная запись: тип значения должен совпадать с типом сигнала.
+    // float допускается и для сигналов double
+    bool ok;
+    switch (target) {
 
-      if(m_signals_by_id.value(id)->config()->usecase != modus::OUT &&
-         m_signals_by_id.value(id)->config()->usecase != modus::VAR) {
+      case QMetaType::UnknownType:  ok = true;                                                  break;
+      case QMetaType::Bool:         ok = item.type == bvBool;                                   break;
+      case QMetaType::Int:
+      case QMetaType::LongLong:     ok = item.type == bvInt32;                                  break;
+      case QMetaType::UInt:
+      case QMetaType::ULongLong:    ok = item.type == bvUInt32;                                 break;
+      case QMetaType::Float:        ok = item.type == bvFloat;                                  break;
+      case QMetaType::Double:       ok = item.type == bvFloat || item.type == bvDouble;         break;
 
-        errors.append(QString(M_SIGNAL_NOT_SUITABLE_TYPE).arg(id));
-        emit message(QString(M_SIGNAL_NOT_SUITABLE_TYPE).arg(id), sv::log::llDebug, sv::log::mtError);
-
-        continue;
-      }
-
-      emit message(jv.toString(), sv::log::llDebug, sv::log::mtParse);
-
-      m_signals_by_id.value(id)->setValue(o.value(P_VALUE).toVariant());
-//        qDebug() << m_signals_by_id.value(id)->value().toInt() << o.value("value").toVariant();
+      default:                      ok = false;
 
     }
-    else if(o.contains(P_NAME)) {
 
-        QString name = o.value(P_NAME).toString("");
+    if(!ok)
+      return false;
 
-        if(!m_signals_by_name.contains(name)) {
+    value = item.value;
 
-          errors.append(QString(M_SIGNAL_NAME_NOT_FOUND).arg(name));
+    return target == QMetaType::UnknownType || value.convert(target);
 
-          emit message(QString(M_SIGNAL_NAME_NOT_FOUND).arg(name), sv::log::llDebug, sv::log::mtError);
+  }
 
-          continue;
-        }
+  // JSON: для сигналов bool - true/false, для остальных - число. значение для целого
+  // сигнала должно быть без дробной части и в пределах типа
+  int got = item.value.userType();
 
-        if(m_signals_by_name.value(name)->config()->usecase != modus::UseCase::OUT ||
-           m_signals_by_name.value(name)->config()->usecase != modus::UseCase::VAR) {
+  if(got != QMetaType::Bool && got != QMetaType::Double)
+    return false;
 
-          errors.append(QString(M_SIGNAL_NOT_SUITABLE_TYPE).arg(name));
-          emit message(QString(M_SIGNAL_NOT_SUITABLE_TYPE).arg(name), sv::log::llDebug, sv::log::mtError);
+  if(target == QMetaType::UnknownType) {
 
-          continue;
-        }
+    value = item.value;
+    return true;
 
-        emit message(jv.toString(), sv::log::llDebug, sv::log::mtParse);
+  }
 
-        m_signals_by_name.value(name)->setValue(o.value(P_VALUE).toVariant());
+  if((target == QMetaType::Bool) != (got == QMetaType::Bool))
+    return false;
 
-      }
-  }
+  double d = item.value.toDouble();
 
+  auto integral = [d](double lo, double hi) -> bool { return std::trunc(d) == d && d >= lo && d < hi; };
 
-  if(!errors.isEmpty()) {
+  bool ok;
+  switch (target) {
 
-    if(errors.endsWith(',')) errors.chop(1);
+    case QMetaType::Bool:
+    case QMetaType::Float:
+    case QMetaType::Double:     ok = true;                                                          break;
+    case QMetaType::Int:        ok = integral(-2147483648.0, 2147483648.0);                         break;
+    case QMetaType::UInt:       ok = integral(0.0, 4294967296.0);                                   break;
+    case QMetaType::LongLong:   ok = integral(-9223372036854775808.0, 9223372036854775808.0);       break;
+    case QMetaType::ULongLong:  ok = integral(0.0, 18446744073709551616.0);                         break;
 
-    result.append(QString("\"errors\":[").toUtf8()).append(errors).append(']');
+    default:                    ok = false;
 
   }
 
-  result.append('}').append("\r\n");
+  if(!ok)
+    return false;
 
-  return result;
+  value = item.value;
+
+  return value.convert(target);
 
 }
 
@@ -718,55 +359,6 @@ QByteArray restapi::SvRestAPI::setSignalValues(const QJsonObject& jo)
 }
 */
 
-QByteArray restapi::SvRestAPI::reply_ws_get(const http::HttpRequest &request)
-{
-  auto getErr = [=](int errorCode, QString errorString) -> QByteArray {
-
-    emit message(errorString, sv::log::llError, sv::log::mtError);
-
-//      if(m_logger)
-//        *m_logger <<llError << mtError << errorString << sv::log::endl;
-
-      return QByteArray()
-                        .append(QString("HTTP/1.1 %1 Error" \
-                                "Content-Type: text/html; charset=\"utf-8\"\r\n\r\n"
-                                "<html>"
-                                "<head><meta charset=\"UTF-8\"><title>Ошибка</title><head>"
-                                "<body>"
-                                "<p style=\"font-size: 16\">%2</p>"
-                                "<a href=\"index.html\" style=\"font-size: 14\">На главную</a>"
-                                "<p>%3</p>"
-                                "</body></html>\n")
-                                    .arg(errorCode)
-                                    .arg(errorString)
-                                    .arg(QDateTime::currentDateTime().toString())
-                                .toUtf8());
-  };
-
-  QByteArray replay = QByteArray();
-
-  replay.append(QString("%1/%2 101 Switching Protocols\r\n").arg(QString(request.protocol)).arg(QString(request.version)));
-//  replay.append(QString("Date: Wed, %1\r\n").arg(QDateTime::currentDateTimeUtc().toString("dd MMM yyyy hh:mm:ss t")));
-  replay.append(QString("Upgrade: websocket\r\n"));
-  replay.append(QString("Connection: Upgrade\r\n"));
-
-  if(request.fields.contains("sec-websocket-key")) {
-
-    QString key = request.fields.value("sec-websocket-key");
-    key.append("258EAFA5-E914-47DA-95CA-C5AB0DC85B11");
-//qDebug() << key;
-    QByteArray hash64 = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toBase64();
-    qDebug() << QString(hash64);
-
-    replay.append(QString("Sec-WebSocket-Accept: %1\r\n\r\n").arg(QString(hash64)));
-
-  }
-
-  return replay;
-
-}
-
-
 /** ********** EXPORT ************ **/
 modus::SvAbstractProvider* create()
 {
@@ -14,11 +14,12 @@
 #include <QHttpMultiPart>
 #include <QDir>
 #include <QHash>
+#include <QVector>
 #include <QFileInfo>
-#include <QThreadPool>
 #include <QByteArray>
 #include <QDataStream>
 #include <QCryptographicHash>
+#include <QTimer>
 
 #include "restapi_server_global.h"
 
@@ -28,13 +29,26 @@
 #include "../../../../Modus/global/restapi/http_global.h"
 #include "../../../../Modus/global/restapi/entity_task_option.h"
 
+#include "../../global/sv_http_worker_pool.h"
+#include "../../global/sv_signal_snapshot.h"
+#include "../../../global/sv_realtime.h"
+
 #include "restapi_server_defs.h"
+#include "sv_restapi_worker.h"
 
 #define M_SIGNAL_ID_NOT_FOUND       "{\"value\":\"get Сигнал с id %1 в конфигурации не найден\"},"
 #define M_SIGNAL_NAME_NOT_FOUND     "{\"value\":\"get Сигнал '%1' в конфигурации не найден\"},"
 #define M_SIGNAL_NOT_SUITABLE_TYPE  "{\"value\":\"Нельзя изменить значение сигнала с id %1. " \
                                     "Могут быть изменены только сигналы с вариантом использования OUT и VAR\"},"
 
+// ошибки пакетной записи. возвращаются вместе с номером элемента в запросе
+#define M_WRITE_ID_NOT_FOUND        "Сигнал с id %1 в конфигурации не найден"
+#define M_WRITE_NAME_NOT_FOUND      "Сигнал '%1' в конфигурации не найден"
+#define M_WRITE_NOT_SUITABLE_TYPE   "Нельзя изменить значение сигнала с id %1. " \
+                                    "Могут быть изменены только сигналы с вариантом использования OUT и VAR"
+#define M_WRITE_INVALID_ITEM        "Элемент должен содержать id или name и значение value"
+#define M_WRITE_TYPE_MISMATCH       "Значение не соответствует типу сигнала с id %1 (%2)"
+
 extern "C" {
 
     INTERACT_SHARED_EXPORT modus::SvAbstractProvider* create();
@@ -66,43 +80,50 @@ public:
 
   bool bindSignal(modus::SvSignal* signal) override;
 
+  // после запуска списки сигналов не изменяются и могут читаться из рабочих потоков
   const QMap<int, modus::SvSignal*>*      signalsById()   const { return &m_signals_by_id;   }
   const QHash<QString, modus::SvSignal*>* signalsByName() const { return &m_signals_by_name; }
 
-private:
-  QTcpServer* m_server;
-  QList<QTcpSocket*> m_websocket_clients;
+  static QString var2str(const QVariant& value);
+  static QByteArray valueFragment(int id, const QVariant& value);
 
-  restapi::Params m_params;
+  // изменение значений сигналов. вызывается только в потоке провайдера.
+  // сначала проверяется весь пакет, затем значения применяются разом.
+  // если atomic и найдена хотя бы одна ошибка, ни одно значение не изменяется
+  QByteArray setSignalValues(const QList<restapi::WriteItem>& items, bool atomic, QJsonArray errors = QJsonArray());
 
-  QMap<int, modus::SvSignal*>      m_signals_by_id;
-  QHash<QString, modus::SvSignal*> m_signals_by_name;
+private:
+  // приведение значения элемента к типу сигнала. false - значение не подходит
+  static bool castValue(const restapi::WriteItem& item, const QVariant& current, QVariant& value);
 
-  bool m_is_active;
-  bool m_is_websocket = false;
+  // прием соединений, запросы обрабатываются в рабочих потоках
+  httpsrv::SvWorkerPool* m_server;
 
-  QByteArray reply_http_get(const http::HttpRequest &request);
-  QByteArray reply_http_get_params(const http::HttpRequest &request);
-  QByteArray reply_http_post(const http::HttpRequest &request);
-  QByteArray reply_ws_get(const http::HttpRequest &request);
+  // значения сигналов для рабочих потоков
+  httpsrv::SvSignalSnapshot m_snapshot;
+  QTimer* m_snapshot_timer = nullptr;
 
-  QByteArray getEntityData(const QString& entity, const QString& task, const QString& option, const QString& data, const char separator = ',');
+  // кэш статических файлов, общий для рабочих потоков
+  httpsrv::SvStaticCache* m_cache = nullptr;
 
-  QByteArray getSignalsData(const QString& task, const QString& option, const QString& data, const char separator = ',');
-  QByteArray getSignalsValues(const QString& option, const QString& data, const char separator = ',');
+  restapi::Params m_params;
 
-  QByteArray getConfigurationData(const QString& task, const QString& option, const QString& data, const char separator = ',');
+  // привязка потока провайдера к ядрам и приоритет
+  rt::Params m_realtime;
 
-  QByteArray getHttpError(int errorCode, QString errorString);
+  QMap<int, modus::SvSignal*>      m_signals_by_id;
+  QHash<QString, modus::SvSignal*> m_signals_by_name;
+
+  bool m_is_active;
 
-  QByteArray setSignalValues(const QJsonObject& jo);
 //  QByteArray setEventlog(const QJsonObject& jo);
 
+signals:
+  void snapshotUpdated(httpsrv::SignalSnapshot snapshot);
+
 private slots:
-  void newConnection();
-  void processHttpRequest();
-  void processWebSocketRequest();
-  void socketDisconnected();
+  void updateSnapshot();
+  void workerMessage(const QString& text, int level, int type);
 
 };
 
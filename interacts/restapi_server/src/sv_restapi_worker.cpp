@@ -0,0 +1,1177 @@
+#include "sv_restapi_worker.h"
+#include "sv_restapi_server.h"
+
+#include <string.h>
+
+/** ********** SvRestWorker ************ **/
+
+restapi::SvRestWorker::SvRestWorker(restapi::SvRestAPI* provider, const restapi::Params& params,
+                                    httpsrv::SvSignalSnapshot* snapshot, httpsrv::SvStaticCache* cache):
+  httpsrv::SvConnectionHandler(),
+  m_provider(provider),
+  m_params(params),
+  m_snapshot(snapshot),
+  m_cache(cache),
+  m_latency(latency::lsPublish)
+{
+
+}
+
+void restapi::SvRestWorker::newConnection(QTcpSocket* socket)
+{
+  connect(socket, &QTcpSocket::readyRead, this, &restapi::SvRestWorker::processHttpRequest);
+}
+
+void restapi::SvRestWorker::connectionClosed(QTcpSocket* socket)
+{
+  m_http_rx.remove(socket);
+
+  ws::Client* client = m_ws_clients.take(socket);
+
+  if(client)
+    delete client;
+
+}
+
+void restapi::SvRestWorker::shutdown()
+{
+  foreach (ws::Client* client, m_ws_clients) {
+
+    client->socket->write(ws::makeCloseFrame(ws::CloseGoingAway));
+    client->socket->flush();
+
+  }
+
+  httpsrv::SvConnectionHandler::shutdown();
+
+}
+
+void restapi::SvRestWorker::processHttpRequest()
+{
+  QTcpSocket *client = qobject_cast<QTcpSocket *>(sender());
+
+//    QTextStream serialized(client);
+//    serialized.readAll();
+
+  // запрос может прийти несколькими сегментами (большие пакеты записи).
+  // разбор начинается, когда получены заголовок и тело целиком
+  QByteArray& rx = m_http_rx[client];
+  rx.append(client->readAll());
+
+  int header_end = rx.indexOf("\r\n\r\n");
+  qint64 length  = header_end < 0 ? 0
+                                  : httpsrv::SvStaticCache::headerField(rx.left(header_end).split('\n'), "Content-Length").toLongLong();
+
+  if(rx.size() > HTTP_MAX_REQUEST_SIZE || length > HTTP_MAX_REQUEST_SIZE) {
+
+    m_http_rx.remove(client);
+    writeAndClose(client, getHttpError(413, QString("Размер запроса превышает %1 байт").arg(HTTP_MAX_REQUEST_SIZE)));
+
+    return;
+
+  }
+
+  if(header_end < 0 || rx.size() - header_end - 4 < length)
+    return;
+
+  // байты после запроса - начало потока кадров, если это запрос на установку WebSocket
+  QByteArray rest = m_http_rx.value(client).mid(header_end + 4 + int(length));
+  QByteArray req  = m_http_rx.take(client).left(header_end + 4 + int(length));
+
+  emit message(QString(req), sv::log::llDebug, sv::log::mtRequest);
+
+  http::HttpRequest request = http::HttpRequest::parse(req);
+
+  // если клиент запрашивает изменение протокола на WebSocket, то отвечаем на запрос http, меняем обработчик и НЕ закрываем сокет
+  if(request.fields.contains("upgrade") && request.fields.value("upgrade").toLower() == "websocket")
+  {
+    if(request.method != "GET" || !request.fields.contains("sec-websocket-key")) {
+
+      client->write(getHttpError(400, QString("Некорректный запрос на установку WebSocket соединения")));
+      client->flush();
+      client->close();
+
+      return;
+
+    }
+
+    client->write(reply_ws_get(request));
+
+    disconnect(client, &QTcpSocket::readyRead, this, &restapi::SvRestWorker::processHttpRequest);
+    connect(client, &QTcpSocket::readyRead, this, &restapi::SvRestWorker::processWebSocketRequest);
+    connect(client, &QTcpSocket::bytesWritten, this, &restapi::SvRestWorker::wsBytesWritten);
+
+    ws::Client* ws_client = new ws::Client(client);
+    m_ws_clients.insert(client, ws_client);
+
+    emit message(QString("WebSocket клиент %1:%2 подключен")
+                 .arg(client->peerAddress().toString()).arg(client->peerPort()), sv::log::llDebug, sv::log::mtConnection);
+
+    // кадры, пришедшие вместе с запросом
+    if(!rest.isEmpty()) {
+
+      ws_client->rx = rest;
+      wsReceive(ws_client);
+
+    }
+
+  }
+  else {
+
+    if(request.method == "GET") {
+
+      if(request.resourse == METRICS_RESOURCE)
+        client->write(metricsReply());
+
+      else if(request.resourse == LATENCY_RESOURCE)
+        client->write(jsonReply(latency::report()));
+
+      // соединение закрывает reply_http_get: большой файл передается асинхронно
+      else if(request.params.isEmpty()) {
+
+        reply_http_get(client, request);
+        return;
+
+      }
+
+      else
+        client->write(reply_http_get_params(request));
+
+    }
+
+    else if (request.method == "POST") {
+
+      // ответ будет отправлен после применения значений в потоке провайдера
+      reply_http_post(client, request);
+
+      return;
+
+    }
+
+    client->flush(); // waitForBytesWritten(); //
+
+    // нужно закрыть сокет
+    client->close();
+
+  }
+}
+
+void restapi::SvRestWorker::processWebSocketRequest()
+{
+  QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+
+  ws::Client* client = m_ws_clients.value(socket);
+  if(!client)
+    return;
+
+  client->rx.append(socket->readAll());
+
+  wsReceive(client);
+
+}
+
+void restapi::SvRestWorker::wsBytesWritten()
+{
+  QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+
+  ws::Client* client = m_ws_clients.value(socket);
+
+  // отправка повторяется, только если была пропущена: иначе pending пуст до следующего снимка
+  if(!client || client->closing || !client->skipped || socket->bytesToWrite() > m_params.ws_max_buffer)
+    return;
+
+  wsFlush(client, m_snapshot->current());
+
+}
+
+void restapi::SvRestWorker::wsReceive(ws::Client* client)
+{
+  // в буфере может оказаться несколько кадров, или кадр может быть принят не полностью
+  while(!client->closing) {
+
+    ws::Frame frame;
+    int result = ws::parseFrame(client->rx, frame);
+
+    if(result == ws::Incomplete)
+      break;
+
+    if(result == ws::ProtocolError) {
+
+      wsClose(client, ws::CloseProtocolError, QString("Ошибка протокола WebSocket"));
+      return;
+
+    }
+
+    if(result == ws::TooBig) {
+
+      wsClose(client, ws::CloseTooBig, QString("Превышен допустимый размер сообщения"));
+      return;
+
+    }
+
+    client->rx.remove(0, result);
+
+    if(!wsProcessFrame(client, frame))
+      return;
+
+  }
+}
+
+bool restapi::SvRestWorker::wsProcessFrame(ws::Client* client, ws::Frame& frame)
+{
+  switch (frame.opcode) {
+
+    case ws::Ping:
+
+      client->socket->write(ws::makeFrame(ws::Pong, frame.payload));
+      return true;
+
+    case ws::Pong:
+      return true;
+
+    case ws::Close:
+
+      // отвечаем тем же кодом и закрываем соединение
+      client->closing = true;
+      client->socket->write(ws::makeFrame(ws::Close, frame.payload.left(2)));
+      client->socket->disconnectFromHost();
+
+      return false;
+
+    case ws::Continuation:
+
+      if(client->message_opcode == ws::Continuation) {
+
+        wsClose(client, ws::CloseProtocolError, QString("Неожиданный кадр продолжения"));
+        return false;
+
+      }
+
+      break;
+
+    case ws::Text:
+    case ws::Binary:
+
+      if(client->message_opcode != ws::Continuation) {
+
+        wsClose(client, ws::CloseProtocolError, QString("Ожидался кадр продолжения"));
+        return false;
+
+      }
+
+      client->message_opcode = frame.opcode;
+      client->message.clear();
+
+      break;
+
+    default:
+
+      wsClose(client, ws::CloseProtocolError, QString("Неизвестный код операции %1").arg(frame.opcode));
+      return false;
+
+  }
+
+  if(client->message.size() + frame.payload.size() > WS_MAX_MESSAGE_SIZE) {
+
+    wsClose(client, ws::CloseTooBig, QString("Превышен допустимый размер сообщения"));
+    return false;
+
+  }
+
+  client->message.append(frame.payload);
+
+  if(!frame.fin)
+    return true;
+
+  quint8 opcode = client->message_opcode;
+  client->message_opcode = ws::Continuation;
+
+  if(opcode == ws::Text)
+    wsProcessCommand(client, client->message);
+
+  else
+    emit message(QString("WebSocket: двоичные сообщения не поддерживаются"), sv::log::llDebug, sv::log::mtError);
+
+  client->message.clear();
+
+  return true;
+
+}
+
+void restapi::SvRestWorker::wsProcessCommand(ws::Client* client, const QByteArray& text)
+{
+  emit message(QString(text), sv::log::llDebug, sv::log::mtRequest);
+
+  QJsonParseError per;
+  QJsonDocument jd = QJsonDocument::fromJson(text, &per);
+
+  if(per.error != QJsonParseError::NoError || !jd.isObject()) {
+
+    client->socket->write(ws::makeFrame(ws::Text, QString("{\"errors\":[{\"value\":\"Некорректная команда: %1\"}]}")
+                                        .arg(per.errorString()).toUtf8()));
+    return;
+
+  }
+
+  QJsonObject jo = jd.object();
+
+  bool subscribe = jo.contains(P_WS_SUBSCRIBE);
+  QString P = subscribe ? P_WS_SUBSCRIBE : P_WS_UNSUBSCRIBE;
+
+  if(!jo.value(P).isObject()) {
+
+    client->socket->write(ws::makeFrame(ws::Text, QString("{\"errors\":[{\"value\":\"Ожидалась команда '%1' или '%2'\"}]}")
+                                        .arg(P_WS_SUBSCRIBE).arg(P_WS_UNSUBSCRIBE).toUtf8()));
+    return;
+
+  }
+
+  QJsonObject jlist = jo.value(P).toObject();
+
+  QList<int> ids;
+  QByteArray errors;
+
+  for(QJsonValue v: jlist.value(P_WS_IDS).toArray()) {
+
+    int id = v.toInt(-1);
+
+    if(m_provider->signalsById()->contains(id))
+      ids.append(id);
+
+    else
+      errors.append(QString(M_SIGNAL_ID_NOT_FOUND).arg(id));
+
+  }
+
+  for(QJsonValue v: jlist.value(P_WS_NAMES).toArray()) {
+
+    modus::SvSignal* signal = m_provider->signalsByName()->value(v.toString());
+
+    if(signal)
+      ids.append(signal->config()->id);
+
+    else
+      errors.append(QString(M_SIGNAL_NAME_NOT_FOUND).arg(v.toString()));
+
+  }
+
+  for(QJsonValue v: jlist.value(P_WS_GROUP_LIST).toArray()) {
+
+    if(!m_params.ws_groups.contains(v.toString())) {
+
+      errors.append(QString("{\"value\":\"Группа '%1' в конфигурации не найдена\"},").arg(v.toString()));
+      continue;
+
+    }
+
+    for(int id: m_params.ws_groups.value(v.toString())) {
+
+      if(m_provider->signalsById()->contains(id))
+        ids.append(id);
+
+      else
+        errors.append(QString(M_SIGNAL_ID_NOT_FOUND).arg(id));
+
+    }
+  }
+
+  if(subscribe)
+    wsSubscribe(client, ids);
+
+  else
+    wsUnsubscribe(client, ids);
+
+  QByteArray reply;
+  reply.append(QString("{\"%1\":%2").arg(subscribe ? P_WS_SUBSCRIBE : P_WS_UNSUBSCRIBE).arg(client->subscriptions.count()));
+
+  if(errors.endsWith(',')) errors.chop(1);
+  if(!errors.isEmpty())
+    reply.append(",\"errors\":[").append(errors).append(']');
+
+  reply.append('}');
+
+  client->socket->write(ws::makeFrame(ws::Text, reply));
+
+}
+
+void restapi::SvRestWorker::wsSubscribe(ws::Client* client, const QList<int>& ids)
+{
+  for(int id: ids) {
+
+    if(client->subscriptions.contains(id))
+      continue;
+
+    client->subscriptions.insert(id);
+
+    // текущие значения отправляем сразу, не дожидаясь изменений
+    client->pending.insert(id);
+
+  }
+
+  wsFlush(client, m_snapshot->current());
+
+}
+
+void restapi::SvRestWorker::wsUnsubscribe(ws::Client* client, const QList<int>& ids)
+{
+  for(int id: ids) {
+
+    client->subscriptions.remove(id);
+    client->pending.remove(id);
+
+  }
+}
+
+void restapi::SvRestWorker::wsClose(ws::Client* client, quint16 code, const QString& reason)
+{
+  emit message(QString("WebSocket клиент %1:%2 отключен: %3")
+               .arg(client->socket->peerAddress().toString()).arg(client->socket->peerPort()).arg(reason),
+               sv::log::llDebug, sv::log::mtConnection);
+
+  client->closing = true;
+  client->socket->write(ws::makeCloseFrame(code, reason.toUtf8()));
+  client->socket->disconnectFromHost();
+
+}
+
+void restapi::SvRestWorker::snapshotUpdated(httpsrv::SignalSnapshot snapshot)
+{
+  if(m_ws_clients.isEmpty() || !snapshot)
+    return;
+
+  foreach (ws::Client* client, m_ws_clients) {
+
+    if(client->closing)
+      continue;
+
+    for(int id: snapshot->changed)
+      if(client->subscriptions.contains(id))
+        client->pending.insert(id);
+
+    wsFlush(client, snapshot);
+
+  }
+}
+
+void restapi::SvRestWorker::wsFlush(ws::Client* client, const httpsrv::SignalSnapshot& snapshot)
+{
+  if(client->pending.isEmpty() || !snapshot)
+    return;
+
+  // клиент не успевает забирать данные. изменения продолжают накапливаться в pending,
+  // при этом в pending остается только последнее значение каждого сигнала
+  if(client->socket->bytesToWrite() > m_params.ws_max_buffer) {
+
+    if(client->skipped++ == 0)
+      emit message(QString("WebSocket клиент %1:%2 не успевает принимать данные")
+                   .arg(client->socket->peerAddress().toString()).arg(client->socket->peerPort()),
+                   sv::log::llDebug, sv::log::mtError);
+
+    if(m_params.ws_drop_policy == dpClose)
+      wsClose(client, ws::ClosePolicy, QString("Превышен объем неотправленных данных"));
+
+    return;
+
+  }
+
+  // значения сериализованы при формировании снимка, здесь только сборка сообщения
+  QByteArray payload;
+  payload.reserve(client->pending.count() * 32 + 16);
+  payload.append("{\"values\":[");
+
+  foreach (int id, client->pending)
+    payload.append(snapshot->fragments.value(id)).append(',');
+
+  payload.chop(1);
+  payload.append("]}");
+
+  // клиент снова принимает данные. пропущенные значения уходят этим сообщением
+  if(client->skipped) {
+
+    emit message(QString("WebSocket клиент %1:%2 принимает данные, пропущено отправок: %3")
+                 .arg(client->socket->peerAddress().toString()).arg(client->socket->peerPort()).arg(client->skipped),
+                 sv::log::llDebug, sv::log::mtInfo);
+
+    client->skipped = 0;
+
+  }
+
+  client->socket->write(ws::frameHeader(ws::Text, quint64(payload.size())));
+  client->socket->write(payload);
+
+  // задержка от приема данных до отправки значения первому клиенту
+  foreach (int id, client->pending)
+    m_latency.record(id);
+
+  client->pending.clear();
+
+}
+
+void restapi::SvRestWorker::reply_http_get(QTcpSocket* client, const http::HttpRequest &request)
+{
+  httpsrv::StaticReply reply = m_cache->get(request.resourse,
+                                            request.fields.value("if-none-match"),
+                                            request.fields.value("accept-encoding"));
+
+  if(reply.status == 404 || reply.status == 500)
+    writeAndClose(client, getHttpError(reply.status, reply.error));
+
+  else if(!httpsrv::SvStaticCache::send(client, reply))
+    emit message(QString("Ошибка при передаче файла %1: %2").arg(request.resourse).arg(client->errorString()),
+                 sv::log::llError, sv::log::mtError);
+
+}
+
+QByteArray restapi::SvRestWorker::reply_http_get_params(const http::HttpRequest &request)
+{
+  auto getErr = [=](int errorCode, QString errorString) -> QByteArray {
+
+    emit message(errorString, sv::log::llError, sv::log::mtError);
+
+//      if(m_logger)
+//        *m_logger <<llError << mtError << errorString << sv::log::endl;
+
+      return QByteArray()
+                        .append(QString("HTTP/1.1 %1 Error" \
+                                "Content-Type: text/html; charset=\"utf-8\"\r\n\r\n"
+                                "<html>"
+                                "<head><meta charset=\"UTF-8\"><title>Ошибка</title><head>"
+                                "<body>"
+                                "<p style=\"font-size: 16\">%2</p>"
+                                "<a href=\"index.html\" style=\"font-size: 14\">На главную</a>"
+                                "<p>%3</p>"
+                                "</body></html>\n")
+                                    .arg(errorCode)
+                                    .arg(errorString)
+                                    .arg(QDateTime::currentDateTime().toString())
+                                .toUtf8());
+  };
+
+  QStringList get_params = QString(request.params).split('&', QString::SplitBehavior::SkipEmptyParts);
+
+  if(get_params.count() == 0)
+    return getErr(404, QString("Неверный запрос"));
+
+  QString entity  = "";
+  QString task    = "";
+  QString option  = "";
+  QString data    = "";
+
+  for(QString param: get_params) {
+
+    if(param.indexOf('=') < 1)
+      return getErr(404, QString("Неверный запрос. Неопределенный параметр %1").arg(param));
+
+    QString field = param.left(param.indexOf('='));
+    QString tag   = param.right(param.length() - param.indexOf('=') - 1);
+
+    if(field.toLower().trimmed() == "entity")
+      entity = tag;
+
+    else if(field.toLower().trimmed() == "task")
+      task = tag;
+
+    else if(field.toLower().trimmed() == "option")
+      option = tag;
+
+    else if(field.toLower().trimmed() == "data")
+      data = tag;
+
+  }
+
+  QByteArray json = getEntityData(entity, task, option, data);
+
+/*  QString entity_param = QString(get_params.at(0));
+
+
+  if(!RestGetFieldsMap.contains(tag))
+    return getErr(404, QString("Неизвестный параметр запроса '%1'").arg(tag));
+
+  if(RestGetFieldsMap.value(tag) != RestGetFields::entity)
+    return getErr(404, QString("Неверный запрос. Ожидалось поле 'entity'. Получено '%1'").arg(tag));
+
+  if(!RestGetEntitiesMap.contains(entity))
+    return getErr(404, QString("Неверный запрос. Неизвестная сущность '%1'").arg(entity));
+
+  get_params.pop_front();
+  QString json = ""; // формируем ответ в формате JSON
+
+  switch (RestGetEntitiesMap.value(entity)) {
+
+    case RestGetEntities::signal:
+
+      json = processEntitySignal(get_params);
+
+      break;
+
+    case RestGetEntities::device:
+
+      break;
+
+    case RestGetEntities::storage:
+
+      break;
+
+    case RestGetEntities::analize:
+
+      break;
+
+    case RestGetEntities::configuration:
+
+      break;
+
+  }
+
+
+  for(QString query: get_params) {
+
+    if(query.indexOf('=') < 1)
+      continue;
+
+    QString query_field = query.left(query.indexOf('='));
+    QString query_data  = query.right(query.length() - query.indexOf('=') - 1);
+
+    if(!RestGetEntitiesMap.contains(query_field))
+      continue;
+
+    switch (RestGetEntitiesMap.value(query_field)) {
+    case RestGetEntities::signal:
+
+      json = handle_signal_request();
+
+      break;
+    default:
+      break;
+    }
+
+    if(query_field == "names")
+    {
+
+      QStringList names = query_data.split(',');
+
+      for(QString name: names)
+      {
+        if(name.trimmed().isEmpty())
+          continue;
+
+        if(signalsByName()->contains(name))
+          json.append(QString("{\"name\":\"%1\",\"value\":\"%2\"},")
+                        .arg(name).arg(Var2Str(signalsByName()->value(name)->value())));
+
+      }
+
+
+      if(!json.isEmpty()) json.chop(1);
+
+
+    }
+
+    else if(query_field == "ids")
+    {
+      QStringList ids = query_data.split(',');
+
+      for(QString curid: ids)
+      {
+        if(curid.trimmed().isEmpty())
+          continue;
+
+        bool ok;
+        int id = curid.toInt(&ok);
+
+        if(ok && signalsById()->contains(id))
+          json.append(QString("{\"id\":\"%1\",\"value\":\"%2\"},")
+                        .arg(id).arg(Var2Str(signalsById()->value(id)->value())));
+
+      }
+
+      if(!json.isEmpty()) json.chop(1);
+
+    }
+  }
+  */
+
+  QByteArray http = QByteArray()
+                    .append("HTTP/1.0 200 Ok\r\n")
+                    .append("Content-Type: text/json; charset=\"utf-8\"\r\n")
+                    .append(QString("Content-Length: %1\r\n").arg(json.length() + 2))
+                    .append("Access-Control-Allow-Origin: *\r\n")
+                    .append("Access-Control-Allow-Headers: *\r\n")
+                    .append("Origin: file://\r\n\r\n")        //! обязательно два!
+                    .append(json).append("\r\n");
+
+//  if(m_logger && m_logger->options().log_level >= sv::log::llDebug2)
+//    *m_logger << sv::log::llDebug2 << sv::log::mtDebug << QString(http) << sv::log::endl;
+
+  emit message(QString(http), sv::log::llDebug, sv::log::mtReply);
+
+  return http;
+
+}
+
+QByteArray restapi::SvRestWorker::getEntityData(const QString& entity, const QString& task, const QString& option, const QString& data, const char separator)
+{
+  QByteArray result;
+
+  switch (restapi::eto::EntitiesTable.value(entity, restapi::eto::noentity)) {
+
+    case restapi::eto::signal:
+
+      result = getSignalsData(task, option, data, separator);
+
+      break;
+
+    case restapi::eto::configuration:
+
+      result = getConfigurationData(task, option, data, separator);
+
+      break;
+
+    default:
+      result = "Не доступно в данной версии";
+      break;
+
+  }
+
+  return result;
+
+}
+
+QByteArray restapi::SvRestWorker::getSignalsData(const QString& task, const QString& option, const QString& data, const char separator)
+{
+  QByteArray result;
+
+  switch (restapi::eto::TasksTable.value(task, restapi::eto::notask)) {
+
+    case restapi::eto::value:
+
+      result = getSignalsValues(option, data, separator);
+
+      break;
+
+    case restapi::eto::json:
+
+      result = "Не доступно в данной версии";
+      break;
+
+    default:
+      result = "Не доступно в данной версии";
+      break;
+
+  }
+
+  return result;
+
+}
+
+QByteArray restapi::SvRestWorker::getSignalsValues(const QString& option, const QString& data, const char separator)
+{
+  // все значения в ответе берутся из одного снимка
+  httpsrv::SignalSnapshot snapshot = m_snapshot->current();
+
+  if(!snapshot)
+    return QByteArray("{\"values\":[],\"errors\":[{\"value\":\"Сервер не запущен\"}]}");
+
+  QByteArray values;
+  QByteArray errors;
+
+  values.append('{')
+        .append("\"values\":[");
+  errors.append("\"errors\":[");
+
+  switch (restapi::eto::OptionsTable.value(option, restapi::eto::nooption)) {
+
+    case restapi::eto::Options::byid:
+    {
+      QList<QString> ids = data.split(QChar(separator), QString::SkipEmptyParts);
+
+      if(ids.isEmpty())
+        errors.append("{\"value\": \"Неверный запрос значений сигналов. Список идентификаторов (data) пуст.\"},");
+
+      bool ok;
+      for(QString id: ids) {
+
+        int iid = id.toInt(&ok);
+
+        if(ok) {
+
+          if(snapshot->values.contains(iid))
+            values.append(QString("{\"id\":%1,\"value\":%2},").arg(id).arg(SvRestAPI::var2str(snapshot->values.value(iid))));
+
+          else
+            errors.append(QString("{\"value\":\"Сигнал с id '%1' не найден\"},").arg(id));
+
+        }
+        else
+          errors.append(QString("{\"value\":\"Неверный id сигнала: '%1'\"},").arg(id));
+
+      }
+
+      break;
+    }
+
+    case eto::Options::byname:
+    {
+
+      QList<QString> names = data.split(QChar(separator), QString::SkipEmptyParts);
+
+      if(names.isEmpty())
+        errors.append("{\"value\": \"Неверный запрос значений сигналов. Список имен сигналов (data) пуст.\"}");
+
+      for(QString name: names) {
+
+        modus::SvSignal* signal = m_provider->signalsByName()->value(name);
+
+        if(signal)
+          values.append(QString("{\"name\":%1,\"value\":%2},").arg(name).arg(SvRestAPI::var2str(snapshot->values.value(signal->config()->id))));
+
+        else
+          errors.append(QString("{\"value\":\"Сигнал с именем '%1' не найден\"},").arg(name));
+
+
+      }
+
+      break;
+    }
+
+    default:
+      errors.append(QString("{\"value\":\"Неверный запрос. Неизвестная опция '%1'\"},").arg(option));
+      break;
+    }
+
+  if(values.endsWith(',')) values.chop(1);
+  if(errors.endsWith(',')) errors.chop(1);
+
+  errors.append(']');
+  values.append(']').append(',').append(errors).append('}');
+
+  return values;
+
+}
+
+QByteArray restapi::SvRestWorker::getHttpError(int errorCode, QString errorString)
+{
+  emit message(errorString, sv::log::llError, sv::log::mtError);
+
+  QByteArray html = QString("<html>"
+                            "<head><meta charset=\"UTF-8\"><title>Ошибка</title><head>"
+                            "<body>"
+                            "<p style=\"font-size: 16\">%1</p>"
+                            "<a href=\"index.html\" style=\"font-size: 14\">На главную</a>"
+                            "<p>%2</p>"
+                            "</body></html>\n")
+                        .arg(errorString)
+                        .arg(QDateTime::currentDateTime().toString())
+                        .toUtf8();
+
+  return QByteArray()
+          .append(QString("HTTP/1.1 %1 Error\r\n").arg(errorCode))
+          .append("Content-Type: text/html; charset=\"utf-8\"\r\n")
+          .append(QString("Content-Length: %1\r\n").arg(html.length()))
+          .append("Access-Control-Allow-Origin: *\r\n\r\n")
+          .append(html);
+
+}
+
+QByteArray restapi::SvRestWorker::getConfigurationData(const QString& task, const QString& option, const QString& data, const char separator)
+{
+  return QByteArray(QString("Not avalable yet. %1 %2 %3 %4").arg(task,option,data).arg(separator).toUtf8());
+}
+
+void restapi::SvRestWorker::reply_http_post(QTcpSocket* client, const http::HttpRequest &request)
+{
+  // двоичный пакет: последовательность записей id + тип + значение. применяется атомарно
+  if(request.fields.value("content-type").startsWith(CONTENT_TYPE_BINARY)) {
+
+    QList<restapi::WriteItem> items;
+    QString error;
+
+    if(!binaryWriteItems(request.data, items, error)) {
+
+      writeAndClose(client, getHttpError(400, QString("Некорректный запрос на обновление данных.\n%1").arg(error)));
+      return;
+
+    }
+
+    postSignalValues(client, items, true, QJsonArray());
+
+    return;
+
+  }
+
+  QJsonParseError per;
+  QJsonDocument jd = QJsonDocument::fromJson(request.data, &per); // запрос должен быть в формате JSON
+
+  if(per.error != QJsonParseError::NoError) {
+
+    writeAndClose(client, getHttpError(400, QString("Некорректный запрос на обновление данных.\n%1\n%2")
+                                       .arg(QString(request.data)).arg(per.errorString())));
+    return;
+
+  }
+
+  QJsonObject jo = jd.object();
+  if(!jo.contains(P_ENTITY) || !jo.value(P_ENTITY).isString() || !jo.contains(P_DATA) || !jo.value(P_DATA).isObject()) {
+
+    writeAndClose(client, getHttpError(400, QString("Некорректный запрос на обновление данных.\n%1\n%2")
+                                       .arg(QString(request.data)).arg(per.errorString())));
+    return;
+
+  }
+
+  if((jo.value(P_ENTITY).toString() == P_SIGNAL) || (jo.value(P_ENTITY).toString() == P_SIGNALS)) {
+
+    // разбор выполняется в потоке обработчика, в поток провайдера передается готовый пакет
+    QJsonObject data = jo.value(P_DATA).toObject();
+
+    QList<restapi::WriteItem> items;
+    QJsonArray errors;
+
+    jsonWriteItems(data.value(P_SIGNALS).toArray(), items, errors);
+
+    postSignalValues(client, items, data.value(P_ATOMIC).toBool(false), errors);
+
+  }
+//  else if(jo.value(P_ENTITY).toString() == P_EVENTLOG) {
+
+//    json = setEventlog(jo.value(P_DATA).toObject());
+
+//  }
+
+  else
+    writeAndClose(client, jsonReply(QByteArray()));
+
+}
+
+void restapi::SvRestWorker::postSignalValues(QTcpSocket* client, const QList<restapi::WriteItem>& items, bool atomic, const QJsonArray& errors)
+{
+  // значения сигналов изменяются только в потоке провайдера. ответ возвращается
+  // в поток обработчика, если к этому моменту клиент еще подключен
+  restapi::SvRestAPI*             provider = m_provider;
+  QPointer<restapi::SvRestWorker> worker(this);
+  QPointer<QTcpSocket>            socket(client);
+
+  QMetaObject::invokeMethod(provider, [provider, worker, socket, items, atomic, errors]() {
+
+    QByteArray json = provider->setSignalValues(items, atomic, errors);
+
+    if(worker)
+      QMetaObject::invokeMethod(worker, [worker, socket, json]() {
+
+        if(socket)
+          worker->writeAndClose(socket, worker->jsonReply(json));
+
+      }, Qt::QueuedConnection);
+
+  }, Qt::QueuedConnection);
+
+}
+
+void restapi::SvRestWorker::jsonWriteItems(const QJsonArray& array, QList<restapi::WriteItem>& items, QJsonArray& errors)
+{
+  items.reserve(array.count());
+
+  for(int i = 0; i < array.count(); ++i) {
+
+    QJsonObject o = array.at(i).toObject();
+
+    restapi::WriteItem item;
+    item.index = i;
+
+    if(!array.at(i).isObject() || !o.contains(P_VALUE) || o.value(P_VALUE).isNull() ||
+       !(o.value(P_ID).isDouble() || o.value(P_NAME).isString())) {
+
+      errors.append(writeError(i, M_WRITE_INVALID_ITEM));
+      continue;
+
+    }
+
+    if(o.value(P_ID).isDouble())
+      item.id = o.value(P_ID).toInt(-1);
+
+    else
+      item.name = o.value(P_NAME).toString();
+
+    item.value = o.value(P_VALUE).toVariant();
+
+    items.append(item);
+
+  }
+}
+
+bool restapi::SvRestWorker::binaryWriteItems(const QByteArray& data, QList<restapi::WriteItem>& items, QString& error)
+{
+  const uchar* d    = reinterpret_cast<const uchar*>(data.constData());
+  int          size = data.size();
+  int          pos  = 0;
+
+  while(pos < size) {
+
+    // id (4) + тип (1)
+    if(size - pos < 5) {
+
+      error = QString("Неполная запись %1 в позиции %2").arg(items.count()).arg(pos);
+      return false;
+
+    }
+
+    restapi::WriteItem item;
+    item.index = items.count();
+    item.id    = int(qFromLittleEndian<quint32>(d + pos));
+
+    quint8 type = d[pos + 4];
+    pos += 5;
+
+    item.type = type;
+
+    int length;
+    switch (type) {
+
+      case bvBool:    length = 1; break;
+      case bvInt32:
+      case bvUInt32:
+      case bvFloat:   length = 4; break;
+      case bvDouble:  length = 8; break;
+
+      default:
+        error = QString("Неизвестный тип значения %1 в записи %2").arg(type).arg(item.index);
+        return false;
+    }
+
+    if(size - pos < length) {
+
+      error = QString("Неполная запись %1 в позиции %2").arg(item.index).arg(pos - 5);
+      return false;
+
+    }
+
+    switch (type) {
+
+      case bvBool:
+        item.value = QVariant(d[pos] != 0);
+        break;
+
+      case bvInt32:
+        item.value = QVariant(qFromLittleEndian<qint32>(d + pos));
+        break;
+
+      case bvUInt32:
+        item.value = QVariant(qFromLittleEndian<quint32>(d + pos));
+        break;
+
+      case bvFloat:
+      {
+        quint32 raw = qFromLittleEndian<quint32>(d + pos);
+        float   f;
+        memcpy(&f, &raw, sizeof(f));
+
+        item.value = QVariant(f);
+        break;
+      }
+
+      case bvDouble:
+      {
+        quint64 raw = qFromLittleEndian<quint64>(d + pos);
+        double  v;
+        memcpy(&v, &raw, sizeof(v));
+
+        item.value = QVariant(v);
+        break;
+      }
+    }
+
+    pos += length;
+    items.append(item);
+
+  }
+
+  return true;
+
+}
+
+QByteArray restapi::SvRestWorker::jsonReply(const QByteArray& json)
+{
+  QByteArray http = QByteArray()
+                    .append("HTTP/1.0 200 Ok\r\n")
+                    .append("Content-Type: text/json; charset=\"utf-8\"\r\n")
+                    .append(QString("Content-Length: %1\r\n").arg(json.length() + 2))
+                    .append("Access-Control-Allow-Origin: *\r\n")
+                    .append("Access-Control-Allow-Headers: *\r\n")
+                    .append("Origin: file://\r\n\r\n")        //! обязательно два!
+                    .append(json).append("\r\n");
+
+  emit message(QString(http), sv::log::llDebug, sv::log::mtReply);
+
+  return http;
+
+}
+
+QByteArray restapi::SvRestWorker::metricsReply()
+{
+  // текст формируется при каждом запросе из общего сегмента метрик процесса
+  QByteArray text = metrics::SvMetrics::instance()->exposition();
+
+  return QByteArray()
+            .append("HTTP/1.0 200 Ok\r\n")
+            .append("Content-Type: " CONTENT_TYPE_METRICS "\r\n")
+            .append(QString("Content-Length: %1\r\n").arg(text.length()))
+            .append("Cache-Control: no-cache\r\n\r\n")
+            .append(text);
+
+}
+
+void restapi::SvRestWorker::writeAndClose(QTcpSocket* client, const QByteArray& reply)
+{
+  client->write(reply);
+  client->flush();
+
+  // нужно закрыть сокет
+  client->close();
+
+}
+
+QByteArray restapi::SvRestWorker::reply_ws_get(const http::HttpRequest &request)
+{
+  auto getErr = [=](int errorCode, QString errorString) -> QByteArray {
+
+    emit message(errorString, sv::log::llError, sv::log::mtError);
+
+//      if(m_logger)
+//        *m_logger <<llError << mtError << errorString << sv::log::endl;
+
+      return QByteArray()
+                        .append(QString("HTTP/1.1 %1 Error" \
+                                "Content-Type: text/html; charset=\"utf-8\"\r\n\r\n"
+                                "<html>"
+                                "<head><meta charset=\"UTF-8\"><title>Ошибка</title><head>"
+                                "<body>"
+                                "<p style=\"font-size: 16\">%2</p>"
+                                "<a href=\"index.html\" style=\"font-size: 14\">На главную</a>"
+                                "<p>%3</p>"
+                                "</body></html>\n")
+                                    .arg(errorCode)
+                                    .arg(errorString)
+                                    .arg(QDateTime::currentDateTime().toString())
+                                .toUtf8());
+  };
+
+  QByteArray replay = QByteArray();
+
+  replay.append(QString("%1/%2 101 Switching Protocols\r\n").arg(QString(request.protocol)).arg(QString(request.version)));
+//  replay.append(QString("Date: Wed, %1\r\n").arg(QDateTime::currentDateTimeUtc().toString("dd MMM yyyy hh:mm:ss t")));
+  replay.append(QString("Upgrade: websocket\r\n"));
+  replay.append(QString("Connection: Upgrade\r\n"));
+
+  if(request.fields.contains("sec-websocket-key")) {
+
+    QString key = request.fields.value("sec-websocket-key").trimmed();
+    key.append(WS_GUID);
+
+    QByteArray hash64 = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toBase64();
+
+    replay.append(QString("Sec-WebSocket-Accept: %1\r\n\r\n").arg(QString(hash64)));
+
+  }
+
+  return replay;
+
+}
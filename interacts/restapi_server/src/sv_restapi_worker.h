@@ -0,0 +1,109 @@
+#ifndef SV_RESTAPI_WORKER_H
+#define SV_RESTAPI_WORKER_H
+
+#include <QTcpSocket>
+#include <QPointer>
+#include <QHash>
+#include <QDateTime>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QtEndian>
+
+#include "../../../../Modus/global/global_defs.h"
+#include "../../../../Modus/global/restapi/http_global.h"
+#include "../../../../Modus/global/restapi/entity_task_option.h"
+
+#include "../../global/sv_http_worker_pool.h"
+#include "../../global/sv_signal_snapshot.h"
+#include "../../global/sv_static_cache.h"
+
+#include "../../../global/sv_metrics.h"
+#include "../../../global/sv_latency.h"
+
+#include "restapi_server_defs.h"
+#include "sv_websocket.h"
+
+namespace restapi {
+
+  class SvRestAPI;
+  class SvRestWorker;
+
+}
+
+/** обработчик запросов. работает в собственном потоке пула **/
+class restapi::SvRestWorker: public httpsrv::SvConnectionHandler
+{
+  Q_OBJECT
+
+public:
+  explicit SvRestWorker(restapi::SvRestAPI* provider, const restapi::Params& params,
+                        httpsrv::SvSignalSnapshot* snapshot, httpsrv::SvStaticCache* cache);
+
+public slots:
+  void shutdown() override;
+
+  // рассылка изменившихся значений подписанным WebSocket клиентам
+  void snapshotUpdated(httpsrv::SignalSnapshot snapshot);
+
+protected:
+  void newConnection(QTcpSocket* socket) override;
+  void connectionClosed(QTcpSocket* socket) override;
+
+private:
+  restapi::SvRestAPI*         m_provider;
+  restapi::Params             m_params;
+  httpsrv::SvSignalSnapshot*  m_snapshot;
+  httpsrv::SvStaticCache*     m_cache;
+
+  // задержка публикации значений WebSocket клиентам
+  latency::Consumer           m_latency;
+
+  // подключенные к данному обработчику WebSocket клиенты
+  QHash<QTcpSocket*, ws::Client*> m_ws_clients;
+
+  // незавершенные http запросы
+  QHash<QTcpSocket*, QByteArray>  m_http_rx;
+
+  void       reply_http_get(QTcpSocket* client, const http::HttpRequest &request);
+  QByteArray reply_http_get_params(const http::HttpRequest &request);
+  void       reply_http_post(QTcpSocket* client, const http::HttpRequest &request);
+
+  // пакетная запись: разбор запроса в потоке обработчика, применение в потоке провайдера
+  void postSignalValues(QTcpSocket* client, const QList<restapi::WriteItem>& items, bool atomic, const QJsonArray& errors);
+  static void jsonWriteItems(const QJsonArray& array, QList<restapi::WriteItem>& items, QJsonArray& errors);
+  static bool binaryWriteItems(const QByteArray& data, QList<restapi::WriteItem>& items, QString& error);
+  QByteArray reply_ws_get(const http::HttpRequest &request);
+
+  QByteArray getEntityData(const QString& entity, const QString& task, const QString& option, const QString& data, const char separator = ',');
+
+  QByteArray getSignalsData(const QString& task, const QString& option, const QString& data, const char separator = ',');
+  QByteArray getSignalsValues(const QString& option, const QString& data, const char separator = ',');
+
+  QByteArray getConfigurationData(const QString& task, const QString& option, const QString& data, const char separator = ',');
+
+  QByteArray getHttpError(int errorCode, QString errorString);
+  QByteArray jsonReply(const QByteArray& json);
+  QByteArray metricsReply();
+
+  void writeAndClose(QTcpSocket* client, const QByteArray& reply);
+
+  void wsReceive(ws::Client* client);
+  bool wsProcessFrame(ws::Client* client, ws::Frame& frame);
+  void wsProcessCommand(ws::Client* client, const QByteArray& text);
+  void wsSubscribe(ws::Client* client, const QList<int>& ids);
+  void wsUnsubscribe(ws::Client* client, const QList<int>& ids);
+  void wsClose(ws::Client* client, quint16 code, const QString& reason);
+  void wsFlush(ws::Client* client, const httpsrv::SignalSnapshot& snapshot);
+
+private slots:
+  void processHttpRequest();
+  void processWebSocketRequest();
+
+  // буфер сокета освободился - отправка значений, пропущенных при переполнении
+  void wsBytesWritten();
+
+};
+
+#endif // SV_RESTAPI_WORKER_H
@@ -0,0 +1,115 @@
+#include "sv_websocket.h"
+
+int restapi::ws::parseFrame(const QByteArray& buffer, Frame& frame, int max_payload)
+{
+  const int size = buffer.size();
+
+  if(size < 2)
+    return Incomplete;
+
+  const uchar* b = reinterpret_cast<const uchar*>(buffer.constData());
+
+  // RSV1-3 должны быть нулевыми, т.к. расширения не согласовывались
+  if(b[0] & 0x70)
+    return ProtocolError;
+
+  frame.fin    = b[0] & 0x80;
+  frame.opcode = b[0] & 0x0F;
+
+  bool    masked = b[1] & 0x80;
+  quint64 length = b[1] & 0x7F;
+  int     pos    = 2;
+
+  if(length == 126) {
+
+    if(size < 4)
+      return Incomplete;
+
+    length = (quint64(b[2]) << 8) | quint64(b[3]);
+    pos = 4;
+
+  }
+  else if(length == 127) {
+
+    if(size < 10)
+      return Incomplete;
+
+    length = 0;
+    for(int i = 0; i < 8; ++i)
+      length = (length << 8) | quint64(b[2 + i]);
+
+    pos = 10;
+
+  }
+
+  // управляющие кадры не фрагментируются и несут не более 125 байт
+  if((frame.opcode & 0x08) && (length > 125 || !frame.fin))
+    return ProtocolError;
+
+  // кадры клиента всегда маскированы (RFC 6455, 5.1)
+  if(!masked)
+    return ProtocolError;
+
+  if(length > quint64(max_payload))
+    return TooBig;
+
+  if(quint64(size) < pos + 4 + length)
+    return Incomplete;
+
+  const uchar* mask = b + pos;
+  pos += 4;
+
+  frame.payload.resize(int(length));
+  char* p = frame.payload.data();
+
+  for(int i = 0; i < int(length); ++i)
+    p[i] = char(b[pos + i] ^ mask[i & 3]);
+
+  return pos + int(length);
+
+}
+
+QByteArray restapi::ws::frameHeader(quint8 opcode, quint64 length, bool fin)
+{
+  QByteArray header;
+  header.reserve(10);
+
+  header.append(char((fin ? 0x80 : 0x00) | (opcode & 0x0F)));
+
+  if(length < 126)
+    header.append(char(length));
+
+  else if(length <= 0xFFFF) {
+
+    header.append(char(126));
+    header.append(char((length >> 8) & 0xFF));
+    header.append(char(length & 0xFF));
+
+  }
+  else {
+
+    header.append(char(127));
+    for(int i = 7; i >= 0; --i)
+      header.append(char((length >> (8 * i)) & 0xFF));
+
+  }
+
+  return header;
+
+}
+
+QByteArray restapi::ws::makeFrame(quint8 opcode, const QByteArray& payload, bool fin)
+{
+  return frameHeader(opcode, quint64(payload.size()), fin).append(payload);
+}
+
+QByteArray restapi::ws::makeCloseFrame(quint16 code, const QByteArray& reason)
+{
+  QByteArray payload;
+  payload.append(char((code >> 8) & 0xFF));
+  payload.append(char(code & 0xFF));
+  payload.append(reason.left(123));
+
+  return makeFrame(Close, payload);
+
+}
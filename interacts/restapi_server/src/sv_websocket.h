@@ -0,0 +1,97 @@
+/**********************************************************************
+ *  кодирование и разбор кадров WebSocket (RFC 6455), а также
+ *  состояние подключенного WebSocket клиента.
+ *
+ *  клиент обязан маскировать свои кадры, сервер кадры не маскирует.
+ *  расширения (RSV биты) не поддерживаются.
+ * *********************************************************************/
+
+#ifndef SV_WEBSOCKET_H
+#define SV_WEBSOCKET_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QSet>
+#include <QTcpSocket>
+
+#define WS_GUID               "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+// максимальный размер сообщения от клиента. клиенты присылают только команды подписки
+#define WS_MAX_MESSAGE_SIZE   65536
+
+namespace restapi {
+
+  namespace ws {
+
+    enum OpCode {
+      Continuation  = 0x0,
+      Text          = 0x1,
+      Binary        = 0x2,
+      Close         = 0x8,
+      Ping          = 0x9,
+      Pong          = 0xA
+    };
+
+    enum CloseCode {
+      CloseNormal         = 1000,
+      CloseGoingAway      = 1001,
+      CloseProtocolError  = 1002,
+      CloseUnsupported    = 1003,
+      ClosePolicy         = 1008,
+      CloseTooBig         = 1009
+    };
+
+    // результат разбора кадра, если кадр разобран, то возвращается кол-во израсходованных байт
+    enum ParseResult {
+      Incomplete    =  0,
+      ProtocolError = -1,
+      TooBig        = -2
+    };
+
+    struct Frame {
+
+      bool        fin     = true;
+      quint8      opcode  = Text;
+      QByteArray  payload;
+
+    };
+
+    /** разбор одного кадра из начала буфера **/
+    int parseFrame(const QByteArray& buffer, Frame& frame, int max_payload = WS_MAX_MESSAGE_SIZE);
+
+    /** заголовок кадра сервера (без маски) для данных длиной length **/
+    QByteArray frameHeader(quint8 opcode, quint64 length, bool fin = true);
+
+    QByteArray makeFrame(quint8 opcode, const QByteArray& payload, bool fin = true);
+    QByteArray makeCloseFrame(quint16 code, const QByteArray& reason = QByteArray());
+
+    /** подключенный клиент **/
+    struct Client {
+
+      Client(QTcpSocket* s): socket(s) { }
+
+      QTcpSocket* socket;
+
+      // принятые, но еще не разобранные байты
+      QByteArray  rx;
+
+      // сборка фрагментированного сообщения
+      QByteArray  message;
+      quint8      message_opcode  = Continuation;
+
+      // идентификаторы сигналов, на которые подписан клиент
+      QSet<int>   subscriptions;
+
+      // сигналы, изменившиеся с момента последней отправки клиенту
+      QSet<int>   pending;
+
+      // сколько раз отправка была пропущена из-за переполнения буфера сокета
+      quint64     skipped         = 0;
+
+      bool        closing         = false;
+
+    };
+  }
+}
+
+#endif // SV_WEBSOCKET_H
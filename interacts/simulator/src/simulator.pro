@@ -0,0 +1,42 @@
+#-------------------------------------------------
+#
+# Имитатор устройств: генератор потоков данных
+#
+#-------------------------------------------------
+
+QT       += network
+QT       -= gui
+
+CONFIG += c++11 plugin
+
+LIBS += -lrt
+
+TARGET = /home/user/Modus/lib/interacts/simulator
+TEMPLATE = lib
+
+DEFINES += INTERACT_SIMULATOR_LIBRARY
+
+SOURCES += sv_simulator.cpp \
+    sv_sim_format.cpp \
+    sv_sim_transport.cpp \
+    ../../../global/sv_realtime.cpp \
+    ../../../global/sv_metrics.cpp \
+    ../../../../Modus/global/signal/sv_signal.cpp
+
+HEADERS += sv_simulator.h \
+        sv_sim_format.h \
+        sv_sim_transport.h \
+        simulator_defs.h \
+        simulator_global.h \
+    ../../interserver_exchange/global/ise_defs.h \
+    ../../../global/sv_realtime.h \
+    ../../../global/sv_metrics.h \
+    ../../../../Modus/global/interact/sv_abstract_interact.h \
+    ../../../../Modus/global/signal/sv_signal.h \
+    ../../../../svlib/SvException/svexception.h \
+    ../../../../svlib/sv_crc.h
+
+unix {
+    target.path = /usr/lib
+    INSTALLS += target
+}
@@ -0,0 +1,539 @@
+/**********************************************************************
+ *  параметры имитатора устройств: сценарий и потоки данных.
+ *
+ *  сценарий - json файл (параметр "scenario") и/или массив "streams"
+ *  в параметрах провайдера. каждый поток формирует пакеты одного
+ *  формата и передает их через один транспорт с заданной частотой:
+ *
+ *  {
+ *    "scenario": "/etc/modus/sim/soak.json",
+ *    "streams": [
+ *      { "name": "opa_1", "format": "opa", "transport": "udp",
+ *        "host": "127.0.0.1", "port": 5001,
+ *        "rate": 1000, "jitter": 200, "duration": 3600,
+ *        "split": 0.05, "corrupt": 0.001, "crc_error": 0.001,
+ *        "register": "0x1006", "types": ["0x19", "0x02"], "length": 32 }
+ *    ]
+ *  }
+ *
+ *  rate - пакетов в секунду, 0 - без пауз (предельная скорость линии).
+ *  jitter - случайное отклонение момента отправки, мкс.
+ *  split, corrupt, crc_error - вероятность (0..1) разбиения пакета на
+ *  части, порчи байта данных и неверной контрольной суммы.
+ * *********************************************************************/
+
+#ifndef SIMULATOR_DEFS_H
+#define SIMULATOR_DEFS_H
+
+#include <QtGlobal>
+#include <QFile>
+#include <QHostAddress>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QList>
+#include <QMap>
+
+#include <math.h>
+
+#include "../../../../svlib/SvException/svexception.h"
+#include "../../../../Modus/global/global_defs.h"
+
+// параметры провайдера
+#define P_SCENARIO      "scenario"
+#define P_STREAMS       "streams"
+
+// параметры потока
+#define P_NAME          "name"
+#define P_FORMAT        "format"
+#define P_TRANSPORT     "transport"
+#define P_HOST          "host"
+#define P_PORT          "port"
+#define P_DEVICE        "device"
+#define P_RATE          "rate"
+#define P_DURATION      "duration"
+#define P_JITTER        "jitter"
+#define P_SPLIT         "split"
+#define P_SPLIT_GAP     "split_gap"
+#define P_CORRUPT       "corrupt"
+#define P_CRC_ERROR     "crc_error"
+#define P_SEED          "seed"
+
+// параметры форматов
+#define P_REGISTER      "register"
+#define P_TYPES         "types"
+#define P_LENGTH        "length"
+#define P_SRC           "src"
+#define P_DST           "dst"
+#define P_VERSION       "version"
+#define P_CAN_IDS       "can_ids"
+#define P_SENTENCE      "sentence"
+#define P_SENDER        "sender"
+#define P_RECEIVER      "receiver"
+#define P_SIGNALS       "signals"
+#define P_PREFIX        "prefix"
+
+#define DEFAULT_HOST        "127.0.0.1"
+#define DEFAULT_RATE        10
+#define DEFAULT_SPLIT_GAP   100
+#define DEFAULT_LENGTH      16
+#define DEFAULT_ISE_SIGNALS 16
+#define DEFAULT_PREFIX      "sim_"
+
+#define MODBUS_MAX_LENGTH   253     // byte_count = тип + длина + данные
+#define SKM_MAX_LENGTH      4096
+#define ISE_MAX_SIGNALS     1024    // QVariantMap должна помещаться в пакет 64 Кб
+
+namespace sim {
+
+  enum Format {
+    sfOPA,
+    sfOHT,
+    sfSKM,
+    sfCAN,
+    sfNMEA,
+    sfISE
+  };
+
+  const QMap<QString, Format> Formats = {{"opa",  sfOPA},
+                                         {"oht",  sfOHT},
+                                         {"skm",  sfSKM},
+                                         {"can",  sfCAN},
+                                         {"nmea", sfNMEA},
+                                         {"ise",  sfISE}};
+
+  enum Transport {
+    stUdp,
+    stTcp,
+    stPty,
+    stVcan
+  };
+
+  const QMap<QString, Transport> Transports = {{"udp",  stUdp},
+                                               {"tcp",  stTcp},
+                                               {"pty",  stPty},
+                                               {"vcan", stVcan}};
+
+  // число или строка "0x..", "0..", "..."
+  inline bool toUInt(const QJsonValue& value, quint32& result)
+  {
+    if(value.isDouble()) {
+
+      double d = value.toDouble();
+
+      if(d < 0 || d > double(0xFFFFFFFF) || d != floor(d))
+        return false;
+
+      result = quint32(d);
+      return true;
+
+    }
+
+    bool ok = false;
+    result = value.toString().trimmed().toUInt(&ok, 0);
+
+    return ok;
+
+  }
+
+  inline double probability(const QJsonObject& object, const QString& P) //throw (SvException)
+  {
+    if(!object.contains(P))
+      return 0.0;
+
+    double p = object.value(P).toDouble(-1.0);
+
+    if(p < 0.0 || p > 1.0)
+      throw SvException(QString(IMPERMISSIBLE_VALUE)
+                        .arg(P).arg(object.value(P).toVariant().toString())
+                        .arg("Вероятность задается числом от 0 до 1"));
+
+    return p;
+
+  }
+
+  struct StreamParams {
+
+    QString     name      = "";
+    Format      format    = sfOPA;
+    Transport   transport = stUdp;
+
+    QString     host      = DEFAULT_HOST;
+    quint16     port      = 0;
+    QString     device    = "";           // pty - ссылка на подчиненное устройство, vcan - имя интерфейса
+
+    double      rate      = DEFAULT_RATE; // пакетов в секунду, 0 - без пауз
+    int         duration  = 0;            // с, 0 - до остановки
+    int         jitter    = 0;            // мкс
+    double      split     = 0.0;
+    int         split_gap = DEFAULT_SPLIT_GAP;  // пауза между частями пакета, мкс
+    double      corrupt   = 0.0;
+    double      crc_error = 0.0;
+    quint32     seed      = 1;
+
+    // opa, oht
+    quint16         reg       = 0x0006;
+    // opa, oht, skm
+    QList<quint8>   types;
+    int             length    = DEFAULT_LENGTH;
+    // skm
+    quint8          src       = 0;
+    quint8          dst       = 0;
+    quint8          version   = 0x24;
+    // can
+    QList<quint32>  can_ids;
+    // nmea
+    QString         sentence  = "XDR";
+    // ise
+    quint16         sender    = 0;
+    quint16         receiver  = 0;
+    int             ise_signals = DEFAULT_ISE_SIGNALS;
+    QString         prefix    = DEFAULT_PREFIX;
+
+    static StreamParams fromJsonObject(const QJsonObject &object) //throw (SvException)
+    {
+      StreamParams p;
+      QString P;
+      quint32 u;
+
+      P = P_NAME;
+      p.name = object.value(P).toString();
+
+      if(p.name.isEmpty())
+        throw SvException(QString(IMPERMISSIBLE_VALUE)
+                          .arg(P).arg(p.name)
+                          .arg("Имя потока должно быть задано"));
+
+      P = P_FORMAT;
+      if(!Formats.contains(object.value(P).toString().toLower()))
+        throw SvException(QString(IMPERMISSIBLE_VALUE)
+                          .arg(P).arg(object.value(P).toVariant().toString())
+                          .arg(QString("Поток %1. Допустимые значения: %2").arg(p.name).arg(QStringList(Formats.keys()).join(", "))));
+
+      p.format = Formats.value(object.value(P).toString().toLower());
+
+      P = P_TRANSPORT;
+      if(!Transports.contains(object.value(P).toString().toLower()))
+        throw SvException(QString(IMPERMISSIBLE_VALUE)
+                          .arg(P).arg(object.value(P).toVariant().toString())
+                          .arg(QString("Поток %1. Допустимые значения: %2").arg(p.name).arg(QStringList(Transports.keys()).join(", "))));
+
+      p.transport = Transports.value(object.value(P).toString().toLower());
+
+      P = P_HOST;
+      if(object.contains(P)) {
+
+        p.host = object.value(P).toString();
+
+        if(QHostAddress(p.host).protocol() != QAbstractSocket::IPv4Protocol)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P).arg(p.host)
+                            .arg(QString("Поток %1. Адрес задается в формате IPv4: \"127.0.0.1\"").arg(p.name)));
+
+      }
+
+      P = P_PORT;
+      if(p.transport == stUdp || p.transport == stTcp) {
+
+        p.port = quint16(object.value(P).toInt(0));
+
+        if(p.port == 0)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P).arg(object.value(P).toVariant().toString())
+                            .arg(QString("Поток %1. Допускаются только числовые значения в диапазоне 1 - 65535").arg(p.name)));
+
+      }
+
+      P = P_DEVICE;
+      p.device = object.value(P).toString();
+
+      if(p.transport == stVcan && (p.device.isEmpty() || p.device.toUtf8().size() >= 16))
+        throw SvException(QString(IMPERMISSIBLE_VALUE)
+                          .arg(P).arg(p.device)
+                          .arg(QString("Поток %1. Для vcan должно быть задано имя интерфейса, не длиннее 15 символов: \"vcan0\"").arg(p.name)));
+
+      if(p.transport == stVcan && p.format != sfCAN)
+        throw SvException(QString(IMPERMISSIBLE_VALUE)
+                          .arg(P_TRANSPORT).arg("vcan")
+                          .arg(QString("Поток %1. Через vcan передаются только кадры формата can").arg(p.name)));
+
+      P = P_RATE;
+      if(object.contains(P)) {
+
+        p.rate = object.value(P).toDouble(-1.0);
+
+        if(p.rate < 0)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P).arg(object.value(P).toVariant().toString())
+                            .arg(QString("Поток %1. Частота задается в пакетах в секунду, 0 - без пауз").arg(p.name)));
+
+      }
+
+      P = P_DURATION;
+      if(object.contains(P)) {
+
+        p.duration = object.value(P).toInt(-1);
+
+        if(p.duration < 0)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P).arg(object.value(P).toVariant().toString())
+                            .arg(QString("Поток %1. Длительность задается в секундах, 0 - до остановки").arg(p.name)));
+
+      }
+
+      P = P_JITTER;
+      if(object.contains(P)) {
+
+        p.jitter = object.value(P).toInt(-1);
+
+        if(p.jitter < 0)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P).arg(object.value(P).toVariant().toString())
+                            .arg(QString("Поток %1. Отклонение задается в микросекундах").arg(p.name)));
+
+      }
+
+      P = P_SPLIT_GAP;
+      if(object.contains(P)) {
+
+        p.split_gap = object.value(P).toInt(-1);
+
+        if(p.split_gap < 0)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P).arg(object.value(P).toVariant().toString())
+                            .arg(QString("Поток %1. Пауза между частями пакета задается в микросекундах").arg(p.name)));
+
+      }
+
+      p.split     = probability(object, P_SPLIT);
+      p.corrupt   = probability(object, P_CORRUPT);
+      p.crc_error = probability(object, P_CRC_ERROR);
+
+      P = P_SEED;
+      if(object.contains(P) && !toUInt(object.value(P), p.seed))
+        throw SvException(QString(IMPERMISSIBLE_VALUE)
+                          .arg(P).arg(object.value(P).toVariant().toString())
+                          .arg(QString("Поток %1. Начальное значение генератора - целое число").arg(p.name)));
+
+      /* параметры форматов */
+      P = P_REGISTER;
+      if(object.contains(P)) {
+
+        if(!toUInt(object.value(P), u) || u > 0xFFFF)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P).arg(object.value(P).toVariant().toString())
+                            .arg(QString("Поток %1. Номер регистра от 0 до 0xFFFF").arg(p.name)));
+
+        p.reg = quint16(u);
+
+      }
+
+      P = P_TYPES;
+      if(object.contains(P)) {
+
+        for(QJsonValue v: object.value(P).toArray()) {
+
+          if(!toUInt(v, u) || u > 0xFF)
+            throw SvException(QString(IMPERMISSIBLE_VALUE)
+                              .arg(P).arg(v.toVariant().toString())
+                              .arg(QString("Поток %1. Типы данных задаются массивом чисел от 0 до 0xFF").arg(p.name)));
+
+          p.types.append(quint8(u));
+
+        }
+      }
+
+      // типы данных, которые разбирают протоколы
+      if(p.types.isEmpty()) {
+
+        switch (p.format) {
+          case sfOPA: p.types = {0x19, 0x02, 0x03, 0x04, 0x33}; break;
+          case sfOHT: p.types = {0x19, 0x13, 0x14}; break;
+          case sfSKM: p.types = {0x01, 0x02}; break;
+          default:    p.types = {0x01}; break;
+        }
+      }
+
+      P = P_LENGTH;
+      if(object.contains(P)) {
+
+        int max = p.format == sfSKM ? SKM_MAX_LENGTH : MODBUS_MAX_LENGTH;
+
+        p.length = object.value(P).toInt(0);
+
+        if(p.length < 1 || p.length > max)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P).arg(object.value(P).toVariant().toString())
+                            .arg(QString("Поток %1. Длина данных от 1 до %2 байт").arg(p.name).arg(max)));
+
+      }
+
+      for(QString name: {QString(P_SRC), QString(P_DST), QString(P_VERSION)}) {
+
+        if(!object.contains(name))
+          continue;
+
+        if(!toUInt(object.value(name), u) || u > 0xFF)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(name).arg(object.value(name).toVariant().toString())
+                            .arg(QString("Поток %1. Допускаются значения от 0 до 0xFF").arg(p.name)));
+
+        if(name == P_SRC)       p.src     = quint8(u);
+        else if(name == P_DST)  p.dst     = quint8(u);
+        else                    p.version = quint8(u);
+
+      }
+
+      P = P_CAN_IDS;
+      if(object.contains(P)) {
+
+        for(QJsonValue v: object.value(P).toArray()) {
+
+          if(!toUInt(v, u) || u > 0x1FFFFFFF)
+            throw SvException(QString(IMPERMISSIBLE_VALUE)
+                              .arg(P).arg(v.toVariant().toString())
+                              .arg(QString("Поток %1. Идентификаторы кадров от 0 до 0x1FFFFFFF").arg(p.name)));
+
+          p.can_ids.append(u);
+
+        }
+      }
+
+      if(p.can_ids.isEmpty())
+        p.can_ids.append(0x100);
+
+      P = P_SENTENCE;
+      if(object.contains(P)) {
+
+        p.sentence = object.value(P).toString().toUpper();
+
+        if(p.sentence != "XDR" && p.sentence != "GEN")
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P).arg(object.value(P).toVariant().toString())
+                            .arg(QString("Поток %1. Допустимые значения: XDR, GEN").arg(p.name)));
+
+      }
+
+      for(QString name: {QString(P_SENDER), QString(P_RECEIVER)}) {
+
+        if(!object.contains(name))
+          continue;
+
+        if(!toUInt(object.value(name), u) || u > 0xFFFF)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(name).arg(object.value(name).toVariant().toString())
+                            .arg(QString("Поток %1. Допускаются значения от 0 до 0xFFFF").arg(p.name)));
+
+        if(name == P_SENDER)  p.sender   = quint16(u);
+        else                  p.receiver = quint16(u);
+
+      }
+
+      P = P_SIGNALS;
+      if(object.contains(P)) {
+
+        p.ise_signals = object.value(P).toInt(0);
+
+        if(p.ise_signals < 1 || p.ise_signals > ISE_MAX_SIGNALS)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P).arg(object.value(P).toVariant().toString())
+                            .arg(QString("Поток %1. Кол-во сигналов от 1 до %2").arg(p.name).arg(ISE_MAX_SIGNALS)));
+
+      }
+
+      P = P_PREFIX;
+      if(object.contains(P))
+        p.prefix = object.value(P).toString();
+
+      return p;
+
+    }
+  };
+
+  struct Params {
+
+    QString             scenario = "";
+    QList<StreamParams> streams;
+
+    static Params fromJsonString(const QString& json_string) //throw (SvException)
+    {
+      QJsonParseError err;
+      QJsonDocument jd = QJsonDocument::fromJson(json_string.toUtf8(), &err);
+
+      if(err.error != QJsonParseError::NoError)
+        throw SvException(err.errorString());
+
+      try {
+
+        return fromJsonObject(jd.object());
+
+      }
+      catch(SvException& e) {
+        throw e;
+      }
+    }
+
+    static Params fromJsonObject(const QJsonObject &object) //throw (SvException)
+    {
+      Params p;
+      QString P;
+
+      // потоки из файла сценария, затем заданные в параметрах
+      P = P_SCENARIO;
+      if(object.contains(P)) {
+
+        p.scenario = object.value(P).toString();
+
+        QFile f(p.scenario);
+
+        if(!f.open(QIODevice::ReadOnly))
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P).arg(p.scenario)
+                            .arg(QString("Ошибка открытия файла сценария: %1").arg(f.errorString())));
+
+        QJsonParseError err;
+        QJsonDocument jd = QJsonDocument::fromJson(f.readAll(), &err);
+
+        if(err.error != QJsonParseError::NoError)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P).arg(p.scenario)
+                            .arg(QString("Ошибка разбора файла сценария: %1").arg(err.errorString())));
+
+        for(QJsonValue v: jd.object().value(P_STREAMS).toArray())
+          p.streams.append(StreamParams::fromJsonObject(v.toObject()));
+
+      }
+
+      P = P_STREAMS;
+      if(object.contains(P)) {
+
+        for(QJsonValue v: object.value(P).toArray())
+          p.streams.append(StreamParams::fromJsonObject(v.toObject()));
+
+      }
+
+      if(p.streams.isEmpty())
+        throw SvException(QString(IMPERMISSIBLE_VALUE)
+                          .arg(P_STREAMS).arg("")
+                          .arg("В сценарии нет ни одного потока"));
+
+      QStringList names;
+
+      for(const StreamParams& s: p.streams) {
+
+        if(names.contains(s.name))
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P_NAME).arg(s.name)
+                            .arg("Имена потоков должны быть уникальны"));
+
+        names << s.name;
+
+      }
+
+      return p;
+
+    }
+  };
+}
+
+#endif // SIMULATOR_DEFS_H
@@ -0,0 +1,203 @@
+#include "sv_sim_format.h"
+
+#include <QDataStream>
+#include <QVariantMap>
+
+#include <linux/can.h>
+
+#include "../../../../svlib/sv_crc.h"
+#include "../../interserver_exchange/global/ise_defs.h"
+
+sim::SvFormat* sim::SvFormat::create(const StreamParams& params)
+{
+  switch (params.format) {
+
+    case sfOPA:
+    case sfOHT:   return new sim::SvModbusFormat(params);
+    case sfSKM:   return new sim::SvSkmFormat(params);
+    case sfCAN:   return new sim::SvCanFormat(params);
+    case sfNMEA:  return new sim::SvNmeaFormat(params);
+    case sfISE:   return new sim::SvIseFormat(params);
+
+  }
+
+  return nullptr;
+
+}
+
+/** ********** opa, oht ************ **/
+int sim::SvModbusFormat::headerSize() const
+{
+  return 7; // client_addr, func_code, ADDRESS, OFFSET, register_count, byte_count
+}
+
+void sim::SvModbusFormat::frame(quint64 seq, Random& random, QByteArray& out, bool crc_error)
+{
+  quint8 byte_count = quint8(2 + p_params.length);
+  quint16 register_count = quint16((byte_count + 1) / 2);
+
+  out.resize(headerSize() + byte_count + 2);
+  quint8* buf = reinterpret_cast<quint8*>(out.data());
+
+  buf[0] = 1;     // client_addr
+  buf[1] = 0x10;  // func_code
+  buf[2] = quint8(p_params.reg >> 8);
+  buf[3] = quint8(p_params.reg & 0xFF);
+  buf[4] = quint8(register_count >> 8);
+  buf[5] = quint8(register_count & 0xFF);
+  buf[6] = byte_count;
+
+  buf[7] = type(seq);
+  buf[8] = quint8(p_params.length);
+
+  for(int i = 0; i < p_params.length; i++)
+    buf[9 + i] = quint8(random.next());
+
+  quint16 crc = CRC::MODBUS_CRC16(buf, headerSize() + byte_count);
+
+  if(crc_error)
+    crc ^= 0x0101;
+
+  buf[headerSize() + byte_count]     = quint8(crc & 0xFF);
+  buf[headerSize() + byte_count + 1] = quint8(crc >> 8);
+
+}
+
+/** ********** skm ************ **/
+void sim::SvSkmFormat::frame(quint64 seq, Random& random, QByteArray& out, bool crc_error)
+{
+  m_body.resize(1 + p_params.length + 2);
+  quint8* body = reinterpret_cast<quint8*>(m_body.data());
+
+  body[0] = type(seq);
+
+  for(int i = 0; i < p_params.length; i++)
+    body[1 + i] = quint8(random.next());
+
+  quint16 crc = CRC::MODBUS_CRC16(body, 1 + p_params.length);
+
+  if(crc_error)
+    crc ^= 0x0101;
+
+  body[1 + p_params.length] = quint8(crc & 0xFF);
+  body[2 + p_params.length] = quint8(crc >> 8);
+
+  out.clear();
+  out.append(char(0x1F))
+     .append(char(p_params.dst))
+     .append(char(p_params.src))
+     .append(char(p_params.version));
+
+  // после служебных байт 0x1F, 0x2F, 0x55 передается дополнительный байт
+  for(int i = 0; i < m_body.size(); i++) {
+
+    out.append(char(body[i]));
+
+    if(body[i] == 0x1F || body[i] == 0x2F || body[i] == 0x55)
+      out.append(char(0x00));
+
+  }
+
+  out.append(char(0x2F)).append(char(0x55));
+
+}
+
+/** ********** can ************ **/
+int sim::SvCanFormat::headerSize() const
+{
+  return int(offsetof(struct can_frame, data));
+}
+
+void sim::SvCanFormat::frame(quint64 seq, Random& random, QByteArray& out, bool crc_error)
+{
+  Q_UNUSED(crc_error); // контрольная сумма кадра проверяется контроллером
+
+  out.fill(0, sizeof(struct can_frame));
+  struct can_frame* frame = reinterpret_cast<struct can_frame*>(out.data());
+
+  quint32 id = p_params.can_ids.at(int(seq % quint64(p_params.can_ids.count())));
+
+  frame->can_id  = id > CAN_SFF_MASK ? (id | CAN_EFF_FLAG) : id;
+  frame->can_dlc = CAN_MAX_DLEN;
+
+  for(int i = 0; i < CAN_MAX_DLEN; i++)
+    frame->data[i] = quint8(random.next());
+
+}
+
+/** ********** nmea ************ **/
+void sim::SvNmeaFormat::frame(quint64 seq, Random& random, QByteArray& out, bool crc_error)
+{
+  out.clear();
+
+  if(p_params.sentence == "GEN")
+    out.append(QString("$IIGEN,%1,0.0,%2")
+               .arg(type(seq), 4, 16, QChar('0'))
+               .arg(random.below(0x10000), 4, 16, QChar('0')).toUpper().toLatin1());
+
+  else {
+
+    out.append(QString("$IIXDR,%1").arg(type(seq) % 10).toLatin1());
+
+    for(int i = 0; i < 15; i++)
+      out.append(QString(",%1.%2").arg(random.below(1000)).arg(random.below(10)).toLatin1());
+
+  }
+
+  quint8 crc = 0;
+  for(int i = 1; i < out.size(); i++)
+    crc ^= quint8(out.at(i));
+
+  if(crc_error)
+    crc ^= 0xFF;
+
+  out.append(QString("*%1\r\n").arg(crc, 2, 16, QChar('0')).toUpper().toLatin1());
+
+}
+
+/** ********** ise ************ **/
+sim::SvIseFormat::SvIseFormat(const StreamParams& params):
+  SvFormat(params)
+{
+  for(int i = 0; i < p_params.ise_signals; i++)
+    m_names.append(QString("%1%2").arg(p_params.prefix).arg(i));
+
+}
+
+int sim::SvIseFormat::headerSize() const
+{
+  return int(sizeof(ise::Header));
+}
+
+void sim::SvIseFormat::frame(quint64 seq, Random& random, QByteArray& out, bool crc_error)
+{
+  Q_UNUSED(seq);
+
+  QVariantMap values;
+
+  for(const QString& name: m_names)
+    values.insert(name, QVariant(double(random.below(100000)) / 100.0));
+
+  QByteArray varmap;
+  QDataStream stream(&varmap, QIODevice::WriteOnly);
+  stream.setVersion(QDataStream::Qt_5_5);
+  stream << values;
+
+  quint16 varlen = quint16(varmap.length());
+
+  // как отправляет ises::SvISESThread
+  out.clear();
+  out.append(ise::DEF_SIGN)
+     .append((const char*)&p_params.sender,   sizeof(quint16))
+     .append((const char*)&p_params.receiver, sizeof(quint16))
+     .append((const char*)&varlen, sizeof(quint16))
+     .append(varmap);
+
+  quint16 crc = CRC::MODBUS_CRC16((const quint8*)(out.data()), sizeof(ise::Header) + varlen);
+
+  if(crc_error)
+    crc ^= 0x0101;
+
+  out.append((const char*)&crc, sizeof(quint16));
+
+}
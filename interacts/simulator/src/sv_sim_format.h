@@ -0,0 +1,138 @@
+/**********************************************************************
+ *  форматы пакетов имитатора устройств.
+ *
+ *  пакеты формируются так же, как их отправляют устройства, и
+ *  разбираются протоколами без изменений:
+ *    opa, oht - modbus 12700: заголовок, тип, длина, данные, crc16;
+ *    skm      - заголовок, байт-стаффинг данных и crc, конец 0x2F 0x55;
+ *    can      - кадр can_frame (16 байт);
+ *    nmea     - $IIXDR / $IIGEN с контрольной суммой xor;
+ *    ise      - межсерверный обмен: заголовок, QVariantMap, crc16.
+ *
+ *  данные пакетов случайные. генератор у каждого потока свой, при
+ *  одинаковом seed последовательность пакетов повторяется.
+ * *********************************************************************/
+
+#ifndef SV_SIM_FORMAT_H
+#define SV_SIM_FORMAT_H
+
+#include <QByteArray>
+
+#include "simulator_defs.h"
+
+namespace sim {
+
+  /** генератор псевдослучайных чисел xorshift32 **/
+  class Random
+  {
+  public:
+    explicit Random(quint32 seed = 1): m_state(seed ? seed : 1) { }
+
+    inline quint32 next()
+    {
+      m_state ^= m_state << 13;
+      m_state ^= m_state >> 17;
+      m_state ^= m_state << 5;
+
+      return m_state;
+    }
+
+    // 0 <= r < n
+    inline quint32 below(quint32 n) { return n ? quint32((quint64(next()) * n) >> 32) : 0; }
+
+    // событие с вероятностью p
+    inline bool chance(double p) { return p > 0.0 && next() < p * 4294967296.0; }
+
+  private:
+    quint32 m_state;
+
+  };
+
+  class SvFormat
+  {
+  public:
+    explicit SvFormat(const StreamParams& params): p_params(params) { }
+    virtual ~SvFormat() { }
+
+    // пакет номер seq. crc_error - неверная контрольная сумма
+    virtual void frame(quint64 seq, Random& random, QByteArray& out, bool crc_error) = 0;
+
+    // размер заголовка. порча данных заголовок не затрагивает
+    virtual int headerSize() const = 0;
+
+    // пакет можно передавать частями. кадр can неделим
+    virtual bool splittable() const { return true; }
+
+    static SvFormat* create(const StreamParams& params);
+
+  protected:
+    StreamParams p_params;
+
+    quint8 type(quint64 seq) const { return p_params.types.at(int(seq % quint64(p_params.types.count()))); }
+
+  };
+
+  /** opa, oht **/
+  class SvModbusFormat: public SvFormat
+  {
+  public:
+    explicit SvModbusFormat(const StreamParams& params): SvFormat(params) { }
+
+    void frame(quint64 seq, Random& random, QByteArray& out, bool crc_error) override;
+    int headerSize() const override;
+
+  };
+
+  /** skm **/
+  class SvSkmFormat: public SvFormat
+  {
+  public:
+    explicit SvSkmFormat(const StreamParams& params): SvFormat(params) { }
+
+    void frame(quint64 seq, Random& random, QByteArray& out, bool crc_error) override;
+    int headerSize() const override { return 4; }
+
+  private:
+    QByteArray m_body;
+
+  };
+
+  /** can **/
+  class SvCanFormat: public SvFormat
+  {
+  public:
+    explicit SvCanFormat(const StreamParams& params): SvFormat(params) { }
+
+    void frame(quint64 seq, Random& random, QByteArray& out, bool crc_error) override;
+    int headerSize() const override;
+    bool splittable() const override { return false; }
+
+  };
+
+  /** nmea **/
+  class SvNmeaFormat: public SvFormat
+  {
+  public:
+    explicit SvNmeaFormat(const StreamParams& params): SvFormat(params) { }
+
+    void frame(quint64 seq, Random& random, QByteArray& out, bool crc_error) override;
+    int headerSize() const override { return 7; } // $IIXDR,
+
+  };
+
+  /** ise **/
+  class SvIseFormat: public SvFormat
+  {
+  public:
+    explicit SvIseFormat(const StreamParams& params);
+
+    void frame(quint64 seq, Random& random, QByteArray& out, bool crc_error) override;
+    int headerSize() const override;
+
+  private:
+    QStringList m_names;
+
+  };
+}
+
+#endif // SV_SIM_FORMAT_H
@@ -0,0 +1,302 @@
+#include "sv_sim_transport.h"
+
+#include <QFile>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+
+#include <linux/can.h>
+#include <linux/can/raw.h>
+
+#define TCP_RECONNECT_INTERVAL 1000 // мс
+
+namespace {
+
+  QString lastError()
+  {
+    return QString::fromLocal8Bit(strerror(errno));
+  }
+
+  qint64 monotonicMs()
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return qint64(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+  }
+
+  bool address(const sim::StreamParams& params, struct sockaddr_in& addr)
+  {
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port   = htons(params.port);
+
+    return inet_pton(AF_INET, params.host.toLatin1().constData(), &addr.sin_addr) == 1;
+  }
+}
+
+sim::SvTransport* sim::SvTransport::create(const StreamParams& params)
+{
+  switch (params.transport) {
+
+    case stUdp:   return new sim::SvUdpTransport(params);
+    case stTcp:   return new sim::SvTcpTransport(params);
+    case stPty:   return new sim::SvPtyTransport(params);
+    case stVcan:  return new sim::SvVcanTransport(params);
+
+  }
+
+  return nullptr;
+
+}
+
+sim::SvTransport::~SvTransport()
+{
+  if(p_fd >= 0)
+    ::close(p_fd);
+
+}
+
+bool sim::SvTransport::send(const char* data, int size)
+{
+  return p_fd >= 0 && ::write(p_fd, data, size_t(size)) == ssize_t(size);
+}
+
+/** ********** udp ************ **/
+bool sim::SvUdpTransport::open(QString& error)
+{
+  struct sockaddr_in addr;
+
+  if(!address(p_params, addr)) {
+
+    error = QString("Неверный адрес %1").arg(p_params.host);
+    return false;
+
+  }
+
+  p_fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+  if(p_fd < 0 || ::connect(p_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+
+    error = QString("Ошибка открытия сокета udp %1: %2").arg(description()).arg(lastError());
+    return false;
+
+  }
+
+  return true;
+
+}
+
+QString sim::SvUdpTransport::description() const
+{
+  return QString("udp://%1:%2").arg(p_params.host).arg(p_params.port);
+}
+
+/** ********** tcp ************ **/
+bool sim::SvTcpTransport::open(QString& error)
+{
+  // сервер может быть еще не запущен: соединение устанавливается при отправке
+  if(!connectToHost(error))
+    error.clear();
+
+  return true;
+
+}
+
+bool sim::SvTcpTransport::connectToHost(QString& error)
+{
+  m_last_attempt = monotonicMs();
+
+  struct sockaddr_in addr;
+
+  if(!address(p_params, addr)) {
+
+    error = QString("Неверный адрес %1").arg(p_params.host);
+    return false;
+
+  }
+
+  int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+  if(fd < 0 || ::connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+
+    error = QString("Ошибка соединения %1: %2").arg(description()).arg(lastError());
+
+    if(fd >= 0)
+      ::close(fd);
+
+    return false;
+
+  }
+
+  int on = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+  p_fd = fd;
+
+  return true;
+
+}
+
+bool sim::SvTcpTransport::send(const char* data, int size)
+{
+  if(p_fd < 0) {
+
+    QString error;
+
+    if(monotonicMs() - m_last_attempt < TCP_RECONNECT_INTERVAL || !connectToHost(error))
+      return false;
+
+  }
+
+  int sent = 0;
+
+  while(sent < size) {
+
+    ssize_t n = ::send(p_fd, data + sent, size_t(size - sent), MSG_NOSIGNAL);
+
+    if(n < 0 && errno == EINTR)
+      continue;
+
+    if(n <= 0) {
+
+      // соединение разорвано
+      ::close(p_fd);
+      p_fd = -1;
+
+      return false;
+
+    }
+
+    sent += int(n);
+
+  }
+
+  return true;
+
+}
+
+QString sim::SvTcpTransport::description() const
+{
+  return QString("tcp://%1:%2").arg(p_params.host).arg(p_params.port);
+}
+
+/** ********** pty ************ **/
+sim::SvPtyTransport::~SvPtyTransport()
+{
+  if(m_slave >= 0)
+    ::close(m_slave);
+
+  if(!p_params.device.isEmpty())
+    QFile::remove(p_params.device);
+
+}
+
+bool sim::SvPtyTransport::open(QString& error)
+{
+  p_fd = ::posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+
+  if(p_fd < 0 || ::grantpt(p_fd) < 0 || ::unlockpt(p_fd) < 0) {
+
+    error = QString("Ошибка создания псевдотерминала: %1").arg(lastError());
+    return false;
+
+  }
+
+  m_slave_name = QString::fromLocal8Bit(::ptsname(p_fd));
+
+  // подчиненное устройство в "сыром" режиме, без преобразования символов
+  m_slave = ::open(m_slave_name.toLocal8Bit().constData(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+
+  if(m_slave < 0) {
+
+    error = QString("Ошибка открытия %1: %2").arg(m_slave_name).arg(lastError());
+    return false;
+
+  }
+
+  struct termios tio;
+  if(tcgetattr(m_slave, &tio) == 0) {
+
+    cfmakeraw(&tio);
+    tcsetattr(m_slave, TCSANOW, &tio);
+
+  }
+
+  // без читателя буфер псевдотерминала заполняется: пакеты теряются, поток не блокируется
+  fcntl(p_fd, F_SETFL, fcntl(p_fd, F_GETFL) | O_NONBLOCK);
+
+  if(!p_params.device.isEmpty()) {
+
+    QFile::remove(p_params.device);
+
+    if(::symlink(m_slave_name.toLocal8Bit().constData(), p_params.device.toLocal8Bit().constData()) < 0) {
+
+      error = QString("Ошибка создания ссылки %1 на %2: %3").arg(p_params.device).arg(m_slave_name).arg(lastError());
+      return false;
+
+    }
+  }
+
+  return true;
+
+}
+
+QString sim::SvPtyTransport::description() const
+{
+  return p_params.device.isEmpty() ? m_slave_name : QString("%1 -> %2").arg(p_params.device).arg(m_slave_name);
+}
+
+/** ********** vcan ************ **/
+bool sim::SvVcanTransport::open(QString& error)
+{
+  p_fd = ::socket(PF_CAN, SOCK_RAW | SOCK_CLOEXEC, CAN_RAW);
+
+  if(p_fd < 0) {
+
+    error = QString("Ошибка открытия сокета can: %1").arg(lastError());
+    return false;
+
+  }
+
+  struct ifreq ifr;
+  memset(&ifr, 0, sizeof(ifr));
+  strncpy(ifr.ifr_name, p_params.device.toLatin1().constData(), IFNAMSIZ - 1);
+
+  if(ioctl(p_fd, SIOCGIFINDEX, &ifr) < 0) {
+
+    error = QString("Интерфейс %1 не найден: %2").arg(p_params.device).arg(lastError());
+    return false;
+
+  }
+
+  struct sockaddr_can addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.can_family  = AF_CAN;
+  addr.can_ifindex = ifr.ifr_ifindex;
+
+  if(bind(p_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+
+    error = QString("Ошибка подключения к интерфейсу %1: %2").arg(p_params.device).arg(lastError());
+    return false;
+
+  }
+
+  return true;
+
+}
+
+QString sim::SvVcanTransport::description() const
+{
+  return QString("can://%1").arg(p_params.device);
+}
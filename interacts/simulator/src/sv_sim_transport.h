@@ -0,0 +1,99 @@
+/**********************************************************************
+ *  транспорты имитатора устройств.
+ *
+ *  транспорт работает в потоке своего потока данных на сокетах POSIX,
+ *  без цикла событий Qt: отправка - один системный вызов.
+ *
+ *    udp  - сокет, связанный с адресом получателя (connect);
+ *    tcp  - клиент, TCP_NODELAY. при обрыве соединение восстанавливается
+ *           не чаще раза в секунду, пакеты до восстановления теряются;
+ *    pty  - псевдотерминал вместо последовательного порта. интерфейс rs
+ *           открывает подчиненное устройство (параметр device - ссылка
+ *           на него). подчиненное устройство держится открытым, чтобы
+ *           запись не завершалась ошибкой до подключения интерфейса;
+ *    vcan - сокет SocketCAN на интерфейсе vcan (или can).
+ * *********************************************************************/
+
+#ifndef SV_SIM_TRANSPORT_H
+#define SV_SIM_TRANSPORT_H
+
+#include <QString>
+
+#include "simulator_defs.h"
+
+namespace sim {
+
+  class SvTransport
+  {
+  public:
+    explicit SvTransport(const StreamParams& params): p_params(params) { }
+    virtual ~SvTransport();
+
+    virtual bool open(QString& error) = 0;
+
+    // false - данные не переданы
+    virtual bool send(const char* data, int size);
+
+    virtual QString description() const = 0;
+
+    static SvTransport* create(const StreamParams& params);
+
+  protected:
+    StreamParams p_params;
+    int          p_fd = -1;
+
+  };
+
+  class SvUdpTransport: public SvTransport
+  {
+  public:
+    explicit SvUdpTransport(const StreamParams& params): SvTransport(params) { }
+
+    bool open(QString& error) override;
+    QString description() const override;
+
+  };
+
+  class SvTcpTransport: public SvTransport
+  {
+  public:
+    explicit SvTcpTransport(const StreamParams& params): SvTransport(params) { }
+
+    bool open(QString& error) override;
+    bool send(const char* data, int size) override;
+    QString description() const override;
+
+  private:
+    qint64 m_last_attempt = 0;  // время последней попытки соединения, мс
+
+    bool connectToHost(QString& error);
+
+  };
+
+  class SvPtyTransport: public SvTransport
+  {
+  public:
+    explicit SvPtyTransport(const StreamParams& params): SvTransport(params) { }
+    ~SvPtyTransport();
+
+    bool open(QString& error) override;
+    QString description() const override;
+
+  private:
+    int     m_slave = -1;
+    QString m_slave_name = "";
+
+  };
+
+  class SvVcanTransport: public SvTransport
+  {
+  public:
+    explicit SvVcanTransport(const StreamParams& params): SvTransport(params) { }
+
+    bool open(QString& error) override;
+    QString description() const override;
+
+  };
+}
+
+#endif // SV_SIM_TRANSPORT_H
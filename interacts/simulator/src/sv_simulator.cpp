@@ -0,0 +1,299 @@
+#include "sv_simulator.h"
+
+#include <time.h>
+#include <errno.h>
+#include <sys/prctl.h>
+
+#define SLEEP_SLICE       100000000LL   // нс. наибольший отрезок ожидания - поток останавливается не дольше
+#define MAX_LAG           1000000000LL  // нс. при большем отставании пропущенные пакеты не досылаются
+
+namespace {
+
+  qint64 nowNs()
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return qint64(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+  }
+}
+
+/** ********** SvSimulator ************ **/
+sim::SvSimulator::SvSimulator():
+  modus::SvAbstractProvider()
+{
+
+}
+
+sim::SvSimulator::~SvSimulator()
+{
+  clear();
+}
+
+bool sim::SvSimulator::configure(modus::ProviderConfig* config, modus::Configuration* configuration)
+{
+  p_config = config;
+  p_modus_configiration = configuration;
+
+  try {
+
+    m_params = sim::Params::fromJsonString(p_config->params);
+
+    m_realtime = rt::Params::fromJsonString(p_config->params);
+
+    for(const sim::StreamParams& stream: m_params.streams) {
+
+      sim::SvStreamThread* thread = new sim::SvStreamThread(stream, m_realtime);
+      m_threads.append(thread);
+
+      QString error;
+      if(!thread->init(error)) {
+
+        p_last_error = QString("Имитатор %1, поток %2: %3").arg(p_config->name).arg(stream.name).arg(error);
+
+        clear();
+
+        return false;
+
+      }
+
+      connect(thread, &sim::SvStreamThread::message, this, &sim::SvSimulator::workerMessage);
+
+    }
+
+    return true;
+
+  }
+  catch(SvException e)
+  {
+    p_last_error = e.error;
+
+    clear();
+
+    return false;
+  }
+}
+
+void sim::SvSimulator::start()
+{
+  for(sim::SvStreamThread* thread: m_threads)
+    thread->start();
+
+}
+
+void sim::SvSimulator::stop()
+{
+  clear();
+}
+
+void sim::SvSimulator::clear()
+{
+  for(sim::SvStreamThread* thread: m_threads)
+    thread->stop();
+
+  for(sim::SvStreamThread* thread: m_threads) {
+
+    thread->wait();
+    delete thread;
+
+  }
+
+  m_threads.clear();
+
+}
+
+void sim::SvSimulator::workerMessage(const QString& text, int level, int type)
+{
+  emit message(text, sv::log::Level(level), sv::log::MessageTypes(type));
+}
+
+/** ********** SvStreamThread ************ **/
+sim::SvStreamThread::SvStreamThread(const sim::StreamParams& params, const rt::Params& realtime):
+  m_params(params),
+  m_realtime(realtime),
+  m_is_active(false)
+{
+
+}
+
+sim::SvStreamThread::~SvStreamThread()
+{
+  if(m_format)
+    delete m_format;
+
+  if(m_transport)
+    delete m_transport;
+
+}
+
+bool sim::SvStreamThread::init(QString& error)
+{
+  m_format    = sim::SvFormat::create(m_params);
+  m_transport = sim::SvTransport::create(m_params);
+
+  if(!m_transport->open(error))
+    return false;
+
+  m_metrics.attach(QString("sim:%1").arg(m_params.name));
+
+  m_is_active = true;
+
+  return true;
+
+}
+
+bool sim::SvStreamThread::sleepUntil(qint64 ns)
+{
+  while(m_is_active) {
+
+    qint64 now = nowNs();
+
+    if(now >= ns)
+      return true;
+
+    qint64 until = qMin(ns, now + SLEEP_SLICE);
+
+    struct timespec ts;
+    ts.tv_sec  = until / 1000000000LL;
+    ts.tv_nsec = until % 1000000000LL;
+
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+
+  }
+
+  return false;
+
+}
+
+bool sim::SvStreamThread::send(const QByteArray& packet, sim::Random& random)
+{
+  if(!m_format->splittable() || packet.size() < 2 || !random.chance(m_params.split)) {
+
+    if(!m_transport->send(packet.constData(), packet.size()))
+      return false;
+
+    m_metrics.bytes_out.inc(quint64(packet.size()));
+
+    return true;
+
+  }
+
+  // пакет передается 2 - 4 частями случайной длины с паузой между ними
+  m_split++;
+
+  int parts = qMin(2 + int(random.below(3)), packet.size());
+  int pos = 0;
+
+  for(int i = parts; i > 0; i--) {
+
+    int left = packet.size() - pos;
+    int len  = i == 1 ? left : 1 + int(random.below(quint32(left - i + 1)));
+
+    if(!m_transport->send(packet.constData() + pos, len))
+      return false;
+
+    m_metrics.bytes_out.inc(quint64(len));
+    pos += len;
+
+    if(i > 1 && m_params.split_gap && !sleepUntil(nowNs() + qint64(m_params.split_gap) * 1000))
+      return false;
+
+  }
+
+  return true;
+
+}
+
+void sim::SvStreamThread::run()
+{
+  // параметры реального времени применяются в потоке имитатора
+  QString rt_error;
+  if(!rt::apply(m_realtime, &rt_error))
+    emit message(rt_error, sv::log::llError, sv::log::mtError);
+
+  // моменты отправки не сдвигаются планировщиком таймеров
+  prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+
+  emit message(QString("Поток %1 запущен: %2, %3 пакетов/с")
+               .arg(m_params.name).arg(m_transport->description())
+               .arg(m_params.rate > 0 ? QString::number(m_params.rate) : QString("без пауз")),
+               sv::log::llInfo, sv::log::mtInfo);
+
+  sim::Random random(m_params.seed);
+  QByteArray packet;
+
+  qint64 period = m_params.rate > 0 ? qint64(1e9 / m_params.rate) : 0;
+  qint64 jitter = qint64(m_params.jitter) * 1000;
+
+  qint64 start  = nowNs();
+  qint64 finish = m_params.duration ? start + qint64(m_params.duration) * 1000000000LL : 0;
+  quint64 seq   = 0;
+
+  while(m_is_active) {
+
+    if(period) {
+
+      qint64 at = start + qint64(seq) * period;
+
+      // поток надолго остановлен (отладчик, перегрузка) - отсчет начинается заново
+      if(nowNs() - at > MAX_LAG) {
+
+        start = nowNs() - qint64(seq) * period;
+        at    = start + qint64(seq) * period;
+
+      }
+
+      if(jitter)
+        at += qint64(random.below(quint32(2 * jitter / 1000 + 1))) * 1000 - jitter;
+
+      if(!sleepUntil(at))
+        break;
+
+    }
+
+    if(finish && nowNs() >= finish)
+      break;
+
+    bool crc_error = random.chance(m_params.crc_error);
+
+    m_format->frame(seq, random, packet, crc_error);
+
+    if(crc_error)
+      m_crc_errors++;
+
+    // порча байта данных, заголовок не затрагивается
+    if(random.chance(m_params.corrupt) && packet.size() > m_format->headerSize()) {
+
+      int i = m_format->headerSize() + int(random.below(quint32(packet.size() - m_format->headerSize())));
+      packet[i] = char(quint8(packet.at(i)) ^ quint8(1 + random.below(255)));
+
+      m_corrupted++;
+
+    }
+
+    if(send(packet, random))
+      m_sent++;
+
+    else {
+
+      m_dropped++;
+      m_metrics.drops.inc();
+
+    }
+
+    seq++;
+
+  }
+
+  emit message(QString("Поток %1 остановлен. Отправлено пакетов: %2, не отправлено: %3, разбито: %4, испорчено: %5, с ошибкой crc: %6")
+               .arg(m_params.name).arg(m_sent).arg(m_dropped).arg(m_split).arg(m_corrupted).arg(m_crc_errors),
+               sv::log::llInfo, sv::log::mtInfo);
+
+}
+
+/** ********** EXPORT ************ **/
+modus::SvAbstractProvider* create()
+{
+  modus::SvAbstractProvider* simulator = new sim::SvSimulator();
+  return simulator;
+}
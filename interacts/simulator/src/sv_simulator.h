@@ -0,0 +1,124 @@
+/**********************************************************************
+ *  имитатор устройств: генератор потоков данных для стендовых и
+ *  длительных испытаний без реального оборудования.
+ *
+ *  каждый поток сценария (simulator_defs.h) работает в своем потоке
+ *  исполнения: формирует пакеты заданного формата и отправляет их
+ *  через транспорт с заданной частотой. моменты отправки отсчитываются
+ *  от начала работы по абсолютному времени (CLOCK_MONOTONIC), поэтому
+ *  ошибка не накапливается; отстающий поток досылает пропущенные пакеты.
+ *
+ *  для проверки устойчивости разбора пакеты можно разбивать на части,
+ *  портить байты данных и контрольную сумму. счетчики отправленных
+ *  байт и потерянных пакетов - метрики интерфейса "sim:<имя потока>"
+ *  (sv_metrics.h), итог выводится в журнал при остановке потока.
+ * *********************************************************************/
+
+#ifndef SV_SIMULATOR_H
+#define SV_SIMULATOR_H
+
+#include <QThread>
+#include <QList>
+#include <QByteArray>
+
+#include <atomic>
+
+#include "simulator_global.h"
+
+#include "../../../../Modus/global/interact/sv_abstract_interact.h"
+#include "../../../../Modus/global/global_defs.h"
+#include "../../../../Modus/global/configuration.h"
+
+#include "../../../global/sv_realtime.h"
+#include "../../../global/sv_metrics.h"
+
+#include "simulator_defs.h"
+#include "sv_sim_format.h"
+#include "sv_sim_transport.h"
+
+extern "C" {
+
+    INTERACT_SHARED_EXPORT modus::SvAbstractProvider* create();
+
+}
+
+namespace sim {
+
+  class SvSimulator;
+  class SvStreamThread;
+
+}
+
+class sim::SvSimulator: public modus::SvAbstractProvider
+{
+  Q_OBJECT
+
+public:
+  explicit SvSimulator();
+  ~SvSimulator();
+
+  bool configure(modus::ProviderConfig* config, modus::Configuration* configuration) override;
+
+  void start() override;
+  void stop() override;
+
+private:
+  sim::Params m_params;
+
+  // привязка потоков к ядрам и приоритет
+  rt::Params m_realtime;
+
+  QList<sim::SvStreamThread*> m_threads;
+
+  void clear();
+
+private slots:
+  void workerMessage(const QString& text, int level, int type);
+
+};
+
+class sim::SvStreamThread: public QThread
+{
+  Q_OBJECT
+
+public:
+  SvStreamThread(const sim::StreamParams& params, const rt::Params& realtime);
+  ~SvStreamThread();
+
+  // формат и транспорт. открывается до запуска, чтобы ошибки попали в конфигурирование
+  bool init(QString& error);
+
+  void stop() { m_is_active = false; }
+
+protected:
+  void run() override;
+
+private:
+  sim::StreamParams m_params;
+  rt::Params        m_realtime;
+
+  sim::SvFormat*    m_format    = nullptr;
+  sim::SvTransport* m_transport = nullptr;
+
+  std::atomic<bool> m_is_active;
+
+  metrics::InterfaceMetrics m_metrics;
+
+  quint64 m_sent      = 0;
+  quint64 m_dropped   = 0;
+  quint64 m_split     = 0;
+  quint64 m_corrupted = 0;
+  quint64 m_crc_errors = 0;
+
+  // false - поток остановлен до наступления момента
+  bool sleepUntil(qint64 ns);
+
+  bool send(const QByteArray& packet, sim::Random& random);
+
+signals:
+  // уровень и тип - sv::log::Level и sv::log::MessageTypes
+  void message(const QString& text, int level, int type);
+
+};
+
+#endif // SV_SIMULATOR_H
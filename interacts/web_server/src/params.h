@@ -19,11 +19,14 @@
 #include <QJsonObject>
 
 #include "../../../svlib/sv_exception.h"
+#include "../../global/sv_http_worker_pool.h"
+#include "../../global/sv_static_cache.h"
 
 // имена параметров для UDP
 #define P_PORT        "port"
 #define P_INDEX_FILE  "index_file"
 #define P_HTML_PATH   "html_path"
+#define P_SNAPSHOT_INTERVAL "snapshot_interval"
 
 
 #define P_IMPERMISSIBLE_VALUE "Недопустимое значение параметра %1: %2.\n%3"
@@ -39,6 +42,12 @@ namespace websrv {
     QString index_file = "index.html";
     QString html_path  = "html";
 
+    int     workers           = httpsrv::defaultWorkersCount();
+    quint16 snapshot_interval = 100;  // период обновления снимка значений сигналов, мс
+
+    qint64  cache_size        = DEFAULT_CACHE_SIZE;        // объем кэша статических файлов, байт
+    qint64  cache_file_limit  = DEFAULT_CACHE_FILE_LIMIT;  // файлы большего размера не кэшируются, байт
+
     static Params fromJsonString(const QString& json) throw (SvException)
     {
       QJsonParseError err;
@@ -82,6 +91,62 @@ namespace websrv {
       P = P_HTML_PATH;
       p.html_path = object.contains(P) ? object.value(P).toString() : "html";
 
+      /* workers */
+      P = P_WORKERS;
+      if(object.contains(P)) {
+
+        p.workers = object.value(P).toInt(0);
+
+        if(p.workers < 1)
+          throw SvException(QString(P_IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Кол-во рабочих потоков должно быть больше 0"));
+
+      }
+      else p.workers = httpsrv::defaultWorkersCount();
+
+      /* snapshot_interval */
+      P = P_SNAPSHOT_INTERVAL;
+      if(object.contains(P)) {
+
+        p.snapshot_interval = object.value(P).toInt(0);
+
+        if(p.snapshot_interval == 0)
+          throw SvException(QString(P_IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Период обновления задается в миллисекундах в диапазоне 1 - 65535"));
+
+      }
+      else p.snapshot_interval = 100;
+
+      /* cache_size */
+      P = P_CACHE_SIZE;
+      if(object.contains(P)) {
+
+        p.cache_size = qint64(object.value(P).toDouble(-1));
+
+        if(p.cache_size < 0)
+          throw SvException(QString(P_IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Объем кэша задается в байтах. 0 - кэширование отключено"));
+
+      }
+      else p.cache_size = DEFAULT_CACHE_SIZE;
+
+      /* cache_file_limit */
+      P = P_CACHE_FILE_LIMIT;
+      if(object.contains(P)) {
+
+        p.cache_file_limit = qint64(object.value(P).toDouble(-1));
+
+        if(p.cache_file_limit < 0)
+          throw SvException(QString(P_IMPERMISSIBLE_VALUE)
+                             .arg(P).arg(object.value(P).toVariant().toString())
+                             .arg("Максимальный размер кэшируемого файла задается в байтах"));
+
+      }
+      else p.cache_file_limit = DEFAULT_CACHE_FILE_LIMIT;
+
 
       return p;
 
@@ -102,6 +167,10 @@ namespace websrv {
       j.insert(P_PORT, QJsonValue(static_cast<int>(port)).toInt());
       j.insert(P_INDEX_FILE, QJsonValue(index_file).toString());
       j.insert(P_HTML_PATH, QJsonValue(html_path).toString());
+      j.insert(P_WORKERS, QJsonValue(workers).toInt());
+      j.insert(P_SNAPSHOT_INTERVAL, QJsonValue(static_cast<int>(snapshot_interval)).toInt());
+      j.insert(P_CACHE_SIZE, QJsonValue(static_cast<double>(cache_size)));
+      j.insert(P_CACHE_FILE_LIMIT, QJsonValue(static_cast<double>(cache_file_limit)));
 
       return j;
 
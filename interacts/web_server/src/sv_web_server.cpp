@@ -6,7 +6,7 @@ using namespace sv::log;
 /** ********** SvWebServer ************ **/
 
 websrv::SvWebServer::SvWebServer():
-  m_web_server(new QTcpServer(this))
+  m_web_server(new httpsrv::SvWorkerPool(this))
 {
 
 }
@@ -33,6 +33,21 @@ bool websrv::SvWebServer::init(modus::InteractConfig *config)
 
     };
 
+    // до запуска сигналы еще не привязаны, соединения принимаются только после start()
+    m_web_server->pauseAccepting();
+
+    m_cache = new httpsrv::SvStaticCache(m_params.html_path, m_params.index_file, m_params.cache_size, m_params.cache_file_limit);
+    m_cache->setParent(this);
+
+    for(int i = 0; i < m_params.workers; ++i) {
+
+      websrv::SvWebWorker* worker = new websrv::SvWebWorker(this, m_params, &m_snapshot, m_cache);
+      connect(worker, &websrv::SvWebWorker::message, this, &websrv::SvWebServer::workerMessage);
+
+      m_web_server->addHandler(worker);
+
+    }
+
     return true;
 
   }
@@ -77,244 +92,43 @@ void websrv::SvWebServer::addSignal(modus::SvSignal* signal) throw (SvException)
 
 void websrv::SvWebServer::start()
 {
-  connect(m_web_server, &QTcpServer::newConnection, this, &websrv::SvWebServer::newConnection);
-}
-
-void websrv::SvWebServer::stop()
-{
-//  emit stopThreads();
+  updateSnapshot();
 
-//  while(!m_clients.isEmpty())
-//    qApp->processEvents();
+  m_snapshot_timer = new QTimer();
+  m_snapshot_timer->setInterval(m_params.snapshot_interval);
+  connect(m_snapshot_timer, &QTimer::timeout, this, &websrv::SvWebServer::updateSnapshot);
+  m_snapshot_timer->start();
 
-  m_web_server->close();
-  qDeleteAll(m_clients.begin(), m_clients.end());
+  m_web_server->resumeAccepting();
 
 }
 
-//void websrv::SvWebServer::threadFinished()
-//{
-//  SvWebServerThread* thr = (SvWebServerThread*)(sender());
-//  m_clients.removeOne(thr);
-//  thr->deleteLater();
-//}
-
-void websrv::SvWebServer::newConnection()
+void websrv::SvWebServer::stop()
 {
-  QTcpSocket *client = m_web_server->nextPendingConnection();
+//  emit stopThreads();
 
-  connect(client, &QTcpSocket::readyRead, this, &websrv::SvWebServer::processRequest);
-  connect(client, &QTcpSocket::disconnected, this, &websrv::SvWebServer::socketDisconnected);
+  if(m_snapshot_timer) {
 
-  m_clients << client;
+    m_snapshot_timer->stop();
+    delete m_snapshot_timer;
+    m_snapshot_timer = nullptr;
 
-}
+  }
 
-void websrv::SvWebServer::socketDisconnected()
-{
-    QTcpSocket *client = qobject_cast<QTcpSocket *>(sender());
+  // закрывает соединения всех клиентов и останавливает рабочие потоки
+  m_web_server->stopHandlers();
 
-    if (client) {
-        m_clients.removeAll(client);
-        client->deleteLater();
-    }
 }
 
-void websrv::SvWebServer::processRequest()
+void websrv::SvWebServer::updateSnapshot()
 {
-    QTcpSocket *m_client = qobject_cast<QTcpSocket *>(sender());
-
-    QByteArray request = m_client->readAll();
-
-    QList<QByteArray> parts = request.split('\n');
-
-    if((parts.count() < 2))
-      return;
-
-    bool is_GET  = parts.at(0).toUpper().startsWith("GET");
-    bool is_POST = parts.at(0).toUpper().startsWith("POST");
-
-    if(!(is_GET || is_POST))
-      return;
-
-    if(m_logger && m_logger->options().log_level >= sv::log::llDebug2)
-    {
-      QStringList sd = QString(request).split("\r\n");
-      for(QString d: sd)
-        *m_logger << sv::log::llDebug2 << sv::log::mtDebug << d << sv::log::endl;
-    }
-
-    if(is_GET)
-      m_client->write(reply_GET(parts));
-
-    else if (is_POST)
-      m_client->write(reply_POST(parts));
-
-    m_client->flush(); // waitForBytesWritten(); //
-
-
-  // нужно закрыть сокет
-  m_client->close();
-
+  m_snapshot.update(m_signals_by_id);
 }
 
-QByteArray websrv::SvWebServer::reply_GET(QList<QByteArray> &parts)
+void websrv::SvWebServer::workerMessage(const QString& text, int level, int type)
 {
-  auto getErr = [=](int errorCode, QString errorString) -> QByteArray {
-
-      if(m_logger)
-        *m_logger <<llError << mtError << errorString << sv::log::endl;
-
-      return QByteArray()
-                        .append(QString("HTTP/1.1 %1 Error" \
-                                "Content-Type: text/html; charset=\"utf-8\"\r\n\r\n"
-                                "<html>"
-                                "<head><meta charset=\"UTF-8\"><title>Ошибка</title><head>"
-                                "<body>"
-                                "<p style=\"font-size: 16\">%2</p>"
-                                "<a href=\"index.html\" style=\"font-size: 14\">На главную</a>"
-                                "<p>%3</p>"
-                                "</body></html>\n")
-                                    .arg(errorCode)
-                                    .arg(errorString)
-                                    .arg(QDateTime::currentDateTime().toString())
-                                .toUtf8());
-  };
-
-  QDir dir(m_params.html_path);
-
-  QString file = QString(parts.at(0).split(' ').at(1));
-
-  if(file.startsWith('/'))
-    file.remove(0, 1);
-
-  if(QFileInfo(dir, file).isDir())
-    file = m_params.index_file;
-
-
-  QByteArray replay = QByteArray();
-
-  QFile f(dir.absoluteFilePath(file));
-
-  if(!f.exists())
-    replay = getErr(404, QString("Файл отсутствует: %1").arg(file));
-
-  else if(!f.open(QIODevice::ReadOnly))
-    replay = getErr(500, f.errorString());
-
-  else
-  {
-    QString content_type = ContentTypeBySuffix.contains(QFileInfo(file).suffix())
-                                   ? ContentTypeBySuffix.value(QFileInfo(file).suffix())
-                                   : "application/octet-stream"; //двоичный файл без указания формата (RFC 2046)
-
-
-    replay.append("HTTP/1.1 200 Ok\r\n")
-          .append(QString("Content-Type: %1; charset=\"utf-8\"\r\n\r\n").arg(content_type).toUtf8())
-          .append(f.readAll())
-          .append("\r\n");
-
-  }
-
-  if(f.isOpen())
-    f.close();
-
-  return replay;
-
-}
-
-QByteArray websrv::SvWebServer::reply_POST(QList<QByteArray> &parts)
-{
-  auto Var2Str = [](QVariant value) -> QString {
-
-      if(value.isValid())
-      {
-        switch (value.type()) {
-          case QMetaType::Int:
-
-            return QString::number(value.toInt());
-            break;
-
-          case QMetaType::Double:
-
-            return QString::number(value.toDouble());
-            break;
-
-          default:
-            return "";
-
-        }
-      }
-
-      return "";
-
-  };
-
-  QStringList r1 = QString(parts.last()).split('?');
-
-  if(r1.count() < 2)
-    return QByteArray();
-
-  QString json = ""; // формируем ответ в формате JSON
-
-  if(r1.at(0) == "names")
-  {
-
-    QStringList names = QString(r1.at(1)).split(',');
-
-    for(QString name: names)
-    {
-      if(name.trimmed().isEmpty())
-        continue;
-
-      if(signalsByName()->contains(name))
-        json.append(QString("{\"name\":\"%1\",\"value\":\"%2\"},")
-                      .arg(name).arg(Var2Str(signalsByName()->value(name)->value())));
-
-    }
-
-
-    if(!json.isEmpty()) json.chop(1);
-
-
-  }
-
-  else if(r1.at(0) == "ids")
-  {
-    QStringList ids = QString(r1.at(1)).split(',');
-
-    for(QString curid: ids)
-    {
-      if(curid.trimmed().isEmpty())
-        continue;
-
-      bool ok;
-      int id = curid.toInt(&ok);
-
-      if(ok && signalsById()->contains(id))
-        json.append(QString("{\"id\":\"%1\",\"value\":\"%2\"},")
-                      .arg(id).arg(Var2Str(signalsById()->value(id)->value())));
-
-    }
-
-    if(!json.isEmpty()) json.chop(1);
-
-  }
-
-  QByteArray http = QByteArray()
-                    .append("HTTP/1.0 200 Ok\r\n")
-                    .append("Content-Type: text/json; charset=\"utf-8\"\r\n")
-                    .append(QString("Content-Length: %1\r\n").arg(json.length() + 2))
-                    .append("Access-Control-Allow-Origin: *\r\n")
-                    .append("Access-Control-Allow-Headers: *\r\n")
-                    .append("Origin: file://\r\n\r\n")        //! обязательно два!
-                    .append("[").append(json).append("]\r\n");
-
-  if(m_logger && m_logger->options().log_level >= sv::log::llDebug2)
-    *m_logger << sv::log::llDebug2 << sv::log::mtDebug << QString(http) << sv::log::endl;
-
-  return http;
-
+  if(m_logger && m_logger->options().log_level >= level)
+    *m_logger << sv::log::Level(level) << sv::log::MessageTypes(type) << text << sv::log::endl;
 }
 
 //void websrv::SvWebServerThread::reply_GET_error(QTcpSocket& m_client, int errorCode, QString errorString)
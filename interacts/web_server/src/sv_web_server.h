@@ -15,7 +15,7 @@
 #include <QDir>
 #include <QHash>
 #include <QFileInfo>
-#include <QThreadPool>
+#include <QTimer>
 #include <QByteArray>
 #include <QDataStream>
 
@@ -24,7 +24,12 @@
 #include "../../../Modus/global/interact/sv_abstract_interact.h"
 #include "../../../Modus/global/signal/sv_signal.h"
 
+#include "../../global/sv_http_worker_pool.h"
+#include "../../global/sv_signal_snapshot.h"
+#include "../../global/sv_static_cache.h"
+
 #include "params.h"
+#include "sv_web_worker.h"
 
 
 extern "C" {
@@ -39,25 +44,6 @@ extern "C" {
 
 namespace websrv {
 
-  const QMap<QString, QString> ContentTypeBySuffix = {{"html", "text/html"},
-                                                      {"cmd",  "text/cmd"},
-                                                      {"css",  "text/css"},
-                                                      {"csv",  "text/csv"},
-                                                      {"txt",  "text/plain"},
-                                                      {"php",  "text/php"},
-                                                      {"ico",  "image/vnd.microsoft.icon"},
-                                                      {"gif",  "image/gif"},
-                                                      {"jpeg", "image/jpeg"},
-                                                      {"png",  "image/png"},
-                                                      {"svg",  "image/svg+xml"},
-                                                      {"js",   "application/javascript"},
-                                                      {"xml",  "application/xml"},
-                                                      {"zip",  "application/zip"},
-                                                      {"gzip", "application/gzip"},
-                                                      {"pdf",  "application/pdf"},
-                                                      {"json", "application/json"}
-                                                     };
-
   class SvWebServer;
 
 }
@@ -78,13 +64,21 @@ public:
   void addSignal(modus::SvSignal* signal) throw (SvException);
   void bindSignalList(QList<modus::SvSignal*>* signalList)  throw (SvException) Q_DECL_OVERRIDE;
 
+  // после запуска списки сигналов не изменяются и могут читаться из рабочих потоков
   const QMap<int, modus::SvSignal*>*      signalsById()   const { return &m_signals_by_id;   }
   const QHash<QString, modus::SvSignal*>* signalsByName() const { return &m_signals_by_name; }
 
 private:
 //  websrv::SvWebTcpServer m_server;
-  QTcpServer* m_web_server;
-  QList<QTcpSocket*> m_clients;
+  // прием соединений, запросы обрабатываются в рабочих потоках
+  httpsrv::SvWorkerPool* m_web_server;
+
+  // значения сигналов для рабочих потоков
+  httpsrv::SvSignalSnapshot m_snapshot;
+  QTimer* m_snapshot_timer = nullptr;
+
+  // кэш статических файлов, общий для рабочих потоков
+  httpsrv::SvStaticCache* m_cache = nullptr;
 
   websrv::Params m_params;
 
@@ -93,17 +87,13 @@ private:
   QMap<int, modus::SvSignal*>      m_signals_by_id;//   = QMap<int, SvSignal*>();
   QHash<QString, modus::SvSignal*> m_signals_by_name;// = QHash<QString, SvSignal*>();
 
-  QByteArray reply_GET(QList<QByteArray> &parts);
-  QByteArray reply_POST(QList<QByteArray> &parts);
-
   void run() {}
 //public slots:
 //  void threadFinished();
 
 private slots:
-  void newConnection();
-  void processRequest();
-  void socketDisconnected();
+  void updateSnapshot();
+  void workerMessage(const QString& text, int level, int type);
 
 //signals:
 //  void stopThreads();
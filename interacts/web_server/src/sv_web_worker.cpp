@@ -0,0 +1,215 @@
+#include "sv_web_worker.h"
+#include "sv_web_server.h"
+
+using namespace sv::log;
+
+
+/** ********** SvWebWorker ************ **/
+
+websrv::SvWebWorker::SvWebWorker(websrv::SvWebServer* server, const websrv::Params& params,
+                                 httpsrv::SvSignalSnapshot* snapshot, httpsrv::SvStaticCache* cache):
+  httpsrv::SvConnectionHandler(),
+  m_server(server),
+  m_params(params),
+  m_snapshot(snapshot),
+  m_cache(cache)
+{
+
+}
+
+void websrv::SvWebWorker::newConnection(QTcpSocket* socket)
+{
+  connect(socket, &QTcpSocket::readyRead, this, &websrv::SvWebWorker::processRequest);
+}
+
+void websrv::SvWebWorker::processRequest()
+{
+    QTcpSocket *m_client = qobject_cast<QTcpSocket *>(sender());
+
+    QByteArray request = m_client->readAll();
+
+    QList<QByteArray> parts = request.split('\n');
+
+    if((parts.count() < 2))
+      return;
+
+    bool is_GET  = parts.at(0).toUpper().startsWith("GET");
+    bool is_POST = parts.at(0).toUpper().startsWith("POST");
+
+    if(!(is_GET || is_POST))
+      return;
+
+    QStringList sd = QString(request).split("\r\n");
+    for(QString d: sd)
+      emit message(d, sv::log::llDebug2, sv::log::mtDebug);
+
+    // соединение закрывается после отправки ответа. большой файл передается
+    // асинхронно, поэтому reply_GET закрывает соединение сам
+    if(is_GET) {
+
+      reply_GET(m_client, parts);
+      return;
+
+    }
+
+    m_client->write(reply_POST(parts));
+
+    m_client->flush(); // waitForBytesWritten(); //
+
+
+  // нужно закрыть сокет
+  m_client->close();
+
+}
+
+void websrv::SvWebWorker::reply_GET(QTcpSocket* client, QList<QByteArray> &parts)
+{
+  auto getErr = [=](int errorCode, QString errorString) -> QByteArray {
+
+      emit message(errorString, llError, mtError);
+
+      return QByteArray()
+                        .append(QString("HTTP/1.1 %1 Error" \
+                                "Content-Type: text/html; charset=\"utf-8\"\r\n\r\n"
+                                "<html>"
+                                "<head><meta charset=\"UTF-8\"><title>Ошибка</title><head>"
+                                "<body>"
+                                "<p style=\"font-size: 16\">%2</p>"
+                                "<a href=\"index.html\" style=\"font-size: 14\">На главную</a>"
+                                "<p>%3</p>"
+                                "</body></html>\n")
+                                    .arg(errorCode)
+                                    .arg(errorString)
+                                    .arg(QDateTime::currentDateTime().toString())
+                                .toUtf8());
+  };
+
+  QList<QByteArray> header = parts.at(0).split(' ');
+
+  if(header.count() < 2) {
+
+    client->write(getErr(400, QString("Неверный запрос")));
+    client->flush();
+    client->close();
+
+    return;
+
+  }
+
+  QString file = QString(header.at(1)).split('?').first();
+
+  httpsrv::StaticReply reply = m_cache->get(file,
+                                            httpsrv::SvStaticCache::headerField(parts, "If-None-Match"),
+                                            httpsrv::SvStaticCache::headerField(parts, "Accept-Encoding"));
+
+  if(reply.status == 404 || reply.status == 500) {
+
+    client->write(getErr(reply.status, reply.error));
+    client->flush();
+    client->close();
+
+  }
+
+  else if(!httpsrv::SvStaticCache::send(client, reply))
+    emit message(QString("Ошибка при передаче файла %1: %2").arg(file).arg(client->errorString()), llError, mtError);
+
+}
+
+QByteArray websrv::SvWebWorker::reply_POST(QList<QByteArray> &parts)
+{
+  auto Var2Str = [](QVariant value) -> QString {
+
+      if(value.isValid())
+      {
+        switch (value.type()) {
+          case QMetaType::Int:
+
+            return QString::number(value.toInt());
+            break;
+
+          case QMetaType::Double:
+
+            return QString::number(value.toDouble());
+            break;
+
+          default:
+            return "";
+
+        }
+      }
+
+      return "";
+
+  };
+
+  QStringList r1 = QString(parts.last()).split('?');
+
+  if(r1.count() < 2)
+    return QByteArray();
+
+  QString json = ""; // формируем ответ в формате JSON
+
+  // все значения в ответе берутся из одного снимка
+  httpsrv::SignalSnapshot snapshot = m_snapshot->current();
+
+  if(!snapshot)
+    return QByteArray();
+
+  if(r1.at(0) == "names")
+  {
+
+    QStringList names = QString(r1.at(1)).split(',');
+
+    for(QString name: names)
+    {
+      if(name.trimmed().isEmpty())
+        continue;
+
+      if(m_server->signalsByName()->contains(name))
+        json.append(QString("{\"name\":\"%1\",\"value\":\"%2\"},")
+                      .arg(name).arg(Var2Str(snapshot->values.value(m_server->signalsByName()->value(name)->config()->id))));
+
+    }
+
+
+    if(!json.isEmpty()) json.chop(1);
+
+
+  }
+
+  else if(r1.at(0) == "ids")
+  {
+    QStringList ids = QString(r1.at(1)).split(',');
+
+    for(QString curid: ids)
+    {
+      if(curid.trimmed().isEmpty())
+        continue;
+
+      bool ok;
+      int id = curid.toInt(&ok);
+
+      if(ok && snapshot->values.contains(id))
+        json.append(QString("{\"id\":\"%1\",\"value\":\"%2\"},")
+                      .arg(id).arg(Var2Str(snapshot->values.value(id))));
+
+    }
+
+    if(!json.isEmpty()) json.chop(1);
+
+  }
+
+  QByteArray http = QByteArray()
+                    .append("HTTP/1.0 200 Ok\r\n")
+                    .append("Content-Type: text/json; charset=\"utf-8\"\r\n")
+                    .append(QString("Content-Length: %1\r\n").arg(json.length() + 2))
+                    .append("Access-Control-Allow-Origin: *\r\n")
+                    .append("Access-Control-Allow-Headers: *\r\n")
+                    .append("Origin: file://\r\n\r\n")        //! обязательно два!
+                    .append("[").append(json).append("]\r\n");
+
+  emit message(QString(http), sv::log::llDebug2, sv::log::mtDebug);
+
+  return http;
+
+}
@@ -0,0 +1,50 @@
+#ifndef SV_WEB_WORKER_H
+#define SV_WEB_WORKER_H
+
+#include <QTcpSocket>
+#include <QDateTime>
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QByteArray>
+
+#include "../../global/sv_http_worker_pool.h"
+#include "../../global/sv_signal_snapshot.h"
+#include "../../global/sv_static_cache.h"
+
+#include "params.h"
+
+namespace websrv {
+
+  class SvWebServer;
+  class SvWebWorker;
+
+}
+
+/** обработчик запросов. работает в собственном потоке пула **/
+class websrv::SvWebWorker: public httpsrv::SvConnectionHandler
+{
+  Q_OBJECT
+
+public:
+  explicit SvWebWorker(websrv::SvWebServer* server, const websrv::Params& params,
+                       httpsrv::SvSignalSnapshot* snapshot, httpsrv::SvStaticCache* cache);
+
+protected:
+  void newConnection(QTcpSocket* socket) override;
+
+private:
+  websrv::SvWebServer*        m_server;
+  websrv::Params              m_params;
+  httpsrv::SvSignalSnapshot*  m_snapshot;
+  httpsrv::SvStaticCache*     m_cache;
+
+  void       reply_GET(QTcpSocket* client, QList<QByteArray> &parts);
+  QByteArray reply_POST(QList<QByteArray> &parts);
+
+private slots:
+  void processRequest();
+
+};
+
+#endif // SV_WEB_WORKER_H
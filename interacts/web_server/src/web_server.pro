@@ -9,15 +9,25 @@ QT       -= gui
 
 CONFIG += c++11 plugin
 
+LIBS += -lz
+
 TARGET = /home/user/Modus/lib/web_server
 TEMPLATE = lib
 
 DEFINES += WEBSERVER_LIBRARY
 
 SOURCES += sv_web_server.cpp \
+    sv_web_worker.cpp \
+    ../../global/sv_http_worker_pool.cpp \
+    ../../global/sv_signal_snapshot.cpp \
+    ../../global/sv_static_cache.cpp \
     ../../../Modus/global/signal/sv_signal.cpp
 
 HEADERS += sv_web_server.h\
+        sv_web_worker.h \
+    ../../global/sv_http_worker_pool.h \
+    ../../global/sv_signal_snapshot.h \
+    ../../global/sv_static_cache.h \
         webserver_global.h \
     params.h \
     ../../../Modus/global/interact/sv_abstract_interact.h \
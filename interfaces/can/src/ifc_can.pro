@@ -19,9 +19,15 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    ../../../global/sv_metrics.cpp \
+    ../../../global/sv_latency.cpp \
+    ../../../global/sv_realtime.cpp \
     sv_can.cpp
 
 HEADERS += \
+    ../../../global/sv_metrics.h \
+    ../../../global/sv_latency.h \
+    ../../../global/sv_realtime.h \
     ifc_can_global.h \
     sv_can.h \
     can_defs.h \
@@ -20,6 +20,12 @@ bool SvCAN::configure(modus::DeviceConfig *config, modus::IOBuffer *iobuffer)
 
     m_params = CANParams::fromJsonString(p_config->interface.params);
 
+    m_realtime = rt::Params::fromJsonString(p_config->interface.params);
+
+
+    m_metrics.attach(p_config->name);
+    m_latency.attach(p_config->name);
+
     {
       // задаем парметры порта с помощью ip link
       QProcess p(this);
@@ -95,6 +101,11 @@ bool SvCAN::configure(modus::DeviceConfig *config, modus::IOBuffer *iobuffer)
 
 bool SvCAN::start()
 {
+  // параметры реального времени применяются в потоке интерфейса
+  QString rt_error;
+  if(!rt::apply(m_realtime, &rt_error))
+    emit message(rt_error, sv::log::llError, sv::log::mtError);
+
   p_is_active = true;
 
   QString err;
@@ -150,6 +161,9 @@ bool SvCAN::start()
 
     else if (nbytes > 0) {
 
+      m_metrics.bytes_in.inc(quint64(nbytes));
+      m_latency.stamp();
+
       if(nbytes != framesz) {
 
 //        p_io_buffer->input->reset();
@@ -165,8 +179,12 @@ bool SvCAN::start()
 
         p_io_buffer->input->mutex.lock();
 
-        if(p_io_buffer->input->offset + framesz > p_io_buffer->input->size)
+        if(p_io_buffer->input->offset + framesz > p_io_buffer->input->size) {
+
           p_io_buffer->input->reset();
+          m_metrics.drops.inc();
+
+        }
 
         memcpy(&p_io_buffer->input->data[p_io_buffer->input->offset], &frame, framesz);
         p_io_buffer->input->offset += framesz;
@@ -189,6 +207,8 @@ bool SvCAN::start()
 
       if(nbytes > 0) {
 
+        m_metrics.bytes_out.inc(quint64(nbytes));
+
         emit_message(QByteArray((const char*)&p_io_buffer->output->data[0], p_io_buffer->output->offset),
             sv::log::llDebug, sv::log::mtSend);
 
@@ -17,6 +17,9 @@
 #include "can_defs.h"
 
 #include "../../../../Modus/global/device/interface/sv_abstract_interface.h"
+#include "../../../global/sv_realtime.h"
+#include "../../../global/sv_metrics.h"
+#include "../../../global/sv_latency.h"
 
 #define ERR_PORT_ADJUST "Ошибка при настроке порта %1: %2"
 
@@ -49,6 +52,15 @@ public slots:
 private:
   CANParams m_params;
 
+  // привязка потока интерфейса к ядрам и приоритет
+  rt::Params m_realtime;
+
+  // счетчики интерфейса, /metrics
+  metrics::InterfaceMetrics m_metrics;
+
+  // время приема данных для трассировки задержек, /latency
+  latency::Receiver m_latency;
+
   int       sock              = 0   ;
   struct    sockaddr_can addr       ;
   struct    can_frame         frame ;
@@ -28,6 +28,11 @@ bool SvTcpClient::configure(modus::DeviceConfig* config, modus::IOBuffer*iobuffe
 
     m_params = tcp::Params::fromJsonString(p_config->interface.params);
 
+    m_realtime = rt::Params::fromJsonString(p_config->interface.params);
+
+    m_metrics.attach(p_config->name);
+    m_latency.attach(p_config->name);
+
     return true;
 
   } catch (SvException& e) {
@@ -42,6 +47,11 @@ bool SvTcpClient::start()
 // Создание и инициализация объектов; создание подключений сигналов к слотам,
 // которые необходимы для работы tcp-клиента.
 {
+  // параметры реального времени применяются в потоке интерфейса
+  QString rt_error;
+  if(!rt::apply(m_realtime, &rt_error))
+    emit message(rt_error, sv::log::llError, sv::log::mtError);
+
     // Создаём объект TCP-клиента:
     m_client = new QTcpSocket;
 
@@ -174,14 +184,21 @@ void SvTcpClient::read()
    // Если места в буфере на новые данные от сокета нет, то очищаем его содержимое и
    // сбрасываем флаг "is_ready":
    if(p_io_buffer->input->offset + m_client->bytesAvailable() > p_config->bufsize)
+   {
         p_io_buffer->input->reset();
+        m_metrics.drops.inc();
+   }
 
 
    qint64 readed = m_client->read(&p_io_buffer->input->data[p_io_buffer->input->offset], p_config->bufsize - p_io_buffer->input->offset);
 
+   if(readed > 0)
+        m_metrics.bytes_in.inc(quint64(readed));
+
    if(p_io_buffer->input->offset == 0)
    { // Фиксируем момент НАЧАЛА чтения:
         p_io_buffer->input->set_time = QDateTime::currentMSecsSinceEpoch();
+        m_latency.stamp();
    }
 
   emit_message(QByteArray((const char*)&p_io_buffer->input->data[p_io_buffer->input->offset], readed), sv::log::llDebug, sv::log::mtReceive);
@@ -244,6 +261,8 @@ void SvTcpClient::write(modus::BUFF* buffer)
   {
     QByteArray sended = QByteArray((const char*)&buffer->data[0], buffer->offset);
 
+    m_metrics.bytes_out.inc(quint64(buffer->offset));
+
     emit_message(sended, sv::log::llDebug, sv::log::mtSend);
 
     //qDebug() << "TCP-клиент: Передал: ";
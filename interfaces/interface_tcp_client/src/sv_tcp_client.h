@@ -9,6 +9,9 @@
 
 #include "../../../../Modus/global/global_defs.h"
 #include "../../../../Modus/global/device/interface/sv_abstract_interface.h"
+#include "../../../global/sv_realtime.h"
+#include "../../../global/sv_metrics.h"
+#include "../../../global/sv_latency.h"
 
 #define LIB_SHORT_INFO \
   "TCP клиент. Интерфейсная библиотека Modus. Версия" LIB_VERSION "\n"
@@ -62,6 +65,15 @@ private:
  // Структура, хранящая параметры TCP-клиента:
   tcp::Params   m_params;
 
+  // привязка потока интерфейса к ядрам и приоритет
+  rt::Params    m_realtime;
+
+  // счетчики интерфейса, /metrics
+  metrics::InterfaceMetrics m_metrics;
+
+  // время приема данных для трассировки задержек, /latency
+  latency::Receiver m_latency;
+
   // Таймер, используемый в функции "SvTcpClient::read". Коментарии - в этой функции.
   QTimer*       m_gap_timer;
 
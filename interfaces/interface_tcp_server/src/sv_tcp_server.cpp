@@ -15,6 +15,11 @@ bool SvTcpServer::configure(modus::DeviceConfig* config, modus::IOBuffer*iobuffe
 
     m_params = tcp::Params::fromJsonString(p_config->interface.params);
 
+    m_realtime = rt::Params::fromJsonString(p_config->interface.params);
+
+    m_metrics.attach(p_config->name);
+    m_latency.attach(p_config->name);
+
     return true;
 
   } catch (SvException& e) {
@@ -29,6 +34,11 @@ bool SvTcpServer::start()
 // Создание и инициализация объектов; создание подключений сигналов к слотам,
 // которые необходимы для работы tcp-сервера.
 {
+  // параметры реального времени применяются в потоке интерфейса
+  QString rt_error;
+  if(!rt::apply(m_realtime, &rt_error))
+    emit message(rt_error, sv::log::llError, sv::log::mtError);
+
     // Создаём объект TCP-сервера:
     m_tcpServer = new QTcpServer(this);
 
@@ -76,14 +86,25 @@ void SvTcpServer::read()
 
   p_io_buffer->input->mutex.lock();
 
-  if(p_io_buffer->input->offset + m_clientConnection->bytesAvailable() > p_config->bufsize)
+  if(p_io_buffer->input->offset + m_clientConnection->bytesAvailable() > p_config->bufsize) {
+
     p_io_buffer->input->reset();
+    m_metrics.drops.inc();
+
+  }
 
 //  qint64 readed = p_io_buffer->input->read(m_client);
   qint64 readed = m_clientConnection->read(&p_io_buffer->input->data[p_io_buffer->input->offset], p_config->bufsize - p_io_buffer->input->offset);
 
-  if(p_io_buffer->input->offset == 0)
+  if(readed > 0)
+    m_metrics.bytes_in.inc(quint64(readed));
+
+  if(p_io_buffer->input->offset == 0) {
+
     p_io_buffer->input->set_time = QDateTime::currentMSecsSinceEpoch();
+    m_latency.stamp();
+
+  }
 
   emit_message(QByteArray((const char*)&p_io_buffer->input->data[p_io_buffer->input->offset], readed), sv::log::llDebug, sv::log::mtReceive);
 
@@ -206,9 +227,13 @@ void SvTcpServer::write(modus::BUFF* buffer)
   bool written = m_clientConnection->write((const char*)&buffer->data[0], buffer->offset) > 0;
   m_clientConnection->flush();
 
-  if(written)
+  if(written) {
+
+    m_metrics.bytes_out.inc(quint64(buffer->offset));
     emit_message(QByteArray((const char*)&buffer->data[0], buffer->offset), sv::log::llDebug, sv::log::mtSend);
 
+  }
+
   buffer->reset();
 
   buffer->mutex.unlock();
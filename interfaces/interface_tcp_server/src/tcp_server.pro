@@ -31,9 +31,15 @@ CONFIG (debug, debug|release){
 }
 
 SOURCES += \
+    ../../../global/sv_metrics.cpp \
+    ../../../global/sv_latency.cpp \
+    ../../../global/sv_realtime.cpp \
     sv_tcp_server.cpp
 
 HEADERS += \
+    ../../../global/sv_metrics.h \
+    ../../../global/sv_latency.h \
+    ../../../global/sv_realtime.h \
     ../../../../Modus/global/device/interface/sv_abstract_interface.h \
     sv_tcp_server.h \
     tcp_server_defs.h \
@@ -6,7 +6,7 @@ DEFINES += IFC_RS_LIBRARY
 
 CONFIG += c++11 plugin
 
-VERSION = 1.0.2    # major.minor.patch
+VERSION = 1.1.0    # major.minor.patch
 DEFINES +=  LIB_VERSION=\\\"$$VERSION\\\"
 DEFINES += "LIB_AUTHOR=\"\\\"Свиридов С. А.\\\"\""
 
@@ -23,13 +23,21 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
-    sv_rs.cpp
+    ../../../global/sv_metrics.cpp \
+    ../../../global/sv_latency.cpp \
+    ../../../global/sv_realtime.cpp \
+    sv_rs.cpp \
+    sv_termios.cpp
 
 HEADERS += \
+    ../../../global/sv_metrics.h \
+    ../../../global/sv_latency.h \
+    ../../../global/sv_realtime.h \
     ../../../../Modus/global/device/interface/sv_abstract_interface.h \
     ../../../../Modus/global/device/device_defs.h \
     ifc_rs_global.h \
     sv_rs.h \
+    sv_termios.h \
     rs_defs.h
 
 # Default rules for deployment.
@@ -31,6 +31,12 @@
 #define P_SERIAL_FLOWCTRL "flowcontrol"
 #define P_SERIAL_FMT      "fmt"
 #define P_DTR_CONTROL     "dtr_control"
+#define P_SERIAL_BACKEND  "backend"
+#define P_LOW_LATENCY     "low_latency"
+#define P_FRAME_GAP       "frame_gap"
+#define P_RS485           "rs485"
+#define P_RS485_DELAY_BEFORE "rs485_delay_before"
+#define P_RS485_DELAY_AFTER  "rs485_delay_after"
 
 
 const QList<int> Baudrates = {75, 115, 134, 150, 300, 600, 1200, 1800, 2400, 4800, 7200, 9600, 14400, 19200, 38400, 57600, 115200, 128000};
@@ -59,6 +65,20 @@ const QMap<QSerialPort::FlowControl, QString> FlowControls = {{QSerialPort::NoFl
 #define DEFAULT_PARITY      0
 #define DEFAULT_STOPBITS    1
 #define DEFAULT_FLOWCONTROL 0
+#define DEFAULT_FRAME_GAP   3.5   // пауза между пакетами в символах, как t3.5 в Modbus RTU
+
+#define MIN_FRAME_GAP_US    500   // меньше не имеет смысла из-за задержек планировщика и USB адаптеров
+#define IDLE_POLL_MS        100   // период проверки флага остановки, когда обмена нет
+#define WRITE_TIMEOUT_MS    1000
+
+/** реализация работы с портом **/
+enum SerialBackend {
+  sbQt,         // QSerialPort, конец пакета по таймеру grain_gap
+  sbTermios     // termios, конец пакета по паузе frame_gap, вычисленной по скорости порта
+};
+
+const QMap<QString, SerialBackend> SerialBackends = {{"qt",      sbQt},
+                                                     {"termios", sbTermios}};
 
 /** структура для хранения параметров последовательного порта **/
 struct SerialParams {
@@ -73,6 +93,15 @@ struct SerialParams {
   quint16                   grain_gap   =     DEFAULT_GRAIN_GAP;
   bool                      dtr_control =     true;
 
+  SerialBackend             backend     =     sbQt;
+  bool                      low_latency =     true;
+  double                    frame_gap   =     DEFAULT_FRAME_GAP;
+
+  // направление передачи RS-485 переключается драйвером (TIOCSRS485), а не вручную через DTR
+  bool                      rs485              = false;
+  quint32                   rs485_delay_before = 0;   // мс
+  quint32                   rs485_delay_after  = 0;   // мс
+
   bool isValid = true;
 
   static SerialParams fromJsonString(const QString& json_string) //throw (SvException)
@@ -229,6 +258,70 @@ struct SerialParams {
     else
       p.dtr_control = true;
 
+    /* backend */
+    P = P_SERIAL_BACKEND;
+    if(object.contains(P)) {
+
+      QString backend = object.value(P).toString("").toLower();
+
+      if(!SerialBackends.contains(backend))
+        throw SvException(QString(IMPERMISSIBLE_VALUE)
+                          .arg(P).arg(object.value(P).toVariant().toString())
+                          .arg("Допустимые значения: [\"qt\"|\"termios\"]"));
+
+      p.backend = SerialBackends.value(backend);
+
+    }
+    else
+      p.backend = sbQt;
+
+    /* low latency */
+    P = P_LOW_LATENCY;
+    p.low_latency = object.contains(P) ? object.value(P).toBool(true) : true;
+
+    /* frame gap */
+    P = P_FRAME_GAP;
+    if(object.contains(P)) {
+
+      if(object.value(P).toDouble(-1) <= 0)
+        throw SvException(QString(IMPERMISSIBLE_VALUE)
+                          .arg(P).arg(object.value(P).toVariant().toString())
+                          .arg("Пауза между пакетами задается в символах положительным числом"));
+
+      p.frame_gap = object.value(P).toDouble(DEFAULT_FRAME_GAP);
+
+    }
+    else
+      p.frame_gap = DEFAULT_FRAME_GAP;
+
+    /* rs485 */
+    P = P_RS485;
+    p.rs485 = object.contains(P) ? object.value(P).toBool(false) : false;
+
+    P = P_RS485_DELAY_BEFORE;
+    if(object.contains(P)) {
+
+      if(object.value(P).toInt(-1) < 0)
+        throw SvException(QString(IMPERMISSIBLE_VALUE)
+                          .arg(P).arg(object.value(P).toVariant().toString())
+                          .arg("Задержка должна быть задана целым неотрицательным числом (мсек.)"));
+
+      p.rs485_delay_before = quint32(object.value(P).toInt(0));
+
+    }
+
+    P = P_RS485_DELAY_AFTER;
+    if(object.contains(P)) {
+
+      if(object.value(P).toInt(-1) < 0)
+        throw SvException(QString(IMPERMISSIBLE_VALUE)
+                          .arg(P).arg(object.value(P).toVariant().toString())
+                          .arg("Задержка должна быть задана целым неотрицательным числом (мсек.)"));
+
+      p.rs485_delay_after = quint32(object.value(P).toInt(0));
+
+    }
+
     return p;
 
   }
@@ -251,6 +344,21 @@ struct SerialParams {
     j.insert(P_SERIAL_FLOWCTRL, QJsonValue(static_cast<int>(flowcontrol)).toInt());
     j.insert(P_SERIAL_PARITY,   QJsonValue(static_cast<int>(parity)).toInt());
     j.insert(P_SERIAL_STOPBITS, QJsonValue(static_cast<int>(stopbits)).toInt());
+    j.insert(P_SERIAL_BACKEND,  QJsonValue(SerialBackends.key(backend)));
+
+    if(backend == sbTermios) {
+
+      j.insert(P_LOW_LATENCY,   QJsonValue(low_latency));
+      j.insert(P_FRAME_GAP,     QJsonValue(frame_gap));
+      j.insert(P_RS485,         QJsonValue(rs485));
+
+      if(rs485) {
+
+        j.insert(P_RS485_DELAY_BEFORE, QJsonValue(int(rs485_delay_before)));
+        j.insert(P_RS485_DELAY_AFTER,  QJsonValue(int(rs485_delay_after)));
+
+      }
+    }
 
     return j;
 
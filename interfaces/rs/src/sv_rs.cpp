@@ -13,6 +13,12 @@ bool SvRS::configure(modus::DeviceConfig *config, modus::IOBuffer *iobuffer)
 
     m_params = SerialParams::fromJsonString(p_config->interface.params);
 
+    m_realtime = rt::Params::fromJsonString(p_config->interface.params);
+
+
+    m_metrics.attach(p_config->name);
+    m_latency.attach(p_config->name);
+
     return true;
 
   } catch (SvException& e) {
@@ -25,6 +31,14 @@ bool SvRS::configure(modus::DeviceConfig *config, modus::IOBuffer *iobuffer)
 
 bool SvRS::start()
 {
+  // параметры реального времени применяются в потоке интерфейса
+  QString rt_error;
+  if(!rt::apply(m_realtime, &rt_error))
+    emit message(rt_error, sv::log::llError, sv::log::mtError);
+
+  if(m_params.backend == sbTermios)
+    return runTermios();
+
   try {
 
     m_port = new QSerialPort();
@@ -72,12 +86,26 @@ void SvRS::read()
 
   p_io_buffer->input->mutex.lock();
 
-  if(p_io_buffer->input->offset + m_port->bytesAvailable() > p_config->bufsize)
+  if(p_io_buffer->input->offset + m_port->bytesAvailable() > p_config->bufsize) {
+
     p_io_buffer->input->reset();
+    m_metrics.drops.inc();
+
+  }
 
 //    /* ... the rest of the datagram will be lost ... */
   qint64 readed = m_port->read(&p_io_buffer->input->data[0], p_config->bufsize);
 
+  if(readed > 0) {
+
+    m_metrics.bytes_in.inc(quint64(readed));
+
+    // время приема фиксируется по первой порции пакета
+    if(p_io_buffer->input->offset == 0)
+      m_latency.stamp();
+
+  }
+
   emit_message(QByteArray((const char*)&p_io_buffer->input->data[0], readed), sv::log::llDebug, sv::log::mtReceive);
 
   p_io_buffer->input->offset += readed;
@@ -109,9 +137,13 @@ void SvRS::write(modus::BUFF* buffer)
   bool written = m_port->write(&buffer->data[0], buffer->offset) > 0;
   m_port->flush();
 
-  if(written)
+  if(written) {
+
+    m_metrics.bytes_out.inc(quint64(buffer->offset));
     emit_message(QByteArray((const char*)&buffer->data[0], buffer->offset), sv::log::llDebug, sv::log::mtSend);
 
+  }
+
   buffer->reset();
 
   if(m_params.dtr_control)
@@ -121,6 +153,299 @@ void SvRS::write(modus::BUFF* buffer)
 
 }
 
+void SvRS::stop()
+{
+  p_is_active = false;
+
+  // цикл termios завершится при ближайшем пробуждении
+  wake();
+
+  modus::SvAbstractInterface::stop();
+
+}
+
+/** ********** termios ************ **/
+
+bool SvRS::openTermios()
+{
+  QString port = serial::device(m_params);
+
+  QStringList warnings;
+  bool rs485;
+
+  m_fd = serial::open(m_params, &p_last_error, warnings, &rs485);
+
+  for(QString w: warnings)
+    emit message(w, lldbg, mterr);
+
+  if(m_fd < 0)
+    return false;
+
+  // если направление RS-485 не переключает драйвер, оно переключается через DTR
+  m_manual_dtr = m_params.dtr_control && !rs485;
+
+  if(m_manual_dtr) {
+
+    if(m_params.rs485)
+      emit message(QString("Порт %1: направление передачи переключается через DTR").arg(port), lldbg, mtdbg);
+
+    setDtr(false);
+
+  }
+
+  m_frame_gap_us = serial::frameGapUs(m_params);
+
+  m_wake = eventfd(0, EFD_NONBLOCK);
+
+  if(m_wake < 0) {
+
+    p_last_error = QString("Ошибка создания eventfd: %1").arg(strerror(errno));
+    closeTermios();
+
+    return false;
+
+  }
+
+  emit message(QString("Порт %1 открыт (termios), пауза между пакетами %2 мкс").arg(port).arg(m_frame_gap_us), lldbg, mtdbg);
+
+  return true;
+
+}
+
+void SvRS::closeTermios()
+{
+  if(m_fd >= 0) {
+
+    ::close(m_fd);
+    m_fd = -1;
+
+  }
+
+  QMutexLocker locker(&m_wake_mutex);
+
+  if(m_wake >= 0) {
+
+    ::close(m_wake);
+    m_wake = -1;
+
+  }
+}
+
+void SvRS::wake()
+{
+  QMutexLocker locker(&m_wake_mutex);
+
+  if(m_wake >= 0)
+    eventfd_write(m_wake, 1);
+
+}
+
+bool SvRS::runTermios()
+{
+  if(!openTermios())
+    return false;
+
+  // readyWrite приходит из потока протокола, а поток интерфейса занят циклом ниже.
+  // поэтому сигнал только будит цикл, запись выполняется в нем
+  connect(p_io_buffer, &modus::IOBuffer::readyWrite, this, [this](modus::BUFF*) { wake(); },
+          Qt::DirectConnection);
+
+  m_clock.start();
+  m_sent_at = -1;
+
+  p_is_active = true;
+
+  struct pollfd fds[2];
+  fds[0].fd     = m_fd;
+  fds[0].events = POLLIN;
+  fds[1].fd     = m_wake;
+  fds[1].events = POLLIN;
+
+  while(p_is_active) {
+
+    // пока пакет принимается, ждем не дольше паузы между пакетами
+    bool receiving = p_io_buffer->input->offset > 0 && !p_io_buffer->input->isReady();
+
+    // пауза на низкой скорости может превышать секунду: tv_nsec должно быть меньше 10^9
+    qint64 wait_us = receiving ? m_frame_gap_us : qint64(IDLE_POLL_MS) * 1000;
+
+    struct timespec timeout;
+    timeout.tv_sec  = time_t(wait_us / 1000000);
+    timeout.tv_nsec = long(wait_us % 1000000) * 1000;
+
+    fds[0].revents = 0;
+    fds[1].revents = 0;
+
+    int r = ppoll(fds, 2, &timeout, nullptr);
+
+    if(r < 0) {
+
+      if(errno == EINTR)
+        continue;
+
+      emit message(QString("Устройство %1: ошибка poll: %2").arg(p_config->name).arg(strerror(errno)), lldbg, mterr);
+      break;
+
+    }
+
+    if(fds[1].revents & POLLIN) {
+
+      eventfd_t v;
+      eventfd_read(m_wake, &v);
+
+    }
+
+    if(fds[0].revents & POLLIN)
+      readTermios();
+
+    // пауза после последнего принятого байта - пакет завершен
+    else if(r == 0 && receiving) {
+
+      p_io_buffer->input->mutex.lock();
+      p_io_buffer->input->setReady(true);
+      p_io_buffer->input->mutex.unlock();
+
+      emit p_io_buffer->dataReaded(p_io_buffer->input);
+
+    }
+
+    if(fds[0].revents & (POLLERR | POLLHUP)) {
+
+      emit message(QString("Устройство %1: порт закрыт").arg(p_config->name), lldbg, mterr);
+      break;
+
+    }
+
+    writeTermios();
+
+  }
+
+  disconnect(p_io_buffer, &modus::IOBuffer::readyWrite, this, nullptr);
+  closeTermios();
+
+  return true;
+
+}
+
+void SvRS::readTermios()
+{
+  p_io_buffer->input->mutex.lock();
+
+  if(p_io_buffer->input->isReady())
+    p_io_buffer->input->reset();
+
+  if(p_io_buffer->input->offset >= p_config->bufsize) {
+
+    p_io_buffer->input->reset();
+    m_metrics.drops.inc();
+
+  }
+
+  ssize_t readed = ::read(m_fd, &p_io_buffer->input->data[p_io_buffer->input->offset], size_t(p_config->bufsize - p_io_buffer->input->offset));
+
+  if(readed > 0) {
+
+    m_metrics.bytes_in.inc(quint64(readed));
+
+    // время от окончания передачи запроса до первого байта ответа
+    if(m_sent_at >= 0) {
+
+      qint64 turnaround = m_clock.nsecsElapsed() / 1000 - m_sent_at;
+      m_sent_at = -1;
+
+      emit message(QString("Время ответа %1 мкс").arg(turnaround), lldbg, mtdbg);
+
+    }
+
+    if(p_io_buffer->input->offset == 0) {
+
+      p_io_buffer->input->set_time = QDateTime::currentMSecsSinceEpoch();
+      m_latency.stamp();
+
+    }
+
+    emit_message(QByteArray((const char*)&p_io_buffer->input->data[p_io_buffer->input->offset], int(readed)), sv::log::llDebug, sv::log::mtReceive);
+
+    p_io_buffer->input->offset += readed;
+
+  }
+
+  p_io_buffer->input->mutex.unlock();
+
+}
+
+void SvRS::writeTermios()
+{
+  modus::BUFF* buffer = p_io_buffer->output;
+
+  if(!buffer->isReady())
+    return;
+
+  buffer->mutex.lock();
+
+  if(m_manual_dtr)
+    setDtr(true);
+
+  qint64 total   = buffer->offset;
+  qint64 written = 0;
+
+  while(written < total) {
+
+    ssize_t w = ::write(m_fd, &buffer->data[written], size_t(total - written));
+
+    if(w > 0) {
+
+      written += w;
+      continue;
+
+    }
+
+    if(w < 0 && (errno == EAGAIN || errno == EINTR)) {
+
+      struct pollfd p;
+      p.fd      = m_fd;
+      p.events  = POLLOUT;
+      p.revents = 0;
+
+      if(::poll(&p, 1, WRITE_TIMEOUT_MS) > 0)
+        continue;
+
+    }
+
+    break;
+
+  }
+
+  // ждем фактической передачи последнего байта, после этого линию можно отпускать
+  tcdrain(m_fd);
+
+  if(m_manual_dtr)
+    setDtr(false);
+
+  m_sent_at = m_clock.nsecsElapsed() / 1000;
+
+  if(written > 0) {
+
+    m_metrics.bytes_out.inc(quint64(written));
+    emit_message(QByteArray((const char*)&buffer->data[0], int(written)), sv::log::llDebug, sv::log::mtSend);
+
+  }
+
+  if(written < total)
+    emit message(QString("Устройство %1: отправлено %2 байт из %3").arg(p_config->name).arg(written).arg(total), lldbg, mterr);
+
+  buffer->reset();
+
+  buffer->mutex.unlock();
+
+}
+
+void SvRS::setDtr(bool on)
+{
+  int flag = TIOCM_DTR;
+  ioctl(m_fd, on ? TIOCMBIS : TIOCMBIC, &flag);
+}
+
 void SvRS::emit_message(const QByteArray& bytes, sv::log::Level level, sv::log::MessageTypes type)
 {
   QString msg = "";
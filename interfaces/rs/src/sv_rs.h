@@ -2,11 +2,26 @@
 #define SV_RS_H
 
 #include <QSerialPort>
+#include <QElapsedTimer>
+#include <QMutex>
+
+#include <termios.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/eventfd.h>
 
 #include "ifc_rs_global.h"
 #include "rs_defs.h"
+#include "sv_termios.h"
 
 #include "../../../../Modus/global/device/interface/sv_abstract_interface.h"
+#include "../../../global/sv_realtime.h"
+#include "../../../global/sv_metrics.h"
+#include "../../../global/sv_latency.h"
 
 extern "C" {
 
@@ -28,12 +43,43 @@ private:
   QSerialPort*  m_port    = nullptr;
   SerialParams  m_params;
 
+  // привязка потока интерфейса к ядрам и приоритет
+  rt::Params m_realtime;
+
+  // счетчики интерфейса, /metrics
+  metrics::InterfaceMetrics m_metrics;
+
+  // время приема данных для трассировки задержек, /latency
+  latency::Receiver m_latency;
+
   QTimer*        m_gap_timer;
 
+  /** termios **/
+  int            m_fd       = -1;
+  int            m_wake     = -1;   // eventfd, будит цикл start() при появлении данных на отправку
+  QMutex         m_wake_mutex;      // m_wake закрывается в потоке интерфейса, а пишется из потоков протокола и stop()
+  bool           m_manual_dtr = false;
+
+  // пауза между пакетами, мкс. вычисляется по скорости порта и формату символа
+  qint64         m_frame_gap_us = 0;
+
+  // время окончания передачи запроса, мкс. -1 - ответ не ожидается
+  QElapsedTimer  m_clock;
+  qint64         m_sent_at  = -1;
+
+  bool openTermios();
+  void closeTermios();
+  bool runTermios();
+  void readTermios();
+  void writeTermios();
+  void setDtr(bool on);
+  void wake();
+
 public slots:
   bool start() override;
   void read() override;
   void write(modus::BUFF* buffer) override;
+  void stop() override;
 
 private slots:
   void newData();
@@ -0,0 +1,179 @@
+#include "sv_termios.h"
+
+#include <termios.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+
+namespace {
+
+  speed_t termiosSpeed(quint32 baudrate)
+  {
+    switch (baudrate) {
+      case 300:     return B300;
+      case 600:     return B600;
+      case 1200:    return B1200;
+      case 1800:    return B1800;
+      case 2400:    return B2400;
+      case 4800:    return B4800;
+      case 9600:    return B9600;
+      case 19200:   return B19200;
+      case 38400:   return B38400;
+      case 57600:   return B57600;
+      case 115200:  return B115200;
+      case 230400:  return B230400;
+      case 460800:  return B460800;
+      case 921600:  return B921600;
+      default:      return B0;
+    }
+  }
+
+}
+
+QString serial::device(const SerialParams& params)
+{
+  return params.portname.startsWith('/') ? params.portname : QString("/dev/%1").arg(params.portname);
+}
+
+int serial::open(const SerialParams& params, QString* error, QStringList& warnings, bool* rs485)
+{
+  if(rs485)
+    *rs485 = false;
+
+  QString name = device(params);
+
+  speed_t speed = termiosSpeed(params.baudrate);
+
+  if(speed == B0) {
+
+    if(error) *error = QString("Скорость %1 не поддерживается (termios)").arg(params.baudrate);
+    return -1;
+
+  }
+
+  int fd = ::open(name.toLocal8Bit().constData(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+
+  if(fd < 0) {
+
+    if(error) *error = QString("Ошибка открытия порта %1: %2").arg(name).arg(strerror(errno));
+    return -1;
+
+  }
+
+  struct termios tio;
+
+  if(tcgetattr(fd, &tio) < 0) {
+
+    if(error) *error = QString("Ошибка чтения параметров порта %1: %2").arg(name).arg(strerror(errno));
+
+    ::close(fd);
+    return -1;
+
+  }
+
+  cfmakeraw(&tio);
+  cfsetispeed(&tio, speed);
+  cfsetospeed(&tio, speed);
+
+  tio.c_cflag |= CLOCAL | CREAD;
+
+  tio.c_cflag &= ~CSIZE;
+  switch (params.databits) {
+    case QSerialPort::Data5: tio.c_cflag |= CS5; break;
+    case QSerialPort::Data6: tio.c_cflag |= CS6; break;
+    case QSerialPort::Data7: tio.c_cflag |= CS7; break;
+    default:                 tio.c_cflag |= CS8; break;
+  }
+
+  tio.c_cflag &= ~(PARENB | PARODD | CMSPAR);
+  switch (params.parity) {
+    case QSerialPort::EvenParity:  tio.c_cflag |= PARENB; break;
+    case QSerialPort::OddParity:   tio.c_cflag |= PARENB | PARODD; break;
+    case QSerialPort::SpaceParity: tio.c_cflag |= PARENB | CMSPAR; break;
+    case QSerialPort::MarkParity:  tio.c_cflag |= PARENB | CMSPAR | PARODD; break;
+    default: break;
+  }
+
+  if(params.stopbits == QSerialPort::OneStop)
+    tio.c_cflag &= ~CSTOPB;
+  else
+    tio.c_cflag |= CSTOPB;
+
+  tio.c_cflag &= ~CRTSCTS;
+  tio.c_iflag &= ~(IXON | IXOFF | IXANY);
+
+  if(params.flowcontrol == QSerialPort::HardwareControl)
+    tio.c_cflag |= CRTSCTS;
+
+  else if(params.flowcontrol == QSerialPort::SoftwareControl)
+    tio.c_iflag |= IXON | IXOFF;
+
+  // read возвращает сразу то, что есть. конец пакета определяется паузой,
+  // т.к. VTIME задается в десятых долях секунды и слишком груб для высоких скоростей
+  tio.c_cc[VMIN]  = 0;
+  tio.c_cc[VTIME] = 0;
+
+  if(tcsetattr(fd, TCSANOW, &tio) < 0) {
+
+    if(error) *error = QString("Ошибка установки параметров порта %1: %2").arg(name).arg(strerror(errno));
+
+    ::close(fd);
+    return -1;
+
+  }
+
+  tcflush(fd, TCIOFLUSH);
+
+  // драйвер передает принятые данные без задержки на накопление
+  if(params.low_latency) {
+
+    struct serial_struct ss;
+
+    if(ioctl(fd, TIOCGSERIAL, &ss) == 0) {
+
+      ss.flags |= ASYNC_LOW_LATENCY;
+
+      if(ioctl(fd, TIOCSSERIAL, &ss) < 0)
+        warnings << QString("Порт %1: режим low latency не установлен: %2").arg(name).arg(strerror(errno));
+
+    }
+    else
+      warnings << QString("Порт %1: режим low latency не поддерживается драйвером").arg(name);
+
+  }
+
+  // направление передачи RS-485 переключает драйвер
+  if(params.rs485) {
+
+    struct serial_rs485 conf;
+    memset(&conf, 0, sizeof(conf));
+
+    conf.flags                 = SER_RS485_ENABLED | SER_RS485_RTS_ON_SEND;
+    conf.delay_rts_before_send = params.rs485_delay_before;
+    conf.delay_rts_after_send  = params.rs485_delay_after;
+
+    if(ioctl(fd, TIOCSRS485, &conf) < 0)
+      warnings << QString("Порт %1: драйвер не поддерживает RS-485 (%2)").arg(name).arg(strerror(errno));
+
+    else if(rs485)
+      *rs485 = true;
+
+  }
+
+  return fd;
+
+}
+
+qint64 serial::frameGapUs(const SerialParams& params)
+{
+  // длительность символа: старт + данные + четность + стоп
+  int bits = 1 + int(params.databits)
+               + (params.parity == QSerialPort::NoParity ? 0 : 1)
+               + (params.stopbits == QSerialPort::OneStop ? 1 : 2);
+
+  return qMax(qint64(MIN_FRAME_GAP_US), qint64(params.frame_gap * bits * 1000000.0 / params.baudrate));
+
+}
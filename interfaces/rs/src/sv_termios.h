@@ -0,0 +1,34 @@
+/**********************************************************************
+ *  открытие последовательного порта средствами termios.
+ *
+ *  общая часть интерфейсов rs (режим termios) и rs_hub: порт
+ *  открывается неблокирующим, устанавливаются скорость, формат
+ *  символа, управление потоком, режим low latency и RS-485.
+ *  read возвращает сразу то, что есть (VMIN = VTIME = 0), конец
+ *  пакета определяется вызывающей стороной по паузе frameGapUs.
+ * *********************************************************************/
+
+#ifndef SV_TERMIOS_H
+#define SV_TERMIOS_H
+
+#include <QString>
+#include <QStringList>
+
+#include "rs_defs.h"
+
+namespace serial {
+
+  // открытие и настройка порта. возвращает дескриптор, при ошибке -1 и текст в error.
+  // некритичные ошибки (low latency, RS-485) добавляются в warnings, порт остается открытым.
+  // rs485 - направление передачи RS-485 переключает драйвер
+  int open(const SerialParams& params, QString* error, QStringList& warnings, bool* rs485 = nullptr);
+
+  // пауза между пакетами, мкс: frame_gap символов при скорости порта, не меньше MIN_FRAME_GAP_US
+  qint64 frameGapUs(const SerialParams& params);
+
+  // полное имя устройства порта
+  QString device(const SerialParams& params);
+
+}
+
+#endif // SV_TERMIOS_H
@@ -0,0 +1,47 @@
+QT -= gui
+QT += serialport
+
+TEMPLATE = lib
+DEFINES += RS_HUB_LIBRARY
+
+CONFIG += c++11 plugin
+
+VERSION = 1.0.0    # major.minor.patch
+DEFINES +=  LIB_VERSION=\\\"$$VERSION\\\"
+DEFINES += "LIB_AUTHOR=\"\\\"Свиридов С. А.\\\"\""
+
+TARGET = /home/user/Modus/lib/interfaces/rs_hub
+# The following define makes your compiler emit warnings if you use
+# any Qt feature that has been marked deprecated (the exact warnings
+# depend on your compiler). Please consult the documentation of the
+# deprecated API in order to know how to port your code away from it.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# Для генерации ошибки линкёра в случае наличия неопределённых
+# ссылок (undefined references) при сборке разделяемой библиотеки:
+QMAKE_LFLAGS += -Wno-unused-variable, -Wl,--no-undefined
+
+SOURCES += \
+    ../../../global/sv_metrics.cpp \
+    ../../../global/sv_latency.cpp \
+    ../../rs/src/sv_termios.cpp \
+    sv_rs_hub.cpp \
+    sv_serial_hub.cpp
+
+HEADERS += \
+    ../../../global/sv_metrics.h \
+    ../../../global/sv_latency.h \
+    ../../../../Modus/global/device/interface/sv_abstract_interface.h \
+    ../../../../Modus/global/device/device_defs.h \
+    ../../rs/src/rs_defs.h \
+    ../../rs/src/sv_termios.h \
+    rs_hub_global.h \
+    rs_hub_defs.h \
+    sv_rs_hub.h \
+    sv_serial_hub.h
+
+# Default rules for deployment.
+unix {
+    target.path = /usr/lib
+}
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,111 @@
+/**********************************************************************
+ *  параметры интерфейса rs_hub.
+ *  параметры порта те же, что у интерфейса rs (rs_defs.h), плюс
+ *  параметры общего для процесса пула потоков обслуживания портов
+ * *********************************************************************/
+
+#ifndef RS_HUB_DEFS_H
+#define RS_HUB_DEFS_H
+
+#include "../../rs/src/rs_defs.h"
+
+#define P_HUB_THREADS       "hub_threads"
+#define P_HUB_GROUP         "hub_group"
+
+#define DEFAULT_HUB_THREADS 1
+#define MAX_HUB_THREADS     16
+
+#define HUB_MAX_EVENTS      64
+#define HUB_WRITE_CHUNK     4096
+
+namespace rshub {
+
+  struct Params {
+
+    SerialParams  serial;
+
+    // кол-во потоков пула. задается первым подключенным портом, для остальных игнорируется
+    int           threads = DEFAULT_HUB_THREADS;
+
+    // номер потока, обслуживающего порт. -1 - поток с наименьшим кол-вом портов
+    int           group   = -1;
+
+    static Params fromJsonString(const QString& json_string) //throw (SvException)
+    {
+      QJsonParseError err;
+      QJsonDocument jd = QJsonDocument::fromJson(json_string.toUtf8(), &err);
+
+      if(err.error != QJsonParseError::NoError)
+        throw SvException(err.errorString());
+
+      try {
+        return fromJsonObject(jd.object());
+      }
+      catch(SvException& e) {
+        throw e;
+      }
+    }
+
+    static Params fromJsonObject(const QJsonObject &object) //throw (SvException)
+    {
+      Params p;
+      QString P;
+
+      p.serial = SerialParams::fromJsonObject(object);
+
+      P = P_HUB_THREADS;
+      if(object.contains(P)) {
+
+        int threads = object.value(P).toInt(-1);
+
+        if(threads < 1 || threads > MAX_HUB_THREADS)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P).arg(object.value(P).toVariant().toString())
+                            .arg(QString("Кол-во потоков должно быть задано целым числом от 1 до %1").arg(MAX_HUB_THREADS)));
+
+        p.threads = threads;
+
+      }
+      else
+        p.threads = DEFAULT_HUB_THREADS;
+
+      P = P_HUB_GROUP;
+      if(object.contains(P)) {
+
+        if(object.value(P).toInt(-2) < -1)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P).arg(object.value(P).toVariant().toString())
+                            .arg("Номер потока должен быть задан целым неотрицательным числом, либо -1"));
+
+        p.group = object.value(P).toInt(-1);
+
+      }
+      else
+        p.group = -1;
+
+      return p;
+
+    }
+
+    QString toJsonString(QJsonDocument::JsonFormat format = QJsonDocument::Indented) const
+    {
+      QJsonDocument jd;
+      jd.setObject(toJsonObject());
+
+      return QString(jd.toJson(format));
+    }
+
+    QJsonObject toJsonObject() const
+    {
+      QJsonObject j = serial.toJsonObject();
+
+      j.insert(P_HUB_THREADS, QJsonValue(threads));
+      j.insert(P_HUB_GROUP,   QJsonValue(group));
+
+      return j;
+
+    }
+  };
+}
+
+#endif // RS_HUB_DEFS_H
@@ -0,0 +1,12 @@
+#ifndef RS_HUB_GLOBAL_H
+#define RS_HUB_GLOBAL_H
+
+#include <QtCore/qglobal.h>
+
+#if defined(RS_HUB_LIBRARY)
+#  define RS_HUB_EXPORT Q_DECL_EXPORT
+#else
+#  define RS_HUB_EXPORT Q_DECL_IMPORT
+#endif
+
+#endif // RS_HUB_GLOBAL_H
@@ -0,0 +1,138 @@
+#include "sv_rs_hub.h"
+
+SvRsHub::SvRsHub()
+{
+}
+
+SvRsHub::~SvRsHub()
+{
+  stop();
+}
+
+bool SvRsHub::configure(modus::DeviceConfig *config, modus::IOBuffer *iobuffer)
+{
+  try {
+
+    p_config = config;
+    p_io_buffer = iobuffer;
+
+    m_params = rshub::Params::fromJsonString(p_config->interface.params);
+
+    m_metrics.attach(p_config->name);
+    m_latency.attach(p_config->name);
+
+    return true;
+
+  } catch (SvException& e) {
+
+    p_last_error = e.error;
+    return false;
+
+  }
+}
+
+bool SvRsHub::start()
+{
+  QMutexLocker locker(&m_lock);
+
+  if(m_port)
+    return true;
+
+  m_port = rshub::SvSerialHub::instance()->attach(m_params, this, p_io_buffer, p_config->bufsize, &p_last_error);
+
+  if(!m_port)
+    return false;
+
+  // запись выполняется сразу в потоке протокола, без перехода в поток интерфейса
+  connect(p_io_buffer, &modus::IOBuffer::readyWrite, this, &SvRsHub::write, Qt::DirectConnection);
+
+  p_is_active = true;
+
+  return true;
+
+}
+
+void SvRsHub::stop()
+{
+  p_is_active = false;
+
+  disconnect(p_io_buffer, &modus::IOBuffer::readyWrite, this, &SvRsHub::write);
+
+  QMutexLocker locker(&m_lock);
+
+  rshub::SvSerialHub::instance()->detach(m_port);
+  m_port = nullptr;
+
+}
+
+void SvRsHub::write(modus::BUFF* buffer)
+{
+  if(!buffer->isReady())
+    return;
+
+  QMutexLocker locker(&m_lock);
+
+  if(!m_port)
+    return;
+
+  buffer->mutex.lock();
+
+  rshub::SvSerialHub::instance()->write(m_port, buffer);
+  m_metrics.bytes_out.inc(quint64(buffer->offset));
+
+  emit_message(QByteArray((const char*)&buffer->data[0], buffer->offset), sv::log::llDebug, sv::log::mtSend);
+
+  buffer->reset();
+
+  buffer->mutex.unlock();
+
+}
+
+void SvRsHub::emit_message(const QByteArray& bytes, sv::log::Level level, sv::log::MessageTypes type)
+{
+  QString msg = "";
+
+  //! The append() function is typically very fast
+  switch (m_params.serial.fmt) {
+    case modus::HEX:
+      msg.append(bytes.toHex());
+      break;
+
+    case modus::ASCII:
+      msg.append(bytes);
+      break;
+
+    case modus::DATALEN:
+      msg = QString("%1 байт %2").arg(bytes.length()).arg(type == sv::log::mtSend ? "отправлено" : type == sv::log::mtReceive ? "принято" : "");
+      break;
+
+    default:
+      return;
+      break;
+  }
+
+  emit message(msg, level, type);
+
+}
+
+/** ********** EXPORT ************ **/
+modus::SvAbstractInterface* create()
+{
+  modus::SvAbstractInterface* device = new SvRsHub();
+  return device;
+}
+
+const char* getDefaultParams()
+{
+  return "{ \"portname\": \"ttyS6\", \"baudrate\": 115200, \"databits\": 8, \"parity\": 0, \"stopbits\": 1, \"flowcontrol\": 0, \"hub_threads\": 1 }";
+}
+
+const char* getName()
+{
+  return LIB_SHORT_INFO;
+}
+
+const char* getDescription()
+{
+  return LIB_DESCRIPTION;
+}
@@ -0,0 +1,77 @@
+#ifndef SV_RS_HUB_H
+#define SV_RS_HUB_H
+
+#include <QMutex>
+
+#include "rs_hub_global.h"
+#include "rs_hub_defs.h"
+#include "sv_serial_hub.h"
+
+#include "../../../../Modus/global/device/interface/sv_abstract_interface.h"
+#include "../../../global/sv_metrics.h"
+#include "../../../global/sv_latency.h"
+
+#define LIB_SHORT_INFO \
+  "Последовательный порт, обслуживаемый общим пулом потоков. Интерфейсная библиотека Modus. Версия " LIB_VERSION "\n"
+
+#define LIB_DESCRIPTION \
+  LIB_SHORT_INFO \
+  "Параметры порта задаются так же, как для интерфейса rs. Порты всех устройств процесса обслуживаются общим пулом "\
+  "из " P_HUB_THREADS " потоков (по умолчанию 1) через epoll, вместо отдельного потока, таймера и цикла событий для каждого порта. "\
+  "Поток для порта задается параметром " P_HUB_GROUP ", либо выбирается наименее загруженный.\n"\
+  "  Конец пакета определяется для каждого порта по паузе " P_FRAME_GAP " (в символах, по умолчанию 3.5), вычисленной по скорости порта. "\
+  "Принятый пакет помещается в буфер input и эмитируется сигнал dataReaded.\n"\
+  "  Данные из буфера output записываются в порт сразу в потоке протокола. Направление передачи RS-485 (" P_RS485 ") переключается драйвером.\n"\
+  "Автор " LIB_AUTHOR
+
+extern "C" {
+
+    RS_HUB_EXPORT modus::SvAbstractInterface* create();
+
+    RS_HUB_EXPORT const char* getDefaultParams();
+    RS_HUB_EXPORT const char* getName();
+    RS_HUB_EXPORT const char* getDescription();
+}
+
+class SvRsHub: public modus::SvAbstractInterface
+{
+public:
+  SvRsHub();
+  ~SvRsHub() override;
+
+  virtual bool configure(modus::DeviceConfig* config, modus::IOBuffer*iobuffer) override;
+
+  // вызывается также из потока пула
+  void emit_message(const QByteArray& bytes, sv::log::Level level, sv::log::MessageTypes type);
+
+  // счетчики интерфейса, /metrics. обновляются также потоком пула
+  metrics::InterfaceMetrics& metrics() { return m_metrics; }
+
+  // время приема данных для трассировки задержек, /latency. отмечается потоком пула
+  latency::Receiver& latency() { return m_latency; }
+
+private:
+  rshub::Params   m_params;
+
+  metrics::InterfaceMetrics m_metrics;
+
+  latency::Receiver m_latency;
+
+  rshub::Port*    m_port = nullptr;
+
+  // защищает m_port от удаления во время записи из потока протокола
+  QMutex          m_lock;
+
+public slots:
+  bool start() override;
+  void stop() override;
+
+  // чтение выполняет поток пула
+  void read() override
+  { }
+
+  void write(modus::BUFF* buffer) override;
+
+};
+
+#endif // SV_RS_HUB_H
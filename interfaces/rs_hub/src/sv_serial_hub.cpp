@@ -0,0 +1,493 @@
+#include "sv_serial_hub.h"
+#include "sv_rs_hub.h"
+
+#include <QDateTime>
+
+#include "../../rs/src/sv_termios.h"
+
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+
+qint64 rshub::monotonicUs()
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+
+  return qint64(t.tv_sec) * 1000000 + t.tv_nsec / 1000;
+
+}
+
+/** ********** SvHubLoop ************ **/
+
+rshub::SvHubLoop::SvHubLoop():
+  QThread()
+{
+
+}
+
+rshub::SvHubLoop::~SvHubLoop()
+{
+  stop();
+
+  if(m_epoll >= 0) ::close(m_epoll);
+  if(m_timer >= 0) ::close(m_timer);
+  if(m_wake  >= 0) ::close(m_wake);
+
+}
+
+bool rshub::SvHubLoop::init(QString* error)
+{
+  m_epoll = epoll_create1(EPOLL_CLOEXEC);
+  m_timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  m_wake  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+  if(m_epoll < 0 || m_timer < 0 || m_wake < 0) {
+
+    if(error) *error = QString("Ошибка создания epoll: %1").arg(strerror(errno));
+    return false;
+
+  }
+
+  // служебные дескрипторы отличаются от портов нулевым указателем
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+
+  ev.events   = EPOLLIN;
+  ev.data.ptr = nullptr;
+
+  epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_timer, &ev);
+  epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake,  &ev);
+
+  m_active = true;
+
+  return true;
+
+}
+
+bool rshub::SvHubLoop::add(Port* port, QString* error)
+{
+  QMutexLocker locker(&m_mutex);
+
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+
+  ev.events   = EPOLLIN;
+  ev.data.ptr = port;
+
+  if(epoll_ctl(m_epoll, EPOLL_CTL_ADD, port->fd, &ev) < 0) {
+
+    if(error) *error = QString("Ошибка добавления порта %1 в epoll: %2").arg(port->name).arg(strerror(errno));
+    return false;
+
+  }
+
+  m_ports.insert(port);
+  port->watched = true;
+
+  return true;
+
+}
+
+void rshub::SvHubLoop::remove(Port* port)
+{
+  // после выхода из remove поток пула больше не обращается к порту
+  m_mutex.lock();
+
+  port->watched = false;
+
+  epoll_ctl(m_epoll, EPOLL_CTL_DEL, port->fd, nullptr);
+  m_ports.remove(port);
+
+  m_mutex.unlock();
+
+  // порт мог попасть в выполняемую эмиссию dataReaded
+  m_emit.lock();
+  m_emit.unlock();
+
+}
+
+void rshub::SvHubLoop::watchWrite(Port* port, bool enable)
+{
+  // порт снят с обслуживания, его события больше не меняются
+  if(!port->watched)
+    return;
+
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+
+  ev.events   = enable ? EPOLLIN | EPOLLOUT : EPOLLIN;
+  ev.data.ptr = port;
+
+  epoll_ctl(m_epoll, EPOLL_CTL_MOD, port->fd, &ev);
+
+}
+
+int rshub::SvHubLoop::count()
+{
+  QMutexLocker locker(&m_mutex);
+  return m_ports.count();
+}
+
+void rshub::SvHubLoop::stop()
+{
+  m_active = false;
+
+  if(m_wake >= 0)
+    eventfd_write(m_wake, 1);
+
+  wait();
+
+}
+
+void rshub::SvHubLoop::run()
+{
+  struct epoll_event events[HUB_MAX_EVENTS];
+
+  while(m_active) {
+
+    int n = epoll_wait(m_epoll, events, HUB_MAX_EVENTS, -1);
+
+    if(n < 0) {
+
+      if(errno == EINTR)
+        continue;
+
+      break;
+
+    }
+
+    m_mutex.lock();
+
+    bool timer = false;
+
+    for(int i = 0; i < n; i++) {
+
+      Port* port = static_cast<Port*>(events[i].data.ptr);
+
+      if(!port) {
+
+        // timerfd и eventfd только вычитываются
+        quint64 v;
+        ssize_t r = ::read(m_timer, &v, sizeof(v));
+        r = ::read(m_wake, &v, sizeof(v));
+        Q_UNUSED(r);
+
+        timer = true;
+        continue;
+
+      }
+
+      // порт мог быть удален, пока события ждали блокировки
+      if(!m_ports.contains(port))
+        continue;
+
+      if(events[i].events & EPOLLIN)
+        readPort(port);
+
+      if(events[i].events & EPOLLOUT)
+        writePending(port);
+
+      if(events[i].events & (EPOLLERR | EPOLLHUP)) {
+
+        emit port->owner->message(QString("Порт %1 закрыт").arg(port->name), lldbg, mterr);
+
+        // порт больше не обслуживается: нет событий, срока пакета и учета в загрузке потока.
+        // дескриптор закрывается при отключении (detach)
+        port->watched = false;
+
+        epoll_ctl(m_epoll, EPOLL_CTL_DEL, port->fd, nullptr);
+        m_ports.remove(port);
+
+      }
+    }
+
+    QList<Port*> ready;
+
+    if(timer || n == 0)
+      ready = expire(monotonicUs());
+
+    armTimer();
+
+    // обработчики dataReaded не задерживают подключение портов и запись
+    m_emit.lock();
+    m_mutex.unlock();
+
+    for(Port* port: ready)
+      emit port->buffer->dataReaded(port->buffer->input);
+
+    m_emit.unlock();
+
+  }
+}
+
+void rshub::SvHubLoop::readPort(Port* port)
+{
+  modus::BUFF* input = port->buffer->input;
+
+  input->mutex.lock();
+
+  // протокол уже получил предыдущий пакет
+  if(input->isReady())
+    input->reset();
+
+  if(input->offset >= port->bufsize) {
+
+    input->reset();
+    port->owner->metrics().drops.inc();
+
+  }
+
+  ssize_t readed = ::read(port->fd, &input->data[input->offset], size_t(port->bufsize - input->offset));
+
+  if(readed > 0) {
+
+    port->owner->metrics().bytes_in.inc(quint64(readed));
+
+    if(input->offset == 0) {
+
+      input->set_time = QDateTime::currentMSecsSinceEpoch();
+      port->owner->latency().stamp();
+
+    }
+
+    port->owner->emit_message(QByteArray((const char*)&input->data[input->offset], int(readed)), sv::log::llDebug, sv::log::mtReceive);
+
+    input->offset += readed;
+
+    // пакет продолжается, срок его окончания отодвигается
+    port->deadline = monotonicUs() + port->gap_us;
+
+  }
+
+  input->mutex.unlock();
+
+}
+
+void rshub::SvHubLoop::writePending(Port* port)
+{
+  QMutexLocker locker(&port->wmutex);
+
+  while(!port->pending.isEmpty()) {
+
+    ssize_t w = ::write(port->fd, port->pending.constData(), size_t(qMin(port->pending.size(), HUB_WRITE_CHUNK)));
+
+    if(w <= 0)
+      break;
+
+    port->pending.remove(0, int(w));
+
+  }
+
+  if(port->pending.isEmpty())
+    watchWrite(port, false);
+
+}
+
+QList<rshub::Port*> rshub::SvHubLoop::expire(qint64 now)
+{
+  QList<Port*> ready;
+
+  for(Port* port: m_ports) {
+
+    if(port->deadline < 0 || port->deadline > now)
+      continue;
+
+    port->deadline = -1;
+
+    modus::BUFF* input = port->buffer->input;
+
+    input->mutex.lock();
+    input->setReady(true);
+    input->mutex.unlock();
+
+    ready.append(port);
+
+  }
+
+  return ready;
+
+}
+
+void rshub::SvHubLoop::armTimer()
+{
+  qint64 next = -1;
+
+  for(Port* port: m_ports)
+    if(port->deadline >= 0 && (next < 0 || port->deadline < next))
+      next = port->deadline;
+
+  struct itimerspec ts;
+  memset(&ts, 0, sizeof(ts));
+
+  // нулевое значение снимает таймер
+  if(next >= 0) {
+
+    ts.it_value.tv_sec  = next / 1000000;
+    ts.it_value.tv_nsec = (next % 1000000) * 1000;
+
+  }
+
+  timerfd_settime(m_timer, TFD_TIMER_ABSTIME, &ts, nullptr);
+
+}
+
+/** ********** SvSerialHub ************ **/
+
+rshub::SvSerialHub* rshub::SvSerialHub::instance()
+{
+  static SvSerialHub hub;
+  return &hub;
+}
+
+rshub::Port* rshub::SvSerialHub::attach(const Params& params, SvRsHub* owner, modus::IOBuffer* buffer, quint32 bufsize, QString* error)
+{
+  QMutexLocker locker(&m_mutex);
+
+  // пул создается при подключении первого порта
+  if(m_loops.isEmpty()) {
+
+    for(int i = 0; i < params.threads; i++) {
+
+      SvHubLoop* loop = new SvHubLoop;
+
+      if(!loop->init(error)) {
+
+        delete loop;
+        qDeleteAll(m_loops);
+        m_loops.clear();
+
+        return nullptr;
+
+      }
+
+      loop->start(QThread::TimeCriticalPriority);
+      m_loops.append(loop);
+
+    }
+  }
+
+  else if(params.threads != m_loops.count())
+    emit owner->message(QString("Пул уже запущен с кол-вом потоков %1, значение %2 игнорируется")
+                        .arg(m_loops.count()).arg(params.threads), lldbg, mtdbg);
+
+  // запись выполняется без ожидания передачи, поэтому направление RS-485
+  // может переключать только драйвер. ручное управление DTR не поддерживается
+  QStringList warnings;
+
+  int fd = serial::open(params.serial, error, warnings);
+
+  for(QString w: warnings)
+    emit owner->message(w, lldbg, mterr);
+
+  if(fd < 0)
+    return nullptr;
+
+  Port* port = new Port;
+
+  port->fd      = fd;
+  port->name    = params.serial.portname;
+  port->owner   = owner;
+  port->buffer  = buffer;
+  port->bufsize = bufsize;
+  port->gap_us  = serial::frameGapUs(params.serial);
+
+  // поток задан явно, либо выбирается наименее загруженный
+  if(params.group >= 0)
+    port->loop = params.group % m_loops.count();
+
+  else {
+
+    port->loop = 0;
+
+    for(int i = 1; i < m_loops.count(); i++)
+      if(m_loops.at(i)->count() < m_loops.at(port->loop)->count())
+        port->loop = i;
+
+  }
+
+  port->hub_loop = m_loops.at(port->loop);
+
+  if(!port->hub_loop->add(port, error)) {
+
+    ::close(fd);
+    delete port;
+
+    return nullptr;
+
+  }
+
+  m_attached++;
+
+  emit owner->message(QString("Порт %1 обслуживается потоком %2 из %3, пауза между пакетами %4 мкс")
+                      .arg(port->name).arg(port->loop).arg(m_loops.count()).arg(port->gap_us), lldbg, mtdbg);
+
+  return port;
+
+}
+
+void rshub::SvSerialHub::detach(Port* port)
+{
+  if(!port)
+    return;
+
+  QMutexLocker locker(&m_mutex);
+
+  port->hub_loop->remove(port);
+
+  ::close(port->fd);
+  delete port;
+
+  // последний порт отключен, потоки пула больше не нужны
+  if(--m_attached == 0) {
+
+    qDeleteAll(m_loops);
+    m_loops.clear();
+
+  }
+}
+
+void rshub::SvSerialHub::write(Port* port, modus::BUFF* buffer)
+{
+  QMutexLocker locker(&port->wmutex);
+
+  // порт закрыт с ошибкой и снят с обслуживания
+  if(!port->watched)
+    return;
+
+  const char* data  = (const char*)&buffer->data[0];
+  qint64      total = buffer->offset;
+  qint64      written = 0;
+
+  // предыдущие данные еще не переданы, новые ставятся за ними
+  if(port->pending.isEmpty()) {
+
+    while(written < total) {
+
+      ssize_t w = ::write(port->fd, data + written, size_t(total - written));
+
+      if(w > 0)
+        written += w;
+
+      else if(w < 0 && errno == EINTR)
+        continue;
+
+      else
+        break;
+
+    }
+  }
+
+  if(written < total) {
+
+    port->pending.append(data + written, int(total - written));
+
+    // без блокировки пула: поток пула берет wmutex под своей блокировкой
+    port->hub_loop->watchWrite(port, true);
+
+  }
+}
@@ -0,0 +1,143 @@
+/**********************************************************************
+ *  общий для процесса пул обслуживания последовательных портов.
+ *
+ *  каждый поток пула обслуживает свои порты одним вызовом epoll_wait.
+ *  конец пакета определяется для каждого порта отдельно по паузе
+ *  frame_gap, вычисленной по скорости порта. ближайший срок по всем
+ *  портам потока задается одним timerfd, поэтому точность паузы не
+ *  ограничена миллисекундным таймаутом epoll_wait.
+ *
+ *  принятые данные помещаются непосредственно в буфер input устройства,
+ *  по окончании пакета эмитируется dataReaded. запись выполняется в
+ *  потоке, вызвавшем write; остаток, не принятый драйвером, дописывается
+ *  потоком пула по готовности порта (EPOLLOUT).
+ *
+ *  порядок блокировок: пул (SvSerialHub) -> поток пула -> запись порта
+ *  (wmutex). write берет только wmutex. dataReaded эмитируется после
+ *  освобождения блокировки потока, под блокировкой m_emit: remove ждет
+ *  ее, поэтому обработчик dataReaded не должен отключать порты.
+ * *********************************************************************/
+
+#ifndef SV_SERIAL_HUB_H
+#define SV_SERIAL_HUB_H
+
+#include <QThread>
+#include <QMutex>
+#include <QSet>
+#include <QList>
+
+#include <atomic>
+
+#include "rs_hub_defs.h"
+
+#include "../../../../Modus/global/device/interface/sv_abstract_interface.h"
+
+class SvRsHub;
+
+namespace rshub {
+
+  class SvHubLoop;
+  class SvSerialHub;
+
+  /** состояние обслуживаемого порта **/
+  struct Port {
+
+    int               fd        = -1;
+    QString           name;
+
+    SvRsHub*          owner     = nullptr;
+    modus::IOBuffer*  buffer    = nullptr;
+    quint32           bufsize   = 0;
+
+    qint64            gap_us    = 0;    // пауза между пакетами
+    qint64            deadline  = -1;   // момент окончания пакета, мкс. -1 - пакет не принимается
+
+    // данные, не принятые драйвером при записи
+    QMutex            wmutex;
+    QByteArray        pending;
+
+    int               loop      = 0;
+
+    // порт зарегистрирован в epoll потока пула. снимается при отключении
+    // и при ошибке порта, после этого write не меняет его события
+    std::atomic<bool> watched   {false};
+
+    // поток пула, обслуживающий порт. существует, пока порт подключен,
+    // поэтому write обращается к нему без блокировки пула
+    SvHubLoop*        hub_loop  = nullptr;
+
+  };
+
+  // текущее значение монотонных часов, мкс
+  qint64 monotonicUs();
+
+}
+
+class rshub::SvHubLoop: public QThread
+{
+public:
+  SvHubLoop();
+  ~SvHubLoop() override;
+
+  bool init(QString* error);
+
+  bool add(Port* port, QString* error);
+  void remove(Port* port);
+
+  // порт ожидает готовности к записи
+  void watchWrite(Port* port, bool enable);
+
+  int  count();
+
+  void stop();
+
+protected:
+  void run() override;
+
+private:
+  int             m_epoll   = -1;
+  int             m_timer   = -1;   // timerfd, ближайший срок окончания пакета
+  int             m_wake    = -1;   // eventfd, пробуждение при остановке
+
+  QMutex          m_mutex;
+  QSet<Port*>     m_ports;
+
+  // эмиссия dataReaded вне m_mutex. берется под m_mutex, отпускается после эмиссии
+  QMutex          m_emit;
+
+  std::atomic<bool> m_active {false};
+
+  void readPort(Port* port);
+  void writePending(Port* port);
+  // порты, у которых закончился пакет. dataReaded эмитируется вызывающим без блокировки потока
+  QList<Port*> expire(qint64 now);
+  void armTimer();
+
+};
+
+class rshub::SvSerialHub
+{
+public:
+  static SvSerialHub* instance();
+
+  // открытие порта и передача его на обслуживание одному из потоков пула
+  Port* attach(const Params& params, SvRsHub* owner, modus::IOBuffer* buffer, quint32 bufsize, QString* error);
+  void  detach(Port* port);
+
+  // запись данных буфера в порт. вызывается в потоке протокола
+  void  write(Port* port, modus::BUFF* buffer);
+
+  int   threads() const { return m_loops.count(); }
+
+private:
+  SvSerialHub() {}
+
+  QMutex              m_mutex;
+  QList<SvHubLoop*>   m_loops;
+
+  // подключенные порты, в том числе закрытые с ошибкой и снятые с обслуживания
+  int                 m_attached = 0;
+
+};
+
+#endif // SV_SERIAL_HUB_H
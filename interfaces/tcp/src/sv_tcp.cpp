@@ -13,6 +13,11 @@ bool SvTcp::configure(modus::DeviceConfig* config, modus::IOBuffer*iobuffer)
 
     m_params = tcp::Params::fromJsonString(p_config->interface.params);
 
+    m_realtime = rt::Params::fromJsonString(p_config->interface.params);
+
+    m_metrics.attach(p_config->name);
+    m_latency.attach(p_config->name);
+
     return true;
 
   } catch (SvException& e) {
@@ -25,6 +30,11 @@ bool SvTcp::configure(modus::DeviceConfig* config, modus::IOBuffer*iobuffer)
 
 bool SvTcp::start()
 {
+  // параметры реального времени применяются в потоке интерфейса
+  QString rt_error;
+  if(!rt::apply(m_realtime, &rt_error))
+    emit message(rt_error, sv::log::llError, sv::log::mtError);
+
   try {
 
     if(m_params.mode == P_MODE_CLIENT) {
@@ -106,14 +116,25 @@ void SvTcp::read()
 
   p_io_buffer->input->mutex.lock();
 
-  if(p_io_buffer->input->offset + m_client->bytesAvailable() > p_config->bufsize)
+  if(p_io_buffer->input->offset + m_client->bytesAvailable() > p_config->bufsize) {
+
     p_io_buffer->input->reset();
+    m_metrics.drops.inc();
+
+  }
 
 //  qint64 readed = p_io_buffer->input->read(m_client);
   qint64 readed = m_client->read(&p_io_buffer->input->data[p_io_buffer->input->offset], p_config->bufsize - p_io_buffer->input->offset);
 
-  if(p_io_buffer->input->offset == 0)
+  if(readed > 0)
+    m_metrics.bytes_in.inc(quint64(readed));
+
+  if(p_io_buffer->input->offset == 0) {
+
     p_io_buffer->input->set_time = QDateTime::currentMSecsSinceEpoch();
+    m_latency.stamp();
+
+  }
 
   emit_message(QByteArray((const char*)&p_io_buffer->input->data[p_io_buffer->input->offset], readed), sv::log::llDebug, sv::log::mtReceive);
 
@@ -146,9 +167,13 @@ void SvTcp::write(modus::BUFF* buffer)
   bool written = m_client->write((const char*)&buffer->data[0], buffer->offset) > 0;
   m_client->flush();
 
-  if(written)
+  if(written) {
+
+    m_metrics.bytes_out.inc(quint64(buffer->offset));
     emit_message(QByteArray((const char*)&buffer->data[0], buffer->offset), sv::log::llDebug, sv::log::mtSend);
 
+  }
+
   buffer->reset();
 
   buffer->mutex.unlock();
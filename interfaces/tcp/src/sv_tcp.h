@@ -9,6 +9,9 @@
 
 #include "../../../../Modus/global/global_defs.h"
 #include "../../../../Modus/global/device/interface/sv_abstract_interface.h"
+#include "../../../global/sv_realtime.h"
+#include "../../../global/sv_metrics.h"
+#include "../../../global/sv_latency.h"
 
 extern "C" {
 
@@ -36,6 +39,15 @@ private:
 //  QTcpSocket*   m_server = nullptr;
   tcp::Params   m_params;
 
+  // привязка потока интерфейса к ядрам и приоритет
+  rt::Params    m_realtime;
+
+  // счетчики интерфейса, /metrics
+  metrics::InterfaceMetrics m_metrics;
+
+  // время приема данных для трассировки задержек, /latency
+  latency::Receiver m_latency;
+
   QTimer*        m_gap_timer;
 
   void datalog(const QByteArray& bytes, QString& message);
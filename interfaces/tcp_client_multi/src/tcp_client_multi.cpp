@@ -13,8 +13,12 @@ SvTcpClientMulti::~SvTcpClientMulti()
 {
   stop();
 
-  m_gap_timer->stop();
-  delete m_gap_timer;
+  if(m_gap_timer) {
+
+    m_gap_timer->stop();
+    delete m_gap_timer;
+
+  }
 
   deleteLater();
 }
@@ -30,6 +34,21 @@ bool SvTcpClientMulti::configure(modus::DeviceConfig* config, modus::IOBuffer*io
 
     m_params = tcpclientm::Params::fromJsonString(p_config->interface.params);
 
+    m_realtime = rt::Params::fromJsonString(p_config->interface.params);
+
+
+    m_metrics.attach(p_config->name);
+    m_latency.attach(p_config->name);
+
+    // RTT каждого сервера и время переключения на резервный сервер
+    metrics::SvMetrics* m = metrics::SvMetrics::instance();
+
+    m_rtt.clear();
+    for(const tcpclientm::ConnectionItem& c: m_params.connections)
+      m_rtt.append(m->gauge(M_TCM_RTT, QString("%1:%2:%3").arg(p_config->name).arg(c.host.toString()).arg(c.port)));
+
+    m_failover = m->histogram(M_TCM_FAILOVER_TIME, p_config->name);
+
     return true;
 
   } catch (SvException& e) {
@@ -43,6 +62,11 @@ bool SvTcpClientMulti::start()
 // Создание и инициализация объектов; создание подключений сигналов к слотам,
 // которые необходимы для работы tcp-клиента.
 {
+  // параметры реального времени применяются в потоке интерфейса
+  QString rt_error;
+  if(!rt::apply(m_realtime, &rt_error))
+    emit message(rt_error, sv::log::llError, sv::log::mtError);
+
   // Создаём сокеты TCP-клиента, в количестве заданном параметром connections
   for(int i = 0; i < m_params.connections.count(); i++) {
 
@@ -52,17 +76,37 @@ bool SvTcpClientMulti::start()
     connect(m_params.connections[i].socket,     &QTcpSocket::connected,       this, &SvTcpClientMulti::connected);
     connect(m_params.connections[i].socket,     &QTcpSocket::disconnected,    this, &SvTcpClientMulti::disconnected);
 
-    // слот readyRead переключаем в функции checkConnection на сокет, который имеет наибольший приоритет
+    // данные принимаются от всех серверов. данные текущего подключения передаются в read
+    connect(m_params.connections[i].socket,     &QTcpSocket::readyRead,       this, &SvTcpClientMulti::socketReadyRead);
+
+    // в режиме multipath паузы между кадрами отслеживаются для каждого сервера отдельно
+    if(m_params.multipath && m_params.frame.mode == tcpclientm::fmGap) {
+
+      QTimer* timer = new QTimer;
+      timer->setTimerType(Qt::PreciseTimer);
+      timer->setInterval(m_params.grain_gap);
+      timer->setSingleShot(true);
+      connect(timer, &QTimer::timeout, this, [this, i]() { frameGap(i); });
+
+      m_params.connections[i].frame_timer = timer;
+
+    }
   }
 
+  m_seen.clear();
+  m_seen_order.clear();
+  m_duplicates = 0;
+
+  m_clock.start();
+
   // Когда протокольная часть сообщает, что поместила в буфер данные
   // для передачи по интерфейсу -> вызываем функцию "SvTcpClient::write",
   // которая запишет данные из буфера в сокет:
-  connect(p_io_buffer,  &modus::IOBuffer::readyWrite, this, &SvTcpClientMulti::write);
+  connect(p_io_buffer,  &modus::IOBuffer::readyWrite, this, &SvTcpClientMulti::write, Qt::UniqueConnection);
 
   // Когда от протокольной части поступает сигнал "say" -> вызывем функцию "say_WorkingOut",
   // чтобы выяснить, какую команду он "требует" и выполнить её:
-  connect(p_io_buffer, &modus::IOBuffer::say, this, &SvTcpClientMulti::say_WorkingOut);
+  connect(p_io_buffer, &modus::IOBuffer::say, this, &SvTcpClientMulti::say_WorkingOut, Qt::UniqueConnection);
 
   p_is_active = true;
 
@@ -71,22 +115,26 @@ bool SvTcpClientMulti::start()
   // функцию "checkConnection", которая будет проверять установлено ли TCP-соединение и,
   // если оно не установлено, пытаться его установить:
   m_connectionCheckTimer = new QTimer;
+  m_connectionCheckTimer->setTimerType(Qt::PreciseTimer);
   connect(m_connectionCheckTimer, &QTimer::timeout, this, &SvTcpClientMulti::checkConnection);
   m_connectionCheckTimer->setSingleShot(true);
 
-  // Даём TCP-клиенту команду на подключение к серверу c
-  // адресом и портом, указанными в конфигурационном файле для данного интерфейса:
-  checkConnection();
-
   // Устанавливаем параметры таймера, по срабатыванию которого, вызываем функцию "newData", которая
   // устанавливает флаг "is_ready" и испускает сигнал "dataReaded".
   // Более подробное описание см. в функции "SvTcpServer::read".
+  if(m_gap_timer)
+    delete m_gap_timer;
+
   m_gap_timer = new QTimer;
   m_gap_timer->setTimerType(Qt::PreciseTimer);
   m_gap_timer->setInterval(m_params.grain_gap);
   m_gap_timer->setSingleShot(true);
   connect(m_gap_timer, &QTimer::timeout, this, &SvTcpClientMulti::newData);
 
+  // Даём TCP-клиенту команду на подключение ко всем серверам c
+  // адресами и портами, указанными в конфигурационном файле для данного интерфейса:
+  checkConnection();
+
   return true;
 }
 
@@ -114,6 +162,24 @@ void SvTcpClientMulti::connected(void)
     int interval = 1;   // send a keepalive packet out every 2 seconds (after the 5 second idle period)
     setsockopt(fd, SOL_TCP, TCP_KEEPINTVL, &interval, sizeof(interval));
 
+    // пакеты проверки связи небольшие, не ждем накопления данных
+    int nodelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+    for(int i = 0; i < m_params.connections.count(); i++) {
+
+      if(m_params.connections.at(i).socket == socket) {
+
+        m_params.connections[i].last_reply = now();
+        m_params.connections[i].probe_sent = -1;
+        m_params.connections[i].probe_seq  = 0;
+        m_params.connections[i].reply_seq  = 0;
+        m_params.connections[i].rtt        = -1;
+        m_params.connections[i].reply.clear();
+
+      }
+    }
+
     QString m = QString("Успешно подключились к TCP-серверу %1:%2")
                 .arg(socket->peerAddress().toString())
                 .arg(socket->peerPort());
@@ -121,6 +187,9 @@ void SvTcpClientMulti::connected(void)
     emit message(m, lldbg, mtscc);
 //    qDebug() << m;
 
+    // сервер с более высоким приоритетом снова доступен
+    selectConnection();
+
   }
 }
 
@@ -134,8 +203,9 @@ void SvTcpClientMulti::disconnected (void)
     // отключаем этот сокет от слота read и обнуляем текущее подключение (текущего подключения нет)
     if(m_current_connection && (m_current_connection->socket == socket)) {
 
-      disconnect(m_current_connection->socket,     &QTcpSocket::readyRead,       this, &SvTcpClientMulti::read );
       m_current_connection = nullptr;
+      m_lost_at = now();
+
     }
 
     QString m = QString("Отключились от TCP-сервера %1:%2")
@@ -145,7 +215,337 @@ void SvTcpClientMulti::disconnected (void)
     emit message(m, lldbg, mtscc);
 //    qDebug() << m;
 
+    // переключение на резервный сервер сразу, не дожидаясь очередной проверки
+    if(p_is_active)
+      selectConnection();
+
+  }
+}
+
+void SvTcpClientMulti::socketReadyRead(void)
+{
+  QTcpSocket* socket = (QTcpSocket*)(sender());
+
+  for(int i = 0; i < m_params.connections.count(); i++) {
+
+    if(m_params.connections.at(i).socket == socket) {
+
+      receive(i);
+      break;
+
+    }
+  }
+}
+
+void SvTcpClientMulti::receive(int index)
+{
+  tcpclientm::ConnectionItem* connection = &m_params.connections[index];
+
+  QByteArray data = connection->socket->readAll();
+
+  if(data.isEmpty())
+    return;
+
+  qint64 t = now();
+
+  // любые данные от сервера подтверждают, что он доступен
+  connection->last_reply = t;
+
+  // ответ на проверку связи в протокол не передается. RTT измеряется только по нему,
+  // иначе в RTT попадает время ожидания данных от сервера
+  // запоздавший ответ на пакет, время ожидания которого истекло, удаляется, но RTT по нему не считается
+  if(takeReply(connection, data) && connection->reply_seq == connection->probe_seq) {
+
+    connection->rtt        = t - connection->probe_sent;
+    connection->probe_sent = -1;
+
+    m_rtt[index].set(connection->rtt);
+
+  }
+
+  if(data.isEmpty())
+    return;
+
+  // данные от всех серверов разбиваются на кадры, в протокол передается первая копия кадра
+  if(m_params.multipath) {
+
+    m_metrics.bytes_in.inc(quint64(data.size()));
+
+    connection->rx.append(data);
+    extractFrames(index);
+
+  }
+
+  else if(connection == m_current_connection)
+    input(data);
+
+  // резервные подключения не передают данные в протокол
+
+}
+
+bool SvTcpClientMulti::takeReply(tcpclientm::ConnectionItem* connection, QByteArray& data)
+{
+  const QByteArray& reply = m_params.heartbeat_reply;
+
+  // ответ ожидается только на отправленный пакет и только в начале принятой порции данных
+  if(reply.isEmpty() || connection->reply_seq == connection->probe_seq)
+    return false;
+
+  if(!connection->reply.isEmpty()) {
+
+    data.prepend(connection->reply);
+    connection->reply.clear();
+
+  }
+
+  if(data.startsWith(reply)) {
+
+    data.remove(0, reply.size());
+    connection->reply_seq++;
+
+    return true;
+
+  }
+
+  // пришло только начало ответа, окончание ожидается со следующей порцией
+  if(reply.startsWith(data)) {
+
+    connection->reply = data;
+    data.clear();
+
+  }
+
+  return false;
+
+}
+
+void SvTcpClientMulti::frameGap(int index)
+{
+  if(index < 0 || index >= m_params.connections.count())
+    return;
+
+  tcpclientm::ConnectionItem* connection = &m_params.connections[index];
+
+  if(connection->rx.isEmpty())
+    return;
+
+  QByteArray frame = connection->rx;
+  connection->rx.clear();
+
+  deliverFrame(frame, index);
+
+}
+
+void SvTcpClientMulti::extractFrames(int index)
+{
+  tcpclientm::ConnectionItem* connection = &m_params.connections[index];
+  const tcpclientm::FrameParams& f = m_params.frame;
+
+  switch (f.mode) {
+
+    // кадр завершается паузой, ждем ее
+    case tcpclientm::fmGap:
+
+      if(connection->frame_timer)
+        connection->frame_timer->start();
+
+      break;
+
+    case tcpclientm::fmFixed:
+    {
+      int pos = 0;
+
+      while(connection->rx.size() - pos >= f.size) {
+
+        deliverFrame(connection->rx.mid(pos, f.size), index);
+        pos += f.size;
+
+      }
+
+      connection->rx.remove(0, pos);
+
+      break;
+    }
+
+    case tcpclientm::fmDelimiter:
+    {
+      int pos = 0;
+      int end;
+
+      while((end = connection->rx.indexOf(f.delimiter, pos)) >= 0) {
+
+        end += f.delimiter.size();
+
+        deliverFrame(connection->rx.mid(pos, end - pos), index);
+        pos = end;
+
+      }
+
+      connection->rx.remove(0, pos);
+
+      break;
+    }
+
+    case tcpclientm::fmLength:
+    {
+      int pos = 0;
+
+      while(connection->rx.size() - pos >= f.length_offset + f.length_size) {
+
+        // поле длины в формате big endian
+        qint64 length = 0;
+        for(int i = 0; i < f.length_size; i++)
+          length = (length << 8) | quint8(connection->rx.at(pos + f.length_offset + i));
+
+        length += f.length_add;
+
+        // поток рассинхронизирован, накопленные данные отбрасываются
+        if(length <= 0 || length > p_config->bufsize) {
+
+          emit message(QString("TCP-сервер %1:%2: недопустимая длина кадра %3, данные отброшены")
+                       .arg(connection->host.toString()).arg(connection->port).arg(length), lldbg, mterr);
+
+          pos = connection->rx.size();
+          break;
+
+        }
+
+        if(connection->rx.size() - pos < length)
+          break;
+
+        deliverFrame(connection->rx.mid(pos, int(length)), index);
+        pos += int(length);
+
+      }
+
+      connection->rx.remove(0, pos);
+
+      break;
+    }
+  }
+
+  // конец кадра не найден, а данных больше, чем вмещает буфер
+  if(connection->rx.size() > int(p_config->bufsize)) {
+
+    emit message(QString("TCP-сервер %1:%2: конец кадра не найден, %3 байт отброшено")
+                 .arg(connection->host.toString()).arg(connection->port).arg(connection->rx.size()), lldbg, mterr);
+
+    connection->rx.clear();
+
+  }
+}
+
+quint64 SvTcpClientMulti::frameKey(const QByteArray& frame, bool& ok) const
+{
+  const tcpclientm::DedupParams& d = m_params.dedup;
+
+  ok = true;
+
+  if(d.key == tcpclientm::dkSequence) {
+
+    // кадр без номера не может быть сопоставлен с копиями
+    if(frame.size() < d.offset + d.size) {
+
+      ok = false;
+      return 0;
+
+    }
+
+    quint64 seq = 0;
+    for(int i = 0; i < d.size; i++)
+      seq = (seq << 8) | quint8(frame.at(d.offset + i));
+
+    return seq;
+
+  }
+
+  // FNV-1a, 64 бита
+  quint64 hash = 14695981039346656037ULL;
+
+  for(int i = 0; i < frame.size(); i++) {
+
+    hash ^= quint8(frame.at(i));
+    hash *= 1099511628211ULL;
+
   }
+
+  return hash;
+
+}
+
+void SvTcpClientMulti::deliverFrame(const QByteArray& frame, int index)
+{
+  if(frame.isEmpty())
+    return;
+
+  bool keyed;
+  quint64 key = frameKey(frame, keyed);
+
+  if(keyed) {
+
+    qint64 t   = now();
+    qint64 age = qint64(m_params.dedup.age) * 1000;
+
+    // забываем кадры старше age и сверх window. запись удаляется, только если
+    // кадр с тем же ключом не был передан позже
+    while(!m_seen_order.isEmpty() &&
+          (t - m_seen_order.head().second >= age || m_seen_order.count() >= m_params.dedup.window)) {
+
+      QPair<quint64, qint64> oldest = m_seen_order.dequeue();
+
+      if(m_seen.value(oldest.first).time == oldest.second)
+        m_seen.remove(oldest.first);
+
+    }
+
+    // копия кадра уже передана от другого сервера
+    QHash<quint64, Seen>::const_iterator seen = m_seen.constFind(key);
+
+    if(seen != m_seen.constEnd() && seen->connection != index) {
+
+      m_duplicates++;
+      return;
+
+    }
+
+    m_seen.insert(key, Seen{index, t});
+    m_seen_order.enqueue(qMakePair(key, t));
+
+  }
+
+  p_io_buffer->input->mutex.lock();
+
+  // протокольная часть еще не прочла прошлые данные, новый кадр добавляется к ним
+  if(p_io_buffer->input->isReady())
+    p_io_buffer->input->is_ready = false;
+
+  if(p_io_buffer->input->offset + frame.size() > p_config->bufsize) {
+
+    p_io_buffer->input->reset();
+    m_metrics.drops.inc();
+
+  }
+
+  int size = qMin(frame.size(), int(p_config->bufsize));
+
+  if(p_io_buffer->input->offset == 0) {
+
+    p_io_buffer->input->set_time = QDateTime::currentMSecsSinceEpoch();
+    m_latency.stamp();
+
+  }
+
+  memcpy(&p_io_buffer->input->data[p_io_buffer->input->offset], frame.constData(), size_t(size));
+  p_io_buffer->input->offset += size;
+
+  emit_message(frame.left(size), sv::log::llDebug, sv::log::mtReceive);
+
+  // кадр завершен, ждать паузы не нужно
+  p_io_buffer->input->setReady(true);
+  p_io_buffer->input->mutex.unlock();
+
+  emit p_io_buffer->dataReaded(p_io_buffer->input);
+
 }
 
 void SvTcpClientMulti::socketError(QAbstractSocket::SocketError err)
@@ -165,10 +565,9 @@ void SvTcpClientMulti::stateChanged(QAbstractSocket::SocketState state)
 
 void SvTcpClientMulti::checkConnection(void)
 // На момент запуска TCP-клиента, TCP-сервер может быть не запущен, поэтому
-// мы по таймеру будем c интервалом, указанным в параметре интерфейса, вызывать
-// функцию "checkConnection", которая
-// будет проверять установлено ли TCP-соединение и, если оно не установлено, пытаться
-// его установить:
+// мы по таймеру будем c интервалом heartbeat_interval вызывать функцию "checkConnection",
+// которая проверяет все подключения параллельно: восстанавливает потерянные,
+// отправляет пакеты проверки связи и выбирает текущее подключение
 {
   // массив для хранения текущих состояний подключений
   // после прохода по всем сокетам, заполняется состояниями и отправляется в протокольный модуль
@@ -181,8 +580,8 @@ void SvTcpClientMulti::checkConnection(void)
   // соединение будет разорвано, пытаться его установить - не нужно:
   if (p_is_active) {
 
-    // проходим по очереди по всем подключениям, заданным в списке connections
-    // анализируем и назначаем текущее подключение
+    qint64 t = now();
+
     for(int i = 0; i < m_params.connections.count(); i++) {
 
       tcpclientm::ConnectionItem* connection  = &m_params.connections[i];
@@ -190,61 +589,43 @@ void SvTcpClientMulti::checkConnection(void)
 
       switch (client->state()) {
 
-        // если для данного сокета не было установлено соединение
+        // даем команду на подключение не чаще, чем раз в reconnect_period.
+        // подключение выполняется асинхронно, ко всем серверам одновременно.
+        // если соединение будет установлено, то для данного сокета будет вызван слот connected
         case QAbstractSocket::UnconnectedState:
         {
-          // отдельно пррверяем вариант, когда соединение было (и оно было текущим), но произошел разрыв.
-          // тогда отключаем данный сокет от слота read и обнуляем текущее соединение (текущего соединения нет)
-          if(m_current_connection && (m_current_connection == connection)) {
+          if(connection->last_attempt < 0 || t - connection->last_attempt >= qint64(m_params.reconnect_period) * 1000) {
 
-            // отключаемся от слота read
-            disconnect(m_current_connection->socket,     &QTcpSocket::readyRead,       this, &SvTcpClientMulti::read );
-            m_current_connection = nullptr;
-          }
+            connection->last_attempt = t;
+            client->connectToHost(connection->host, connection->port);
 
-          // даем команду на подключение
-          // данную команду выполняем асинхронно. здесь не ждем подключения, чтобы не блокировать поток
-          // если ждать подключение здесь, то интервал ожидания (для 4 подключений) превышает
-          // timeout сигналов и данные на экране мигают (становятся серыми, как будто нет данных, потом восстанавливаются)
-          // если соединение будет установлено, то для данного сокета будет вызван слот connected
-          // и при следующем вызове checkConnection, будет произведен его анализ
-          client->connectToHost(m_params.connections.at(i).host, m_params.connections.at(i).port);
+          }
 
           break;
         }
 
-        // если для данного сокета есть установленное соединение
         case QAbstractSocket::ConnectedState:
         {
-          // если это текущее соединение, то ничего не делаем
-          if(m_current_connection && (m_current_connection == connection))
-            break;
-
+          if(m_params.heartbeat.isEmpty()) {
 
-          // если i-ый элемент имеет больший приоритет, чем текущее соединение (m_current_connection),
-          // то перебрасываем текущее соединение на элемент с большим приоритетом
-          // для этого, сначала отключаем сокет от слота read и обнуляем текущее соединение
-          if((connection->priority > -1) && m_current_connection && (connection->priority < m_current_connection->priority)) {
+            updateKernelRtt(connection);
+            m_rtt[i].set(connection->rtt);
 
-            disconnect(m_current_connection->socket,     &QTcpSocket::readyRead,       this, &SvTcpClientMulti::read );
-            m_current_connection = nullptr;
           }
 
-          // если текущее соединение не задано, то назначаем ему текущий элемент списка
-          // в данном случае текущий элемент будет иметь наибольший приоритет
-          if(!m_current_connection) {
+          // следующий пакет отправляется после ответа на предыдущий, либо по истечении времени ожидания
+          else if(connection->probe_sent < 0 || t - connection->probe_sent >= qint64(m_params.heartbeat_timeout) * 1000) {
 
-            // в качестве ткущего подключения используем текущий элемент
-            m_current_connection = connection;
+            connection->probe_sent = t;
+            connection->probe_seq++;
 
-            // прикручиваем сокет текущего соединения к слоту read
-            connect(m_current_connection->socket,     &QTcpSocket::readyRead,       this, &SvTcpClientMulti::read );
+            client->write(m_params.heartbeat);
+            client->flush();
 
           }
 
           break;
-
-         }
+        }
 
         // все другие состояния подключения игнорируем
         default:
@@ -252,17 +633,31 @@ void SvTcpClientMulti::checkConnection(void)
       }
     }
 
+    selectConnection();
+
     // пооходим по списку подключений, смотрим состояние подключения и заполняем массив
     for(int i = 0; i < m_params.connections.count(); i++) {
 
-      if(m_params.connections.at(i).socket->state() == QAbstractSocket::ConnectedState)
-        states[i] = &m_params.connections.at(i) == m_current_connection ? STATE_HOST_IN_USE : STATE_HOST_ACCESIBLE;
+      tcpclientm::ConnectionItem* connection = &m_params.connections[i];
+
+      if(isAlive(connection))
+        states[i] = connection == m_current_connection ? STATE_HOST_IN_USE : STATE_HOST_ACCESIBLE;
 
       else
         states[i] = STATE_NO_CONNECTION;
 
       states_msg.append(QString(" %1").arg(int(states[i])));
 
+      if(connection->rtt >= 0)
+        states_msg.append(QString(" (rtt %1 мкс)").arg(connection->rtt));
+
+    }
+
+    if(m_params.multipath) {
+
+      states_msg.append(QString(", повторных кадров отброшено: %1").arg(m_duplicates));
+      m_duplicates = 0;
+
     }
   }
 
@@ -277,18 +672,119 @@ void SvTcpClientMulti::checkConnection(void)
 
   // запускаем таймер проверки подключений, если не был вызван слот stop
   if(p_is_active)
-    m_connectionCheckTimer->start(m_params.reconnect_period);
+    m_connectionCheckTimer->start(m_params.heartbeat_interval);
 
 }
 
-void SvTcpClientMulti::read()
-// Получение данных из сокета.
+bool SvTcpClientMulti::isAlive(tcpclientm::ConnectionItem* connection)
+{
+  if(connection->socket->state() != QAbstractSocket::ConnectedState)
+    return false;
+
+  // без пакета проверки связи last_reply обновляется по TCP_INFO, пока нет повторных передач
+  return now() - connection->last_reply < qint64(m_params.heartbeat_timeout) * 1000;
+
+}
+
+void SvTcpClientMulti::selectConnection(void)
+{
+  // текущее подключение перестало отвечать
+  if(m_current_connection && !isAlive(m_current_connection)) {
+
+    emit message(QString("TCP-сервер %1:%2 не отвечает")
+                 .arg(m_current_connection->host.toString()).arg(m_current_connection->port), lldbg, mterr);
+
+    m_current_connection = nullptr;
+    m_lost_at = now();
+
+  }
+
+  tcpclientm::ConnectionItem* best = m_current_connection;
+
+  for(int i = 0; i < m_params.connections.count(); i++) {
+
+    tcpclientm::ConnectionItem* connection = &m_params.connections[i];
+
+    if(connection == best || !isAlive(connection))
+      continue;
+
+    // если текущее соединение не задано, то назначаем ему первый доступный элемент списка.
+    // если i-ый элемент имеет больший приоритет, чем выбранный, то выбираем его.
+    // хост с приоритетом -1 используется, только если нет других подключений
+    if(!best ||
+       (connection->priority > -1 && (best->priority == -1 || connection->priority < best->priority)))
+      best = connection;
+
+  }
+
+  if(best == m_current_connection)
+    return;
+
+  tcpclientm::ConnectionItem* previous = m_current_connection;
+  m_current_connection = best;
+
+  if(!best)
+    return;
+
+  QString m = QString("Текущее подключение: %1:%2").arg(best->host.toString()).arg(best->port);
+
+  if(best->rtt >= 0)
+    m.append(QString(", rtt %1 мкс").arg(best->rtt));
+
+  // время от потери предыдущего подключения до назначения нового
+  if(!previous && m_lost_at >= 0) {
+
+    qint64 failover = now() - m_lost_at;
+
+    m.append(QString(", время переключения %1 мс").arg(double(failover) / 1000.0, 0, 'f', 1));
+    m_failover.record(quint64(failover));
+
+    m_lost_at = -1;
+
+  }
+
+  emit message(m, sv::log::llInfo, sv::log::mtConnection);
+
+}
+
+void SvTcpClientMulti::updateKernelRtt(tcpclientm::ConnectionItem* connection)
 {
-  if(!m_current_connection)
+  struct tcp_info info;
+  socklen_t length = sizeof(info);
+
+  if(getsockopt(int(connection->socket->socketDescriptor()), IPPROTO_TCP, TCP_INFO, &info, &length) != 0)
     return;
 
+  // сглаженное ядром значение, мкс
+  connection->rtt = qint64(info.tcpi_rtt);
+
+  // если сервер перестал подтверждать данные, ядро повторяет передачу
+  if(info.tcpi_state == TCP_ESTABLISHED && info.tcpi_retransmits == 0)
+    connection->last_reply = now();
+
+}
+
+void SvTcpClientMulti::read()
+// Получение данных текущего подключения.
+{
+  for(int i = 0; i < m_params.connections.count(); i++) {
+
+    if(&m_params.connections[i] == m_current_connection) {
+
+      receive(i);
+      break;
+
+    }
+  }
+}
+
+void SvTcpClientMulti::input(const QByteArray& data)
+// Передача данных текущего подключения в буфер протокола.
+{
   m_gap_timer->stop();
 
+  m_metrics.bytes_in.inc(quint64(data.size()));
+
   p_io_buffer->input->mutex.lock();
 
   // Если нам надо читать данные от сокета в буфер, а протокольная часть ещё не прочла
@@ -299,18 +795,24 @@ void SvTcpClientMulti::read()
 
   // Если места в буфере на новые данные от сокета нет, то очищаем его содержимое и
   // сбрасываем флаг "is_ready":
-  if(p_io_buffer->input->offset + m_current_connection->socket->bytesAvailable() > p_config->bufsize)
+  if(p_io_buffer->input->offset + data.size() > p_config->bufsize) {
+
         p_io_buffer->input->reset();
+        m_metrics.drops.inc();
 
+  }
 
-   qint64 readed = m_current_connection->socket->read(&p_io_buffer->input->data[p_io_buffer->input->offset], p_config->bufsize - p_io_buffer->input->offset);
+  int readed = qMin(data.size(), int(p_config->bufsize - p_io_buffer->input->offset));
 
-   if(p_io_buffer->input->offset == 0)
-   { // Фиксируем момент НАЧАЛА чтения:
-        p_io_buffer->input->set_time = QDateTime::currentMSecsSinceEpoch();
-   }
+  if(p_io_buffer->input->offset == 0)
+  { // Фиксируем момент НАЧАЛА чтения:
+       p_io_buffer->input->set_time = QDateTime::currentMSecsSinceEpoch();
+       m_latency.stamp();
+  }
+
+  memcpy(&p_io_buffer->input->data[p_io_buffer->input->offset], data.constData(), size_t(readed));
 
-  emit_message(QByteArray((const char*)&p_io_buffer->input->data[p_io_buffer->input->offset], readed), sv::log::llDebug, sv::log::mtReceive);
+  emit_message(data.left(readed), sv::log::llDebug, sv::log::mtReceive);
 
   p_io_buffer->input->offset += readed;
 
@@ -368,6 +870,8 @@ void SvTcpClientMulti::write(modus::BUFF* buffer)
 
   if(written)
   {
+    m_metrics.bytes_out.inc(quint64(buffer->offset));
+
     QByteArray sended = QByteArray((const char*)&buffer->data[0], buffer->offset);
 
     emit_message(sended, sv::log::llDebug, sv::log::mtSend);
@@ -394,18 +898,11 @@ void SvTcpClientMulti::say_WorkingOut(QByteArray command)
     }
     else if(QString(command).toLower() == "connect") {
 
-      p_is_active = true;
+      if(p_is_active)
+        return;
 
-      checkConnection();
-
-      // На момент запуска TCP-клиента, TCP-сервер может быть не запущен, поэтому
-      // мы по таймеру будем c интервалом, указанным в параметре интерфейса, вызывать
-      // функцию "checkConnection", которая
-      // будет проверять установлено ли TCP-соединение и, если оно не установлено, пытаться
-      // его установить:
-      m_connectionCheckTimer = new QTimer;
-      connect(m_connectionCheckTimer, &QTimer::timeout, this, &SvTcpClientMulti::checkConnection);
-      m_connectionCheckTimer->start(m_params.reconnect_period);
+      // сокеты и таймер проверки подключений создаются заново
+      start();
 
     }
 }
@@ -415,22 +912,51 @@ void SvTcpClientMulti::stop()
   p_is_active = false;
 
   // отключаем все сигналы таймера от всех слотов
-  m_connectionCheckTimer->disconnect();
-  m_connectionCheckTimer->stop();
-  delete m_connectionCheckTimer;
-  m_connectionCheckTimer = nullptr;
+  if(m_connectionCheckTimer) {
+
+    m_connectionCheckTimer->disconnect();
+    m_connectionCheckTimer->stop();
+    delete m_connectionCheckTimer;
+    m_connectionCheckTimer = nullptr;
+
+  }
+
+  m_current_connection = nullptr;
 
   // Даём команду на отключение от TCP-сервера:
-  for(auto c: m_params.connections) {
+  for(int i = 0; i < m_params.connections.count(); i++) {
 
-    if(c.socket) {
+    tcpclientm::ConnectionItem* c = &m_params.connections[i];
 
-      if(c.socket->state() == QAbstractSocket::ConnectedState)
-        c.socket->disconnectFromHost();
+    if(c->socket) {
 
-      delete c.socket;
+      c->socket->disconnect(this);
+
+      if(c->socket->state() == QAbstractSocket::ConnectedState)
+        c->socket->disconnectFromHost();
+
+      delete c->socket;
+      c->socket = nullptr;
 
     }
+
+    if(c->frame_timer) {
+
+      c->frame_timer->stop();
+      delete c->frame_timer;
+      c->frame_timer = nullptr;
+
+    }
+
+    c->rx.clear();
+    c->reply.clear();
+
+    c->last_attempt = -1;
+    c->probe_sent   = -1;
+    c->probe_seq    = 0;
+    c->reply_seq    = 0;
+    c->rtt          = -1;
+
   }
 
 }
@@ -4,6 +4,11 @@
 #include <QNetworkInterface>
 #include <QTcpSocket>
 #include <QObjectUserData>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPair>
+#include <QQueue>
+#include <QVector>
 
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -14,6 +19,13 @@
 
 #include "../../../../Modus/global/global_defs.h"
 #include "../../../../Modus/global/device/interface/sv_abstract_interface.h"
+#include "../../../global/sv_realtime.h"
+#include "../../../global/sv_metrics.h"
+#include "../../../global/sv_latency.h"
+
+// RTT сервера, мкс: device - <имя устройства>:<хост>:<порт>
+#define M_TCM_RTT                 "modus_interface_rtt_microseconds"
+#define M_TCM_FAILOVER_TIME       "modus_interface_failover_seconds"
 
 #define LIB_SHORT_INFO \
   "TCP клиент с возможностью множественного подключения. Интерфейсная библиотека Modus. Версия" LIB_VERSION "\n"
@@ -21,19 +33,27 @@
 #define LIB_DESCRIPTION \
   LIB_SHORT_INFO \
   "Алгоритм работы:\n"\
-  "  1. С интервалом, заданным параметром " P_RECONNECT_PERIOD " проверяется соединение с заданным списком серверов. "\
-  "Пытается подключиться ко всем серверам из списка по очереди. Подключение к серверу осуществляется с заданными праметрами " P_HOST " и " P_PORT \
-  ". Если очередной хост из списка, доступен, то для данного подключения задается состояние 1 (сервер доступен для подключения). "\
-  "Первый доступный хост из списка назначается текущим подключением m_current_connection. Это подключение используется, как основное для обмена данными.\n"\
-  "    Также, для каждого подключения может быть определен приоритет. Он определяет какие хосты предпочтительнее других. Если в процессе проверки соединения, "\
-  "выяснится, что доступен хост с более высоким приоритетом, то в качестве текущего подключения будет использоваться именно оно. "\
-  "Приоритет задается числовым значением начиная с 0. 0 имеет наивысший приоритет, и далее, чем больше число, тем меньше приоритет. "\
+  "  1. Клиент одновременно подключается ко всем серверам из списка " P_CONNECTIONS " (неблокирующее подключение), "\
+  "подключение к серверу осуществляется с заданными праметрами " P_HOST " и " P_PORT ". Потерянные подключения восстанавливаются "\
+  "с периодом " P_RECONNECT_PERIOD ". С периодом " P_HEARTBEAT_INTERVAL " всем подключенным серверам отправляется пакет проверки связи " P_HEARTBEAT \
+  ". Ответ сервера (" P_HEARTBEAT_REPLY ", по умолчанию эхо пакета) удаляется из начала принятых данных и в протокол не передается, "\
+  "время до получения ответа фиксируется как RTT. Если пакет не задан, RTT и состояние соединения определяются по TCP_INFO. "\
+  "Сервер, от которого не было данных дольше " P_HEARTBEAT_TIMEOUT ", считается недоступным.\n"\
+  "    Из доступных серверов текущим подключением m_current_connection назначается сервер с наивысшим приоритетом. "\
+  "Это подключение используется, как основное для обмена данными. Переключение на резервный сервер происходит сразу при разрыве "\
+  "текущего соединения, либо при отсутствии данных от сервера - не позднее " P_HEARTBEAT_TIMEOUT " + " P_HEARTBEAT_INTERVAL ". Время переключения и RTT серверов выводятся в журнал и в метрики " M_TCM_RTT ", " M_TCM_FAILOVER_TIME ".\n"\
+  "    Приоритет задается числовым значением начиная с 0. 0 имеет наивысший приоритет, и далее, чем больше число, тем меньше приоритет. "\
   "Значение -1 (по умолчанию) указывает, что приоритет не определен. К хосту с приоритетом -1 подключение проиходит только если нет других подключений. "\
   "Если будет обнаружено подключение к хосту с таким же приоритетом, как у текущего, то текущее подключение не меняется.\n"\
   "  Состояния подключений фиксируются в буфере state. Для каждого сервера выделяется один байт. "\
   "0 - сервер недоступен, 1 - сервер доступен для подключения, 2 - сервер доступен и используется, для получения данных.\n"\
   "  В конце проверки соединения эмитируется сигнал notice с буфером state, в качестве параметра (содержит текущие состояния подключений).\n"\
   "  2. При получении новых данных, они помещаются в буфер input и эмитируется сигнал dataReaded.\n"\
+  "    Если задан параметр " P_MULTIPATH ", данные принимаются от всех подключенных серверов одновременно. Поток каждого сервера "\
+  "разбивается на кадры (" P_FRAME "), кадр передается в протокол сразу, как только получена его первая копия. Повторные копии "\
+  "от других серверов определяются по хэшу содержимого, либо по порядковому номеру кадра (" P_DEDUP ") и отбрасываются, "\
+  "если пришли не позже age после первой копии. Повтор кадра тем же сервером считается новыми данными. "\
+  "Потеря любого из серверов не приводит к паузе в получении данных. Отправка данных выполняется через текущее подключение.\n"\
   "  3. При получении сигнала readyWrite от протокольной библиотеки, буфер output помещается в tcp стек на отправку.\n"\
   "Автор " LIB_AUTHOR
 
@@ -77,13 +97,34 @@ private:
  // Структура, хранящая параметры TCP-клиента:
   tcpclientm::Params          m_params;
 
+  // привязка потока интерфейса к ядрам и приоритет
+  rt::Params m_realtime;
+
+  // счетчики интерфейса, /metrics
+  metrics::InterfaceMetrics m_metrics;
+
+  // время приема данных для трассировки задержек, /latency
+  latency::Receiver m_latency;
+
+  // RTT серверов по порядку подключений и время переключения на резервный сервер
+  QVector<metrics::Gauge>     m_rtt;
+  metrics::Histogram          m_failover;
+
   // Таймер, используемый в функции "SvTcpClient::read". Коментарии - в этой функции.
   QTimer*                     m_gap_timer;
 
   // Таймер, пр таймауту которого, мы выполняем проверку установлено ли TCP-соединение
-  // с сервером:
+  // с сервером. срабатывает с периодом heartbeat_interval
   QTimer*                     m_connectionCheckTimer;
 
+  // монотонные часы для измерения RTT и времени переключения
+  QElapsedTimer               m_clock;
+
+  // момент потери текущего подключения, мкс. -1 - подключение не терялось
+  qint64                      m_lost_at = -1;
+
+  qint64 now() const { return m_clock.nsecsElapsed() / 1000; }
+
   // Флаг, говорящий о том, что выполняется команда разрыва TCP-соединения
   // с сервером. Этот флаг нужен нам для того, чтобы с момента подачи TCP-сокету команды
   // на разъединение соединения с сервером до момента, когда соединение будет разорвано, не
@@ -99,6 +140,49 @@ private:
   // его установить:
    void checkConnection(void);
 
+   // доступен ли сервер: есть соединение и ответ был не позже heartbeat_timeout
+   bool isAlive(tcpclientm::ConnectionItem* connection);
+
+   // выбор текущего подключения из доступных серверов по приоритету
+   void selectConnection(void);
+
+   // RTT по данным ядра (TCP_INFO), если пакет проверки связи не задан
+   void updateKernelRtt(tcpclientm::ConnectionItem* connection);
+
+   // режим multipath: последние переданные в протокол кадры по ключу
+   struct Seen {
+
+     int     connection;   // подключение, от которого кадр передан в протокол
+     qint64  time;         // момент передачи, мкс
+
+   };
+
+   QHash<quint64, Seen>              m_seen;
+   QQueue<QPair<quint64, qint64>>    m_seen_order;
+
+   // кол-во отброшенных повторных кадров с последней проверки подключений
+   quint64                     m_duplicates = 0;
+
+   // прием данных подключения index: ответ на проверку связи отделяется, остальное
+   // передается в протокол (текущее подключение или multipath)
+   void receive(int index);
+
+   // удаление ответа на проверку связи из начала данных. true - ответ получен
+   bool takeReply(tcpclientm::ConnectionItem* connection, QByteArray& data);
+
+   // данные текущего подключения в буфер протокола
+   void input(const QByteArray& data);
+
+   // выделение из накопленных данных подключения завершенных кадров
+   void extractFrames(int index);
+
+   // передача в протокол кадра, принятого от подключения index. кадр отбрасывается,
+   // если такой же кадр был передан от другого подключения не раньше dedup.age.
+   // повтор кадра тем же подключением - новые данные, а не копия
+   void deliverFrame(const QByteArray& frame, int index);
+
+   quint64 frameKey(const QByteArray& frame, bool& ok) const;
+
 
 private slots:
   // Отображение в утилите "logview" ошибки сокета:
@@ -119,6 +203,13 @@ private slots:
   // в утилите "logview":
   void disconnected(void);
 
+  // данные от любого из серверов. данные текущего подключения передаются в read,
+  // остальные используются только как ответ на проверку связи
+  void socketReadyRead(void);
+
+  // режим multipath, кадры разделяются паузой: пауза grain_gap для подключения index истекла
+  void frameGap(int index);
+
   // Выяснение, какую команду требуется выполнить, и её выполнение.
   // Аргумент "command" - требуемая команда.
   // Возможные команды: "breakConnection" - разорвать соединение с сервером.
@@ -7,7 +7,7 @@ DEFINES += TCP_CLIENT_MULTI_LIBRARY
 CONFIG += c++11 plugin
 
 
-VERSION =   1.3.0    # major.minor.patch
+VERSION =   1.5.0    # major.minor.patch
 DEFINES +=  LIB_VERSION=\\\"$$VERSION\\\"
 DEFINES += "LIB_AUTHOR=\"\\\"Свиридов С. А.\\\"\""
 
@@ -36,9 +36,15 @@ QMAKE_LFLAGS += -Wno-unused-variable, -Wl,--no-undefined
 #}
 
 SOURCES += \
+    ../../../global/sv_metrics.cpp \
+    ../../../global/sv_latency.cpp \
+    ../../../global/sv_realtime.cpp \
     tcp_client_multi.cpp
 
 HEADERS += \
+    ../../../global/sv_metrics.h \
+    ../../../global/sv_latency.h \
+    ../../../global/sv_realtime.h \
     tcp_client_multi_defs.h \
     tcp_client_multi.h \
     tcp_client_multi_global.h \
@@ -4,6 +4,8 @@
 #include <QtGlobal>
 #include <QHostAddress>
 #include <QTcpSocket>
+#include <QTimer>
+#include <QMap>
 
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -16,6 +18,24 @@
 #define P_RECONNECT_PERIOD          "reconnect_period"
 #define P_CONNECTIONS               "connections"
 #define P_PRIORITY                  "priority"
+#define P_HEARTBEAT                 "heartbeat"
+#define P_HEARTBEAT_REPLY           "heartbeat_reply"
+#define P_HEARTBEAT_INTERVAL        "heartbeat_interval"
+#define P_HEARTBEAT_TIMEOUT         "heartbeat_timeout"
+
+#define P_MULTIPATH                 "multipath"
+#define P_FRAME                     "frame"
+#define P_DEDUP                     "dedup"
+#define P_MODE                      "mode"
+#define P_SIZE                      "size"
+#define P_OFFSET                    "offset"
+#define P_DELIMITER                 "delimiter"
+#define P_LENGTH_OFFSET             "length_offset"
+#define P_LENGTH_SIZE               "length_size"
+#define P_LENGTH_ADD                "length_add"
+#define P_KEY                       "key"
+#define P_WINDOW                    "window"
+#define P_AGE                       "age"
 
 #define P_CONNECTIONS_DESC          "список хостов, к которым должен подключаться клиент. должен содержать ip адрес, порт, приоритет подключения. флаг enable определяет, будет ли использоваться данное подключение"
 #define P_HOST_DESC                 "ip адрес, к которому клиент должен подключаться"
@@ -24,6 +44,13 @@
 #define P_RECONNECT_PERIOD_DESC     "период в милисекундах, с которым TCP-клиент осуществляет попытки установить соединение с сервером"
 #define P_GRAIN_GAP_DESC            "период (в милисекундах) ожидания частей пакета данных"
 #define P_FMT_DESC                  "форматирование сообщений для логирования"
+#define P_HEARTBEAT_DESC            "пакет проверки связи в hex, отправляемый всем подключенным серверам. если не задан, состояние и RTT определяются по TCP_INFO"
+#define P_HEARTBEAT_REPLY_DESC      "начало ответа сервера на пакет проверки связи в hex. ответ удаляется из принятых данных и не передается в протокол. по умолчанию совпадает с heartbeat (эхо)"
+#define P_HEARTBEAT_INTERVAL_DESC   "период (в милисекундах) проверки подключений. сервер считается недоступным через heartbeat_timeout после последних данных от него, переключение на резервный сервер занимает не более heartbeat_timeout + heartbeat_interval"
+#define P_HEARTBEAT_TIMEOUT_DESC    "время (в милисекундах) без ответа от сервера, после которого сервер считается недоступным"
+#define P_MULTIPATH_DESC            "прием данных от всех подключенных серверов одновременно. в протокол передается первая копия каждого кадра"
+#define P_FRAME_DESC                "разбиение потока на кадры в режиме multipath. mode: gap | fixed (size) | delimiter (delimiter hex) | length (length_offset, length_size, length_add)"
+#define P_DEDUP_DESC                "отбрасывание повторных кадров в режиме multipath. key: hash | seq (offset, size), window - кол-во запоминаемых кадров, age - время (мс), в течение которого кадр от другого сервера считается копией"
 
 // дефолтное значение параметра "port" по умолчанию (то есть если оно не задано в конфигурационном файле):
 #define DEFAULT_PORT                10000
@@ -34,6 +61,12 @@
 // дефолтное значение периода с которым TCP-клиент осуществляет попытки установить соединение с сервером,
 #define DEFAULT_RECONNECT_PERIOD    1000
 
+#define DEFAULT_HEARTBEAT_INTERVAL  200
+#define DEFAULT_HEARTBEAT_TIMEOUT   1000
+
+#define DEFAULT_DEDUP_WINDOW        256
+#define DEFAULT_DEDUP_AGE           500
+
 #define STATE_NO_CONNECTION         0
 #define STATE_HOST_ACCESIBLE        1
 #define STATE_HOST_IN_USE           2
@@ -49,6 +82,13 @@ namespace tcpclientm {
       MAKE_PARAM_STR_2(P_PRIORITY,          P_PRIORITY_DESC,         "int",         "false", STR(DEFAULT_UNDEFINED_PRIORITY), "", ",\n")\
       MAKE_PARAM_STR_2(P_RECONNECT_PERIOD,  P_RECONNECT_PERIOD_DESC, "quint16",     "false", STR(DEFAULT_RECONNECT_PERIOD),   "1 - 65535", ",\n")\
       MAKE_PARAM_STR_2(P_GRAIN_GAP,         P_GRAIN_GAP_DESC,        "quint16",     "false", STR(DEFAULT_GRAIN_GAP),          "1 - 65535", ",\n")\
+      MAKE_PARAM_STR_2(P_HEARTBEAT,         P_HEARTBEAT_DESC,        "string",      "false", "NULL",                          "hex строка", ",\n")\
+      MAKE_PARAM_STR_2(P_HEARTBEAT_REPLY,   P_HEARTBEAT_REPLY_DESC,  "string",      "false", "NULL",                          "hex строка", ",\n")\
+      MAKE_PARAM_STR_2(P_HEARTBEAT_INTERVAL,P_HEARTBEAT_INTERVAL_DESC,"quint16",    "false", STR(DEFAULT_HEARTBEAT_INTERVAL), "1 - 65535", ",\n")\
+      MAKE_PARAM_STR_2(P_HEARTBEAT_TIMEOUT, P_HEARTBEAT_TIMEOUT_DESC,"quint16",     "false", STR(DEFAULT_HEARTBEAT_TIMEOUT),  "1 - 65535", ",\n")\
+      MAKE_PARAM_STR_2(P_MULTIPATH,         P_MULTIPATH_DESC,        "bool",        "false", "false",                         "true | false", ",\n")\
+      MAKE_PARAM_STR_2(P_FRAME,             P_FRAME_DESC,            "json объект", "false", "{\\\"mode\\\": \\\"gap\\\"}",      "", ",\n")\
+      MAKE_PARAM_STR_2(P_DEDUP,             P_DEDUP_DESC,            "json объект", "false", "{\\\"key\\\": \\\"hash\\\"}",      "", ",\n")\
       MAKE_PARAM_STR_2(P_FMT,               P_FMT_DESC,              "string",      "false", "hex",                           "hex | ascii | len", "\n")\
       "]}";
 
@@ -108,6 +148,46 @@ namespace tcpclientm {
                                                                     {"any",       QHostAddress::Any},
                                                                     {"broadcast", QHostAddress::Broadcast}};
 
+  /** разбиение потока на кадры в режиме multipath **/
+  enum FrameMode {
+    fmGap,          // кадр - данные, пришедшие без перерыва больше grain_gap
+    fmFixed,        // кадры фиксированного размера
+    fmDelimiter,    // кадр заканчивается заданной последовательностью байт
+    fmLength        // длина кадра задана полем в заголовке
+  };
+
+  const QMap<QString, FrameMode> FrameModes = {{"gap",       fmGap},
+                                               {"fixed",     fmFixed},
+                                               {"delimiter", fmDelimiter},
+                                               {"length",    fmLength}};
+
+  struct FrameParams {
+
+    FrameMode   mode          = fmGap;
+    int         size          = 0;          // fmFixed
+    QByteArray  delimiter;                  // fmDelimiter
+    int         length_offset = 0;          // fmLength: смещение поля длины (big endian)
+    int         length_size   = 2;          // размер поля длины, 1 - 4 байта
+    int         length_add    = 0;          // полная длина кадра = значение поля + length_add
+
+  };
+
+  /** ключ, по которому определяются повторные кадры **/
+  enum DedupKey {
+    dkHash,         // хэш содержимого кадра
+    dkSequence      // порядковый номер кадра (big endian)
+  };
+
+  struct DedupParams {
+
+    DedupKey    key     = dkHash;
+    int         offset  = 0;
+    int         size    = 2;
+    int         window  = DEFAULT_DEDUP_WINDOW;
+    int         age     = DEFAULT_DEDUP_AGE;     // мс
+
+  };
+
   struct ConnectionItem {
 
     // приоритет подключения. по умолчанию -1, не определен
@@ -121,6 +201,25 @@ namespace tcpclientm {
     QTcpSocket*  socket     = nullptr;
     int          state      = STATE_NO_CONNECTION;
 
+    // время по монотонным часам интерфейса, мкс
+    qint64       last_attempt = -1;   // последняя попытка подключения
+    qint64       last_reply   = -1;   // последние данные от сервера
+    qint64       probe_sent   = -1;   // отправленный, но еще не подтвержденный пакет проверки связи
+
+    // номера отправленных пакетов проверки связи и полученных ответов. TCP сохраняет порядок,
+    // поэтому n-ый ответ относится к n-му пакету. RTT засчитывается только ответу на последний пакет
+    quint32      probe_seq    = 0;
+    quint32      reply_seq    = 0;
+
+    // начало ответа на проверку связи, пришедшее без окончания
+    QByteArray   reply;
+
+    qint64       rtt          = -1;   // время прохождения запрос-ответ, мкс. -1 - не измерено
+
+    // режим multipath: накопленные данные незавершенного кадра и таймер паузы для fmGap
+    QByteArray   rx;
+    QTimer*      frame_timer  = nullptr;
+
   };
 
     // Cтруктура для хранения параметров TCP клиента:
@@ -139,6 +238,17 @@ namespace tcpclientm {
     // Период с которым TCP-клиент осуществляет попытки установить соединение с сервером:
     quint16     reconnect_period  = DEFAULT_RECONNECT_PERIOD;
 
+    // пакет проверки связи и период опроса серверов
+    QByteArray  heartbeat           = QByteArray();
+    QByteArray  heartbeat_reply     = QByteArray();
+    quint16     heartbeat_interval  = DEFAULT_HEARTBEAT_INTERVAL;
+    quint16     heartbeat_timeout   = DEFAULT_HEARTBEAT_TIMEOUT;
+
+    // прием от всех серверов с отбрасыванием повторных кадров
+    bool        multipath           = false;
+    FrameParams frame;
+    DedupParams dedup;
+
 //    static QString usage()
 //    {
 //      QString fmts = QString();
@@ -310,6 +420,154 @@ namespace tcpclientm {
       }
       else p.reconnect_period = quint16(DEFAULT_RECONNECT_PERIOD);
 
+      // пакет проверки связи
+      P = P_HEARTBEAT;
+      if(object.contains(P)) {
+
+        QString hex = object.value(P).toString("").remove(' ');
+
+        if(!object.value(P).isString() || hex.length() % 2 || QByteArray::fromHex(hex.toLatin1()).toHex() != hex.toLower().toLatin1())
+          throw SvException(QString(IMPERMISSIBLE_VALUE).arg(P).arg(json)
+                            .arg("Пакет проверки связи должен быть задан строкой в шестнадцатеричном формате, например \"AA0155\""));
+
+        p.heartbeat = QByteArray::fromHex(hex.toLatin1());
+
+      }
+      else p.heartbeat = QByteArray();
+
+      // ответ на пакет проверки связи
+      P = P_HEARTBEAT_REPLY;
+      if(object.contains(P)) {
+
+        QString hex = object.value(P).toString("").remove(' ');
+
+        if(!object.value(P).isString() || hex.isEmpty() || hex.length() % 2 || QByteArray::fromHex(hex.toLatin1()).toHex() != hex.toLower().toLatin1())
+          throw SvException(QString(IMPERMISSIBLE_VALUE).arg(P).arg(json)
+                            .arg("Ответ на пакет проверки связи должен быть задан непустой строкой в шестнадцатеричном формате, например \"AA0155\""));
+
+        if(p.heartbeat.isEmpty())
+          throw SvException(QString(IMPERMISSIBLE_VALUE).arg(P).arg(json)
+                            .arg(QString("Ответ на пакет проверки связи задается только вместе с параметром \"%1\"").arg(P_HEARTBEAT)));
+
+        p.heartbeat_reply = QByteArray::fromHex(hex.toLatin1());
+
+      }
+      else p.heartbeat_reply = p.heartbeat;
+
+      // период проверки подключений
+      P = P_HEARTBEAT_INTERVAL;
+      if(object.contains(P)) {
+
+        if(object.value(P).toInt(-1) < 1 || object.value(P).toInt(-1) > 65535)
+          throw SvException(QString(IMPERMISSIBLE_VALUE).arg(P).arg(json)
+                            .arg("Период проверки подключений задается в милисекундах в диапазоне [1..65535]"));
+
+        p.heartbeat_interval = object.value(P).toInt(DEFAULT_HEARTBEAT_INTERVAL);
+
+      }
+      else p.heartbeat_interval = quint16(DEFAULT_HEARTBEAT_INTERVAL);
+
+      // время ожидания ответа сервера
+      P = P_HEARTBEAT_TIMEOUT;
+      if(object.contains(P)) {
+
+        if(object.value(P).toInt(-1) < 1 || object.value(P).toInt(-1) > 65535)
+          throw SvException(QString(IMPERMISSIBLE_VALUE).arg(P).arg(json)
+                            .arg("Время ожидания ответа задается в милисекундах в диапазоне [1..65535]"));
+
+        p.heartbeat_timeout = object.value(P).toInt(DEFAULT_HEARTBEAT_TIMEOUT);
+
+      }
+      else p.heartbeat_timeout = quint16(DEFAULT_HEARTBEAT_TIMEOUT);
+
+      // прием от всех серверов одновременно
+      P = P_MULTIPATH;
+      p.multipath = object.contains(P) ? object.value(P).toBool(false) : false;
+
+      // разбиение на кадры
+      P = P_FRAME;
+      if(object.contains(P)) {
+
+        if(!object.value(P).isObject())
+          throw SvException(QString(IMPERMISSIBLE_VALUE).arg(P).arg(json)
+                            .arg("Параметры разбиения на кадры должны быть заданы json объектом"));
+
+        QJsonObject fo = object.value(P).toObject();
+
+        QString mode = fo.value(P_MODE).toString("gap").toLower();
+        if(!FrameModes.contains(mode))
+          throw SvException(QString(IMPERMISSIBLE_VALUE).arg(P).arg(json)
+                            .arg("Допустимые режимы разбиения на кадры: [\"gap\"|\"fixed\"|\"delimiter\"|\"length\"]"));
+
+        p.frame.mode = FrameModes.value(mode);
+
+        switch (p.frame.mode) {
+
+          case fmFixed:
+
+            p.frame.size = fo.value(P_SIZE).toInt(0);
+
+            if(p.frame.size < 1)
+              throw SvException(QString(IMPERMISSIBLE_VALUE).arg(P).arg(json)
+                                .arg("Размер кадра должен быть задан целым положительным числом"));
+            break;
+
+          case fmDelimiter:
+
+            p.frame.delimiter = QByteArray::fromHex(fo.value(P_DELIMITER).toString("").toLatin1());
+
+            if(p.frame.delimiter.isEmpty())
+              throw SvException(QString(IMPERMISSIBLE_VALUE).arg(P).arg(json)
+                                .arg("Разделитель кадров должен быть задан строкой в шестнадцатеричном формате"));
+            break;
+
+          case fmLength:
+
+            p.frame.length_offset = fo.value(P_LENGTH_OFFSET).toInt(0);
+            p.frame.length_size   = fo.value(P_LENGTH_SIZE).toInt(2);
+            p.frame.length_add    = fo.value(P_LENGTH_ADD).toInt(0);
+
+            if(p.frame.length_offset < 0 || p.frame.length_size < 1 || p.frame.length_size > 4)
+              throw SvException(QString(IMPERMISSIBLE_VALUE).arg(P).arg(json)
+                                .arg("Поле длины кадра задается смещением от 0 и размером от 1 до 4 байт"));
+            break;
+
+          default:
+            break;
+        }
+      }
+
+      // отбрасывание повторных кадров
+      P = P_DEDUP;
+      if(object.contains(P)) {
+
+        if(!object.value(P).isObject())
+          throw SvException(QString(IMPERMISSIBLE_VALUE).arg(P).arg(json)
+                            .arg("Параметры отбрасывания повторных кадров должны быть заданы json объектом"));
+
+        QJsonObject dobj = object.value(P).toObject();
+
+        QString key = dobj.value(P_KEY).toString("hash").toLower();
+        if(key != "hash" && key != "seq")
+          throw SvException(QString(IMPERMISSIBLE_VALUE).arg(P).arg(json)
+                            .arg("Ключ для отбрасывания повторных кадров: [\"hash\"|\"seq\"]"));
+
+        p.dedup.key     = key == "seq" ? dkSequence : dkHash;
+        p.dedup.offset  = dobj.value(P_OFFSET).toInt(0);
+        p.dedup.size    = dobj.value(P_SIZE).toInt(2);
+        p.dedup.window  = dobj.value(P_WINDOW).toInt(DEFAULT_DEDUP_WINDOW);
+        p.dedup.age     = dobj.value(P_AGE).toInt(DEFAULT_DEDUP_AGE);
+
+        if(p.dedup.offset < 0 || p.dedup.size < 1 || p.dedup.size > 8 || p.dedup.window < 1)
+          throw SvException(QString(IMPERMISSIBLE_VALUE).arg(P).arg(json)
+                            .arg("Номер кадра задается смещением от 0 и размером от 1 до 8 байт, размер окна должен быть больше 0"));
+
+        if(p.dedup.age < 1 || p.dedup.age > 65535)
+          throw SvException(QString(IMPERMISSIBLE_VALUE).arg(P).arg(json)
+                            .arg("Время, в течение которого кадр от другого сервера считается копией, задается в милисекундах в диапазоне [1..65535]"));
+
+      }
+
       return p;
 
     }
@@ -342,6 +600,44 @@ namespace tcpclientm {
       j.insert(P_GRAIN_GAP,         QJsonValue(grain_gap));
       j.insert(P_FMT,               QJsonValue(fmt));
       j.insert(P_RECONNECT_PERIOD,  QJsonValue(reconnect_period));
+      j.insert(P_HEARTBEAT_INTERVAL,QJsonValue(heartbeat_interval));
+      j.insert(P_HEARTBEAT_TIMEOUT, QJsonValue(heartbeat_timeout));
+
+      if(!heartbeat.isEmpty())
+        j.insert(P_HEARTBEAT,       QJsonValue(QString(heartbeat.toHex())));
+
+      if(!heartbeat_reply.isEmpty())
+        j.insert(P_HEARTBEAT_REPLY, QJsonValue(QString(heartbeat_reply.toHex())));
+
+      j.insert(P_MULTIPATH,         QJsonValue(multipath));
+
+      QJsonObject fo;
+      fo.insert(P_MODE,             QJsonValue(FrameModes.key(frame.mode)));
+
+      switch (frame.mode) {
+        case fmFixed:     fo.insert(P_SIZE,      QJsonValue(frame.size)); break;
+        case fmDelimiter: fo.insert(P_DELIMITER, QJsonValue(QString(frame.delimiter.toHex()))); break;
+        case fmLength:
+          fo.insert(P_LENGTH_OFFSET, QJsonValue(frame.length_offset));
+          fo.insert(P_LENGTH_SIZE,   QJsonValue(frame.length_size));
+          fo.insert(P_LENGTH_ADD,    QJsonValue(frame.length_add));
+          break;
+        default: break;
+      }
+
+      j.insert(P_FRAME,             QJsonValue(fo));
+
+      QJsonObject dobj;
+      dobj.insert(P_KEY,            QJsonValue(dedup.key == dkSequence ? "seq" : "hash"));
+      dobj.insert(P_WINDOW,         QJsonValue(dedup.window));
+      dobj.insert(P_AGE,            QJsonValue(dedup.age));
+
+      if(dedup.key == dkSequence) {
+        dobj.insert(P_OFFSET,       QJsonValue(dedup.offset));
+        dobj.insert(P_SIZE,         QJsonValue(dedup.size));
+      }
+
+      j.insert(P_DEDUP,             QJsonValue(dobj));
 
       return j;
     }
@@ -14,6 +14,9 @@
 
 #include "../../../../Modus/global/global_defs.h"
 #include "../../../../Modus/global/device/interface/sv_abstract_interface.h"
+#include "../../../global/sv_realtime.h"
+#include "../../../global/sv_metrics.h"
+#include "../../../global/sv_latency.h"
 
 #define LIB_SHORT_INFO \
   "TCP сервер рассчитанный на подключение одного клиента. Взможность подключения нескольких клиентов не реализована. Интерфейсная библиотека Modus. Версия" LIB_VERSION "\n"
@@ -82,6 +85,15 @@ private:
   // Структура, хранящая параметры TCP-сервера:
   tcp::Params m_params;
 
+  // привязка потока интерфейса к ядрам и приоритет
+  rt::Params m_realtime;
+
+  // счетчики интерфейса, /metrics
+  metrics::InterfaceMetrics m_metrics;
+
+  // время приема данных для трассировки задержек, /latency
+  latency::Receiver m_latency;
+
   // Таймер, который используется при операции чтения данных от клиента.
   // Коментарии - в функции: SvTcpServer::read.
   QTimer*  m_gap_timer;
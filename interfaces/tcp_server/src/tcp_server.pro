@@ -36,9 +36,15 @@ QMAKE_LFLAGS += -Wno-unused-variable, -Wl,--no-undefined
 #}
 
 SOURCES += \
+    ../../../global/sv_metrics.cpp \
+    ../../../global/sv_latency.cpp \
+    ../../../global/sv_realtime.cpp \
     sv_tcp_server.cpp
 
 HEADERS += \
+    ../../../global/sv_metrics.h \
+    ../../../global/sv_latency.h \
+    ../../../global/sv_realtime.h \
     ../../../../Modus/global/device/interface/sv_abstract_interface.h \
     ../../../../Modus/global/device/device_defs.h \
     sv_tcp_server.h \
@@ -23,6 +23,12 @@ bool SvUdp::configure(modus::DeviceConfig* config, modus::IOBuffer*iobuffer)
 
     m_params = udp::Params::fromJsonString(p_config->interface.params);
 
+    m_realtime = rt::Params::fromJsonString(p_config->interface.params);
+
+
+    m_metrics.attach(p_config->name);
+    m_latency.attach(p_config->name);
+
     return true;
 
   } catch (SvException& e) {
@@ -35,6 +41,11 @@ bool SvUdp::configure(modus::DeviceConfig* config, modus::IOBuffer*iobuffer)
 
 bool SvUdp::start()
 {
+  // параметры реального времени применяются в потоке интерфейса
+  QString rt_error;
+  if(!rt::apply(m_realtime, &rt_error))
+    emit message(rt_error, sv::log::llError, sv::log::mtError);
+
   try {
 
     m_socket = new QUdpSocket();
@@ -95,14 +106,25 @@ void SvUdp::read()
 
   p_io_buffer->input->mutex.lock();
 
-  if(p_io_buffer->input->offset + m_socket->bytesAvailable() > p_config->bufsize)
+  if(p_io_buffer->input->offset + m_socket->bytesAvailable() > p_config->bufsize) {
+
     p_io_buffer->input->reset();
+    m_metrics.drops.inc();
+
+  }
 
 //    /* ... the rest of the datagram will be lost ... */
   qint64 readed = m_socket->readDatagram(&p_io_buffer->input->data[p_io_buffer->input->offset], p_config->bufsize - p_io_buffer->input->offset);
 
-  if(p_io_buffer->input->offset == 0)
+  if(readed > 0)
+    m_metrics.bytes_in.inc(quint64(readed));
+
+  if(p_io_buffer->input->offset == 0) {
+
     p_io_buffer->input->set_time = QDateTime::currentMSecsSinceEpoch();
+    m_latency.stamp();
+
+  }
 
   emit_message(QByteArray((const char*)&p_io_buffer->input->data[p_io_buffer->input->offset], readed), sv::log::llDebug, sv::log::mtReceive);
 
@@ -153,9 +175,13 @@ void SvUdp::write(modus::BUFF* buffer)
   bool written = m_socket->writeDatagram(&buffer->data[0], buffer->offset, m_params.host, m_params.send_port) > 0;
   m_socket->flush();
 
-  if(written)
+  if(written) {
+
+    m_metrics.bytes_out.inc(quint64(buffer->offset));
     emit_message(QByteArray((const char*)&buffer->data[0], buffer->offset), sv::log::llDebug, sv::log::mtSend);
 
+  }
+
   buffer->reset();
 
   buffer->mutex.unlock();
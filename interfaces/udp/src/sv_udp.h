@@ -9,6 +9,9 @@
 
 #include "../../../../Modus/global/global_defs.h"
 #include "../../../../Modus/global/device/interface/sv_abstract_interface.h"
+#include "../../../global/sv_realtime.h"
+#include "../../../global/sv_metrics.h"
+#include "../../../global/sv_latency.h"
 
 #define LIB_SHORT_INFO \
   "UDP сервер, слушающий один порт. Реализована возможность перенаправления данных на другой узел сети. Интерфейсная библиотека Modus. Версия" LIB_VERSION "\n"
@@ -63,6 +66,15 @@ private:
 
   udp::Params     m_params;
 
+  // привязка потока интерфейса к ядрам и приоритет
+  rt::Params m_realtime;
+
+  // счетчики интерфейса, /metrics
+  metrics::InterfaceMetrics m_metrics;
+
+  // время приема данных для трассировки задержек, /latency
+  latency::Receiver m_latency;
+
   QTimer*       m_gap_timer;
 
   QTimer*       m_test_timer;
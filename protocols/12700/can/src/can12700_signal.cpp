@@ -10,7 +10,7 @@ void can::CANSignalCollection::addSignal(modus::SvSignal* signal) //throw (SvExc
 {
   try
   {
-    can::SignalParams p = can::SignalParams::fromJson(signal->config()->params);
+    can::SignalParams p = signalParams<can::SignalParams>(signal);
 
     if(m_signals.contains(getUid(p.canid, 0, 0, quint8(p.offset / 8), p.offset % 8)))
       throw SvException(QString("Не уникальные значения параметров: '%1'")
@@ -44,7 +44,7 @@ void can::CANSignalCollection::updateSignals(const can_frame& frame)
 
       quint8 mask = pow(2, m_signals.value(uid).params.len) - 1;
 
-      m_signals.value(uid).signal->setValue((frame.data[byte] >> bit) & mask);
+      setSignalValue(m_signals.value(uid).signal, (frame.data[byte] >> bit) & mask);
 
     }
   }
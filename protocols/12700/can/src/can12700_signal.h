@@ -8,6 +8,7 @@
 
 #include "can_defs.h"
 #include "../../../../../Modus/global/signal/sv_abstract_signal_collection.h"
+#include "../../global/sv_batched_collection.h"
 
 #define P_CANID   "canid"
 #define P_OFFSET  "offset"
@@ -129,7 +130,7 @@ namespace can {
 
   };
 
-  class CANSignalCollection : public modus::SvAbstractSignalCollection
+  class CANSignalCollection : public modus::SvAbstractSignalCollection, public m12700::SvBatchedCollection
   {
     Q_OBJECT
   public:
@@ -144,7 +145,6 @@ namespace can {
   private:
     QMap<quint64, can::CANSignal> m_signals;
 
-
   };
 }
 
@@ -1,37 +1,32 @@
 ﻿#include "proj_12700_can.h"
 
 can::SvCAN12700::SvCAN12700():
-  modus::SvAbstractProtocol()
+  m12700::SvProtocol12700("12700_can", false, 1)
 {
-
+  signal_collection.setBatch(&m_batch);
+  signal_collection.setImage(&m_image);
 }
 
-bool can::SvCAN12700::configure(modus::DeviceConfig *config, modus::IOBuffer *iobuffer)
+can::SvCAN12700::~SvCAN12700()
 {
-  try {
-
-    p_config = config;
-    p_io_buffer = iobuffer;
-
-//    m_params = can::DeviceParams::fromJson(p_config->protocol.params);
-
-    if(!m_data.resize(p_config->bufsize))
-      throw SvException(QString("Не удалось выделить %1 байт памяти для буфера").arg(p_config->bufsize));
-
-    return true;
-
-  } catch (SvException& e) {
+  detach();
+}
 
-    p_last_error = e.error;
-    return false;
+void can::SvCAN12700::configureDevice()
+{
+//  m_params = can::DeviceParams::fromJson(p_config->protocol.params);
 
-  }
+  // у устройства CAN своих параметров нет, образ хранит только параметры сигналов
+  if(!m_data.resize(p_config->bufsize))
+    throw SvException(QString("Не удалось выделить %1 байт памяти для буфера").arg(p_config->bufsize));
 }
 
 void can::SvCAN12700::disposeInputSignal (modus::SvSignal* signal)
 {
   try {
 
+    m_timeouts.addSignal(signal, this);
+
     signal_collection.addSignal(signal);
 
   }
@@ -46,35 +41,26 @@ void can::SvCAN12700::disposeOutputSignal (modus::SvSignal* signal)
   Q_UNUSED(signal);
 }
 
-void can::SvCAN12700::run()
+bool can::SvCAN12700::parseInput()
 {
-  p_is_active = bool(p_config) && bool(p_io_buffer);
-
-  while(p_is_active) {
-
-//    p_io_buffer->confirm->mutex.lock();     // если нужен ответ квитирование
-    p_io_buffer->input->mutex.lock();
-
-    can::PARSERESULT result = parse();
+  quint64 received = p_io_buffer->input->offset;
 
-    if(result.do_reset == DO_RESET)
-      p_io_buffer->input->reset();
+  can::PARSERESULT result = parse();
 
-    p_io_buffer->input->mutex.unlock();
-//    p_io_buffer->confirm->mutex.unlock();   // если нужен ответ квитирование
+  if(result.do_reset == DO_RESET)
+    p_io_buffer->input->reset();
 
-    if(result.parse_time.isValid())
-      validateSignals(result.parse_time);
+  return received != 0;
 
-    msleep(1);
-
-  }
 }
 
 can::PARSERESULT can::SvCAN12700::parse()
 {
 //  qDebug() << p_io_buffer->input->offset << m_framesz;
 
+  if(p_io_buffer->input->offset)
+    m_latency.parsed();
+
   // проходим по буферу, с учетом того, что там могут быть несколько фреймов
   for(quint64 oof = 0; oof < p_io_buffer->input->offset; oof += m_framesz) {
 
@@ -92,6 +78,8 @@ can::PARSERESULT can::SvCAN12700::parse()
 
     signal_collection.updateSignals(frame);
 
+    m_metrics.frames.inc();
+
   }
 
   return can::PARSERESULT(DO_RESET, QDateTime::currentDateTime());
@@ -5,6 +5,7 @@
 
 #include <QMutex>
 #include <QMutexLocker>
+#include <QElapsedTimer>
 
 #include "proj_12700_can_global.h"
 
@@ -16,6 +17,7 @@
 //#include "can_params.h"
 //#include "can_defs.h"
 #include "can12700_signal.h"
+#include "../../global/sv_protocol_12700.h"
 
 
 extern "C" {
@@ -63,17 +65,17 @@ namespace can {
 
 }
 
-class can::SvCAN12700: public modus::SvAbstractProtocol
+class can::SvCAN12700: public m12700::SvProtocol12700
 {
   Q_OBJECT
 
 public:
   SvCAN12700();
-
-  bool configure(modus::DeviceConfig* config, modus::IOBuffer *iobuffer) override;
+  ~SvCAN12700();
 
 protected:
-  void run() override;
+  void configureDevice() override; //throw (SvException)
+  bool parseInput() override;
 
   void disposeInputSignal (modus::SvSignal* signal) override;
   void disposeOutputSignal (modus::SvSignal* signal) override;
@@ -19,11 +19,28 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    ../../global/sv_params_image.cpp \
+    ../../global/sv_parse_scheduler.cpp \
+    ../../../../global/sv_realtime.cpp \
+    ../../../../global/sv_metrics.cpp \
+    ../../../../global/sv_latency.cpp \
+    ../../global/sv_signal_batch.cpp \
+    ../../global/sv_timing_wheel.cpp \
+    ../../global/sv_protocol_12700.cpp \
     proj_12700_can.cpp \
     ../../../../../Modus/global/signal/sv_signal.cpp \
     can12700_signal.cpp
 
 HEADERS += \
+    ../../global/sv_params_image.h \
+    ../../global/sv_parse_scheduler.h \
+    ../../../../global/sv_realtime.h \
+    ../../../../global/sv_metrics.h \
+    ../../../../global/sv_latency.h \
+    ../../global/sv_signal_batch.h \
+    ../../global/sv_timing_wheel.h \
+    ../../global/sv_protocol_12700.h \
+    ../../global/sv_batched_collection.h \
     ../../../../../Modus/global/device/protocol/sv_abstract_protocol.h \
     ../../../../../Modus/global/global_defs.h \
     can_defs.h \
@@ -33,6 +50,9 @@ HEADERS += \
     can12700_signal.h \
     ../../../../../Modus/global/signal/sv_abstract_signal_collection.h
 
+# dladdr - отпечаток сборки для образа параметров
+LIBS += -ldl
+
 # Default rules for deployment.
 unix {
     target.path = /usr/lib
@@ -0,0 +1,55 @@
+/**********************************************************************
+ *  общая часть коллекций сигналов протоколов проекта 12700.
+ *
+ *  коллекции opa, oht, skm и can назначают значения сигналам через
+ *  пакет изменений протокола (sv_signal_batch.h) и берут параметры
+ *  сигналов из образа параметров устройства (sv_params_image.h).
+ *  класс подмешивается к базовому классу коллекции протокола.
+ * *********************************************************************/
+
+#ifndef SV_BATCHED_COLLECTION_H
+#define SV_BATCHED_COLLECTION_H
+
+#include <QVariant>
+
+#include "../../../../Modus/global/signal/sv_signal.h"
+
+#include "sv_signal_batch.h"
+#include "sv_params_image.h"
+
+namespace m12700 {
+
+  class SvBatchedCollection;
+
+}
+
+class m12700::SvBatchedCollection
+{
+public:
+  virtual ~SvBatchedCollection() { }
+
+  // пакет изменений протокола. если не задан, значения назначаются сразу
+  void setBatch(m12700::SvSignalBatch* batch) { m_batch = batch; }
+
+  // образ разобранных параметров устройства. если не задан, параметры разбираются из JSON
+  void setImage(m12700::SvParamsImage* image) { m_image = image; }
+
+protected:
+  m12700::SvSignalBatch* m_batch = nullptr;
+  m12700::SvParamsImage* m_image = nullptr;
+
+  inline void setSignalValue(modus::SvSignal* signal, const QVariant& value)
+  {
+    if(m_batch) m_batch->stage(signal, value);
+    else        signal->setValue(value);
+  }
+
+  template<typename T>
+  inline T signalParams(modus::SvSignal* signal) //throw (SvException)
+  {
+    return m_image ? m_image->params<T>(signal->config()->params) : T::fromJson(signal->config()->params);
+  }
+
+};
+
+#endif // SV_BATCHED_COLLECTION_H
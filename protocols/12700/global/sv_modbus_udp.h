@@ -0,0 +1,213 @@
+/**********************************************************************
+ *  общий разбор пакетов Modbus поверх UDP для систем проекта 12700
+ *  (ОПА, ОХТ и т.д.).
+ *
+ *  пакет: Header, тип данных (1 байт), длина данных (1 байт), данные,
+ *  crc16 modbus. пакет разбирается на месте, в буфере input: DATA
+ *  содержит указатель на данные в буфере и действителен, пока буфер
+ *  заблокирован и не сброшен.
+ *
+ *  регистры и типы данных каждой системы задаются в ее описании
+ *  (структура с constexpr таблицами Registers и Types). по таблицам на
+ *  этапе компиляции строятся массивы на 256 элементов, поэтому выбор
+ *  действия по регистру и коллекции сигналов по типу - одно обращение
+ *  по индексу.
+ *
+ *  описание системы:
+ *    struct Project {
+ *      static constexpr quint8 CLIENT_ADDR = 1;
+ *      static constexpr quint8 FUNC_CODE   = 0x10;
+ *      static constexpr m12700::RegisterEntry Registers[] = { {0x00, m12700::raConfirm}, ... };
+ *      static constexpr m12700::TypeEntry     Types[]     = { {0x19, 0}, ... };  // тип -> номер коллекции
+ *      static constexpr int COLLECTIONS = ...;
+ *    };
+ * *********************************************************************/
+
+#ifndef SV_MODBUS_UDP_H
+#define SV_MODBUS_UDP_H
+
+#include <QtGlobal>
+#include <QString>
+
+#include <string.h>
+
+#include "../../../../Modus/global/device/device_defs.h"
+#include "../../../../svlib/sv_crc.h"
+
+#define M12700_TABLE_SIZE 256
+#define M12700_NO_SLOT    -1
+
+namespace m12700 {
+
+  #pragma pack(push,1)
+  struct Header
+  {
+    quint8  client_addr;
+    quint8  func_code;
+    quint8  ADDRESS;
+    quint8  OFFSET;
+    quint16 register_count;
+    quint8  byte_count;
+  };
+  #pragma pack(pop)
+
+  /** данные пакета. не владеет памятью, указывает в буфер input **/
+  struct DATA
+  {
+    const quint8* data  = nullptr;
+    quint8        type  = 0;
+    quint8        len   = 0;
+    quint16       crc   = 0;
+  };
+
+  /** действие по номеру регистра (смещению от start_register) **/
+  enum RegisterAction {
+    raNone = 0,     // регистр не обслуживается
+    raConfirm,      // только квитирование
+    raData          // квитирование и разбор данных
+  };
+
+  struct RegisterEntry {
+    quint8          offset;
+    RegisterAction  action;
+  };
+
+  struct TypeEntry {
+    quint8  type;
+    int     slot;   // номер коллекции сигналов
+  };
+
+  /** результат разбора **/
+  enum ParseStatus {
+    psIncomplete,   // пакет получен не полностью
+    psForeign,      // чужой пакет
+    psBadLength,    // длина данных не соответствует размеру пакета
+    psBadCrc,       // ошибка crc
+    psOk
+  };
+
+  struct Packet {
+
+    const Header*   header  = nullptr;
+    DATA            data;
+    quint16         register_offset = 0;
+    RegisterAction  action  = raNone;
+    int             slot    = M12700_NO_SLOT;
+    quint16         calc_crc = 0;
+
+  };
+
+  /** таблицы, построенные по описанию системы на этапе компиляции **/
+  template<typename Project>
+  struct Tables
+  {
+    RegisterAction  actions[M12700_TABLE_SIZE];
+    int             slots[M12700_TABLE_SIZE];
+
+    constexpr Tables(): actions{}, slots{}
+    {
+      for(int i = 0; i < M12700_TABLE_SIZE; i++) {
+
+        actions[i] = raNone;
+        slots[i]   = M12700_NO_SLOT;
+
+      }
+
+      for(const RegisterEntry& r: Project::Registers)
+        actions[r.offset] = r.action;
+
+      for(const TypeEntry& t: Project::Types)
+        slots[t.type] = t.slot;
+
+    }
+  };
+
+  template<typename Project>
+  class Parser
+  {
+  public:
+    static constexpr Tables<Project> tables = Tables<Project>();
+
+    // номер коллекции для типа данных, M12700_NO_SLOT - тип не обслуживается
+    static int slot(int type)
+    {
+      return (type >= 0 && type < M12700_TABLE_SIZE) ? tables.slots[type] : M12700_NO_SLOT;
+    }
+
+    static ParseStatus parse(const modus::BUFF* input, quint16 start_register, quint16 last_register, Packet& packet)
+    {
+      const quint8* buf = reinterpret_cast<const quint8*>(&input->data[0]);
+      const quint32 hsz = sizeof(Header);
+
+      // проверяем, что длина данных в буфере не меньше длины звголовка
+      if(input->offset < hsz)
+        return psIncomplete;
+
+      // разбираем заголовок. если адрес или код функции не тот, значит это чужой пакет
+      packet.header = reinterpret_cast<const Header*>(buf);
+
+      if((packet.header->client_addr != Project::CLIENT_ADDR) || (packet.header->func_code != Project::FUNC_CODE))
+        return psForeign;
+
+      // проверяем, что длина данных в буфере не меньше длины всего отправленного пакета
+      if(input->offset < hsz + packet.header->byte_count + 2)
+        return psIncomplete;
+
+      // проверяем начальный и конечный адреса регистров. если не входит в заданный диапазон - чужой пакет
+      quint16 current_register = (static_cast<quint16>(packet.header->ADDRESS << 8)) + packet.header->OFFSET;
+
+      if((current_register < start_register) || (current_register > last_register))
+        return psForeign;
+
+      packet.register_offset = current_register - start_register;
+
+      packet.data.type = buf[hsz];
+      packet.data.len  = buf[hsz + 1];
+      packet.data.data = &buf[hsz + 2];
+      packet.data.crc  = quint16(buf[hsz + packet.header->byte_count]) | quint16(buf[hsz + packet.header->byte_count + 1] << 8);
+
+      // данные должны помещаться в пакет, перед crc
+      if(packet.header->byte_count < 2 || packet.data.len > packet.header->byte_count - 2)
+        return psBadLength;
+
+      packet.calc_crc = CRC::MODBUS_CRC16(buf, hsz + packet.header->byte_count);
+
+      if(packet.calc_crc != packet.data.crc)
+        return psBadCrc;
+
+      packet.action = packet.register_offset < M12700_TABLE_SIZE ? tables.actions[packet.register_offset] : raNone;
+      packet.slot   = tables.slots[packet.data.type];
+
+      return psOk;
+
+    }
+
+    // ответ-квитирование: первые 6 байт заголовка и crc
+    static void confirmation(const Header* header, modus::BUFF* confirm)
+    {
+      memcpy(&confirm->data[0], header, 6);
+
+      quint16 crc = CRC::MODBUS_CRC16(reinterpret_cast<const quint8*>(header), 6);
+      confirm->data[6] = char(crc & 0xFF);
+      confirm->data[7] = char(crc >> 8);
+
+      confirm->offset = 8;
+
+    }
+
+    static QString crcError(const Packet& packet)
+    {
+      return QString("Ошибка crc! Ожидалось %1%2, получено %3%4")
+          .arg(quint8(packet.calc_crc), 2, 16, QChar('0'))
+          .arg(quint8(packet.calc_crc >> 8), 2, 16, QChar('0'))
+          .arg(quint8(packet.data.crc), 2, 16, QChar('0'))
+          .arg(quint8(packet.data.crc >> 8), 2, 16, QChar('0'));
+    }
+  };
+
+  template<typename Project>
+  constexpr Tables<Project> Parser<Project>::tables;
+
+}
+
+#endif // SV_MODBUS_UDP_H
@@ -0,0 +1,220 @@
+#include "sv_params_image.h"
+
+#include <QDir>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDateTime>
+
+#include <algorithm>
+
+#include <dlfcn.h>
+
+m12700::SvParamsImage::~SvParamsImage()
+{
+  if(m_file.isOpen())
+    m_file.close();   // отображение снимается вместе с закрытием файла
+}
+
+bool m12700::SvParamsImage::open(const ImageParams& params, const QString& tag, const QString& device, QString* error)
+{
+  // повторное конфигурирование - прежний образ закрывается
+  if(m_file.isOpen())
+    m_file.close();
+
+  m_path.clear();
+  m_records = nullptr;
+  m_count   = 0;
+  m_used.clear();
+  m_added.clear();
+  m_added_keys.clear();
+  m_hits    = 0;
+  m_misses  = 0;
+
+  if(params.dir.isEmpty())
+    return true;
+
+  QDir dir(params.dir);
+
+  if(!dir.exists() && !dir.mkpath(".")) {
+
+    if(error) *error = QString("Не удалось создать каталог образов параметров %1").arg(params.dir);
+    return false;
+
+  }
+
+  // имя устройства может содержать любые символы, в имени файла - его хеш
+  QByteArray name = device.toUtf8();
+  m_path = dir.filePath(QString("%1_%2.pimg").arg(tag).arg(fnv(name.constData(), name.size()), 16, 16, QChar('0')));
+
+  m_file.setFileName(m_path);
+
+  // файла еще нет - образ будет создан при сохранении
+  if(!m_file.exists())
+    return true;
+
+  if(!m_file.open(QIODevice::ReadOnly)) {
+
+    if(error) *error = QString("Ошибка открытия образа параметров %1: %2").arg(m_path).arg(m_file.errorString());
+    return false;
+
+  }
+
+  qint64 size = m_file.size();
+
+  const uchar* map = size >= qint64(sizeof(Header)) ? m_file.map(0, size) : nullptr;
+
+  if(map) {
+
+    const Header* header = reinterpret_cast<const Header*>(map);
+
+    // образ другой версии, записан другой сборкой библиотеки или поврежден - пересоздается
+    if(header->magic        == PARAMS_IMAGE_MAGIC &&
+       header->version      == PARAMS_IMAGE_VERSION &&
+       header->record_size  == sizeof(Record) &&
+       header->build        == build() &&
+       size == qint64(sizeof(Header) + quint64(header->count) * sizeof(Record))) {
+
+      m_records = reinterpret_cast<const Record*>(map + sizeof(Header));
+      m_count   = header->count;
+
+    }
+  }
+
+  return true;
+
+}
+
+const m12700::SvParamsImage::Record* m12700::SvParamsImage::find(quint64 key, quint32 type, quint32 text_len, quint32 size)
+{
+  // записи файла отсортированы по ключу
+  const Record* end = m_records + m_count;
+  const Record* r   = std::lower_bound(m_records, end, key, [](const Record& rec, quint64 k) { return rec.key < k; });
+
+  for(; r != end && r->key == key; ++r) {
+
+    if(r->type == type && r->text_len == text_len && r->size == size) {
+
+      m_used.insert(quint32(r - m_records));
+      return r;
+
+    }
+  }
+
+  // одинаковые параметры разных сигналов
+  if(m_added_keys.contains(key)) {
+
+    const Record& added = m_added.at(m_added_keys.value(key));
+
+    if(added.type == type && added.text_len == text_len && added.size == size)
+      return &added;
+
+  }
+
+  return nullptr;
+
+}
+
+void m12700::SvParamsImage::add(quint64 key, quint32 type, quint32 text_len, const void* data, quint32 size)
+{
+  Record r;
+  memset(&r, 0, sizeof(Record));
+
+  r.key       = key;
+  r.type      = type;
+  r.text_len  = text_len;
+  r.size      = size;
+  memcpy(r.data, data, size);
+
+  m_added_keys.insert(key, m_added.count());
+  m_added.append(r);
+
+}
+
+bool m12700::SvParamsImage::save(QString* error)
+{
+  if(!isOpen())
+    return true;
+
+  // образ не изменился
+  if(m_added.isEmpty() && m_used.count() == int(m_count))
+    return true;
+
+  QVector<Record> records;
+  records.reserve(m_used.count() + m_added.count());
+
+  for(quint32 i: m_used)
+    records.append(m_records[i]);
+
+  records += m_added;
+
+  std::sort(records.begin(), records.end(), [](const Record& a, const Record& b) { return a.key < b.key; });
+
+  Header header;
+  header.magic        = PARAMS_IMAGE_MAGIC;
+  header.version      = PARAMS_IMAGE_VERSION;
+  header.record_size  = sizeof(Record);
+  header.count        = quint32(records.count());
+  header.build        = build();
+
+  // запись во временный файл с заменой: при пропадании питания остается целый образ, старый или новый
+  QSaveFile f(m_path);
+
+  if(!f.open(QIODevice::WriteOnly) ||
+     f.write(reinterpret_cast<const char*>(&header), sizeof(Header)) != qint64(sizeof(Header)) ||
+     f.write(reinterpret_cast<const char*>(records.constData()), qint64(records.count()) * sizeof(Record)) != qint64(records.count()) * qint64(sizeof(Record)) ||
+     !f.commit()) {
+
+    if(error) *error = QString("Ошибка записи образа параметров %1: %2").arg(m_path).arg(f.errorString());
+    return false;
+
+  }
+
+  return true;
+
+}
+
+quint32 m12700::SvParamsImage::typeKey(const char* name, quint32 size)
+{
+  return quint32(fnv(name, int(strlen(name)), size));
+}
+
+quint64 m12700::SvParamsImage::build()
+{
+  // отпечаток вычисляется один раз: библиотека не меняется, пока загружена
+  static const quint64 b = [] {
+
+    QByteArray id = QByteArray(__DATE__ " " __TIME__);
+
+    // библиотека, в которую собран этот код
+    Dl_info info;
+    if(dladdr(reinterpret_cast<void*>(&SvParamsImage::build), &info) && info.dli_fname) {
+
+      QFileInfo fi(QString::fromLocal8Bit(info.dli_fname));
+
+      id.append(QString("|%1|%2|%3").arg(fi.absoluteFilePath()).arg(fi.size()).arg(fi.lastModified().toMSecsSinceEpoch()).toUtf8());
+
+    }
+
+    return fnv(id.constData(), id.size());
+
+  }();
+
+  return b;
+
+}
+
+quint64 m12700::SvParamsImage::fnv(const char* data, int len, quint64 seed)
+{
+  // FNV-1a, 64 бит
+  quint64 h = 14695981039346656037ULL ^ seed;
+
+  for(int i = 0; i < len; i++) {
+
+    h ^= quint8(data[i]);
+    h *= 1099511628211ULL;
+
+  }
+
+  return h;
+
+}
@@ -0,0 +1,218 @@
+/**********************************************************************
+ *  скомпилированный образ параметров устройства и его сигналов
+ *  для протоколов проекта 12700.
+ *
+ *  при большой конфигурации запуск занимает много времени: параметры
+ *  каждого сигнала (config()->params) разбираются отдельно, с полным
+ *  разбором JSON и преобразованием шестнадцатеричных и восьмеричных
+ *  строк в числа. образ хранит уже проверенные и разобранные структуры
+ *  параметров в двоичном виде, файл отображается в память.
+ *
+ *  запись образа - ключ (хеш типа структуры и текста параметров) и
+ *  сама структура. записи отсортированы по ключу, поиск двоичный.
+ *  при изменении текста параметров в конфигурации ключ меняется,
+ *  параметры разбираются заново, и образ перезаписывается - без
+ *  записей, которые больше не используются. ошибочные параметры в
+ *  образ не попадают и проверяются при каждом запуске.
+ *
+ *  образ включается параметром протокола "params_cache" - каталог для
+ *  файлов образов. на каждое устройство - отдельный файл.
+ *  структуры параметров должны быть простыми (trivially copyable), не
+ *  больше PARAMS_IMAGE_DATA байт. в заголовке образа хранится
+ *  отпечаток сборки библиотеки протокола (путь, размер и время
+ *  изменения файла): после пересборки или замены библиотеки образ
+ *  пересоздается, даже если изменились правила разбора или раскладка
+ *  структур. при изменении формата самого образа нужно увеличить
+ *  PARAMS_IMAGE_VERSION.
+ * *********************************************************************/
+
+#ifndef SV_PARAMS_IMAGE_H
+#define SV_PARAMS_IMAGE_H
+
+#include <QFile>
+#include <QVector>
+#include <QSet>
+#include <QHash>
+#include <QString>
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <typeinfo>
+#include <type_traits>
+#include <string.h>
+
+#include "../../../../Modus/global/global_defs.h"
+
+#define P_PARAMS_CACHE        "params_cache"
+
+#define PARAMS_IMAGE_MAGIC    0x474D4950    // "PIMG"
+#define PARAMS_IMAGE_VERSION  2
+#define PARAMS_IMAGE_DATA     16            // максимальный размер структуры параметров, байт
+
+namespace m12700 {
+
+  struct ImageParams {
+
+    // каталог файлов образов. пустой - образ не используется
+    QString dir = "";
+
+    static ImageParams fromJson(const QString& json_string) //throw (SvException)
+    {
+      if(json_string.trimmed().isEmpty())
+        return ImageParams();
+
+      QJsonParseError err;
+      QJsonDocument jd = QJsonDocument::fromJson(json_string.toUtf8(), &err);
+
+      if(err.error != QJsonParseError::NoError)
+        throw SvException(err.errorString());
+
+      try {
+
+        return fromJsonObject(jd.object());
+
+      }
+      catch(SvException& e) {
+        throw e;
+      }
+    }
+
+    static ImageParams fromJsonObject(const QJsonObject &object) //throw (SvException)
+    {
+      ImageParams p;
+      QString P;
+
+      P = P_PARAMS_CACHE;
+      if(object.contains(P)) {
+
+        if(!object.value(P).isString())
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P)
+                            .arg(object.value(P).toVariant().toString())
+                            .arg("Каталог образов параметров должен быть задан строкой"));
+
+        p.dir = object.value(P).toString();
+
+      }
+
+      return p;
+
+    }
+
+    QJsonObject toJsonObject() const
+    {
+      QJsonObject j;
+
+      j.insert(P_PARAMS_CACHE, QJsonValue(dir));
+
+      return j;
+
+    }
+  };
+
+  class SvParamsImage;
+
+}
+
+class m12700::SvParamsImage
+{
+public:
+  SvParamsImage() { }
+  ~SvParamsImage();
+
+  // открытие образа устройства device протокола tag в каталоге params.dir.
+  // если файла нет или он другой версии, образ будет создан при сохранении
+  bool open(const ImageParams& params, const QString& tag, const QString& device, QString* error = nullptr);
+
+  bool isOpen() const { return !m_path.isEmpty(); }
+
+  // параметры из образа. если записи нет - разбор T::fromJson и добавление записи
+  template<typename T>
+  T params(const QString& json_string) //throw (SvException)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "структура параметров должна быть простой");
+    static_assert(sizeof(T) <= PARAMS_IMAGE_DATA, "структура параметров больше записи образа");
+
+    if(!isOpen())
+      return T::fromJson(json_string);
+
+    QByteArray text = json_string.toUtf8();
+    quint32 type    = typeKey(typeid(T).name(), sizeof(T));
+    quint64 key     = fnv(text.constData(), text.size(), type);
+
+    const Record* record = find(key, type, text.size(), sizeof(T));
+
+    T p;
+
+    if(record) {
+
+      memcpy(&p, record->data, sizeof(T));
+      m_hits++;
+
+    }
+    else {
+
+      p = T::fromJson(json_string);
+      add(key, type, text.size(), &p, sizeof(T));
+      m_misses++;
+
+    }
+
+    return p;
+
+  }
+
+  // запись образа, если он изменился: добавлены или не использованы записи
+  bool save(QString* error = nullptr);
+
+  int hits() const    { return m_hits; }
+  int misses() const  { return m_misses; }
+
+  QString path() const { return m_path; }
+
+private:
+  struct Header {
+
+    quint32 magic;
+    quint32 version;
+    quint32 record_size;
+    quint32 count;
+    quint64 build;      // отпечаток сборки библиотеки, записавшей образ
+
+  };
+
+  struct Record {
+
+    quint64 key;
+    quint32 type;
+    quint32 text_len;   // длина текста параметров, дополнительная проверка ключа
+    quint32 size;
+    quint8  data[PARAMS_IMAGE_DATA];
+
+  };
+
+  QString         m_path = "";
+  QFile           m_file;
+
+  // записи отображенного файла
+  const Record*   m_records = nullptr;
+  quint32         m_count   = 0;
+
+  QSet<quint32>   m_used;       // номера использованных записей файла
+  QVector<Record> m_added;
+  QHash<quint64, int> m_added_keys;
+
+  int             m_hits    = 0;
+  int             m_misses  = 0;
+
+  const Record* find(quint64 key, quint32 type, quint32 text_len, quint32 size);
+  void add(quint64 key, quint32 type, quint32 text_len, const void* data, quint32 size);
+
+  static quint32 typeKey(const char* name, quint32 size);
+  static quint64 build();
+  static quint64 fnv(const char* data, int len, quint64 seed = 0);
+
+};
+
+#endif // SV_PARAMS_IMAGE_H
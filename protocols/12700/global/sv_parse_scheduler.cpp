@@ -0,0 +1,288 @@
+#include "sv_parse_scheduler.h"
+
+/** ********** SvParseWorker ************ **/
+
+m12700::SvParseWorker::SvParseWorker(SvParseScheduler* scheduler, int index):
+  QThread(),
+  m_scheduler(scheduler),
+  m_index(index)
+{
+
+}
+
+void m12700::SvParseWorker::run()
+{
+  m_scheduler->work(m_index);
+}
+
+/** ********** SvParseScheduler ************ **/
+
+m12700::SvParseScheduler* m12700::SvParseScheduler::instance()
+{
+  // объект не удаляется. потоки пула останавливаются при снятии последней задачи
+  static SvParseScheduler* scheduler = new SvParseScheduler;
+  return scheduler;
+}
+
+void m12700::SvParseScheduler::attach(SvParseTask* task, const SchedulerParams& params)
+{
+  QMutexLocker pool_locker(&m_pool_mutex);
+  QMutexLocker locker(&m_mutex);
+
+  if(m_workers.isEmpty()) {
+
+    int count = params.threads > 0 ? params.threads : qMax(1, QThread::idealThreadCount());
+
+    m_tick = params.tick;
+
+    m_clock.start();
+    m_next_tick.storeRelease(m_tick);
+
+    for(int i = 0; i < count; i++)
+      m_queues.append(new Queue);
+
+    m_active.storeRelease(1);
+
+    for(int i = 0; i < count; i++) {
+
+      SvParseWorker* worker = new SvParseWorker(this, i);
+      m_workers.append(worker);
+
+      worker->start();
+
+    }
+  }
+
+  task->m_home = m_next_home++ % m_workers.count();
+  task->m_state.storeRelease(SvParseTask::tsIdle);
+
+  m_tasks.append(task);
+
+  locker.unlock();
+  pool_locker.unlock();
+
+  // первый проход - сразу, данные могли поступить до подключения
+  schedule(task);
+
+}
+
+void m12700::SvParseScheduler::detach(SvParseTask* task)
+{
+  {
+    QMutexLocker locker(&m_mutex);
+    m_tasks.removeOne(task);
+  }
+
+  // задача в очереди или выполняется. ждем, пока поток пула ее освободит
+  forever {
+
+    int state = task->m_state.loadAcquire();
+
+    if(state == SvParseTask::tsDetached)
+      break;
+
+    if(state == SvParseTask::tsIdle && task->m_state.testAndSetOrdered(SvParseTask::tsIdle, SvParseTask::tsDetached))
+      break;
+
+    QThread::usleep(100);
+
+  }
+
+  shutdown();
+
+}
+
+void m12700::SvParseScheduler::shutdown()
+{
+  QMutexLocker pool_locker(&m_pool_mutex);
+
+  {
+    // задачу остановленного устройства снимает поток пула (execute), но
+    // потоки останавливает только detach: поток пула не может ждать сам себя
+    QMutexLocker locker(&m_mutex);
+
+    if(m_workers.isEmpty() || !m_tasks.isEmpty())
+      return;
+  }
+
+  // подключенных задач нет, задачи в очереди больше не ставятся.
+  // флаг меняется под m_sleep_mutex, чтобы засыпающий поток не пропустил пробуждение
+  {
+    QMutexLocker locker(&m_sleep_mutex);
+
+    m_active.storeRelease(0);
+    m_wake.wakeAll();
+  }
+
+  // m_mutex не удерживается: потоки пула берут его в tick
+  for(SvParseWorker* worker: m_workers)
+    worker->wait();
+
+  qDeleteAll(m_workers);
+  qDeleteAll(m_queues);
+
+  m_workers.clear();
+  m_queues.clear();
+
+  m_pending.storeRelease(0);
+  m_next_home = 0;
+
+}
+
+void m12700::SvParseScheduler::schedule(SvParseTask* task)
+{
+  forever {
+
+    switch (task->m_state.loadAcquire()) {
+
+      case SvParseTask::tsIdle:
+
+        if(task->m_state.testAndSetOrdered(SvParseTask::tsIdle, SvParseTask::tsQueued)) {
+
+          push(task, task->m_home);
+          return;
+
+        }
+
+        break;
+
+      case SvParseTask::tsRunning:
+
+        // задача будет выполнена еще раз после текущего шага
+        if(task->m_state.testAndSetOrdered(SvParseTask::tsRunning, SvParseTask::tsRerun))
+          return;
+
+        break;
+
+      default:
+        // уже в очереди, уже отмечена для повтора или снята с пула
+        return;
+
+    }
+  }
+}
+
+void m12700::SvParseScheduler::push(SvParseTask* task, int queue)
+{
+  {
+    QMutexLocker locker(&m_queues.at(queue)->mutex);
+    m_queues.at(queue)->tasks.append(task);
+  }
+
+  m_pending.ref();
+
+  if(m_sleeping.loadAcquire() > 0) {
+
+    QMutexLocker locker(&m_sleep_mutex);
+    m_wake.wakeOne();
+
+  }
+}
+
+m12700::SvParseTask* m12700::SvParseScheduler::take(int index)
+{
+  int count = m_queues.count();
+
+  // сначала своя очередь, с начала. затем чужие, с конца
+  for(int i = 0; i < count; i++) {
+
+    Queue* queue = m_queues.at((index + i) % count);
+
+    QMutexLocker locker(&queue->mutex);
+
+    if(queue->tasks.isEmpty())
+      continue;
+
+    m_pending.deref();
+
+    if(i == 0)
+      return queue->tasks.takeFirst();
+
+    m_steals.ref();
+
+    return queue->tasks.takeLast();
+
+  }
+
+  return nullptr;
+
+}
+
+void m12700::SvParseScheduler::execute(SvParseTask* task, int index)
+{
+  task->m_state.storeRelease(SvParseTask::tsRunning);
+
+  bool active = task->step();
+
+  m_steps.ref();
+
+  // устройство остановлено
+  if(!active) {
+
+    {
+      QMutexLocker locker(&m_mutex);
+      m_tasks.removeOne(task);
+    }
+
+    task->m_state.storeRelease(SvParseTask::tsDetached);
+    return;
+
+  }
+
+  if(task->m_state.testAndSetOrdered(SvParseTask::tsRunning, SvParseTask::tsIdle))
+    return;
+
+  // за время шага поступили новые данные. задача остается в этом потоке
+  task->m_state.storeRelease(SvParseTask::tsQueued);
+  push(task, index);
+
+}
+
+void m12700::SvParseScheduler::tick()
+{
+  qint64 now  = m_clock.elapsed();
+  qint64 next = m_next_tick.loadAcquire();
+
+  // период отрабатывает один из потоков пула
+  if(now < next || !m_next_tick.testAndSetOrdered(next, now + m_tick))
+    return;
+
+  QMutexLocker locker(&m_mutex);
+
+  for(SvParseTask* task: m_tasks)
+    schedule(task);
+
+}
+
+void m12700::SvParseScheduler::work(int index)
+{
+  while(m_active.loadAcquire()) {
+
+    tick();
+
+    SvParseTask* task = take(index);
+
+    if(task) {
+
+      execute(task, index);
+      continue;
+
+    }
+
+    QMutexLocker locker(&m_sleep_mutex);
+
+    m_sleeping.ref();
+
+    if(m_pending.loadAcquire() <= 0 && m_active.loadAcquire()) {
+
+      qint64 wait = m_next_tick.loadAcquire() - m_clock.elapsed();
+
+      if(wait > 0)
+        m_wake.wait(&m_sleep_mutex, ulong(wait));
+
+    }
+
+    m_sleeping.deref();
+
+  }
+}
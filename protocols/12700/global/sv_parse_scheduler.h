@@ -0,0 +1,263 @@
+/**********************************************************************
+ *  общий пул потоков разбора для протоколов проекта 12700.
+ *
+ *  в режиме "thread" (по умолчанию) каждый протокол, как и раньше,
+ *  выполняет разбор в собственном потоке, в цикле run(). в режиме
+ *  "pool" run() передает протокол пулу и завершается: разбор
+ *  становится задачей (SvParseTask::step), которая ставится в очередь
+ *  при поступлении данных в буфер (IOBuffer::dataReaded) и
+ *  периодически, с шагом pool_tick, для контроля сроков сигналов.
+ *
+ *  пул - кол-во потоков по числу ядер (или pool_threads), у каждого
+ *  потока своя очередь. задача ставится в очередь "своего" потока,
+ *  свободный поток забирает задачи из чужих очередей. задача одного
+ *  устройства никогда не выполняется в двух потоках одновременно:
+ *  если данные пришли во время выполнения, задача будет выполнена
+ *  еще раз сразу после текущего шага, поэтому порядок обработки
+ *  пакетов устройства сохраняется.
+ *
+ *  параметры пула задаются первым подключенным протоколом. при снятии
+ *  последней задачи (остановка или выгрузка протоколов) потоки пула
+ *  останавливаются, при подключении следующей пул создается заново.
+ * *********************************************************************/
+
+#ifndef SV_PARSE_SCHEDULER_H
+#define SV_PARSE_SCHEDULER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QList>
+#include <QMap>
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "../../../../Modus/global/device/protocol/sv_abstract_protocol.h"
+#include "../../../../Modus/global/global_defs.h"
+
+#define P_SCHEDULER         "scheduler"
+#define P_POOL_THREADS      "pool_threads"
+#define P_POOL_TICK         "pool_tick"
+
+#define DEFAULT_POOL_TICK   10    // мс
+#define MAX_POOL_THREADS    64
+
+namespace m12700 {
+
+  enum SchedulerMode {
+    smThread,   // собственный поток протокола
+    smPool      // общий пул потоков
+  };
+
+  const QMap<QString, SchedulerMode> SchedulerModes = {{"thread", smThread},
+                                                      {"pool",   smPool}};
+
+  struct SchedulerParams {
+
+    SchedulerMode mode    = smThread;
+
+    // кол-во потоков пула. 0 - по кол-ву ядер
+    int           threads = 0;
+
+    // период принудительного запуска задач, мс
+    int           tick    = DEFAULT_POOL_TICK;
+
+    static SchedulerParams fromJson(const QString& json_string) //throw (SvException)
+    {
+      // параметры не заданы - собственный поток
+      if(json_string.trimmed().isEmpty())
+        return SchedulerParams();
+
+      QJsonParseError err;
+      QJsonDocument jd = QJsonDocument::fromJson(json_string.toUtf8(), &err);
+
+      if(err.error != QJsonParseError::NoError)
+        throw SvException(err.errorString());
+
+      try {
+
+        return fromJsonObject(jd.object());
+
+      }
+      catch(SvException& e) {
+        throw e;
+      }
+    }
+
+    static SchedulerParams fromJsonObject(const QJsonObject &object) //throw (SvException)
+    {
+      SchedulerParams p;
+      QString P;
+
+      P = P_SCHEDULER;
+      if(object.contains(P)) {
+
+        QString mode = object.value(P).toString().toLower();
+
+        if(!SchedulerModes.contains(mode))
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P)
+                            .arg(object.value(P).toVariant().toString())
+                            .arg("Допустимые значения: thread, pool"));
+
+        p.mode = SchedulerModes.value(mode);
+
+      }
+
+      P = P_POOL_THREADS;
+      if(object.contains(P)) {
+
+        p.threads = object.value(P).toInt(-1);
+
+        if(p.threads < 0 || p.threads > MAX_POOL_THREADS)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P)
+                            .arg(object.value(P).toVariant().toString())
+                            .arg(QString("Кол-во потоков пула должно быть целым числом от 0 до %1. 0 - по кол-ву ядер").arg(MAX_POOL_THREADS)));
+
+      }
+
+      P = P_POOL_TICK;
+      if(object.contains(P)) {
+
+        p.tick = object.value(P).toInt(-1);
+
+        if(p.tick < 1)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P)
+                            .arg(object.value(P).toVariant().toString())
+                            .arg("Период запуска задач должен быть задан целым положительным числом, мс"));
+
+      }
+
+      return p;
+
+    }
+
+    QJsonObject toJsonObject() const
+    {
+      QJsonObject j;
+
+      j.insert(P_SCHEDULER,     QJsonValue(SchedulerModes.key(mode)));
+      j.insert(P_POOL_THREADS,  QJsonValue(threads));
+      j.insert(P_POOL_TICK,     QJsonValue(tick));
+
+      return j;
+
+    }
+  };
+
+  class SvParseTask;
+  class SvParseWorker;
+  class SvParseScheduler;
+
+}
+
+/** задача разбора одного устройства **/
+class m12700::SvParseTask
+{
+public:
+  virtual ~SvParseTask() { }
+
+  // один проход разбора. false - устройство остановлено, задача снимается с пула
+  virtual bool step() = 0;
+
+private:
+  friend class SvParseScheduler;
+
+  enum State {
+    tsIdle,
+    tsQueued,
+    tsRunning,
+    tsRerun,      // данные поступили во время выполнения
+    tsDetached
+  };
+
+  QAtomicInt  m_state {tsDetached};
+  int         m_home  = 0;      // номер потока, в очередь которого ставится задача
+
+};
+
+class m12700::SvParseWorker: public QThread
+{
+public:
+  SvParseWorker(SvParseScheduler* scheduler, int index);
+
+protected:
+  void run() override;
+
+private:
+  SvParseScheduler* m_scheduler;
+  int               m_index;
+
+};
+
+class m12700::SvParseScheduler
+{
+public:
+  static SvParseScheduler* instance();
+
+  // передача задачи пулу. пул создается при подключении первой задачи
+  void attach(SvParseTask* task, const SchedulerParams& params);
+
+  // снятие задачи с пула. ожидает завершения выполняемого шага.
+  // после снятия последней задачи останавливает потоки пула
+  void detach(SvParseTask* task);
+
+  // постановка задачи в очередь. может вызываться из любого потока
+  void schedule(SvParseTask* task);
+
+  int threads() const { return m_workers.count(); }
+
+  // статистика: кол-во выполненных шагов и кол-во задач, забранных из чужих очередей
+  quint64 steps() const   { return quint64(m_steps.load()); }
+  quint64 steals() const  { return quint64(m_steals.load()); }
+
+private:
+  friend class SvParseWorker;
+
+  SvParseScheduler() {}
+
+  struct Queue {
+
+    QMutex              mutex;
+    QList<SvParseTask*> tasks;
+
+  };
+
+  QMutex                m_pool_mutex;   // создание и остановка пула. потоки пула его не берут
+  QMutex                m_mutex;        // список задач
+  QList<SvParseTask*>   m_tasks;
+
+  QAtomicInt            m_active;       // потоки пула работают
+
+  QList<SvParseWorker*> m_workers;
+  QList<Queue*>         m_queues;
+
+  // ожидание задач свободными потоками
+  QMutex                m_sleep_mutex;
+  QWaitCondition        m_wake;
+  QAtomicInt            m_sleeping;
+  QAtomicInt            m_pending;
+
+  QElapsedTimer         m_clock;
+  QAtomicInteger<qint64> m_next_tick;
+  int                   m_tick = DEFAULT_POOL_TICK;
+  int                   m_next_home = 0;
+
+  QAtomicInteger<quint64> m_steps;
+  QAtomicInteger<quint64> m_steals;
+
+  void push(SvParseTask* task, int queue);
+  SvParseTask* take(int index);
+  void execute(SvParseTask* task, int index);
+  void tick();
+  void work(int index);
+  void shutdown();
+
+};
+
+#endif // SV_PARSE_SCHEDULER_H
@@ -0,0 +1,133 @@
+#include "sv_protocol_12700.h"
+
+m12700::SvProtocol12700::SvProtocol12700(const char* tag, bool confirm, unsigned long idle):
+  modus::SvAbstractProtocol(),
+  m_tag(tag),
+  m_confirm(confirm),
+  m_idle(idle)
+{
+
+}
+
+bool m12700::SvProtocol12700::configure(modus::DeviceConfig *config, modus::IOBuffer *iobuffer)
+{
+  try {
+
+    p_config = config;
+    p_io_buffer = iobuffer;
+
+    // образ разобранных параметров устройства и сигналов
+    QString error;
+    if(!m_image.open(m12700::ImageParams::fromJson(p_config->protocol.params), m_tag, p_config->name, &error))
+      throw SvException(error);
+
+    configureDevice();
+
+    m_scheduling = m12700::SchedulerParams::fromJson(p_config->protocol.params);
+
+    m_realtime = rt::Params::fromJsonString(p_config->protocol.params);
+
+    m_metrics.attach(p_config->name);
+
+    m_latency.attach(p_config->name);
+    m_batch.setTracer(&m_latency);
+
+    // в общем пуле разбор запускается при поступлении данных в буфер
+    if(m_scheduling.mode == m12700::smPool)
+      connect(p_io_buffer, &modus::IOBuffer::dataReaded, this, [this]() {
+        m12700::SvParseScheduler::instance()->schedule(this);
+      }, Qt::DirectConnection);
+
+    return true;
+
+  } catch (SvException& e) {
+
+    p_last_error = e.error;
+    return false;
+
+  }
+}
+
+void m12700::SvProtocol12700::detach()
+{
+  m12700::SvParseScheduler::instance()->detach(this);
+}
+
+void m12700::SvProtocol12700::run()
+{
+  p_is_active = bool(p_config) && bool(p_io_buffer);
+
+  // параметры всех сигналов разобраны, образ сохраняется для следующего запуска
+  QString error;
+  if(p_is_active && !m_image.save(&error))
+    emit message(error, sv::log::llError, sv::log::mtError);
+
+  if(m_image.isOpen())
+    emit message(QString("Образ параметров %1: из образа %2, разобрано %3")
+                 .arg(m_image.path()).arg(m_image.hits()).arg(m_image.misses()),
+                 sv::log::llDebug, sv::log::mtDebug);
+
+  // разбор выполняется потоками общего пула, собственный поток не нужен
+  if(p_is_active && m_scheduling.mode == m12700::smPool) {
+
+    // потоки пула общие для всех устройств, параметры устройства к ним не применяются
+    if(!m_realtime.isEmpty())
+      emit message(QString("Параметры реального времени не применяются в режиме pool: %1").arg(m_realtime.toString()),
+                   sv::log::llWarning, sv::log::mtWarning);
+
+    m12700::SvParseScheduler::instance()->attach(this, m_scheduling);
+    return;
+
+  }
+
+  if(p_is_active && !m_realtime.isEmpty() && !rt::apply(m_realtime, &error))
+    emit message(error, sv::log::llError, sv::log::mtError);
+
+  while(p_is_active) {
+
+    process();
+
+    if(m_idle)
+      msleep(m_idle);
+
+  }
+}
+
+bool m12700::SvProtocol12700::step()
+{
+  if(!p_is_active)
+    return false;
+
+  process();
+
+  return true;
+
+}
+
+void m12700::SvProtocol12700::process()
+{
+  if(m_confirm)
+    p_io_buffer->confirm->mutex.lock();     // если нужен ответ квитирование
+
+  p_io_buffer->input->mutex.lock();
+
+  m_batch.begin();
+
+  // время разбора учитывается только для принятых пакетов, не для ожидания данных
+  QElapsedTimer timer;
+  timer.start();
+
+  if(parseInput())
+    m_metrics.parse_time.record(quint64(timer.nsecsElapsed() / 1000));
+
+  p_io_buffer->input->mutex.unlock();
+
+  if(m_confirm)
+    p_io_buffer->confirm->mutex.unlock();
+
+  // значения, полученные в пакете, назначаются сигналам после освобождения буфера
+  m_batch.commit();
+
+  // проверка сроков действия сигналов
+  m_timeouts.checkup();
+}
@@ -0,0 +1,99 @@
+/**********************************************************************
+ *  общая часть протоколов проекта 12700 (opa, oht, skm, can).
+ *
+ *  класс выполняет то, что одинаково для всех протоколов: открывает
+ *  образ параметров (sv_params_image.h), читает режим выполнения
+ *  (sv_parse_scheduler.h) и параметры реального времени, подключает
+ *  счетчики и трассировку задержек, выполняет разбор в собственном
+ *  потоке или передает устройство общему пулу.
+ *
+ *  проход разбора (process): пакет изменений сигналов открывается,
+ *  под блокировкой буферов вызывается parseInput() протокола, после
+ *  освобождения буферов изменения фиксируются и проверяются сроки
+ *  действия сигналов.
+ *
+ *  производный класс задает тег образа, разбирает параметры своего
+ *  устройства (configureDevice), разбирает данные (parseInput) и
+ *  в своем деструкторе снимает устройство с пула (detach), пока
+ *  его члены еще не разрушены.
+ * *********************************************************************/
+
+#ifndef SV_PROTOCOL_12700_H
+#define SV_PROTOCOL_12700_H
+
+#include <QElapsedTimer>
+
+#include "../../../../Modus/global/device/protocol/sv_abstract_protocol.h"
+#include "../../../../Modus/global/global_defs.h"
+
+#include "sv_parse_scheduler.h"
+#include "sv_params_image.h"
+#include "sv_signal_batch.h"
+#include "sv_timing_wheel.h"
+#include "../../../global/sv_realtime.h"
+#include "../../../global/sv_metrics.h"
+#include "../../../global/sv_latency.h"
+
+namespace m12700 {
+
+  class SvProtocol12700;
+
+}
+
+class m12700::SvProtocol12700: public modus::SvAbstractProtocol, public m12700::SvParseTask
+{
+  Q_OBJECT
+
+public:
+  // tag - имя протокола в имени файла образа параметров.
+  // confirm - протокол формирует квитирование, буфер confirm блокируется на время разбора.
+  // idle - пауза между проходами собственного потока, мс. 0 - без паузы
+  SvProtocol12700(const char* tag, bool confirm, unsigned long idle = 0);
+
+  bool configure(modus::DeviceConfig* config, modus::IOBuffer *iobuffer) override;
+
+protected:
+  void run() override;
+  bool step() override;
+
+  // разбор параметров устройства. образ параметров уже открыт
+  virtual void configureDevice() { } //throw (SvException)
+
+  // разбор данных буфера input, буферы заблокированы. протокол сам сбрасывает буфер.
+  // true - данные приняты в разбор, время разбора учитывается в метриках
+  virtual bool parseInput() = 0;
+
+  // снятие устройства с пула. ожидает завершения выполняемого шага
+  void detach();
+
+  // режим выполнения: собственный поток или общий пул
+  m12700::SchedulerParams m_scheduling;
+
+  // привязка к ядрам и приоритет собственного потока
+  rt::Params m_realtime;
+
+  // пакет изменений сигналов, фиксируется один раз на пакет
+  m12700::SvSignalBatch m_batch;
+
+  // сроки действия сигналов
+  m12700::SvSignalTimeouts m_timeouts;
+
+  // образ разобранных параметров устройства и сигналов
+  m12700::SvParamsImage m_image;
+
+  // счетчики протокола, /metrics
+  metrics::ProtocolMetrics m_metrics;
+
+  // задержки разбора и назначения значений от приема данных, /latency
+  latency::Tracer m_latency;
+
+private:
+  const char*   m_tag;
+  bool          m_confirm;
+  unsigned long m_idle;
+
+  void process();
+
+};
+
+#endif // SV_PROTOCOL_12700_H
@@ -0,0 +1,66 @@
+#include "sv_signal_batch.h"
+
+#include <QDateTime>
+
+m12700::SvSignalBatch::SvSignalBatch()
+{
+  m_set.changes.reserve(SIGNAL_BATCH_RESERVE);
+}
+
+void m12700::SvSignalBatch::begin()
+{
+  // память под изменения сохраняется между пакетами
+  m_set.changes.resize(0);
+  m_set.time = 0;
+
+  m_open = true;
+
+}
+
+void m12700::SvSignalBatch::stage(modus::SvSignal* signal, const QVariant& value)
+{
+  if(!m_open) {
+
+    signal->setValue(value);
+    return;
+
+  }
+
+  // время читается один раз на пакет
+  if(m_set.time == 0)
+    m_set.time = QDateTime::currentMSecsSinceEpoch();
+
+  m_set.changes.append(SignalChange());
+
+  SignalChange& change = m_set.changes.last();
+  change.signal = signal;
+  change.value  = value;
+
+}
+
+int m12700::SvSignalBatch::commit()
+{
+  m_open = false;
+
+  if(m_set.changes.isEmpty())
+    return 0;
+
+  // общее время пакета назначается всем значениям. уведомления сигналов
+  // (changed, updated) выдаются для каждого значения
+  QDateTime time = QDateTime::fromMSecsSinceEpoch(m_set.time);
+
+  for(const SignalChange& change: m_set.changes) {
+
+    change.signal->setValue(change.value, time);
+
+    if(m_tracer)
+      m_tracer->updated(change.signal->id());
+
+  }
+
+  if(m_tracer)
+    m_tracer->committed();
+
+  return m_set.changes.count();
+
+}
@@ -0,0 +1,82 @@
+/**********************************************************************
+ *  пакетное назначение значений сигналам для систем проекта 12700.
+ *
+ *  коллекции разбирают пакет побитно. протокол открывает пакет
+ *  изменений (begin), коллекции добавляют в него значения (stage),
+ *  после разбора пакет фиксируется (commit): значения назначаются
+ *  сигналам с общим для всего пакета временем, время читается один
+ *  раз на пакет. разбор не прерывается уведомлениями сигналов.
+ *
+ *  уведомления сигналов (changed, updated) выдаются при фиксации для
+ *  каждого сигнала, как и раньше: общего уведомления о наборе
+ *  изменений нет. хранилища и провайдеры этого дерева читают значения
+ *  сигналов по таймеру и от кол-ва уведомлений не зависят, на updated
+ *  подписан контроль таймаутов (sv_timing_wheel.h).
+ *
+ *  если задан трассировщик задержек, при фиксации каждому сигналу
+ *  назначается метка времени приема пакета (см. sv_latency.h).
+ *
+ *  все вызовы выполняются в потоке протокола.
+ * *********************************************************************/
+
+#ifndef SV_SIGNAL_BATCH_H
+#define SV_SIGNAL_BATCH_H
+
+#include <QVector>
+#include <QVariant>
+
+#include "../../../../Modus/global/signal/sv_signal.h"
+#include "../../../global/sv_latency.h"
+
+#define SIGNAL_BATCH_RESERVE  256
+
+namespace m12700 {
+
+  struct SignalChange {
+
+    modus::SvSignal*  signal = nullptr;
+    QVariant          value;
+
+  };
+
+  /** набор изменений одного пакета **/
+  struct SignalChangeSet {
+
+    qint64                  time = 0;   // мс от начала эпохи, общее для всех изменений
+    QVector<SignalChange>   changes;
+
+  };
+
+  class SvSignalBatch;
+
+}
+
+class m12700::SvSignalBatch
+{
+public:
+  SvSignalBatch();
+
+  // начало пакета изменений. предыдущие неподтвержденные изменения отбрасываются
+  void begin();
+
+  // значение сигнала в пакете. если пакет не открыт, значение назначается сразу
+  void stage(modus::SvSignal* signal, const QVariant& value);
+
+  // назначение значений сигналам с общим временем пакета. возвращает кол-во изменений
+  int commit();
+
+  bool isOpen() const { return m_open; }
+
+  const SignalChangeSet& changeSet() const { return m_set; }
+
+  void setTracer(latency::Tracer* tracer) { m_tracer = tracer; }
+
+private:
+  SignalChangeSet   m_set;
+  bool              m_open = false;
+
+  latency::Tracer*  m_tracer = nullptr;
+
+};
+
+#endif // SV_SIGNAL_BATCH_H
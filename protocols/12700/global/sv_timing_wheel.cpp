@@ -0,0 +1,173 @@
+#include "sv_timing_wheel.h"
+
+#define WHEEL_MASK        (TIMING_WHEEL_SLOTS - 1)
+#define WHEEL_MAX_DELTA   ((qint64(1) << (TIMING_WHEEL_BITS * TIMING_WHEEL_LEVELS)) - 1)
+
+/** ********** SvTimingWheel ************ **/
+
+m12700::SvTimingWheel::SvTimingWheel():
+  m_slots(TIMING_WHEEL_LEVELS * TIMING_WHEEL_SLOTS, -1)
+{
+
+}
+
+int m12700::SvTimingWheel::add()
+{
+  m_nodes.append(Node());
+  return m_nodes.size() - 1;
+}
+
+void m12700::SvTimingWheel::schedule(int id, qint64 delay)
+{
+  unlink(id);
+
+  // округляем вверх, чтобы срок не наступил раньше заданного
+  qint64 expires = (m_now + delay + TIMING_WHEEL_TICK - 1) / TIMING_WHEEL_TICK;
+
+  m_nodes[id].expires = qBound(m_tick + 1, expires, m_tick + WHEEL_MAX_DELTA);
+
+  link(id);
+
+}
+
+void m12700::SvTimingWheel::cancel(int id)
+{
+  unlink(id);
+}
+
+void m12700::SvTimingWheel::advance(qint64 now, QVector<int>& expired)
+{
+  m_now = now;
+
+  qint64 target = now / TIMING_WHEEL_TICK;
+
+  while(m_tick < target) {
+
+    ++m_tick;
+
+    // при переходе через границу ячейки старшего уровня ее элементы переносятся вниз
+    for(int level = 1; level < TIMING_WHEEL_LEVELS; ++level) {
+
+      if((m_tick >> (TIMING_WHEEL_BITS * (level - 1))) & WHEEL_MASK)
+        break;
+
+      cascade(level);
+
+    }
+
+    int& head = m_slots[int(m_tick & WHEEL_MASK)];
+
+    while(head != -1) {
+
+      int id = head;
+
+      unlink(id);
+      expired.append(id);
+
+    }
+  }
+}
+
+void m12700::SvTimingWheel::link(int id)
+{
+  Node& node = m_nodes[id];
+
+  qint64 delta = node.expires - m_tick;
+
+  int level = 0;
+  while(level < TIMING_WHEEL_LEVELS - 1 && delta >= (qint64(1) << (TIMING_WHEEL_BITS * (level + 1))))
+    ++level;
+
+  node.slot = level * TIMING_WHEEL_SLOTS + int((node.expires >> (TIMING_WHEEL_BITS * level)) & WHEEL_MASK);
+  node.prev = -1;
+  node.next = m_slots[node.slot];
+
+  if(node.next != -1)
+    m_nodes[node.next].prev = id;
+
+  m_slots[node.slot] = id;
+
+}
+
+void m12700::SvTimingWheel::unlink(int id)
+{
+  Node& node = m_nodes[id];
+
+  if(node.slot == -1)
+    return;
+
+  if(node.prev != -1) m_nodes[node.prev].next = node.next;
+  else                m_slots[node.slot] = node.next;
+
+  if(node.next != -1)
+    m_nodes[node.next].prev = node.prev;
+
+  node.prev = -1;
+  node.next = -1;
+  node.slot = -1;
+
+}
+
+void m12700::SvTimingWheel::cascade(int level)
+{
+  int slot = level * TIMING_WHEEL_SLOTS + int((m_tick >> (TIMING_WHEEL_BITS * level)) & WHEEL_MASK);
+
+  while(m_slots[slot] != -1) {
+
+    int id = m_slots[slot];
+
+    unlink(id);
+    link(id);
+
+  }
+}
+
+/** ********** SvSignalTimeouts ************ **/
+
+void m12700::SvSignalTimeouts::addSignal(modus::SvSignal* signal, QObject* context)
+{
+  qint64 timeout = signal->config()->timeout;
+
+  if(timeout <= 0)
+    return;
+
+  if(!m_clock.isValid())
+    m_clock.start();
+
+  int id = m_wheel.add();
+
+  m_signals.append(signal);
+  m_timeouts.append(timeout);
+
+  // срок отсчитывается от последнего обновления сигнала
+  QObject::connect(signal, &modus::SvSignal::updated, context, [this, id](modus::SvSignal*) {
+
+    if(!m_expiring)
+      m_wheel.schedule(id, m_timeouts.at(id));
+
+  }, Qt::DirectConnection);
+
+  m_wheel.schedule(id, timeout);
+
+}
+
+void m12700::SvSignalTimeouts::checkup()
+{
+  if(m_signals.isEmpty())
+    return;
+
+  m_wheel.advance(m_clock.elapsed(), m_expired);
+
+  if(m_expired.isEmpty())
+    return;
+
+  m_expiring = true;
+
+  for(int id: m_expired)
+    m_signals.at(id)->reset();
+
+  m_expiring = false;
+
+  m_expired.clear();
+
+}
@@ -0,0 +1,106 @@
+/**********************************************************************
+ *  контроль таймаутов сигналов для систем проекта 12700.
+ *
+ *  срок действия каждого сигнала хранится в иерархическом колесе
+ *  таймеров: 4 уровня по 64 ячейки, шаг TIMING_WHEEL_TICK мс. ячейка -
+ *  двусвязный список элементов, связанных индексами, поэтому продление
+ *  срока при обновлении сигнала - удаление из одной ячейки и вставка
+ *  в другую, без поиска. колесо продвигается из цикла run() протокола
+ *  (одна проверка времени на итерацию), работа выполняется только на
+ *  границе шага: переносятся элементы старших уровней и забирается
+ *  пачка просроченных сигналов. затраты зависят от кол-ва истекших
+ *  сроков, а не от частоты пакетов и кол-ва сигналов.
+ *
+ *  SvSignalTimeouts подключается к сигналу SvSignal::updated (в том
+ *  числе для значений из пакета изменений SvSignalBatch) и сбрасывает
+ *  просроченные сигналы. сигналы с timeout <= 0 не контролируются. все вызовы выполняются в потоке протокола.
+ * *********************************************************************/
+
+#ifndef SV_TIMING_WHEEL_H
+#define SV_TIMING_WHEEL_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QHash>
+#include <QObject>
+#include <QElapsedTimer>
+
+#include "../../../../Modus/global/signal/sv_signal.h"
+
+#define TIMING_WHEEL_TICK     10  // мс
+#define TIMING_WHEEL_BITS     6
+#define TIMING_WHEEL_SLOTS    (1 << TIMING_WHEEL_BITS)
+#define TIMING_WHEEL_LEVELS   4
+
+namespace m12700 {
+
+  class SvTimingWheel;
+  class SvSignalTimeouts;
+
+}
+
+class m12700::SvTimingWheel
+{
+public:
+  SvTimingWheel();
+
+  // новый элемент. возвращает его номер
+  int add();
+
+  // назначение срока элементу id: через delay мс от текущего положения колеса
+  void schedule(int id, qint64 delay);
+
+  // снятие элемента с контроля
+  void cancel(int id);
+
+  // продвижение колеса до момента now (мс). номера просроченных элементов добавляются в expired
+  void advance(qint64 now, QVector<int>& expired);
+
+  qint64 now() const { return m_now; }
+
+private:
+  struct Node {
+
+    qint64  expires = 0;   // в шагах колеса
+    int     prev    = -1;
+    int     next    = -1;
+    int     slot    = -1;  // уровень * TIMING_WHEEL_SLOTS + ячейка. -1 - не в колесе
+
+  };
+
+  QVector<Node>   m_nodes;
+  QVector<int>    m_slots;            // голова списка каждой ячейки
+
+  qint64          m_tick    = 0;      // текущий шаг колеса
+  qint64          m_now     = 0;
+
+  void link(int id);
+  void unlink(int id);
+  void cascade(int level);
+
+};
+
+class m12700::SvSignalTimeouts
+{
+public:
+  // контроль срока действия сигнала. context - объект протокола, владелец подключения
+  void addSignal(modus::SvSignal* signal, QObject* context);
+
+  // проверка сроков. вызывается на каждой итерации цикла run()
+  void checkup();
+
+private:
+  SvTimingWheel             m_wheel;
+  QElapsedTimer             m_clock;
+
+  QVector<modus::SvSignal*> m_signals;
+  QVector<qint64>           m_timeouts;
+  QVector<int>              m_expired;
+
+
+  // сброс просроченного сигнала вызывает updated, срок при этом не продлевается
+  bool                      m_expiring = false;
+
+};
+
+#endif // SV_TIMING_WHEEL_H
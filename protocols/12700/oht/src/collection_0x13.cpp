@@ -10,7 +10,7 @@ void oht::Type0x13::addSignal(modus::SvSignal* signal) //throw (SvException)
 {
   try
   {
-    oht::SignalParams_0x13 p = oht::SignalParams_0x13::fromJson(signal->config()->params);
+    oht::SignalParams_0x13 p = signalParams<oht::SignalParams_0x13>(signal);
 
     quint32 uid = getUid(0, p.route, p.byte, p.bit);
 
@@ -51,7 +51,7 @@ void oht::Type0x13::updateSignals(const oht::DATA* data)
         quint8 mask = pow(2, m_signals.value(uid).params.len) - 1;
         QVariant value = (static_cast<quint8>(data->data[byte] >> bit) & mask);
 
-        m_signals.value(uid).signal->setValue(value);
+        setSignalValue(m_signals.value(uid).signal, value);
 
       }
     }
@@ -10,7 +10,7 @@ void oht::Type0x14::addSignal(modus::SvSignal* signal) //throw (SvException)
 {
   try
   {
-    oht::SignalParams_0x14 p = oht::SignalParams_0x14::fromJson(signal->config()->params);
+    oht::SignalParams_0x14 p = signalParams<oht::SignalParams_0x14>(signal);
 
     m_signals.append(Signal0x14(signal, p));
 
@@ -29,7 +29,7 @@ void oht::Type0x14::updateSignals(const oht::DATA* data)
   foreach (Signal0x14 signal14, m_signals) {
 
     if(signal14.params.byte < data->len)
-      signal14.signal->setValue(int((data->data[signal14.params.byte] >> signal14.params.bit) & 1));
+      setSignalValue(signal14.signal, int((data->data[signal14.params.byte] >> signal14.params.bit) & 1));
 
   }
 }
@@ -10,7 +10,7 @@ void oht::Type0x19::addSignal(modus::SvSignal* signal) //throw (SvException)
 {
   try
   {
-    oht::SignalParams_0x19 p = oht::SignalParams_0x19::fromJson(signal->config()->params);
+    oht::SignalParams_0x19 p = signalParams<oht::SignalParams_0x19>(signal);
 
     m_signals.append(Signal0x19(signal, p));
 
@@ -29,7 +29,7 @@ void oht::Type0x19::updateSignals(const oht::DATA* data)
   foreach (Signal0x19 signal19, m_signals) {
 
     if(signal19.params.byte < data->len)
-      signal19.signal->setValue(int((data->data[signal19.params.byte] >> signal19.params.bit) & 1));
+      setSignalValue(signal19.signal, int((data->data[signal19.params.byte] >> signal19.params.bit) & 1));
 
   }
 }
@@ -10,7 +10,7 @@ void oht::Type0x33::addSignal(modus::SvSignal* signal) //throw (SvException)
 {
   try
   {
-    oht::SignalParams_0x33 p = oht::SignalParams_0x33::fromJson(signal->config()->params);
+    oht::SignalParams_0x33 p = signalParams<oht::SignalParams_0x33>(signal);
 
     m_signals.append(Signal0x33(signal, p));
 
@@ -29,7 +29,7 @@ void oht::Type0x33::updateSignals(const oht::DATA* data)
   foreach (Signal0x33 signal33, m_signals) {
 
     if(signal33.params.byte < data->len)
-      signal33.signal->setValue(int((data->data[signal33.params.byte] >> signal33.params.bit) & 1));
+      setSignalValue(signal33.signal, int((data->data[signal33.params.byte] >> signal33.params.bit) & 1));
 
   }
 }
@@ -22,6 +22,6 @@ void oht::LineStatus::updateSignals(const oht::DATA* data)
   Q_UNUSED(data);
 
   foreach (modus::SvSignal* signal, m_signals)
-    signal->setValue(1);
+    setSignalValue(signal, 1);
 
 }
@@ -8,6 +8,9 @@
 #include "../../../../../Modus/global/global_defs.h"
 #include "../../../../../Modus/global/device/device_defs.h"
 
+#include "../../global/sv_modbus_udp.h"
+#include "../../global/sv_batched_collection.h"
+
 #define TYPE_0x33 0x33
 #define TYPE_0x13 0x13
 #define TYPE_0x14 0x14
@@ -22,49 +25,35 @@
 
 namespace oht {
 
-  struct DATA
-  {
-    DATA():
-      data(nullptr),
-      bufsize(0)
-    {  }
-
-    DATA(quint16 size):
-      data(nullptr),
-      bufsize(size)
-    {
-      data = (quint8*)malloc(size);
-    }
-
-    ~DATA()
-    {
-      if(data)
-        free(data);
-    }
+  // данные пакета указывают в буфер input, без копирования
+  typedef m12700::DATA DATA;
 
-    bool resize(quint16 size)
-    {
-      if(data)
-        free(data);
+  /** описание системы для общего разбора пакетов **/
+  struct Project {
 
-      data = nullptr;
+    static constexpr quint8 CLIENT_ADDR = 1;
+    static constexpr quint8 FUNC_CODE   = 0x10;
 
-      bufsize = size;
-      data = (quint8*)malloc(size);
+    // смещение регистра от start_register
+    static constexpr m12700::RegisterEntry Registers[] = {{0x00, m12700::raConfirm},
+                                                          {0x03, m12700::raConfirm},
+                                                          {0x05, m12700::raConfirm},
+                                                          {0x06, m12700::raData},
+                                                          {0xA0, m12700::raData},
+                                                          {0xFA, m12700::raData}};
 
-      return bool(data);
-    }
+    // тип данных -> номер коллекции сигналов
+    static constexpr m12700::TypeEntry Types[] = {{TYPE_0x13, 0},
+                                                 {TYPE_0x14, 1},
+                                                 {TYPE_0x19, 2}};
 
-    quint8* data = nullptr;
-    quint8  type;
-    quint8  len;
-    quint16 crc;
-
-    quint16 bufsize;
+    static constexpr int COLLECTIONS = 3;
 
   };
 
-  class SvAbstractSignalCollection: public QObject
+  typedef m12700::Parser<Project> Parser;
+
+  class SvAbstractSignalCollection: public QObject, public m12700::SvBatchedCollection
   {
     Q_OBJECT
 
@@ -80,7 +69,6 @@ namespace oht {
     virtual void updateSignals(const oht::DATA* data = nullptr) = 0;
 
   protected:
-
     inline quint32 getUid(quint8 val1, quint8 val2, quint8 val3, quint8 val4)
     {
       return (static_cast<quint32>(val1) << 24) + (static_cast<quint32>(val2) << 16) + (static_cast<quint32>(val3) << 8) + static_cast<quint32>(val4);
@@ -3,6 +3,7 @@
 
 #include <QMutex>
 #include <QMutexLocker>
+#include <QElapsedTimer>
 
 #include "proj_12700_oht_global.h"
 
@@ -17,6 +18,7 @@
 #include "collection_0x33.h"
 #include "collection_0x19.h"
 #include "collection_status.h"
+#include "../../global/sv_protocol_12700.h"
 
 #include "../../../../../svlib/sv_abstract_logger.h"
 #include "../../../../../svlib/sv_exception.h"
@@ -38,17 +40,7 @@ extern "C" {
 
 namespace oht {
 
-  #pragma pack(push,1)
-  struct Header
-  {
-    quint8  client_addr;
-    quint8  func_code;
-    quint8  ADDRESS;
-    quint8  OFFSET;
-    quint16 register_count;
-    quint8  byte_count;
-  };
-  #pragma pack(pop)
+  typedef m12700::Header Header;
 
   struct PARSERESULT {
 
@@ -63,23 +55,22 @@ namespace oht {
 
   class SvOHT;
 
-  typedef QMap<int, SvAbstractSignalCollection*> SignalCollections;
 
 //  bool parse_signal(modus::SvSignal* signal);
 
 }
 
-class oht::SvOHT: public modus::SvAbstractProtocol
+class oht::SvOHT: public m12700::SvProtocol12700
 {
   Q_OBJECT
 
 public:
   SvOHT();
-
-  bool configure(modus::DeviceConfig* config, modus::IOBuffer *iobuffer) override;
+  ~SvOHT();
 
 protected:
-  void run() override;
+  void configureDevice() override; //throw (SvException)
+  bool parseInput() override;
 
   void disposeInputSignal (modus::SvSignal* signal) override;
   void disposeOutputSignal (modus::SvSignal* signal) override;
@@ -92,10 +83,6 @@ private:
 
   oht::DeviceParams m_params;
 
-  oht::DATA m_data;
-
-  oht::Header m_header;
-  size_t m_hsz = sizeof(oht::Header);
 
   oht::Type0x13   type0x03_signals;
   oht::Type0x14   type0x04_signals;
@@ -103,10 +90,10 @@ private:
   oht::Type0x33   type0x33_signals;
   oht::LineStatus line_status_signals;
 
-  oht::SignalCollections signal_collections;
+  // коллекции сигналов по номерам из oht::Project::Types
+  SvAbstractSignalCollection* m_collections[oht::Project::COLLECTIONS];
 
   PARSERESULT parse();
-  void confirmation();
 
 };
 
@@ -10,7 +10,7 @@ void opa::Type0x02::addSignal(modus::SvSignal* signal) //throw (SvException)
 {
   try
   {
-    opa::SignalParams_0x02 p = opa::SignalParams_0x02::fromJson(signal->config()->params);
+    opa::SignalParams_0x02 p = signalParams<opa::SignalParams_0x02>(signal);
 
     quint32 uniq_index = (static_cast<quint32>(p.sensor) << 8) + static_cast<quint32>(p.faktor);
 
@@ -47,7 +47,7 @@ void opa::Type0x02::updateSignals(const opa::DATA* data)
 
       if(m_signals.contains(uniq_index)) {
         foreach (modus::SvSignal* signal, m_signals.values(uniq_index))
-          signal->setValue(1);
+          setSignalValue(signal, 1);
       }
 
     }
@@ -58,7 +58,7 @@ void opa::Type0x02::updateSignals(const opa::DATA* data)
 
         if((index >> 8) == sensor){
           foreach (modus::SvSignal* signal, m_signals.values(index))
-            signal->setValue(0);
+            setSignalValue(signal, 0);
         }
       }
     }
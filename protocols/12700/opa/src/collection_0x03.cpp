@@ -10,7 +10,7 @@ void opa::Type0x03::addSignal(modus::SvSignal* signal) //throw (SvException)
 {
   try
   {
-    opa::SignalParams_0x03 p = opa::SignalParams_0x03::fromJson(signal->config()->params);
+    opa::SignalParams_0x03 p = signalParams<opa::SignalParams_0x03>(signal);
 
     quint32 uniq_index = (static_cast<quint32>(p.room) << 8) + static_cast<quint32>(p.level);
 
@@ -46,7 +46,7 @@ void opa::Type0x03::updateSignals(const opa::DATA* data)
       quint32 uniq_index = (static_cast<quint32>(space) << 8) + static_cast<quint32>(level);
 
       if(m_signals.contains(uniq_index))
-        m_signals.value(uniq_index)->setValue(1);
+        setSignalValue(m_signals.value(uniq_index), 1);
 
     }
 
@@ -55,7 +55,7 @@ void opa::Type0x03::updateSignals(const opa::DATA* data)
       foreach (quint32 uniq_index, m_signals.keys()) {
 
         if((uniq_index >> 8) == space)
-          m_signals.value(uniq_index)->setValue(0);
+          setSignalValue(m_signals.value(uniq_index), 0);
 
       }
     }
@@ -10,7 +10,7 @@ void opa::Type0x04::addSignal(modus::SvSignal* signal) //throw (SvException)
 {
   try
   {
-    opa::SignalParams_0x04 p = opa::SignalParams_0x04::fromJson(signal->config()->params);
+    opa::SignalParams_0x04 p = signalParams<opa::SignalParams_0x04>(signal);
 
     m_signals.append(Signal0x04(signal, p));
 
@@ -29,7 +29,7 @@ void opa::Type0x04::updateSignals(const opa::DATA* data)
   foreach (Signal0x04 signal04, m_signals) {
 
     if(signal04.params.byte < data->len)
-      signal04.signal->setValue(int((data->data[signal04.params.byte] >> signal04.params.bit) & 1));
+      setSignalValue(signal04.signal, int((data->data[signal04.params.byte] >> signal04.params.bit) & 1));
 
   }
 }
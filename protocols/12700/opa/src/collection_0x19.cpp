@@ -10,7 +10,7 @@ void opa::Type0x19::addSignal(modus::SvSignal* signal) //throw (SvException)
 {
   try
   {
-    opa::SignalParams_0x19 p = opa::SignalParams_0x19::fromJson(signal->config()->params);
+    opa::SignalParams_0x19 p = signalParams<opa::SignalParams_0x19>(signal);
 
     m_signals.append(Signal0x19(signal, p));
 
@@ -29,7 +29,7 @@ void opa::Type0x19::updateSignals(const opa::DATA* data)
   foreach (Signal0x19 signal19, m_signals) {
 
     if(signal19.params.byte < data->len)
-      signal19.signal->setValue(int((data->data[signal19.params.byte] ))); // проверка битов делается в агрегате  >> signal19.params.bit) & 1));
+      setSignalValue(signal19.signal, int((data->data[signal19.params.byte] ))); // проверка битов делается в агрегате  >> signal19.params.bit) & 1));
 
   }
 }
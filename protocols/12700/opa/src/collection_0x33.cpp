@@ -10,7 +10,7 @@ void opa::Type0x33::addSignal(modus::SvSignal* signal) //throw (SvException)
 {
   try
   {
-    opa::SignalParams_0x33 p = opa::SignalParams_0x33::fromJson(signal->config()->params);
+    opa::SignalParams_0x33 p = signalParams<opa::SignalParams_0x33>(signal);
 
     m_signals.append(Signal0x33(signal, p));
 
@@ -29,7 +29,7 @@ void opa::Type0x33::updateSignals(const opa::DATA* data)
   foreach (Signal0x33 signal33, m_signals) {
 
     if(signal33.params.byte < data->len)
-      signal33.signal->setValue(int((data->data[signal33.params.byte] >> signal33.params.bit) & 1));
+      setSignalValue(signal33.signal, int((data->data[signal33.params.byte] >> signal33.params.bit) & 1));
 
   }
 }
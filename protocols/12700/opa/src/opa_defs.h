@@ -8,6 +8,9 @@
 #include "../../../../../Modus/global/global_defs.h"
 #include "../../../../../Modus/global/device/device_defs.h"
 
+#include "../../global/sv_modbus_udp.h"
+#include "../../global/sv_batched_collection.h"
+
 #define TYPE_0x33 0x33
 #define TYPE_0x02 0x02
 #define TYPE_0x03 0x03
@@ -24,49 +27,38 @@
 
 namespace opa {
 
-  struct DATA
-  {
-    DATA():
-      data(nullptr),
-      bufsize(0)
-    {  }
-
-    DATA(quint16 size):
-      data(nullptr),
-      bufsize(size)
-    {
-      data = (quint8*)malloc(size);
-    }
+  // данные пакета указывают в буфер input, без копирования
+  typedef m12700::DATA DATA;
 
-    ~DATA()
-    {
-      if(data)
-        free(data);
-    }
+  /** описание системы для общего разбора пакетов **/
+  struct Project {
 
-    bool resize(quint16 size)
-    {
-      if(data)
-        free(data);
+    static constexpr quint8 CLIENT_ADDR = 1;
+    static constexpr quint8 FUNC_CODE   = 0x10;
 
-      data = nullptr;
+    // смещение регистра от start_register
+    static constexpr m12700::RegisterEntry Registers[] = {{0x00, m12700::raConfirm},
+                                                          {0x03, m12700::raConfirm},
+                                                          {0x05, m12700::raConfirm},
+                                                          {0x06, m12700::raData},
+                                                          {0x10, m12700::raData},
+                                                          {0x50, m12700::raData},
+                                                          {0x90, m12700::raData}};
 
-      bufsize = size;
-      data = (quint8*)malloc(size);
+    // тип данных -> номер коллекции сигналов
+    static constexpr m12700::TypeEntry Types[] = {{TYPE_0x33, 0},
+                                                 {TYPE_0x02, 1},
+                                                 {TYPE_0x03, 2},
+                                                 {TYPE_0x04, 3},
+                                                 {TYPE_0x19, 4}};
 
-      return bool(data);
-    }
-
-    quint8* data = nullptr;
-    quint8  type;
-    quint8  len;
-    quint16 crc;
-
-    quint16 bufsize;
+    static constexpr int COLLECTIONS = 5;
 
   };
 
-  class SvAbstractSignalCollection: public QObject
+  typedef m12700::Parser<Project> Parser;
+
+  class SvAbstractSignalCollection: public QObject, public m12700::SvBatchedCollection
   {
     Q_OBJECT
 
@@ -1,41 +1,43 @@
 ﻿#include "proj_12700_opa.h"
 
-opa::SvOPA::SvOPA():
-  modus::SvAbstractProtocol()
-{
-  signal_collections.insert(TYPE_0x33, &type0x33_signals);
-  signal_collections.insert(TYPE_0x02, &type0x02_signals);
-  signal_collections.insert(TYPE_0x03, &type0x03_signals);
-  signal_collections.insert(TYPE_0x04, &type0x04_signals);
-  signal_collections.insert(TYPE_0x19, &type0x19_signals);
-}
+constexpr m12700::RegisterEntry opa::Project::Registers[];
+constexpr m12700::TypeEntry     opa::Project::Types[];
 
-bool opa::SvOPA::configure(modus::DeviceConfig *config, modus::IOBuffer *iobuffer)
+opa::SvOPA::SvOPA():
+  m12700::SvProtocol12700("12700_opa", true)
 {
-  try {
+  m_collections[Parser::slot(TYPE_0x33)] = &type0x33_signals;
+  m_collections[Parser::slot(TYPE_0x02)] = &type0x02_signals;
+  m_collections[Parser::slot(TYPE_0x03)] = &type0x03_signals;
+  m_collections[Parser::slot(TYPE_0x04)] = &type0x04_signals;
+  m_collections[Parser::slot(TYPE_0x19)] = &type0x19_signals;
 
-    p_config = config;
-    p_io_buffer = iobuffer;
+  for(SvAbstractSignalCollection* collection: m_collections) {
 
-    m_params = opa::DeviceParams::fromJson(p_config->protocol.params);
+    collection->setBatch(&m_batch);
+    collection->setImage(&m_image);
 
-    if(!m_data.resize(p_config->bufsize))
-      throw SvException(QString("Не удалось выделить %1 байт памяти для буфера").arg(p_config->bufsize));
-
-    return true;
+  }
 
-  } catch (SvException& e) {
+  line_status_signals.setBatch(&m_batch);
+}
 
-    p_last_error = e.error;
-    return false;
+opa::SvOPA::~SvOPA()
+{
+  detach();
+}
 
-  }
+void opa::SvOPA::configureDevice()
+{
+  m_params = m_image.params<opa::DeviceParams>(p_config->protocol.params);
 }
 
 void opa::SvOPA::disposeInputSignal (modus::SvSignal* signal)
 {
   try {
 
+    m_timeouts.addSignal(signal, this);
+
     QString type = signal->config()->type.toLower();
 
     if(type == "status")
@@ -46,8 +48,8 @@ void opa::SvOPA::disposeInputSignal (modus::SvSignal* signal)
       bool ok;
       int itype = type.toInt(&ok, 0);
 
-      if(ok && signal_collections.contains(itype))
-        signal_collections.value(itype)->addSignal(signal);
+      if(ok && Parser::slot(itype) != M12700_NO_SLOT)
+        m_collections[Parser::slot(itype)]->addSignal(signal);
 
       else {
 
@@ -68,125 +70,93 @@ void opa::SvOPA::disposeOutputSignal (modus::SvSignal* signal)
   Q_UNUSED(signal);
 }
 
-void opa::SvOPA::run()
+bool opa::SvOPA::parseInput()
 {
-  p_is_active = bool(p_config) && bool(p_io_buffer);
+  opa::PARSERESULT result = parse();
 
-  while(p_is_active) {
-
-    p_io_buffer->confirm->mutex.lock();     // если нужен ответ квитирование
-    p_io_buffer->input->mutex.lock();
-
-    opa::PARSERESULT result = parse();
-
-    if(result.do_reset == DO_RESET)
-      p_io_buffer->input->reset();
+  if(result.do_reset != DO_RESET)
+    return false;
 
-    p_io_buffer->input->mutex.unlock();     // если нужен ответ квитирование
-    p_io_buffer->confirm->mutex.unlock();
+  p_io_buffer->input->reset();
 
-    if(result.parse_time.isValid())
-      validateSignals(result.parse_time);
+  return true;
 
-  }
 }
 
 opa::PARSERESULT opa::SvOPA::parse()
 {
-  // проверяем, что длина данных в буфере не меньше длины звголовка
-  if(p_io_buffer->input->offset < m_hsz)
-    return opa::PARSERESULT(DO_NOT_RESET);
+  // пакет разбирается на месте, в буфере input. packet.data указывает в буфер
+  m12700::Packet packet;
 
-  // разбираем заголовок. если адрес или код функции не тот, значит это чужой пакет
-  memcpy(&m_header, &p_io_buffer->input->data[0], m_hsz);
-  if((m_header.client_addr != 1) || (m_header.func_code != 0x10))
-    return opa::PARSERESULT(DO_RESET);
+  m12700::ParseStatus status = Parser::parse(p_io_buffer->input, m_params.start_register, m_params.last_register, packet);
 
-  // проверяем, что длина данных в буфере не меньше длины всего отправленного пакета
-  if(p_io_buffer->input->offset < m_hsz + m_header.byte_count + 2)
+  if(status == m12700::psIncomplete)
     return opa::PARSERESULT(DO_NOT_RESET);
 
-  // проверяем начальный и конечный адреса регистров. если не входит в заданный диапазон - чужой пакет
-  quint16 current_register = (static_cast<quint16>(m_header.ADDRESS << 8)) + m_header.OFFSET;
+  // чужой пакет
+  if(status == m12700::psForeign) {
 
-  if((current_register < m_params.start_register) ||
-     (current_register > m_params.last_register))
+    m_metrics.resets.inc();
     return opa::PARSERESULT(DO_RESET);
+  }
 
   /**
   *  в этой точке в буфере должны находиться правильные данные
   *  производим непосредственно разбор данных и назначаем значения сигналам
   **/
-//  qDebug() << QString(QByteArray((const char*)&p_io_buffer->input->data[0], p_io_buffer->input->offset).toHex());
   message(QString(">> %1").arg(QString(QByteArray((const char*)&p_io_buffer->input->data[0], p_io_buffer->input->offset).toHex())));
 
-  // если хоть какие то пакеты сыпятся (для данного получателя), то
-  // считаем, что линия передачи в порядке и задаем новую контрольную точку времени
-//  p_device->setNewLostEpoch();
-
   // ставим состояние данной линии
   line_status_signals.updateSignals();
 
-  // парсим и проверяем crc
-  memcpy(&m_data.type, &p_io_buffer->input->data[m_hsz], 1);                       // тип данных
-  memcpy(&m_data.len,  &p_io_buffer->input->data[m_hsz + 1], 1);                   // длина данных
-  memcpy(&m_data.crc,  &p_io_buffer->input->data[m_hsz + m_header.byte_count], 2); // crc полученная
+  // проверяем, что данные помещаются в пакет
+  if(status == m12700::psBadLength) {
 
-  // проверяем, что длина данных не превышает размер выделенного буфера
-  if(m_data.len > m_data.bufsize) {
-
-    message(QString("Размер данных превышает размер буфера! Данные %1 байт, буфер %2 байт")
-                 .arg(m_data.len).arg(m_data.bufsize),
+    message(QString("Размер данных превышает размер пакета! Данные %1 байт, пакет %2 байт")
+                 .arg(packet.data.len).arg(packet.header->byte_count),
                  sv::log::llError, sv::log::mtError);
 
+    m_metrics.resets.inc();
     return opa::PARSERESULT(DO_RESET);
   }
 
-  memcpy(&m_data.data[0],     &p_io_buffer->input->data[m_hsz + 2], m_data.len);    // данные
-
-  quint16 calc_crc = CRC::MODBUS_CRC16((const quint8*)&p_io_buffer->input->data[0], m_hsz + m_header.byte_count); // вычисляем crc из данных
-
-  if(calc_crc != m_data.crc) {
+  if(status == m12700::psBadCrc) {
 
     // если crc не совпадает, то выходим без обработки и ответа
-    emit message(QString("Ошибка crc! Ожидалось %1%2, получено %3%4")
-                 .arg(quint8(calc_crc), 2, 16, QChar('0'))
-                 .arg(quint8(calc_crc >> 8), 2, 16, QChar('0'))
-                 .arg(quint8(m_data.crc), 2, 16, QChar('0'))
-                 .arg(quint8(m_data.crc >> 8), 2, 16, QChar('0')),
-                 sv::log::llError, sv::log::mtError);
+    message(Parser::crcError(packet), sv::log::llError, sv::log::mtError);
 
+    m_metrics.crc_errors.inc();
+    m_metrics.resets.inc();
     return opa::PARSERESULT(DO_RESET);
   }
 
-  // если все корректно, то разбираем данные в зависимости от типа
-  switch (current_register - m_params.start_register)
+  m_metrics.frames.inc();
+  m_latency.parsed();
+
+  // если все корректно, то разбираем данные в зависимости от регистра.
+  // действие по регистру и коллекция по типу данных заданы в opa::Project
+  switch (packet.action)
   {
-      case 0x00:
-      case 0x03:
-      case 0x05:
+      case m12700::raConfirm:
 
         // здесь просто отправляем ответ-квитирование
-        confirmation();
+        Parser::confirmation(packet.header, p_io_buffer->confirm);
 
-        if(m_data.type == 0x77) {
+        if(packet.data.type == 0x77) {
 
           for (modus::SvSignal* signal: p_input_signals)
-            signal->setValue(0);
+            m_batch.stage(signal, 0);
         }
 
         break;
 
-      case 0x06:
-      case 0x10:
-      case 0x50:
-      case 0x90:
+      case m12700::raData:
       {
          // формируем и отправляем ответ-квитирование
-         confirmation();
+         Parser::confirmation(packet.header, p_io_buffer->confirm);
 
-         if(signal_collections.contains(m_data.type))
-           signal_collections.value(m_data.type)->updateSignals(&m_data);
+         if(packet.slot != M12700_NO_SLOT)
+           m_collections[packet.slot]->updateSignals(&packet.data);
 
          break;
       }
@@ -195,26 +165,10 @@ opa::PARSERESULT opa::SvOPA::parse()
           break;
   }
 
-
   return opa::PARSERESULT(DO_RESET, QDateTime::currentDateTime());
-}
-
-void opa::SvOPA::confirmation()
-{
-  QByteArray confirm;
-  confirm.append((const char*)(&m_header), 6);
-
-  // вычисляем crc ответа
-  quint16 crc = CRC::MODBUS_CRC16((uchar*)(&m_header), 6);
-  confirm.append(quint8(crc & 0xFF));
-  confirm.append(quint8(crc >> 8));
-
-  memcpy(&p_io_buffer->confirm->data[0], confirm.data(), confirm.length());
-  p_io_buffer->confirm->offset = confirm.length();
 
 }
 
-
 /** ********** EXPORT ************ **/
 modus::SvAbstractProtocol* create()
 {
@@ -3,6 +3,7 @@
 
 #include <QMutex>
 #include <QMutexLocker>
+#include <QElapsedTimer>
 
 #include "proj_12700_opa_global.h"
 
@@ -18,6 +19,7 @@
 #include "collection_0x33.h"
 #include "collection_0x19.h"
 #include "collection_status.h"
+#include "../../global/sv_protocol_12700.h"
 
 #include "../../../../../svlib/sv_abstract_logger.h"
 #include "../../../../../svlib/sv_exception.h"
@@ -39,17 +41,7 @@ extern "C" {
 
 namespace opa {
 
-  #pragma pack(push,1)
-  struct Header
-  {
-    quint8  client_addr;
-    quint8  func_code;
-    quint8  ADDRESS;
-    quint8  OFFSET;
-    quint16 register_count;
-    quint8  byte_count;
-  };
-  #pragma pack(pop)
+  typedef m12700::Header Header;
 
   struct PARSERESULT {
 
@@ -64,23 +56,22 @@ namespace opa {
 
   class SvOPA;
 
-  typedef QMap<int, SvAbstractSignalCollection*> SignalCollections;
 
 //  bool parse_signal(modus::SvSignal* signal);
 
 }
 
-class opa::SvOPA: public modus::SvAbstractProtocol
+class opa::SvOPA: public m12700::SvProtocol12700
 {
   Q_OBJECT
 
 public:
   SvOPA();
-
-  bool configure(modus::DeviceConfig* config, modus::IOBuffer *iobuffer) override;
+  ~SvOPA();
 
 protected:
-  void run() override;
+  void configureDevice() override; //throw (SvException)
+  bool parseInput() override;
 
   void disposeInputSignal (modus::SvSignal* signal) override;
   void disposeOutputSignal (modus::SvSignal* signal) override;
@@ -93,10 +84,6 @@ private:
 
   opa::DeviceParams m_params;
 
-  opa::DATA m_data;
-
-  opa::Header m_header;
-  size_t m_hsz = sizeof(opa::Header);
 
   opa::Type0x02   type0x02_signals;
   opa::Type0x03   type0x03_signals;
@@ -105,10 +92,10 @@ private:
   opa::Type0x33   type0x33_signals;
   opa::LineStatus line_status_signals;
 
-  opa::SignalCollections signal_collections;
+  // коллекции сигналов по номерам из opa::Project::Types
+  SvAbstractSignalCollection* m_collections[opa::Project::COLLECTIONS];
 
   PARSERESULT parse();
-  void confirmation();
 
 };
 
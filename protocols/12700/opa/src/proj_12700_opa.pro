@@ -2,7 +2,7 @@ QT -= gui
 
 DEFINES += PROJ_12700_OPA_LIBRARY
 
-CONFIG += c++11 plugin
+CONFIG += c++14 plugin
 
 TARGET = /home/user/Modus/lib/protocols/proj_12700_opa
 TEMPLATE = lib
@@ -19,6 +19,14 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    ../../global/sv_params_image.cpp \
+    ../../global/sv_parse_scheduler.cpp \
+    ../../../../global/sv_realtime.cpp \
+    ../../../../global/sv_metrics.cpp \
+    ../../../../global/sv_latency.cpp \
+    ../../global/sv_signal_batch.cpp \
+    ../../global/sv_timing_wheel.cpp \
+    ../../global/sv_protocol_12700.cpp \
     collection_0x02.cpp \
     collection_0x03.cpp \
     collection_0x04.cpp \
@@ -29,6 +37,15 @@ SOURCES += \
     proj_12700_opa.cpp
 
 HEADERS += \
+    ../../global/sv_params_image.h \
+    ../../global/sv_parse_scheduler.h \
+    ../../../../global/sv_realtime.h \
+    ../../../../global/sv_metrics.h \
+    ../../../../global/sv_latency.h \
+    ../../global/sv_signal_batch.h \
+    ../../global/sv_timing_wheel.h \
+    ../../global/sv_protocol_12700.h \
+    ../../global/sv_batched_collection.h \
     ../../../../../Modus/global/device/protocol/sv_abstract_protocol.h \
     ../../../../../Modus/global/global_defs.h \
     collection_0x02.h \
@@ -38,11 +55,15 @@ HEADERS += \
     collection_0x33.h \
     collection_status.h \
     opa_defs.h \
+    ../../global/sv_modbus_udp.h \
     opa_params.h \
     proj_12700_opa.h \
     proj_12700_opa_global.h \
     ../../../../../Modus/global/signal/sv_signal.h
 
+# dladdr - отпечаток сборки для образа параметров
+LIBS += -ldl
+
 # Default rules for deployment.
 unix {
     target.path = /usr/lib
@@ -10,7 +10,7 @@ void skm::Type0x01::addSignal(modus::SvSignal* signal) //throw (SvException)
 {
   try
   {
-    skm::SignalParams_0x01 p = skm::SignalParams_0x01::fromJson(signal->config()->params);
+    skm::SignalParams_0x01 p = signalParams<skm::SignalParams_0x01>(signal);
 
     if(m_signals.contains(getUid(0, 0, p.vin, p.faktor)))
       throw SvException(QString("Не уникальные значения параметров: '%1'")
@@ -45,12 +45,11 @@ void skm::Type0x01::updateSignals(const skm::DATA* data)
     while(faktor_count) {
 
         quint8 faktor = data->data[offset++];
-        if(check_1F_2F_55(faktor)) offset++;
 
         quint32 uid = getUid(0, 0, vin, faktor);
 
         if(m_signals.contains(uid))
-          m_signals.value(uid)->setValue(1);
+          setSignalValue(m_signals.value(uid), 1);
 
         faktor_count--;
     }
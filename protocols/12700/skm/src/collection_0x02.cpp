@@ -10,7 +10,7 @@ void skm::Type0x02::addSignal(modus::SvSignal* signal) //throw (SvException)
 {
   try
   {
-    skm::SignalParams_0x02 p = skm::SignalParams_0x02::fromJson(signal->config()->params);
+    skm::SignalParams_0x02 p = signalParams<skm::SignalParams_0x02>(signal);
 
     quint32 uid = getUid(0, 0, p.byte, p.bit);
 
@@ -35,23 +35,13 @@ void skm::Type0x02::updateSignals(const skm::DATA* data)
   if(data->len < 3)
     return;
 
-  int b[3];
-  b[0] = 0;
-  b[1] = check_1F_2F_55(data->data[b[0]]) ? b[0] + 2 : b[0] + 1;
-  if(b[1] >= data->len)
-    return;
-
-  b[2] = check_1F_2F_55(data->data[b[1]]) ? b[1] + 2 : b[1] + 1;
-  if(b[2] >= data->len)
-    return;
-
   for(quint8 i = 0; i < 3; i++ ) {
     for(quint8 j = 0; j < 8; j++) {
 
       quint32 uid = getUid(0, 0, i, j);
 
       if(m_signals.contains(uid))
-        m_signals.value(uid)->setValue(((quint8)data->data[b[i]] >> j) & 1);
+        setSignalValue(m_signals.value(uid), ((quint8)data->data[i] >> j) & 1);
     }
   }
 }
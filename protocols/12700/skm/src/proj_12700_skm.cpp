@@ -1,38 +1,38 @@
 ﻿#include "proj_12700_skm.h"
 
 skm::SvSKM::SvSKM():
-  modus::SvAbstractProtocol()
+  m12700::SvProtocol12700("12700_skm", true)
 {
   signal_collections.insert(TYPE_0x01, &type0x01_signals);
   signal_collections.insert(TYPE_0x02, &type0x02_signals);
-}
-
-bool skm::SvSKM::configure(modus::DeviceConfig *config, modus::IOBuffer *iobuffer)
-{
-  try {
 
-    p_config = config;
-    p_io_buffer = iobuffer;
+  for(SvAbstractSignalCollection* collection: signal_collections) {
 
-    m_params = skm::DeviceParams::fromJson(p_config->protocol.params);
+    collection->setBatch(&m_batch);
+    collection->setImage(&m_image);
 
-    if(!m_data.resize(p_config->bufsize))
-      throw SvException(QString("Не удалось выделить %1 байт памяти для буфера").arg(p_config->bufsize));
-
-    return true;
+  }
+}
 
-  } catch (SvException& e) {
+skm::SvSKM::~SvSKM()
+{
+  detach();
+}
 
-    p_last_error = e.error;
-    return false;
+void skm::SvSKM::configureDevice()
+{
+  m_params = m_image.params<skm::DeviceParams>(p_config->protocol.params);
 
-  }
+  if(!m_data.resize(p_config->bufsize))
+    throw SvException(QString("Не удалось выделить %1 байт памяти для буфера").arg(p_config->bufsize));
 }
 
 void skm::SvSKM::disposeInputSignal (modus::SvSignal* signal)
 {
   try {
 
+    m_timeouts.addSignal(signal, this);
+
     QString type = signal->config()->type.toLower();
 
     bool ok;
@@ -59,27 +59,17 @@ void skm::SvSKM::disposeOutputSignal (modus::SvSignal* signal)
   Q_UNUSED(signal);
 }
 
-void skm::SvSKM::run()
+bool skm::SvSKM::parseInput()
 {
-  p_is_active = bool(p_config) && bool(p_io_buffer);
-
-  while(p_is_active) {
-
-    p_io_buffer->confirm->mutex.lock();     // если нужен ответ квитирование
-    p_io_buffer->input->mutex.lock();
+  skm::PARSERESULT result = parse();
 
-    skm::PARSERESULT result = parse();
-
-    if(result.do_reset == DO_RESET)
-      p_io_buffer->input->reset();
+  if(result.do_reset != DO_RESET)
+    return false;
 
-    p_io_buffer->input->mutex.unlock();     // если нужен ответ квитирование
-    p_io_buffer->confirm->mutex.unlock();
+  p_io_buffer->input->reset();
 
-    if(result.parse_time.isValid())
-      validateSignals(result.parse_time);
+  return true;
 
-  }
 }
 
 skm::PARSERESULT skm::SvSKM::parse()
@@ -95,46 +85,49 @@ skm::PARSERESULT skm::SvSKM::parse()
      (m_header.DST != m_params.dst) ||
      (m_header.version != m_params.protocol_version)) {
 
+    m_metrics.resets.inc();
+    m_scanner.reset(m_hsz);
     return skm::PARSERESULT(DO_RESET);
   }
 
-  // ищем признак конца пакета
-  bool found = false;
-  quint64 offset_of_2f55 = sizeof(m_header) + 1;
+  // буфер был сброшен интерфейсом, начинаем просмотр заново. по длине данных сброс
+  // виден не всегда: интерфейс может сбросить буфер и сразу заполнить его более
+  // длинной датаграммой. поэтому буфер узнается по времени начала заполнения
+  if(m_scan_time != p_io_buffer->input->set_time ||
+     m_scanner.position() < m_hsz || p_io_buffer->input->offset < m_scanner.position()) {
 
-  while(!found && offset_of_2f55 < p_io_buffer->input->offset) {
+    m_scanner.reset(m_hsz);
+    m_scan_time = p_io_buffer->input->set_time;
 
-      found = (p_io_buffer->input->data[offset_of_2f55] == 0x2F) && (p_io_buffer->input->data[offset_of_2f55 + 1] == 0x55);
-      offset_of_2f55++;
   }
 
-  if(!found)
+  // ищем признак конца пакета, просматривая только новые данные.
+  // одновременно снимаем байт-стаффинг: в m_data попадают чистые данные
+  skm::ScanResult scan = m_scanner.feed((const quint8*)&p_io_buffer->input->data[0], p_io_buffer->input->offset, &m_data);
+
+  if(scan == skm::srIncomplete)
     return skm::PARSERESULT(DO_NOT_RESET);
 
-  // если нашли конец пакета, то начинаем парсить его
-  {
-    p_io_buffer->input->offset = offset_of_2f55 + 1;
+  if(scan == skm::srOverflow) {
 
-    message(QString(QByteArray((const char*)&p_io_buffer->input->data[0], p_io_buffer->input->offset).toHex()));
+    message(QString("Размер данных превышает размер буфера! Буфер %1 байт").arg(m_data.bufsize),
+                 sv::log::llError, sv::log::mtError);
 
-    // вытаскиваем данные
-    // длина данных вычисляется по вормуле:
-    // len = [длина пакета] - [длина заголовка] - [1 байт тип данных] - [crc 2 байта] - [2F55 в конце]
-    memcpy(&m_data.len,     &p_io_buffer->input->offset - (m_hsz + 1 + 2 + 2), 1);
-    memcpy(&m_data.type,    &p_io_buffer->input->data[m_hsz], 1);
-    memcpy(&m_data.crc,     &p_io_buffer->input->data[p_io_buffer->input->offset - 4], 2);
+    m_metrics.resets.inc();
+    m_scanner.reset(m_hsz);
 
-    // проверяем, что длина данных не превышает размер выделенного буфера
-    if(m_data.len > m_data.bufsize) {
+    return skm::PARSERESULT(DO_RESET);
+  }
 
-      message(QString("Размер данных превышает размер буфера! Данные %1 байт, буфер %2 байт")
-                   .arg(m_data.len).arg(m_data.bufsize),
-                   sv::log::llError, sv::log::mtError);
+  // если нашли конец пакета, то начинаем парсить его
+  {
+    p_io_buffer->input->offset = m_scanner.position();
+    m_metrics.frames.inc();
+    m_latency.parsed();
 
-      return skm::PARSERESULT(DO_RESET);
-    }
+    m_scanner.reset(m_hsz);
 
-    memcpy(&m_data.data[0], &p_io_buffer->input->data[m_hsz], m_data.len);          // данные
+    message(QString(QByteArray((const char*)&p_io_buffer->input->data[0], p_io_buffer->input->offset).toHex()));
 
     /* программист СКМ говорит, что они никак не анализируют мой ответ на посылку данных
      * поэтому, чтобы не тратить ресурсы, убрал отправку подтверждения.
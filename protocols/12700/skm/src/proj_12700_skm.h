@@ -3,6 +3,7 @@
 
 #include <QMutex>
 #include <QMutexLocker>
+#include <QElapsedTimer>
 
 #include "proj_12700_skm_global.h"
 
@@ -14,6 +15,8 @@
 
 #include "collection_0x02.h"
 #include "collection_0x01.h"
+#include "skm_scanner.h"
+#include "../../global/sv_protocol_12700.h"
 
 #include "../../../../../Modus/global/misc/sv_abstract_logger.h"
 #include "../../../../../Modus/global/misc/sv_exception.h"
@@ -64,17 +67,17 @@ namespace skm {
 
 }
 
-class skm::SvSKM: public modus::SvAbstractProtocol
+class skm::SvSKM: public m12700::SvProtocol12700
 {
   Q_OBJECT
 
 public:
   SvSKM();
-
-  bool configure(modus::DeviceConfig* config, modus::IOBuffer *iobuffer) override;
+  ~SvSKM();
 
 protected:
-  void run() override;
+  void configureDevice() override; //throw (SvException)
+  bool parseInput() override;
 
   void disposeInputSignal (modus::SvSignal* signal) override;
   void disposeOutputSignal (modus::SvSignal* signal) override;
@@ -89,6 +92,10 @@ private:
 
   skm::DATA m_data;
 
+  // поиск конца пакета и снятие стаффинга, продолжается с места остановки
+  skm::SvScanner m_scanner;
+  qint64         m_scan_time = -1;   // set_time буфера, просмотр которого ведет m_scanner
+
   skm::Header m_header;
   size_t m_hsz = sizeof(skm::Header);
 
@@ -98,7 +105,6 @@ private:
   skm::SignalCollections signal_collections;
 
   PARSERESULT parse();
-  bool check_1F_2F_55(quint8 byte);
   quint16 pull_data(modus::BUFF* buff, skm::DATA* data, skm::Header* header);
   void confirmation();
 
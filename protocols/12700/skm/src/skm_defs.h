@@ -8,6 +8,8 @@
 #include "../../../../../Modus/global/global_defs.h"
 #include "../../../../../Modus/global/device/device_defs.h"
 
+#include "../../global/sv_batched_collection.h"
+
 #define TYPE_0x01 0x01
 #define TYPE_0x02 0x02
 
@@ -55,16 +57,16 @@ namespace skm {
       return bool(data);
     }
 
-    quint8* data = nullptr;
+    quint8* data = nullptr;   // данные без байт-стаффинга
     quint8  type;
-    quint8  len;
+    quint16 len;
     quint16 crc;
 
     quint16 bufsize;
 
   };
 
-  class SvAbstractSignalCollection: public QObject
+  class SvAbstractSignalCollection: public QObject, public m12700::SvBatchedCollection
   {
     Q_OBJECT
 
@@ -80,12 +82,6 @@ namespace skm {
     virtual void updateSignals(const skm::DATA* data = nullptr) = 0;
 
   protected:
-
-    inline bool check_1F_2F_55(quint8 byte)
-    {
-      return ((byte == 0x1F) || (byte == 0x2F) || (byte == 0x55));
-    }
-
     inline quint32 getUid(quint8 val1, quint8 val2, quint8 val3, quint8 val4)
     {
       return (static_cast<quint32>(val1) << 24) + (static_cast<quint32>(val2) << 16) + (static_cast<quint32>(val3) << 8) + static_cast<quint32>(val4);
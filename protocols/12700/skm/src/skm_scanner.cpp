@@ -0,0 +1,150 @@
+#include "skm_scanner.h"
+
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+void skm::SvScanner::reset(quint32 start)
+{
+  m_pos       = start;
+  m_clean     = 0;
+  m_has_type  = false;
+  m_skip      = false;
+  m_after_2F  = false;
+  m_overflow  = false;
+}
+
+inline void skm::SvScanner::put(quint8 byte, skm::DATA* data)
+{
+  if(!m_has_type) {
+
+    data->type = byte;
+    m_has_type = true;
+
+  }
+  else if(m_clean < data->bufsize)
+    data->data[m_clean++] = byte;
+
+  else
+    m_overflow = true;
+
+}
+
+const quint8* skm::SvScanner::findSpecial(const quint8* begin, const quint8* end)
+{
+  const quint8* p = begin;
+
+#ifdef __SSE2__
+  const __m128i v1F = _mm_set1_epi8(0x1F);
+  const __m128i v2F = _mm_set1_epi8(0x2F);
+  const __m128i v55 = _mm_set1_epi8(0x55);
+
+  while(end - p >= 16) {
+
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, v1F), _mm_cmpeq_epi8(v, v2F)), _mm_cmpeq_epi8(v, v55));
+
+    int mask = _mm_movemask_epi8(m);
+
+    if(mask)
+      return p + __builtin_ctz(unsigned(mask));
+
+    p += 16;
+
+  }
+#endif
+
+  while(p < end && *p != 0x1F && *p != 0x2F && *p != 0x55)
+    p++;
+
+  return p;
+
+}
+
+skm::ScanResult skm::SvScanner::feed(const quint8* buffer, quint32 size, skm::DATA* data)
+{
+  while(m_pos < size) {
+
+    // дополнительный байт после 0x1F или 0x55
+    if(m_skip) {
+
+      m_skip = false;
+      m_pos++;
+
+      continue;
+
+    }
+
+    // после 0x2F: 0x55 - конец пакета, иначе дополнительный байт
+    if(m_after_2F) {
+
+      m_after_2F = false;
+
+      if(buffer[m_pos++] == 0x55) {
+
+        if(m_overflow || m_clean < 2)
+          return srOverflow;
+
+        data->len = quint16(m_clean - 2);
+        data->crc = quint16(data->data[m_clean - 2]) | quint16(data->data[m_clean - 1] << 8);
+
+        return srComplete;
+
+      }
+
+      put(0x2F, data);
+
+      continue;
+
+    }
+
+    // участок без служебных байт копируется целиком
+    const quint8* run  = buffer + m_pos;
+    const quint8* stop = findSpecial(run, buffer + size);
+
+    if(stop > run) {
+
+      quint32 n = quint32(stop - run);
+
+      if(!m_has_type) {
+
+        put(*run++, data);
+        n--;
+
+      }
+
+      if(m_clean + n > data->bufsize) {
+
+        m_overflow = true;
+        n = data->bufsize - m_clean;
+
+      }
+
+      memcpy(&data->data[m_clean], run, n);
+      m_clean += n;
+
+      m_pos = quint32(stop - buffer);
+
+    }
+
+    if(m_pos >= size)
+      break;
+
+    quint8 byte = buffer[m_pos++];
+
+    if(byte == 0x2F)
+      m_after_2F = true;
+
+    else {
+
+      put(byte, data);
+      m_skip = true;
+
+    }
+  }
+
+  return m_overflow ? srOverflow : srIncomplete;
+
+}
@@ -0,0 +1,61 @@
+/**********************************************************************
+ *  поиск конца пакета СКМ и снятие байт-стаффинга за один проход.
+ *
+ *  в данных пакета за каждым байтом 0x1F, 0x2F, 0x55 следует
+ *  дополнительный байт, конец пакета - последовательность 0x2F 0x55.
+ *  сканер запоминает позицию, на которой остановился, поэтому при
+ *  получении пакета по частям каждый байт просматривается один раз.
+ *  участки без служебных байт находятся сравнением по 16 байт (SSE2)
+ *  и копируются в DATA целиком.
+ *
+ *  результат: DATA.type - первый байт после заголовка, DATA.data -
+ *  данные без стаффинга, DATA.crc - два последних байта перед 0x2F 0x55
+ * *********************************************************************/
+
+#ifndef SKM_SCANNER_H
+#define SKM_SCANNER_H
+
+#include <QtGlobal>
+
+#include "skm_defs.h"
+
+namespace skm {
+
+  enum ScanResult {
+    srIncomplete,   // конец пакета еще не получен
+    srComplete,     // пакет получен, данные в DATA
+    srOverflow      // данные не помещаются в DATA
+  };
+
+  class SvScanner;
+
+}
+
+class skm::SvScanner
+{
+public:
+  // начало нового пакета. данные начинаются со смещения start
+  void reset(quint32 start = 0);
+
+  // позиция, до которой буфер уже просмотрен
+  quint32 position() const { return m_pos; }
+
+  // просмотр новых данных буфера [position(), size).
+  // при srComplete position() указывает на байт, следующий за 0x2F 0x55
+  ScanResult feed(const quint8* buffer, quint32 size, skm::DATA* data);
+
+private:
+  quint32   m_pos       = 0;
+  quint32   m_clean     = 0;      // кол-во байт, записанных в data->data
+  bool      m_has_type  = false;
+  bool      m_skip      = false;  // следующий байт - дополнительный, отбрасывается
+  bool      m_after_2F  = false;  // предыдущий байт 0x2F: либо конец пакета, либо стаффинг
+  bool      m_overflow  = false;
+
+  inline void put(quint8 byte, skm::DATA* data);
+
+  static const quint8* findSpecial(const quint8* begin, const quint8* end);
+
+};
+
+#endif // SKM_SCANNER_H
@@ -181,6 +181,8 @@ void ConningKongsberUDPThread::conform(const QString& jsonDevParams, const QStri
     dev_params = DeviceParams::fromJson(jsonDevParams);
     ifc_params = UdpParams::fromJsonString(jsonIfcParams);
 
+    m_tx.setGap(dev_params.tx_gap);
+
   }
   catch(SvException& e) {
 
@@ -208,11 +210,14 @@ void ConningKongsberUDPThread::run()
 {
   p_is_active = true;
 
+  QByteArray confirm;
+
   while(p_is_active) {
 
     process_signals();
 
-    while(socket.waitForReadyRead(1000) && p_is_active) {
+    // ожидание данных прерывается к моменту отправки очередного подтверждения
+    while((socket.waitForReadyRead(m_tx.wait(1000)) || !m_tx.isEmpty()) && p_is_active) {
 
       while(socket.hasPendingDatagrams() && p_is_active)
       {
@@ -231,6 +236,10 @@ void ConningKongsberUDPThread::run()
         process_data();
 
       }
+
+      while(m_tx.next(confirm))
+        transmit(confirm);
+
     }
   }
 
@@ -244,9 +253,17 @@ quint64 ConningKongsberUDPThread::write(const QByteArray& data)
     return 0;
 
   // небольшая задержка перед отправкой подтверждения
-  // из-за того, что "шкаф не успевает обработать данные" (c) Гаврилов
-  msleep(10);
+  // из-за того, что "шкаф не успевает обработать данные" (c) Гаврилов.
+  // подтверждение отправит цикл приема, когда пауза истечет
+  if(!m_tx.enqueue(data))
+    return 0;
+
+  return data.size();
 
+}
+
+quint64 ConningKongsberUDPThread::transmit(const QByteArray& data)
+{
   if(p_logger) // && p_device->info()->debug_mode)
     *p_logger //<< static_cast<dev::SvAbstractKsutsDevice*>(p_device)->make_dbus_sender()
               << sv::log::mtDebug
@@ -288,6 +305,8 @@ void ConningKongsberSerialThread::conform(const QString& jsonDevParams, const QS
     dev_params = DeviceParams::fromJson(jsonDevParams);
     ifc_params = SerialParams::fromJsonString(jsonIfcParams);
 
+    m_tx.setGap(dev_params.tx_gap);
+
   }
   catch(SvException& e) {
 
@@ -322,18 +341,30 @@ void ConningKongsberSerialThread::run()
 {
   p_is_active = true;
 
+  QByteArray confirm;
+
   while(p_is_active) {
 
     process_signals();
 
-    while(port.waitForReadyRead(1000) && p_is_active) {
+    // ожидание данных прерывается к моменту отправки очередного подтверждения
+    while(p_is_active) {
 
-      if(p_buff.offset > MAX_PACKET_SIZE)
-        reset_buffer();
+      if(port.waitForReadyRead(m_tx.wait(1000))) {
 
-      p_buff.offset += port.read((char*)(&p_buff.buf[p_buff.offset]), MAX_PACKET_SIZE - p_buff.offset);
+        if(p_buff.offset > MAX_PACKET_SIZE)
+          reset_buffer();
 
-      process_data();
+        p_buff.offset += port.read((char*)(&p_buff.buf[p_buff.offset]), MAX_PACKET_SIZE - p_buff.offset);
+
+        process_data();
+
+      }
+      else if(m_tx.isEmpty())
+        break;
+
+      while(m_tx.next(confirm))
+        transmit(confirm);
 
     }
   }
@@ -348,9 +379,17 @@ quint64 ConningKongsberSerialThread::write(const QByteArray& data)
     return 0;
 
   // небольшая задержка перед отправкой подтверждения
-  // из-за того, что "шкаф не успевает обработать данные" (c) Гаврилов
-  msleep(10);
+  // из-за того, что "шкаф не успевает обработать данные" (c) Гаврилов.
+  // подтверждение отправит цикл приема, когда пауза истечет
+  if(!m_tx.enqueue(data))
+    return 0;
+
+  return data.size();
 
+}
+
+quint64 ConningKongsberSerialThread::transmit(const QByteArray& data)
+{
   if(p_logger) // && p_device->info()->debug_mode)
     *p_logger //<< static_cast<dev::SvAbstractKsutsDevice*>(p_device)->make_dbus_sender()
               << sv::log::mtDebug
@@ -172,6 +172,11 @@ private:
 
   UdpParams    ifc_params;
 
+  // подтверждения отправляются с паузой, не останавливая прием
+  tx::SvTxScheduler m_tx;
+
+  quint64 transmit(const QByteArray& data);
+
   void run() Q_DECL_OVERRIDE;
 
 public slots:
@@ -198,6 +203,11 @@ private:
 
   SerialParams ifc_params;
 
+  // подтверждения отправляются с паузой, не останавливая прием
+  tx::SvTxScheduler m_tx;
+
+  quint64 transmit(const QByteArray& data);
+
   void run() Q_DECL_OVERRIDE;
 
 public slots:
@@ -20,6 +20,7 @@ DEFINES += CONNING_KONGSBER_LIBRARY
 
 SOURCES += conning_kongsber_device.cpp \
     ../../../svlib/sv_abstract_logger.cpp \
+    ../../../../global/sv_tx_scheduler.cpp \
     ../../../Modus/global/sv_signal.cpp
 
 HEADERS += conning_kongsber_device.h\
@@ -30,6 +31,7 @@ HEADERS += conning_kongsber_device.h\
     ifc_test_params.h \
     signal_params.h \
     ../../../svlib/sv_abstract_logger.h \
+    ../../../../global/sv_tx_scheduler.h \
     ../../../Modus/global/sv_abstract_device.h \
     ../../../Modus/global/sv_signal.h
 
@@ -7,6 +7,7 @@
 #include "conning_kongsber_device_global.h"
 
 #include "../../../svlib/sv_exception.h"
+#include "../../../../global/sv_tx_scheduler.h"
 
 #define RESET_INTERVAL  180 // миллисекунд
 
@@ -19,6 +20,7 @@
   struct DeviceParams {
 
     quint16   reset_timeout = RESET_INTERVAL;
+    quint16   tx_gap        = DEFAULT_TX_GAP;   // пауза перед отправкой подтверждения, мс
 
     bool isValid = true;
 
@@ -59,6 +61,20 @@
       }
       else p.reset_timeout = quint16(RESET_INTERVAL);
 
+      P = P_TX_GAP;
+      if(object.contains(P)) {
+
+        if(object.value(P).toInt(-1) < 0 || object.value(P).toInt(-1) > 10000)
+          throw SvException(QString(CNKG_IMPERMISSIBLE_VALUE)
+                            .arg(P)
+                            .arg(object.value(P).toVariant().toString())
+                            .arg("Пауза перед отправкой задается в мсек. от 0 до 10000"));
+
+        p.tx_gap = object.value(P).toInt(DEFAULT_TX_GAP);
+
+      }
+      else p.tx_gap = quint16(DEFAULT_TX_GAP);
+
       return p;
 
     }
@@ -76,6 +92,7 @@
       QJsonObject j;
 
       j.insert(P_RESET_TIMEOUT, QJsonValue(reset_timeout));
+      j.insert(P_TX_GAP,        QJsonValue(tx_gap));
 
       return j;
 
@@ -20,6 +20,15 @@ bool plug::SvDummy::configure(modus::DeviceConfig *config, modus::IOBuffer *iobu
 
     m_params = plug::ProtocolParams::fromJson(p_config->protocol.params);
 
+    if(m_params.mode == plug::dmBench) {
+
+      m_metrics.attach(p_config->name);
+      m_trace.attach(p_config->name);
+
+      m_latency.assign(HIST_BUCKETS, 0);
+
+    }
+
     return true;
 
   } catch (SvException& e) {
@@ -81,7 +90,9 @@ void plug::SvDummy::start()
 //  connect(m_timer, &QTimer::timeout, this, &SvDummy::send);
 //  m_timer->start(m_params.interval);
 
-  connect(p_io_buffer, &modus::IOBuffer::dataReaded, this, &SvDummy::parse);
+  connect(p_io_buffer, &modus::IOBuffer::dataReaded, this, m_params.mode == plug::dmBench ? &SvDummy::count : &SvDummy::parse);
+
+  m_window.start();
 
   p_is_active = bool(p_config) && bool(p_io_buffer);
 }
@@ -105,6 +116,94 @@ void plug::SvDummy::parse(modus::BUFF* buffer)
   }
 }
 
+void plug::SvDummy::count(modus::BUFF* buffer)
+{
+  if(!p_is_active)
+    return;
+
+  buffer->mutex.lock();
+
+  if(buffer->isReady()) {
+
+    m_trace.parsed();
+
+    // от приема первых байт пакета интерфейсом до разбора
+    if(m_trace.stamp()) {
+
+      quint64 us = latency::now() - m_trace.stamp();
+
+      m_latency[metrics::bucket(us)]++;
+      m_latency_count++;
+      m_latency_max = qMax(m_latency_max, us);
+
+    }
+
+    m_packets++;
+    m_bytes += quint64(buffer->offset);
+
+    m_metrics.frames.inc();
+
+    buffer->reset();
+
+  }
+
+  buffer->mutex.unlock();
+
+  // итоги выводятся при поступлении данных: пока данных нет, выводить нечего
+  if(m_window.elapsed() >= qint64(m_params.report) * 1000)
+    report();
+
+}
+
+quint64 plug::SvDummy::quantile(double q) const
+{
+  quint64 rank = quint64(q * m_latency_count + 0.5);
+  quint64 seen = 0;
+
+  for(int i = 0; i < int(m_latency.size()); i++) {
+
+    seen += m_latency[i];
+
+    // верхняя граница интервала, но не больше наибольшей задержки
+    if(seen >= qMax(rank, quint64(1)))
+      return qMin(metrics::bound(i), m_latency_max);
+
+  }
+
+  return m_latency_max;
+
+}
+
+void plug::SvDummy::report()
+{
+  double seconds = m_window.restart() / 1000.0;
+
+  m_total_packets += m_packets;
+  m_total_bytes   += m_bytes;
+
+  QString latency = m_latency_count
+      ? QString("задержка от приема, мкс: p50 %1, p99 %2, p999 %3, max %4")
+        .arg(quantile(0.5)).arg(quantile(0.99)).arg(quantile(0.999)).arg(m_latency_max)
+      : QString("интерфейс не отмечает время приема");
+
+  emit message(QString("%1: %2 пакетов/с, %3 байт/с, %4. Всего пакетов: %5, байт: %6")
+               .arg(p_config->name)
+               .arg(m_packets / seconds, 0, 'f', 1)
+               .arg(m_bytes / seconds, 0, 'f', 0)
+               .arg(latency)
+               .arg(m_total_packets)
+               .arg(m_total_bytes),
+               sv::log::llInfo, sv::log::mtInfo);
+
+  m_packets       = 0;
+  m_bytes         = 0;
+  m_latency_count = 0;
+  m_latency_max   = 0;
+
+  std::fill(m_latency.begin(), m_latency.end(), 0);
+
+}
+
 /** ********** EXPORT ************ **/
 modus::SvAbstractProtocol* create()
 {
@@ -3,6 +3,10 @@
 
 #include <QMutex>
 #include <QMutexLocker>
+#include <QElapsedTimer>
+
+#include <vector>
+#include <algorithm>
 
 #include "dummy_global.h"
 #include "protocol_params.h"
@@ -14,6 +18,9 @@
 #include "../../../../svlib/SvException/1.1/sv_exception.h"
 #include "../../../../svlib/SvCRC/1.1/sv_crc.h"
 
+#include "../../../global/sv_metrics.h"
+#include "../../../global/sv_latency.h"
+
 extern "C" {
 
     SKM_IMITATOR_EXPORT modus::SvAbstractProtocol* create();
@@ -24,6 +31,23 @@ extern "C" {
 
 }
 
+/**********************************************************************
+ *  режим bench ("mode": "bench") - нулевой приемник для измерения
+ *  издержек интерфейса и IOBuffer без разбора и без журнала: пакеты
+ *  и байты только подсчитываются. раз в report секунд выводятся
+ *  пакеты/с, байт/с и квантили задержки от приема первых байт пакета
+ *  интерфейсом до обработки (для интерфейсов, отмечающих время
+ *  приема, см. sv_latency.h). задержка также записывается в
+ *  гистограмму этапа разбора (/metrics, /latency).
+ *
+ *  для измерения интерфейс устройства подключается к имитатору
+ *  (interacts/simulator) через loopback: udp, tcp, pty (rs) или vcan
+ *  (can). наибольший устойчивый поток - наибольший rate имитатора, при
+ *  котором байт/с устройства совпадают с отправленными имитатором
+ *  (modus_interface_bytes_out_total{device="sim:<поток>"}), а задержка
+ *  не растет от периода к периоду.
+ * *********************************************************************/
+
 namespace plug {
 
   class SvDummy: public modus::SvAbstractProtocol
@@ -47,6 +71,25 @@ namespace plug {
 
     QTimer* m_timer;
 
+    /* режим bench */
+    metrics::ProtocolMetrics  m_metrics;    // /metrics
+    latency::Tracer           m_trace;      // задержка от приема интерфейсом
+
+    QElapsedTimer m_window;                 // отсчет периода итогов
+
+    quint64 m_packets       = 0;            // за период
+    quint64 m_bytes         = 0;
+    quint64 m_total_packets = 0;
+    quint64 m_total_bytes   = 0;
+
+    // задержки периода по интервалам гистограммы метрик
+    std::vector<quint32> m_latency;
+    quint64 m_latency_count = 0;
+    quint64 m_latency_max   = 0;
+
+    quint64 quantile(double q) const;
+    void report();
+
   public slots:
     void signalUpdated(modus::SvSignal* signal) override;
     void signalChanged(modus::SvSignal* signal) override;
@@ -54,6 +97,7 @@ namespace plug {
 
   private slots:
     void parse(modus::BUFF* buffer);
+    void count(modus::BUFF* buffer);
 
   };
 }
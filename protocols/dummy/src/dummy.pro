@@ -20,10 +20,14 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    ../../../global/sv_metrics.cpp \
+    ../../../global/sv_latency.cpp \
     ../../../../Modus/global/signal/sv_signal.cpp \
     dummy.cpp
 
 HEADERS += \
+    ../../../global/sv_metrics.h \
+    ../../../global/sv_latency.h \
     ../../../../Modus/global/device/protocol/sv_abstract_protocol.h \
     ../../../../Modus/global/global_defs.h \
     ../../../../Modus/global/signal/sv_signal.h \
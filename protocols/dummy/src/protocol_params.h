@@ -13,13 +13,30 @@
 
 #define P_VIN     "vin"
 #define P_FACTOR  "factor"
+#define P_MODE    "mode"
+#define P_REPORT  "report"
+
+#define DEFAULT_REPORT  10  // с
 
 namespace plug {
 
+  enum Mode {
+    dmLog,      // содержимое пакетов выводится в журнал
+    dmBench     // только подсчет пакетов, байт и задержки
+  };
+
+  const QMap<QString, Mode> Modes = {{"log",   dmLog},
+                                     {"bench", dmBench}};
+
   struct ProtocolParams {
 
     quint16 interval = 1000;
 
+    Mode    mode     = dmLog;
+
+    // период вывода итогов в режиме bench, с
+    quint16 report   = DEFAULT_REPORT;
+
     static ProtocolParams fromJson(const QString& json_string) //throw (SvException)
     {
       QJsonParseError err;
@@ -58,6 +75,34 @@ namespace plug {
       else
         p.interval = 1000;
 
+      P = P_MODE;
+      if(object.contains(P)) {
+
+        QString mode = object.value(P).toString().toLower();
+
+        if(!Modes.contains(mode))
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P)
+                            .arg(object.value(P).toVariant().toString())
+                            .arg("Допустимые значения: log, bench"));
+
+        p.mode = Modes.value(mode);
+
+      }
+
+      P = P_REPORT;
+      if(object.contains(P)) {
+
+        if(object.value(P).toInt(-1) < 1 || object.value(P).toInt(-1) > 3600)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P)
+                            .arg(object.value(P).toVariant().toString())
+                            .arg("Период вывода итогов должен быть задан целым числом от 1 до 3600 секунд"));
+
+        p.report = object.value(P).toInt(DEFAULT_REPORT);
+
+      }
+
       return p;
 
     }
@@ -75,6 +120,8 @@ namespace plug {
       QJsonObject j;
 
       j.insert(P_INTERVAL,   QJsonValue(interval).toInt());
+      j.insert(P_MODE,       QJsonValue(Modes.key(mode)));
+      j.insert(P_REPORT,     QJsonValue(report).toInt());
 
       return j;
 
@@ -0,0 +1,509 @@
+#include "sv_pg_pipeline.h"
+
+#include <QSqlDatabase>
+#include <QSqlError>
+
+#include "../../svlib/sv_pgdb.h"
+
+namespace {
+
+  // конвейеры библиотеки по параметрам соединения
+  QMutex registry_mutex;
+  QMap<QString, pgw::SvPgPipeline*> registry;
+  QHash<pgw::SvPgPipeline*, int> registry_clients;
+  int registry_number = 0;
+
+  // выполнение вызовов в одной транзакции
+  QSqlError transact(SvPGDB* db, const QStringList& calls)
+  {
+    QSqlError err = db->execSQL("begin;");
+
+    if(err.type() != QSqlError::NoError)
+      return err;
+
+    for(const QString& call: calls) {
+
+      err = db->execSQL(call);
+
+      if(err.type() != QSqlError::NoError) {
+
+        db->execSQL("rollback;");
+        return err;
+
+      }
+    }
+
+    err = db->execSQL("commit;");
+
+    if(err.type() != QSqlError::NoError)
+      db->execSQL("rollback;");
+
+    return err;
+
+  }
+}
+
+/** ********** SvPgWriter ************ **/
+
+pgw::SvPgWriter::SvPgWriter(SvPgPipeline* pipeline, int index):
+  QThread(),
+  m_pipeline(pipeline),
+  m_index(index)
+{
+
+}
+
+void pgw::SvPgWriter::run()
+{
+  m_pipeline->work(m_index);
+}
+
+/** ********** SvPgPipeline ************ **/
+
+pgw::SvPgPipeline* pgw::SvPgPipeline::attach(SvPgClient* client, const Connection& connection, const PipelineParams& params)
+{
+  QMutexLocker locker(&registry_mutex);
+
+  SvPgPipeline* pipeline = registry.value(connection.key(), nullptr);
+
+  if(!pipeline) {
+
+    pipeline = new SvPgPipeline(connection, params, registry_number++);
+    registry.insert(connection.key(), pipeline);
+
+  }
+
+  registry_clients[pipeline]++;
+
+  QMutexLocker plocker(&pipeline->m_mutex);
+  pipeline->m_pending.insert(client, 0);
+
+  return pipeline;
+
+}
+
+void pgw::SvPgPipeline::detach(SvPgPipeline* pipeline, SvPgClient* client)
+{
+  // ожидание записи - без блокировки реестра, чтобы не задерживать подключение и
+  // отключение хранилищ других конвейеров. конвейер не удаляется, пока хранилище
+  // учтено в registry_clients
+  {
+    QMutexLocker plocker(&pipeline->m_mutex);
+
+    // пакеты хранилища в записи могут вернуться в очередь при потере соединения.
+    // после записи хранилище уже не вызывается
+    forever {
+
+      for(int i = pipeline->m_queue.count() - 1; i >= 0; i--) {
+
+        if(pipeline->m_queue.at(i).client != client)
+          continue;
+
+        pipeline->m_queued_calls -= pipeline->m_queue.at(i).calls.count();
+        pipeline->m_pending[client]--;
+        pipeline->m_queue.removeAt(i);
+
+      }
+
+      pipeline->m_queue_depth.set(pipeline->m_queued_calls);
+
+      if(pipeline->m_pending.value(client) <= 0)
+        break;
+
+      pipeline->m_done.wait(&pipeline->m_mutex);
+
+    }
+
+    pipeline->m_pending.remove(client);
+
+  }
+
+  QMutexLocker locker(&registry_mutex);
+
+  if(--registry_clients[pipeline] > 0)
+    return;
+
+  registry_clients.remove(pipeline);
+  registry.remove(pipeline->m_connection.key());
+
+  delete pipeline;
+
+}
+
+pgw::SvPgPipeline::SvPgPipeline(const Connection& connection, const PipelineParams& params, int number):
+  m_connection(connection),
+  m_params(params),
+  m_name(QString("PGPool_%1").arg(number))
+{
+  metrics::SvMetrics* m = metrics::SvMetrics::instance();
+
+  m_transactions  = m->counter(M_PGW_TRANSACTIONS,  m_name);
+  m_calls         = m->counter(M_PGW_CALLS,         m_name);
+  m_commit_time   = m->histogram(M_PGW_COMMIT_TIME, m_name);
+  m_queue_depth   = m->gauge(M_PGW_QUEUE,           m_name);
+
+  m_clock.start();
+
+  for(int i = 0; i < m_params.connections; i++) {
+
+    SvPgWriter* writer = new SvPgWriter(this, i);
+    m_writers.append(writer);
+
+    writer->start();
+
+  }
+}
+
+pgw::SvPgPipeline::~SvPgPipeline()
+{
+  {
+    QMutexLocker locker(&m_mutex);
+
+    m_stop = true;
+    m_wake.wakeAll();
+
+  }
+
+  for(SvPgWriter* writer: m_writers) {
+
+    writer->wait();
+    delete writer;
+
+  }
+}
+
+void pgw::SvPgPipeline::submit(SvPgClient* client, const QStringList& calls, const QVector<int>& ids)
+{
+  if(calls.isEmpty())
+    return;
+
+  QList<Batch> dropped;
+
+  {
+    QMutexLocker locker(&m_mutex);
+
+    m_queue.append(Batch{client, calls, now(), ids});
+    m_queued_calls += calls.count();
+    m_pending[client]++;
+
+    // переполнение - отбрасываются самые старые пакеты, но не только что поставленный
+    while(m_queued_calls > m_params.queue && m_queue.count() > 1) {
+
+      Batch batch = m_queue.takeFirst();
+      m_queued_calls -= batch.calls.count();
+
+      dropped.append(batch);
+
+    }
+
+    m_queue_depth.set(m_queued_calls);
+
+    // поток ждет commit_delay или commit_calls вызовов
+    if(m_queue.count() == 1 || m_queued_calls >= m_params.commit_calls)
+      m_wake.wakeOne();
+
+  }
+
+  if(!dropped.isEmpty())
+    drop(dropped, QString("Очередь записи %1 переполнена, пакет отброшен").arg(m_name));
+
+}
+
+bool pgw::SvPgPipeline::flush(SvPgClient* client, int timeout)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  QMutexLocker locker(&m_mutex);
+
+  while(m_pending.value(client) > 0) {
+
+    qint64 left = timeout - timer.elapsed();
+
+    if(left <= 0)
+      return false;
+
+    // пакеты хранилища записываются без ожидания commit_delay
+    m_flushing++;
+    m_wake.wakeAll();
+
+    m_done.wait(&m_mutex, quint64(left));
+
+    m_flushing--;
+
+  }
+
+  return true;
+
+}
+
+bool pgw::SvPgPipeline::take(QList<Batch>& group)
+{
+  QMutexLocker locker(&m_mutex);
+
+  forever {
+
+    if(m_stop)
+      return false;
+
+    // первый пакет хранилища, пакеты которого сейчас не записываются другим потоком
+    int first = 0;
+
+    while(first < m_queue.count() && m_writing.contains(m_queue.at(first).client))
+      first++;
+
+    if(first == m_queue.count()) {
+
+      m_wake.wait(&m_mutex);
+      continue;
+
+    }
+
+    // group commit: ждем пакеты других хранилищ, но не дольше commit_delay от постановки первого
+    qint64 left = m_queue.at(first).queued + qint64(m_params.commit_delay) * 1000 - now();
+
+    if(left > 0 && m_queued_calls < m_params.commit_calls && !m_flushing) {
+
+      m_wake.wait(&m_mutex, quint64((left + 999) / 1000));
+      continue;
+
+    }
+
+    break;
+
+  }
+
+  // хранилища, пакеты которых записываются другими потоками. их пакеты остаются в очереди,
+  // чтобы не быть зафиксированными раньше предыдущих
+  QSet<SvPgClient*> busy = QSet<SvPgClient*>::fromList(m_writing.keys());
+
+  // пакет целиком, даже если в нем больше commit_calls вызовов. на первом не поместившемся
+  // пакете группа завершается, иначе следующий пакет того же хранилища мог бы его обогнать
+  int calls = 0;
+  int i     = 0;
+
+  while(i < m_queue.count()) {
+
+    const Batch& batch = m_queue.at(i);
+
+    if(busy.contains(batch.client)) {
+
+      i++;
+      continue;
+
+    }
+
+    if(!group.isEmpty() && calls + batch.calls.count() > m_params.commit_calls)
+      break;
+
+    group.append(m_queue.takeAt(i));
+    calls += group.last().calls.count();
+
+    m_writing[group.last().client]++;
+
+  }
+
+  m_queued_calls -= calls;
+  m_queue_depth.set(m_queued_calls);
+
+  return true;
+
+}
+
+void pgw::SvPgPipeline::requeue(const QList<Batch>& group)
+{
+  // вызывается под m_mutex. порядок пакетов сохраняется: следующие пакеты тех же
+  // хранилищ, пока эти были в записи, из очереди не брались
+  for(int i = group.count() - 1; i >= 0; i--) {
+
+    m_queue.prepend(group.at(i));
+    m_queued_calls += group.at(i).calls.count();
+
+    if(--m_writing[group.at(i).client] <= 0)
+      m_writing.remove(group.at(i).client);
+
+  }
+
+  m_queue_depth.set(m_queued_calls);
+
+  m_done.wakeAll();
+  m_wake.wakeAll();
+
+}
+
+void pgw::SvPgPipeline::finish(const QList<Batch>& group, const QString& error)
+{
+  qint64 done = now();
+
+  for(const Batch& batch: group) {
+
+    if(error.isEmpty())
+      batch.client->written(batch.calls.count(), done - batch.queued, batch.ids);
+
+    else
+      batch.client->failed(batch.calls.count(), error);
+
+  }
+
+  QMutexLocker locker(&m_mutex);
+
+  for(const Batch& batch: group) {
+
+    m_pending[batch.client]--;
+
+    if(--m_writing[batch.client] <= 0)
+      m_writing.remove(batch.client);
+
+  }
+
+  m_done.wakeAll();
+
+  // пакеты хранилищ, ожидавшие окончания записи, могут быть взяты другими потоками
+  m_wake.wakeAll();
+
+}
+
+void pgw::SvPgPipeline::drop(const QList<Batch>& dropped, const QString& error)
+{
+  // отброшенные пакеты не были в записи: m_writing не меняется, иначе пакеты
+  // хранилища, которое сейчас записывается, мог бы взять другой поток
+  for(const Batch& batch: dropped)
+    batch.client->failed(batch.calls.count(), error);
+
+  QMutexLocker locker(&m_mutex);
+
+  for(const Batch& batch: dropped)
+    m_pending[batch.client]--;
+
+  m_done.wakeAll();
+
+}
+
+void pgw::SvPgPipeline::work(int index)
+{
+  QString name = QString("%1_%2").arg(m_name).arg(index);
+
+  SvPGDB* db = nullptr;
+  bool connected = false;
+
+  QList<Batch> group;
+
+  while(take(group)) {
+
+    if(!connected) {
+
+      if(db) {
+
+        delete db;
+        QSqlDatabase::removeDatabase(name);
+
+      }
+
+      db = new SvPGDB();
+      db->setConnectionParams(m_connection.db, m_connection.host, m_connection.port,
+                              m_connection.login, m_connection.pass, m_connection.role);
+
+      QSqlError err = db->connectToDB(name);
+
+      connected = err.type() == QSqlError::NoError;
+
+      if(!connected) {
+
+        // сообщение об ошибке - хранилищам, пакеты которых не записаны.
+        // до возврата в очередь: пока пакет в записи, хранилище не отключится
+        for(const Batch& batch: group)
+          batch.client->failed(0, QString("%1: %2").arg(name).arg(err.text()));
+
+        // группа возвращается в очередь, повтор соединения не чаще RECONNECT_INTERVAL
+        {
+          QMutexLocker locker(&m_mutex);
+
+          requeue(group);
+
+          QElapsedTimer pause;
+          pause.start();
+
+          while(!m_stop && pause.elapsed() < RECONNECT_INTERVAL)
+            m_wake.wait(&m_mutex, quint64(RECONNECT_INTERVAL - pause.elapsed()));
+
+        }
+
+        group.clear();
+        continue;
+
+      }
+    }
+
+    QStringList calls;
+    for(const Batch& batch: group)
+      calls.append(batch.calls);
+
+    qint64 start = now();
+
+    QSqlError err = transact(db, calls);
+
+    if(err.type() == QSqlError::NoError) {
+
+      m_commit_time.record(quint64(now() - start));
+      m_transactions.inc();
+      m_calls.inc(quint64(calls.count()));
+
+      finish(group, QString());
+
+    }
+
+    else if(!db->connected()) {
+
+      // потеря связи. группа будет записана после восстановления соединения
+      connected = false;
+
+      QMutexLocker locker(&m_mutex);
+      requeue(group);
+
+    }
+
+    else {
+
+      // ошибка вызова одного из хранилищ - пакеты выполняются по одному
+      for(int i = 0; i < group.count(); i++) {
+
+        const Batch& batch = group.at(i);
+
+        QSqlError berr = group.count() == 1 ? err : transact(db, batch.calls);
+
+        // потеря связи посреди группы: этот и следующие пакеты не записаны,
+        // они будут записаны после восстановления соединения
+        if(berr.type() != QSqlError::NoError && !db->connected()) {
+
+          connected = false;
+
+          QMutexLocker locker(&m_mutex);
+          requeue(group.mid(i));
+
+          break;
+
+        }
+
+        if(berr.type() == QSqlError::NoError) {
+
+          m_transactions.inc();
+          m_calls.inc(quint64(batch.calls.count()));
+
+        }
+
+        finish(QList<Batch>() << batch, berr.type() == QSqlError::NoError ? QString() : berr.text());
+
+      }
+    }
+
+    group.clear();
+
+  }
+
+  if(db) {
+
+    delete db;
+    QSqlDatabase::removeDatabase(name);
+
+  }
+}
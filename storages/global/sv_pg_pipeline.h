@@ -0,0 +1,338 @@
+/**********************************************************************
+ *  общий конвейер записи в БД PostgreSQL для хранилищ.
+ *
+ *  в режиме "own" (по умолчанию) каждое хранилище, как и раньше, держит
+ *  собственное соединение PGConn_<id> и выполняет вызовы процедуры в
+ *  своем потоке, каждый вызов - отдельная транзакция.
+ *
+ *  в режиме "shared" хранилище передает вызовы одного прохода пакетом
+ *  (submit) конвейеру своего сервера БД и продолжает работу, не ожидая
+ *  записи. у конвейера pool_connections соединений, у каждого свой
+ *  поток записи. поток забирает из очереди пакеты нескольких хранилищ
+ *  и выполняет их в одной транзакции (group commit):
+ *    - после постановки в очередь первого пакета поток ждет не дольше
+ *      commit_delay мс, пока подойдут пакеты других хранилищ;
+ *    - если в очереди набралось commit_calls вызовов, транзакция
+ *      начинается сразу, не дожидаясь commit_delay.
+ *  если транзакция не выполнена из-за ошибки вызова, пакеты группы
+ *  выполняются по одному, и ошибка одного хранилища не мешает записи
+ *  остальных. при потере соединения незаписанные пакеты группы
+ *  возвращаются в очередь.
+ *
+ *  пакеты одного хранилища записываются в порядке постановки: пока
+ *  пакет хранилища в записи у одного потока, другие потоки его пакеты
+ *  из очереди не берут.
+ *  очередь ограничена pool_queue вызовами, при переполнении
+ *  отбрасываются самые старые пакеты.
+ *
+ *  конвейер общий для хранилищ библиотеки с одинаковыми параметрами
+ *  соединения. создается при подключении первого хранилища, его
+ *  параметрами, и удаляется при отключении последнего.
+ * *********************************************************************/
+
+#ifndef SV_PG_PIPELINE_H
+#define SV_PG_PIPELINE_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QMap>
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "../../svlib/sv_exception.h"
+#include "../../Modus/global/global_defs.h"
+#include "../../global/sv_metrics.h"
+
+#define P_WRITER                "writer"
+#define P_POOL_CONNECTIONS      "pool_connections"
+#define P_COMMIT_DELAY          "commit_delay"
+#define P_COMMIT_CALLS          "commit_calls"
+#define P_POOL_QUEUE            "pool_queue"
+
+#define DEFAULT_POOL_CONNECTIONS  2
+#define DEFAULT_COMMIT_DELAY      20      // мс
+#define DEFAULT_COMMIT_CALLS      256     // вызовов в транзакции
+#define DEFAULT_POOL_QUEUE        10000   // вызовов в очереди
+
+#define MAX_POOL_CONNECTIONS      16
+#define MAX_COMMIT_DELAY          10000
+#define RECONNECT_INTERVAL        1000    // мс
+#define FLUSH_TIMEOUT             5000    // мс, ожидание записи при остановке хранилища
+
+// конвейеры
+#define M_PGW_TRANSACTIONS        "modus_pg_pipeline_transactions_total"
+#define M_PGW_CALLS               "modus_pg_pipeline_calls_total"
+#define M_PGW_COMMIT_TIME         "modus_pg_pipeline_commit_seconds"
+#define M_PGW_QUEUE               "modus_pg_pipeline_queue"
+
+namespace pgw {
+
+  enum WriterMode {
+    wmOwn,      // собственное соединение хранилища
+    wmShared    // общий конвейер
+  };
+
+  const QMap<QString, WriterMode> WriterModes = {{"own",    wmOwn},
+                                                 {"shared", wmShared}};
+
+  struct PipelineParams {
+
+    WriterMode  mode          = wmOwn;
+
+    int         connections   = DEFAULT_POOL_CONNECTIONS;
+
+    // наибольшее ожидание пакетов для общей транзакции, мс. 0 - без ожидания
+    int         commit_delay  = DEFAULT_COMMIT_DELAY;
+
+    // наибольшее кол-во вызовов в транзакции
+    int         commit_calls  = DEFAULT_COMMIT_CALLS;
+
+    int         queue         = DEFAULT_POOL_QUEUE;
+
+    static PipelineParams fromJson(const QString& json_string) //throw (SvException)
+    {
+      QJsonParseError err;
+      QJsonDocument jd = QJsonDocument::fromJson(json_string.toUtf8(), &err);
+
+      if(err.error != QJsonParseError::NoError)
+        throw SvException(err.errorString());
+
+      try {
+
+        return fromJsonObject(jd.object());
+
+      }
+      catch(SvException& e) {
+        throw e;
+      }
+    }
+
+    static PipelineParams fromJsonObject(const QJsonObject &object) //throw (SvException)
+    {
+      PipelineParams p;
+      QString P;
+
+      /* writer */
+      P = P_WRITER;
+      if(object.contains(P)) {
+
+        QString mode = object.value(P).toString().toLower();
+
+        if(!WriterModes.contains(mode))
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P)
+                            .arg(object.value(P).toVariant().toString())
+                            .arg("Допустимые значения: own, shared"));
+
+        p.mode = WriterModes.value(mode);
+
+      }
+
+      /* pool_connections */
+      P = P_POOL_CONNECTIONS;
+      if(object.contains(P)) {
+
+        p.connections = object.value(P).toInt(-1);
+
+        if(p.connections < 1 || p.connections > MAX_POOL_CONNECTIONS)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P)
+                            .arg(object.value(P).toVariant().toString())
+                            .arg(QString("Кол-во соединений должно быть целым числом от 1 до %1").arg(MAX_POOL_CONNECTIONS)));
+
+      }
+
+      /* commit_delay */
+      P = P_COMMIT_DELAY;
+      if(object.contains(P)) {
+
+        p.commit_delay = object.value(P).toInt(-1);
+
+        if(p.commit_delay < 0 || p.commit_delay > MAX_COMMIT_DELAY)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P)
+                            .arg(object.value(P).toVariant().toString())
+                            .arg(QString("Время ожидания должно быть целым числом от 0 до %1 мс").arg(MAX_COMMIT_DELAY)));
+
+      }
+
+      /* commit_calls */
+      P = P_COMMIT_CALLS;
+      if(object.contains(P)) {
+
+        p.commit_calls = object.value(P).toInt(-1);
+
+        if(p.commit_calls < 1)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P)
+                            .arg(object.value(P).toVariant().toString())
+                            .arg("Кол-во вызовов в транзакции должно быть целым положительным числом"));
+
+      }
+
+      /* pool_queue */
+      P = P_POOL_QUEUE;
+      if(object.contains(P)) {
+
+        p.queue = object.value(P).toInt(-1);
+
+        if(p.queue < p.commit_calls)
+          throw SvException(QString(IMPERMISSIBLE_VALUE)
+                            .arg(P)
+                            .arg(object.value(P).toVariant().toString())
+                            .arg(QString("Размер очереди должен быть целым числом не меньше %1 (%2)").arg(P_COMMIT_CALLS).arg(p.commit_calls)));
+
+      }
+
+      return p;
+
+    }
+
+    QJsonObject toJsonObject() const
+    {
+      QJsonObject j;
+
+      j.insert(P_WRITER,            QJsonValue(WriterModes.key(mode)));
+      j.insert(P_POOL_CONNECTIONS,  QJsonValue(connections));
+      j.insert(P_COMMIT_DELAY,      QJsonValue(commit_delay));
+      j.insert(P_COMMIT_CALLS,      QJsonValue(commit_calls));
+      j.insert(P_POOL_QUEUE,        QJsonValue(queue));
+
+      return j;
+
+    }
+  };
+
+  // параметры соединения с БД. конвейер общий для одинаковых параметров
+  struct Connection {
+
+    QString db;
+    QString host;
+    quint16 port;
+    QString login;
+    QString pass;
+    QString role;
+
+    QString key() const
+    {
+      return QString("%1:%2/%3/%4/%5/%6").arg(host).arg(port).arg(db).arg(login).arg(role).arg(pass);
+    }
+  };
+
+  class SvPgClient;
+  class SvPgWriter;
+  class SvPgPipeline;
+
+}
+
+/** хранилище, передающее вызовы конвейеру **/
+class pgw::SvPgClient
+{
+public:
+  virtual ~SvPgClient() { }
+
+  // вызовы пакета выполнены. us - от постановки в очередь до фиксации транзакции,
+  // ids - сигналы, значения которых переданы в пакете. вызывается из потока записи
+  virtual void written(int calls, qint64 us, const QVector<int>& ids) = 0;
+
+  // пакет не записан (ошибка вызова или переполнение очереди). вызывается из потока записи
+  // или из submit
+  virtual void failed(int calls, const QString& error) = 0;
+
+};
+
+class pgw::SvPgWriter: public QThread
+{
+public:
+  SvPgWriter(SvPgPipeline* pipeline, int index);
+
+protected:
+  void run() override;
+
+private:
+  SvPgPipeline* m_pipeline;
+  int           m_index;
+
+};
+
+class pgw::SvPgPipeline
+{
+public:
+  // конвейер для соединения. создается при подключении первого хранилища
+  static SvPgPipeline* attach(SvPgClient* client, const Connection& connection, const PipelineParams& params);
+
+  // отключение хранилища. пакеты хранилища, еще не взятые в запись, отбрасываются.
+  // после отключения последнего хранилища конвейер удаляется
+  static void detach(SvPgPipeline* pipeline, SvPgClient* client);
+
+  // постановка пакета вызовов в очередь. ids возвращаются хранилищу в written.
+  // может вызываться из любого потока
+  void submit(SvPgClient* client, const QStringList& calls, const QVector<int>& ids = QVector<int>());
+
+  // ожидание записи всех пакетов хранилища. false - не записаны за timeout мс
+  bool flush(SvPgClient* client, int timeout);
+
+  const PipelineParams& params() const { return m_params; }
+
+private:
+  friend class SvPgWriter;
+
+  SvPgPipeline(const Connection& connection, const PipelineParams& params, int number);
+  ~SvPgPipeline();
+
+  struct Batch {
+
+    SvPgClient*   client;
+    QStringList   calls;
+    qint64        queued;     // момент постановки в очередь, мкс
+    QVector<int>  ids;
+
+  };
+
+  Connection            m_connection;
+  PipelineParams        m_params;
+  QString               m_name;         // PGPool_<номер>, для соединений и метрик
+
+  QMutex                m_mutex;
+  QWaitCondition        m_wake;         // очередь не пуста
+  QWaitCondition        m_done;         // пакет записан
+
+  QList<Batch>          m_queue;
+  int                   m_queued_calls = 0;
+
+  // пакеты хранилищ в очереди и в записи
+  QHash<SvPgClient*, int> m_pending;
+
+  // пакеты хранилищ, взятые потоками записи
+  QHash<SvPgClient*, int> m_writing;
+
+  QList<SvPgWriter*>    m_writers;
+  bool                  m_stop = false;
+  int                   m_flushing = 0; // ожидающих в flush - commit_delay не выдерживается
+
+  QElapsedTimer         m_clock;
+
+  metrics::Counter      m_transactions;
+  metrics::Counter      m_calls;
+  metrics::Histogram    m_commit_time;
+  metrics::Gauge        m_queue_depth;
+
+  qint64 now() const { return m_clock.nsecsElapsed() / 1000; }
+
+  bool take(QList<Batch>& group);
+  void requeue(const QList<Batch>& group);
+  void finish(const QList<Batch>& group, const QString& error);
+  void drop(const QList<Batch>& dropped, const QString& error);
+  void work(int index);
+
+};
+
+#endif // SV_PG_PIPELINE_H
@@ -25,6 +25,15 @@ bool pgsp::pgStoredProcStorage::configure(modus::StorageConfig *config)
     /* парсим - проверяем, что парметры заданы верно */
     m_params = pgsp::Params::fromJson(p_config->params);
 
+    /* режим записи: собственное соединение или общий конвейер */
+    m_pipeline = pgw::PipelineParams::fromJson(p_config->params);
+
+    /* привязка потока хранилища к ядрам и приоритет */
+    m_realtime = rt::Params::fromJsonString(p_config->params);
+
+    /* метка рядов - имя хранилища */
+    m_metrics.attach(p_config->name);
+
     return true;
 
   }
@@ -126,8 +135,20 @@ void pgsp::pgStoredProcStorage::processSignals()
 
   p_is_active = true;
 
+  // параметры реального времени применяются в потоке хранилища
+  QString rt_error;
+  if(!rt::apply(m_realtime, &rt_error))
+    emit message(rt_error, sv::log::llError, sv::log::mtError);
+
+  // в режиме shared вызовы выполняются потоками конвейера, соединение хранилища не нужно
+  bool shared = m_pipeline.mode == pgw::wmShared;
+
+  if(shared)
+    m_writer = pgw::SvPgPipeline::attach(this, pgw::Connection{m_params.db, m_params.host, m_params.port,
+                                                                m_params.login, m_params.pass, m_params.role}, m_pipeline);
+
   bool need_to_finish    = false;
-  bool need_to_reconnect = true;
+  bool need_to_reconnect = !shared;
 
   while(!need_to_finish) {
 
@@ -189,29 +210,76 @@ void pgsp::pgStoredProcStorage::processSignals()
       need_to_finish = true;
     }
 
+    if(shared) {
+
+      QStringList calls;
+
+      foreach (QString type, signals_values.keys()) {
+
+        if(!signals_values.value(type).isEmpty()) {
+
+          signals_values[type].chop(1);
+
+          calls << QString(PROC_CALL).arg(m_params.proc_name).arg(type).arg(signals_values.value(type));
+
+        }
+      }
+
+      // очередь - вызовы, переданные конвейеру и еще не записанные
+      m_metrics.queue_depth.add(calls.count());
+
+      // задержка этапа записывается в written, после фиксации транзакции
+      QVector<int> ids;
+      ids.reserve(p_signals.count());
+
+      for(modus::SvSignal* signal: p_signals)
+        ids.append(signal->id());
+
+      m_writer->submit(this, calls, ids);
+
+      continue;
+
+    }
+
 
     try {
 
+      // очередь - вызовы процедуры, еще не выполненные в этом проходе
+      m_metrics.queue_depth.set(signals_values.count());
+
       foreach (QString type, signals_values.keys()) {
 
         if(!signals_values.value(type).isEmpty()) {
 
           signals_values[type].chop(1);
 
+          QElapsedTimer write_timer;
+          write_timer.start();
+
           QSqlError serr = PGDB->execSQL(QString(PROC_CALL)
                                          .arg(m_params.proc_name)
                                          .arg(type)
                                          .arg(signals_values.value(type)));
 
+          m_metrics.write_time.record(quint64(write_timer.nsecsElapsed() / 1000));
+          m_metrics.queue_depth.add(-1);
+
           if(serr.type() != QSqlError::NoError)
             throw SvException(serr.text());
 
         }
       }
+
+      // задержка от приема данных до записи значений в БД
+      for(modus::SvSignal* signal: p_signals)
+        m_trace.record(signal->id());
     }
 
     catch(SvException& e) {
 
+      m_metrics.write_errors.inc();
+      m_metrics.queue_depth.set(0);
+
       emit message(e.error, sv::log::llError, sv::log::mtError);
 
       // если произошла потеря связи с серверм БД, то завершаем поток
@@ -221,6 +289,45 @@ void pgsp::pgStoredProcStorage::processSignals()
 
     }
   }
+
+  if(shared) {
+
+    // значения timeout_value последнего прохода должны быть записаны до завершения
+    if(!m_writer->flush(this, FLUSH_TIMEOUT))
+      emit message(QString("PGConn_%1: не все значения записаны в БД до завершения работы").arg(p_config->id),
+                   sv::log::llError, sv::log::mtError);
+
+    pgw::SvPgPipeline::detach(m_writer, this);
+    m_writer = nullptr;
+
+  }
+}
+
+void pgsp::pgStoredProcStorage::written(int calls, qint64 us, const QVector<int>& ids)
+{
+  m_metrics.queue_depth.add(-calls);
+
+  // от передачи конвейеру до фиксации транзакции
+  m_metrics.write_time.record(quint64(us));
+
+  // задержка от приема данных до записи значений в БД, как и в режиме own
+  for(int id: ids)
+    m_trace.record(id);
+
+}
+
+void pgsp::pgStoredProcStorage::failed(int calls, const QString& error)
+{
+  // calls = 0 - нет соединения, пакет остается в очереди конвейера
+  if(calls) {
+
+    m_metrics.queue_depth.add(-calls);
+    m_metrics.write_errors.inc();
+
+  }
+
+  emit message(error, sv::log::llError, sv::log::mtError);
+
 }
 
 
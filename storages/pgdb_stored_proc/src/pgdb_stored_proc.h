@@ -20,6 +20,10 @@
 #include "../../../Modus/global/global_defs.h"
 
 #include "../../../svlib/sv_pgdb.h"
+#include "../../../global/sv_realtime.h"
+#include "../../../global/sv_metrics.h"
+#include "../../../global/sv_latency.h"
+#include "../../global/sv_pg_pipeline.h"
 #include "params.h"
 
 extern "C" {
@@ -39,7 +43,7 @@ namespace pgsp {
 }
 
 
-class pgsp::pgStoredProcStorage: public modus::SvAbstractStorage
+class pgsp::pgStoredProcStorage: public modus::SvAbstractStorage, public pgw::SvPgClient
 {
   Q_OBJECT
 
@@ -51,8 +55,17 @@ public:
 
 private:
   pgsp::Params m_params;
+  rt::Params   m_realtime;
+  metrics::StorageMetrics m_metrics;   // /metrics
+
+  // этап записи в БД. в режиме shared - из written: потоки конвейера вызывают его
+  // для хранилища поочередно, поток хранилища этап не записывает
+  latency::Consumer m_trace{latency::lsStorage};
   SvPGDB* PGDB = nullptr;
 
+  pgw::PipelineParams m_pipeline;
+  pgw::SvPgPipeline*  m_writer = nullptr;   // общий конвейер записи, writer = shared
+
   QString m_last_error = "";
 
   QTimer* m_reconnect_timer = nullptr;
@@ -60,6 +73,10 @@ private:
   bool connect();
   void processSignals() override;
 
+  // pgw::SvPgClient. вызываются из потока записи конвейера
+  void written(int calls, qint64 us, const QVector<int>& ids) override;
+  void failed(int calls, const QString& error) override;
+
 private slots:
   void reconnect();
   void start_reconnect_timer();
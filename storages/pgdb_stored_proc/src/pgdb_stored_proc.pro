@@ -18,10 +18,18 @@ DEFINES += PGDB_STORED_PROC_LIBRARY
 SOURCES += \
     pgdb_stored_proc.cpp \
     ../../../svlib/sv_pgdb.cpp \
+    ../../../global/sv_realtime.cpp \
+    ../../../global/sv_metrics.cpp \
+    ../../../global/sv_latency.cpp \
+    ../../global/sv_pg_pipeline.cpp \
     ../../../Modus/global/signal/sv_signal.cpp
 
 HEADERS += \
     params.h \
+    ../../../global/sv_realtime.h \
+    ../../../global/sv_metrics.h \
+    ../../../global/sv_latency.h \
+    ../../global/sv_pg_pipeline.h \
     pgdb_stored_proc_global.h \
     pgdb_stored_proc.h \
     ../../../Modus/global/storage/sv_abstract_storage.h \
@@ -25,6 +25,8 @@ bool pgsp::pgStoredProcStorage::configure(modus::StorageConfig *config)
     /* парсим - проверяем, что парметры заданы верно */
     m_params = pgsp::Params::fromJson(p_config->params);
 
+    m_metrics.attach(p_config->name);
+
     return true;
 
   }
@@ -191,6 +193,8 @@ void pgsp::pgStoredProcStorage::processSignals()
     }
 
 
+    m_metrics.queue_depth.set(signals_values.count());
+
     try {
 
       foreach (QString type, signals_values.keys()) {
@@ -199,18 +203,29 @@ void pgsp::pgStoredProcStorage::processSignals()
 
           signals_values[type].chop(1);
 
+          QElapsedTimer write_timer;
+          write_timer.start();
+
           QSqlError serr = PGDB->execSQL(QString(PROC_CALL)
                                          .arg(m_params.proc_name, signals_values.value(type)));
 
           if(serr.type() != QSqlError::NoError)
             throw SvException(serr.text());
 
+          m_metrics.write_time.record(quint64(write_timer.nsecsElapsed() / 1000));
+
         }
+
+        m_metrics.queue_depth.add(-1);
+
       }
     }
 
     catch(SvException& e) {
 
+      m_metrics.write_errors.inc();
+      m_metrics.queue_depth.set(0);
+
       emit message(e.error, sv::log::llError, sv::log::mtError);
 
       // если произошла потеря связи с серверм БД, то завершаем поток
@@ -20,6 +20,7 @@
 #include "../../../Modus/global/global_defs.h"
 
 #include "../../../svlib/sv_pgdb.h"
+#include "../../../global/sv_metrics.h"
 #include "params.h"
 
 extern "C" {
@@ -57,6 +58,8 @@ private:
 
   QTimer* m_reconnect_timer = nullptr;
 
+  metrics::StorageMetrics m_metrics;   // /metrics
+
   bool connect();
   void processSignals() override;
 
@@ -18,11 +18,13 @@ DEFINES += PGDB_STORED_PROC_AGGREGATE_LIBRARY
 SOURCES += \
     pgdb_stored_proc_aggregate.cpp \
     ../../../svlib/sv_pgdb.cpp \
+    ../../../global/sv_metrics.cpp \
     ../../../Modus/global/signal/sv_signal.cpp
 
 HEADERS += \
     pgdb_stored_proc_aggregate_global.h \
     pgdb_stored_proc_aggregate.h \
+    ../../../global/sv_metrics.h \
     ../../../Modus/global/storage/sv_abstract_storage.h \
     ../../../Modus/global/misc/sv_pgdb.h \
     ../../../Modus/global/misc/sv_exception.h \